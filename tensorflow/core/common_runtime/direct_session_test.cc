@@ -2966,6 +2966,55 @@ BENCHMARK(BM_FeedFetchCallableSingleThreadExecutor)
     ->Arg(5)
     ->Arg(10);
 
+// Builds a session graph with `num_nodes` nodes split into `num_signatures`
+// independent Identity chains, and measures the cost of preparing a callable
+// that fetches the end of one chain. Each callable only touches a small part of
+// a large graph, which is the common case for sessions with many signatures.
+void BM_MakeCallableManySignatures(::testing::benchmark::State& state) {
+  const int num_nodes = state.range(0);
+  const int num_signatures = state.range(1);
+  const int chain_length = num_nodes / num_signatures;
+
+  Graph g(OpRegistry::Global());
+  std::vector<std::string> fetches;
+  for (int i = 0; i < num_signatures; ++i) {
+    Node* prev;
+    TF_CHECK_OK(NodeBuilder(g.NewName("Placeholder"), "Placeholder")
+                    .Attr("shape", TensorShape())
+                    .Attr("dtype", DT_FLOAT)
+                    .Device("/cpu:0")
+                    .Finalize(&g, &prev));
+    for (int j = 1; j < chain_length; ++j) {
+      TF_CHECK_OK(NodeBuilder(g.NewName("Identity"), "Identity")
+                      .Input(prev)
+                      .Attr("T", DT_FLOAT)
+                      .Device("/cpu:0")
+                      .Finalize(&g, &prev));
+    }
+    fetches.push_back(prev->name() + ":0");
+  }
+  GraphDef gd;
+  g.ToGraphDef(&gd);
+  SessionOptions opts;
+  std::unique_ptr<Session> session(NewSession(opts));
+  TF_CHECK_OK(session->Create(gd));
+
+  int next_signature = 0;
+  for (auto s : state) {
+    CallableOptions callable_options;
+    callable_options.add_fetch(fetches[next_signature]);
+    next_signature = (next_signature + 1) % num_signatures;
+    Session::CallableHandle handle;
+    TF_CHECK_OK(session->MakeCallable(callable_options, &handle));
+    TF_CHECK_OK(session->ReleaseCallable(handle));
+  }
+}
+
+BENCHMARK(BM_MakeCallableManySignatures)
+    ->ArgPair(10000, 100)
+    ->ArgPair(100000, 100)
+    ->ArgPair(100000, 1000);
+
 }  // namespace
 
 class DirectSessionCollectiveTest : public ::testing::Test {
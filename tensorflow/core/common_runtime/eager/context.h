@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_CONTEXT_H_
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -778,9 +779,24 @@ class EagerContext : public ImmediateExecutionContext, public core::RefCounted {
 
     std::unique_ptr<std::vector<Fprint128>> cached_kernel_keys;
   };
-  std::unordered_map<Fprint128, core::RefCountPtr<KernelAndDevice>,
-                     Fprint128Hasher>
-      kernel_cache_ TF_GUARDED_BY(cache_mu_);
+  // The kernel cache is looked up on every eager op, so it is split into
+  // shards with their own reader/writer locks. Lookups only take a shared lock
+  // on one shard and never contend with `cache_mu_`. Writers that also need
+  // `cache_mu_` (e.g. to track per-function cache keys) must acquire it before
+  // any shard lock.
+  static constexpr int kNumKernelCacheShards = 16;
+  struct KernelCacheShard {
+    mutex mu;
+    std::unordered_map<Fprint128, core::RefCountPtr<KernelAndDevice>,
+                       Fprint128Hasher>
+        kernels TF_GUARDED_BY(mu);
+  };
+  KernelCacheShard& GetKernelCacheShard(const Fprint128& cache_key) {
+    // `low64` already selects the bucket inside the shard's map, so pick the
+    // shard from the high bits to keep the two independent.
+    return kernel_cache_[cache_key.high64 % kNumKernelCacheShards];
+  }
+  std::array<KernelCacheShard, kNumKernelCacheShards> kernel_cache_;
   std::unordered_map<std::string, RegisteredFunction*> registered_functions_
       TF_GUARDED_BY(cache_mu_);
 
@@ -32,12 +32,26 @@ bool IsAsyncWaitForRemoteFunctionEnabled() {
                                  true, &enabled));
   return enabled;
 }
+
+int64_t NumParallelWorkers(int num_parallel_workers) {
+  if (num_parallel_workers > 0) return num_parallel_workers;
+  int64_t from_env = 0;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_EAGER_ASYNC_NUM_PARALLEL_WORKERS", 0,
+                                  &from_env));
+  return from_env;
+}
 }  // namespace
 
 EagerExecutor::EagerExecutor(bool async, bool enable_streaming_enqueue,
-                             int in_flight_nodes_limit)
+                             int in_flight_nodes_limit,
+                             int num_parallel_workers)
     : next_node_id_(0),
       ok_(true),
+      worker_pool_(async && NumParallelWorkers(num_parallel_workers) > 0
+                       ? std::make_unique<thread::ThreadPool>(
+                             tensorflow::Env::Default(), "eager_async_worker",
+                             NumParallelWorkers(num_parallel_workers))
+                       : nullptr),
       thread_(async ? tensorflow::Env::Default()->StartThread(
                           tensorflow::ThreadOptions(), "eager_async_executor",
                           std::bind(&EagerExecutor::Run, this))
@@ -51,12 +65,21 @@ EagerExecutor::EagerExecutor(bool async, bool enable_streaming_enqueue,
     VLOG(4) << "EagerExecutor InFlightNodes limit is set to "
             << in_flight_nodes_limit_;
   }
+  if (worker_pool_ != nullptr) {
+    VLOG(4) << "EagerExecutor dispatches independent nodes to "
+            << worker_pool_->NumThreads() << " parallel workers";
+  }
 }
 
 EagerExecutor::~EagerExecutor() {
   tensorflow::mutex_lock l(node_queue_mutex_);
   state_ = ExecutorState::kShutDown;
   nodes_pending_.notify_all();
+  nodes_done_.notify_all();
+  // Nodes running on `worker_pool_` call back into this executor when done.
+  while (num_concurrent_nodes_in_flight_ > 0) {
+    nodes_done_.wait(l);
+  }
   for (const auto& cleanups_for_key : cleanups_) {
     for (const std::function<void()>& cleanup : cleanups_for_key.second) {
       cleanup();
@@ -239,7 +262,7 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
   DCHECK(item->state != NodeState::kDONE);
   item->state = NodeState::kDONE;
 
-  bool async = item->node->AsAsync() != nullptr;
+  bool async = item->node->AsAsync() != nullptr || item->concurrent;
   // If executing synchronously we don't need to notify if status is OK since
   // the node  was never added to the unfinished_nodes_ list and nobody should
   // ever be waiting for it.
@@ -250,6 +273,11 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
   std::forward_list<core::RefCountPtr<NodeItem>> items_to_destroy;
   {
     mutex_lock l(node_queue_mutex_);
+    if (item->concurrent) {
+      --num_concurrent_nodes_in_flight_;
+      // Wake the executor thread, which may be waiting for in-flight nodes.
+      nodes_done_.notify_all();
+    }
     if (!status_.ok()) return;
 
     bool need_notification = from_queue;
@@ -293,6 +321,9 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
         node_queue_.pop();
       }
       for (auto& it : unfinished_nodes_) {
+        // Nodes still running on `worker_pool_` will produce (or poison) their
+        // own outputs when they finish.
+        if (it.second->concurrent) continue;
         items_to_destroy.push_front(std::move(it.second));
       }
       unfinished_nodes_.clear();
@@ -351,9 +382,25 @@ void EagerExecutor::Run() {
     core::RefCountPtr<NodeItem> curr_item;
     {
       tensorflow::mutex_lock l(node_queue_mutex_);
-      while (node_queue_.empty() || !status_.ok()) {
-        if (state_ == ExecutorState::kShutDown) return;
-        nodes_pending_.wait(l);
+      std::optional<bool> run_concurrently = WaitForRunnableFrontLocked(&l);
+      if (!run_concurrently.has_value()) return;
+      if (*run_concurrently) {
+        NodeItem* item = node_queue_.front().get();
+        DVLOG(3) << "Dispatching Node: [id " << item->id << "] "
+                 << item->node->DebugString() << " to a parallel worker";
+        item->Ref();
+        item->state = NodeState::kSCHEDULED;
+        item->concurrent = true;
+        ++num_concurrent_nodes_in_flight_;
+        unfinished_nodes_.emplace_hint(unfinished_nodes_.end(), item->id,
+                                       std::move(node_queue_.front()));
+        node_queue_.pop();
+        worker_pool_->Schedule([this, item]() {
+          core::RefCountPtr<NodeItem> concurrent_item(item);
+          absl::Status status = concurrent_item->node->Run();
+          NodeDone(concurrent_item, status, /*from_queue=*/false);
+        });
+        continue;
       }
       // Obtain raw pointer since we don't want to remove from the queue until
       // the node has been run. Otherwise, WaitForAllPendingNodes can return
@@ -372,6 +419,25 @@ void EagerExecutor::Run() {
   }
 }
 
+std::optional<bool> EagerExecutor::WaitForRunnableFrontLocked(
+    mutex_lock* lock) {
+  while (true) {
+    while (node_queue_.empty() || !status_.ok()) {
+      if (state_ == ExecutorState::kShutDown) return std::nullopt;
+      nodes_pending_.wait(*lock);
+    }
+    if (worker_pool_ == nullptr) return false;
+    const EagerNode* node = node_queue_.front()->node.get();
+    if (node->CanRunConcurrently() && node->InputsReady()) return true;
+    // The front node either has to observe the effects of every node
+    // dispatched before it, or consumes the output of one that is still
+    // running. Wait for a dispatched node to finish and check again.
+    if (num_concurrent_nodes_in_flight_ == 0) return false;
+    if (state_ == ExecutorState::kShutDown) return std::nullopt;
+    nodes_done_.wait(*lock);
+  }
+}
+
 absl::Status EagerExecutor::RunItem(core::RefCountPtr<NodeItem> item,
                                     bool from_queue) {
   DVLOG(3) << "Running Node: [id " << item->id << "] "
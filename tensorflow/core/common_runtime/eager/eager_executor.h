@@ -21,6 +21,7 @@ limitations under the License.
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <string>
 #include <unordered_map>
@@ -34,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -80,6 +82,17 @@ class EagerNode {
 
   // Indicates whether a node failure should make the executor unusable.
   virtual bool Fatal() const { return true; }
+
+  // Returns true if this node has no ordering constraints with respect to
+  // other nodes in the same executor beyond its data dependencies, i.e. it
+  // neither reads nor writes state that an earlier or later node may touch.
+  // Such nodes may be dispatched concurrently by an async EagerExecutor with
+  // parallel workers once InputsReady() returns true.
+  virtual bool CanRunConcurrently() const { return false; }
+
+  // Returns true if all the tensors this node consumes have been produced.
+  // Only consulted for nodes where CanRunConcurrently() is true.
+  virtual bool InputsReady() const { return true; }
 };
 
 class AsyncEagerNode : public EagerNode {
@@ -111,13 +124,20 @@ class AsyncRemoteExecuteNode : public AsyncEagerNode {
 // TODO(agarwal): TFE_OpAddInput may currently block if it tries to access the
 // device of the input handle. Fix that.
 // TODO(agarwal): Implement support for control dependencies.
-// TODO(agarwal): Support out-of-order execution and dispatching multiple
-// EagerNode in parallel.
+//
+// In async mode with `num_parallel_workers` > 0 (or the
+// TF_EAGER_ASYNC_NUM_PARALLEL_WORKERS environment variable set), nodes that
+// report CanRunConcurrently() are dispatched to a pool of worker threads as
+// soon as their inputs are ready, so that independent ops overlap. All other
+// nodes act as barriers: they only start once every previously dispatched node
+// has finished, and run on the executor thread as before. Thus the observable
+// behavior is that of a single in-order stream.
 // TODO(agarwal): Implement optimizations over EagerNode traces.
 class EagerExecutor {
  public:
   explicit EagerExecutor(bool async, bool enable_streaming_enqueue = true,
-                         int in_flight_nodes_limit = 0);
+                         int in_flight_nodes_limit = 0,
+                         int num_parallel_workers = 0);
 
   ~EagerExecutor();
 
@@ -196,6 +216,9 @@ class EagerExecutor {
     uint64_t id;
     std::unique_ptr<EagerNode> node;
     NodeState state;
+    // True if the node was dispatched to `worker_pool_` rather than run on
+    // the executor thread.
+    bool concurrent = false;
   };
 
   const char* StateStringLocked()
@@ -213,6 +236,13 @@ class EagerExecutor {
   void Run();
 
   absl::Status RunItem(core::RefCountPtr<NodeItem> item, bool from_queue);
+
+  // Blocks until the node at the front of `node_queue_` may be started.
+  // Returns true if it should be dispatched to `worker_pool_`, false if it
+  // should run on the executor thread. Returns std::nullopt if the executor
+  // was shut down while waiting.
+  std::optional<bool> WaitForRunnableFrontLocked(mutex_lock* lock)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(node_queue_mutex_);
   absl::Status MoveToUnfinished(core::RefCountPtr<NodeItem> item,
                                 bool from_queue);
 
@@ -252,6 +282,10 @@ class EagerExecutor {
   std::multimap<uint64_t, condition_variable*, std::less<uint64_t>>
       node_done_notifications_ TF_GUARDED_BY(node_queue_mutex_);
 
+  // Number of nodes dispatched to `worker_pool_` that have not called
+  // NodeDone() yet.
+  int64_t num_concurrent_nodes_in_flight_ TF_GUARDED_BY(node_queue_mutex_) = 0;
+
   // thread_exited_notification_ is notified by the `thread_` right before it
   // exits.
   absl::Notification thread_exited_notification_;
@@ -261,6 +295,11 @@ class EagerExecutor {
   ExecutorState state_ TF_GUARDED_BY(node_queue_mutex_) =
       ExecutorState::kActive;
 
+  // Pool running nodes that can be executed concurrently. It is `nullptr` in
+  // sync mode or if parallel workers are disabled. Declared before `thread_`
+  // so that the executor thread is joined before the pool is destroyed.
+  const std::unique_ptr<thread::ThreadPool> worker_pool_;
+
   // Thread object that calls the `Run` method in async mode.This thread runs
   // until state_ is set to kShuttingDown. It is `nullptr` in sync mode.
   const std::unique_ptr<Thread> thread_;
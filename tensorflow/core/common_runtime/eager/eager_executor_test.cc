@@ -17,9 +17,11 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "absl/synchronization/notification.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "xla/tsl/platform/status.h"
 #include "xla/tsl/protobuf/error_codes.pb.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
@@ -102,6 +104,35 @@ class TestAsyncEagerNode : public AsyncEagerNode {
   absl::Status run_return_status_;
 };
 
+// A node without ordering constraints. `Run()` signals `started` and then
+// blocks until `proceed` is notified, which lets tests observe overlap.
+class TestConcurrentEagerNode : public EagerNode {
+ public:
+  TestConcurrentEagerNode(absl::Notification* started,
+                          absl::Notification* proceed,
+                          absl::Status run_return_status = absl::OkStatus())
+      : started_(started),
+        proceed_(proceed),
+        run_return_status_(run_return_status) {}
+  TestConcurrentEagerNode(const TestConcurrentEagerNode&) = delete;
+  TestConcurrentEagerNode& operator=(const TestConcurrentEagerNode&) = delete;
+
+  absl::Status Run() override {
+    started_->Notify();
+    proceed_->WaitForNotification();
+    return run_return_status_;
+  }
+
+  void Abort(absl::Status status) override {}
+  bool CanRunConcurrently() const override { return true; }
+  std::string DebugString() const override { return "testConcurrentNode"; }
+
+ private:
+  absl::Notification* started_;
+  absl::Notification* proceed_;
+  absl::Status run_return_status_;
+};
+
 TEST(EagerExecutorTest, TestSyncExecutorWithEagerNode) {
   auto sync_executor = std::make_unique<EagerExecutor>(
       /*async=*/false, /*enable_streaming_enqueue=*/true);
@@ -280,5 +311,67 @@ TEST(EagerExecutorTest, TestAsyncExecutorAddNodesAfterShutdown) {
   EXPECT_THAT(async_executor->AddOrExecute(std::move(node)),
               absl_testing::StatusIs(tensorflow::error::FAILED_PRECONDITION));
 }
+
+TEST(EagerExecutorTest, TestParallelWorkersOverlapIndependentNodes) {
+  auto async_executor = std::make_unique<EagerExecutor>(
+      /*async=*/true, /*enable_streaming_enqueue=*/true,
+      /*in_flight_nodes_limit=*/0, /*num_parallel_workers=*/2);
+
+  // The first node only finishes once the second one has started, which can
+  // only happen if both are in flight at the same time.
+  absl::Notification first_started, second_started;
+  TF_ASSERT_OK(async_executor->AddOrExecute(
+      std::make_unique<TestConcurrentEagerNode>(&first_started,
+                                                &second_started)));
+  absl::Notification proceed;
+  proceed.Notify();
+  TF_ASSERT_OK(async_executor->AddOrExecute(
+      std::make_unique<TestConcurrentEagerNode>(&second_started, &proceed)));
+  TF_ASSERT_OK(async_executor->WaitForAllPendingNodes());
+  EXPECT_TRUE(first_started.HasBeenNotified());
+  EXPECT_TRUE(second_started.HasBeenNotified());
+}
+
+TEST(EagerExecutorTest, TestParallelWorkersOrderedNodeWaitsForInFlight) {
+  auto async_executor = std::make_unique<EagerExecutor>(
+      /*async=*/true, /*enable_streaming_enqueue=*/true,
+      /*in_flight_nodes_limit=*/0, /*num_parallel_workers=*/2);
+
+  absl::Notification started, proceed;
+  TF_ASSERT_OK(async_executor->AddOrExecute(
+      std::make_unique<TestConcurrentEagerNode>(&started, &proceed)));
+  auto state = std::make_unique<TestState>();
+  TF_ASSERT_OK(async_executor->AddOrExecute(
+      std::make_unique<TestEagerNode>(state.get())));
+
+  started.WaitForNotification();
+  // The ordered node must not start while the concurrent one is running.
+  Env::Default()->SleepForMicroseconds(10000);
+  EXPECT_EQ(state->read_state(), TestState::State::kNotRun);
+  proceed.Notify();
+  TF_ASSERT_OK(async_executor->WaitForAllPendingNodes());
+  EXPECT_EQ(state->read_state(), TestState::State::kSuccess);
+}
+
+TEST(EagerExecutorTest, TestParallelWorkersFailRun) {
+  auto async_executor = std::make_unique<EagerExecutor>(
+      /*async=*/true, /*enable_streaming_enqueue=*/true,
+      /*in_flight_nodes_limit=*/0, /*num_parallel_workers=*/2);
+
+  absl::Notification started, proceed;
+  proceed.Notify();
+  TF_ASSERT_OK(async_executor->AddOrExecute(
+      std::make_unique<TestConcurrentEagerNode>(&started, &proceed,
+                                                absl::InternalError("test"))));
+  auto status = async_executor->WaitForAllPendingNodes();
+  ASSERT_EQ(status.code(), tensorflow::error::INTERNAL);
+
+  // Later nodes are rejected until the error is cleared.
+  auto state = std::make_unique<TestState>();
+  EXPECT_FALSE(
+      async_executor->AddOrExecute(std::make_unique<TestEagerNode>(state.get()))
+          .ok());
+  EXPECT_EQ(state->read_state(), TestState::State::kNotRun);
+}
 }  // namespace
 }  // namespace tensorflow
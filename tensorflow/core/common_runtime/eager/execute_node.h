@@ -38,6 +38,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eager/execute.h"
 #include "tensorflow/core/common_runtime/eager/kernel_and_device.h"
 #include "tensorflow/core/common_runtime/eager/tensor_handle.h"
+#include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
@@ -230,6 +231,29 @@ class AsyncExecuteNode : public EagerNode {
     }
   }
 
+  bool CanRunConcurrently() const override {
+    // Only primitive, stateless, local ops that do not consume resources are
+    // free of ordering constraints beyond their data dependencies.
+    const OpKernel* op_kernel = kernel_->kernel();
+    if (op_kernel == nullptr || kernel_->IsCrossProcess()) return false;
+    for (DataType dtype : kernel_->input_dtypes()) {
+      if (dtype == DT_RESOURCE) return false;
+    }
+    const OpDef* op_def = nullptr;
+    if (!OpRegistry::Global()->LookUpOpDef(op_kernel->type_string(), &op_def)
+             .ok()) {
+      return false;
+    }
+    return !op_def->is_stateful();
+  }
+
+  bool InputsReady() const override {
+    for (const TensorHandle* h : inputs_) {
+      if (!h->IsReady()) return false;
+    }
+    return true;
+  }
+
   std::string DebugString() const override {
     std::string out = "[AsyncExecuteNode]";
     absl::StrAppend(&out, " kernel: ", kernel_->name());
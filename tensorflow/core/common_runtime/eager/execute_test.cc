@@ -21,8 +21,12 @@ limitations under the License.
 #include "tensorflow/core/framework/full_type.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 
 namespace tensorflow {
 namespace {
@@ -428,5 +432,128 @@ TEST(ExecuteTest, MultipleNestedCompiledFunction) {
   ctx->Unref();
 }
 
+// Runs `num_threads` threads that each issue `kOpsPerThread` eager `op_name`
+// ops on two identical inputs against a shared EagerContext. This exercises
+// the per-op dispatch path (fingerprinting, kernel cache lookup, EagerOperation
+// setup) that dominates small-op throughput.
+void BM_EagerExecuteSmallOps(::testing::benchmark::State& state,
+                             const char* op_name, const Tensor& input_tensor) {
+  constexpr int kOpsPerThread = 256;
+  const int num_threads = state.range(0);
+
+  StaticDeviceMgr device_mgr(
+      DeviceFactory::NewDevice("CPU", {}, "/job:localhost/replica:0/task:0"));
+  auto ctx = new EagerContext(
+      SessionOptions(),
+      tensorflow::ContextDevicePlacementPolicy::DEVICE_PLACEMENT_EXPLICIT,
+      false, &device_mgr, false, nullptr, nullptr);
+  auto input = core::RefCountPtr<ImmediateExecutionTensorHandle>(
+      ctx->CreateLocalHandleFromTFTensor(input_tensor,
+                                         ctx->HostCPUName().c_str()));
+
+  auto run_ops = [&]() {
+    auto op = std::make_unique<EagerOperation>(ctx);
+    for (int i = 0; i < kOpsPerThread; ++i) {
+      TF_CHECK_OK(op->Reset(
+          op_name,
+          /*raw_device_name=*/"/job:localhost/replica:0/task:0/device:CPU:0"));
+      TF_CHECK_OK(op->AddInput(input.get()));
+      TF_CHECK_OK(op->AddInput(input.get()));
+      TensorHandle* retval = nullptr;
+      int num_retvals = 1;
+      TF_CHECK_OK(EagerExecute(op.get(), &retval, &num_retvals));
+      retval->Unref();
+    }
+  };
+
+  thread::ThreadPool pool(Env::Default(), "eager_bm", num_threads);
+  for (auto s : state) {
+    BlockingCounter counter(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      pool.Schedule([&]() {
+        run_ops();
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_threads * kOpsPerThread);
+
+  input.reset();
+  ctx->Unref();
+}
+
+void BM_EagerExecuteScalarAdd(::testing::benchmark::State& state) {
+  BM_EagerExecuteSmallOps(state, "AddV2", test::AsScalar<float>(1.0f));
+}
+BENCHMARK(BM_EagerExecuteScalarAdd)->UseRealTime()->Arg(1)->Arg(4)->Arg(16);
+
+void BM_EagerExecuteSmallMatMul(::testing::benchmark::State& state) {
+  BM_EagerExecuteSmallOps(state, "MatMul",
+                          test::AsTensor<float>({1, 2, 3, 4}, {2, 2}));
+}
+BENCHMARK(BM_EagerExecuteSmallMatMul)->UseRealTime()->Arg(1)->Arg(4)->Arg(16);
+
+
+// Enqueues `width` independent MatMuls on an async executor and waits for
+// them, comparing the in-order async executor (0 workers) against dispatching
+// independent nodes to `num_parallel_workers` threads.
+void BM_EagerAsyncWideProgram(::testing::benchmark::State& state) {
+  const int num_parallel_workers = state.range(0);
+  const int width = state.range(1);
+  constexpr int kDim = 128;
+
+  StaticDeviceMgr device_mgr(
+      DeviceFactory::NewDevice("CPU", {}, "/job:localhost/replica:0/task:0"));
+  auto ctx = new EagerContext(
+      SessionOptions(),
+      tensorflow::ContextDevicePlacementPolicy::DEVICE_PLACEMENT_EXPLICIT,
+      /*async=*/true, &device_mgr, false, nullptr, nullptr);
+  auto executor = std::make_unique<EagerExecutor>(
+      /*async=*/true, /*enable_streaming_enqueue=*/true,
+      /*in_flight_nodes_limit=*/0, num_parallel_workers);
+  ctx->SetExecutorForThread(executor.get());
+
+  Tensor input_tensor(DT_FLOAT, TensorShape({kDim, kDim}));
+  input_tensor.flat<float>().setConstant(1.0f);
+  auto input = core::RefCountPtr<ImmediateExecutionTensorHandle>(
+      ctx->CreateLocalHandleFromTFTensor(input_tensor,
+                                         ctx->HostCPUName().c_str()));
+
+  std::vector<TensorHandle*> retvals(width);
+  auto op = std::make_unique<EagerOperation>(ctx);
+  for (auto s : state) {
+    for (int i = 0; i < width; ++i) {
+      TF_CHECK_OK(op->Reset(
+          "MatMul",
+          /*raw_device_name=*/"/job:localhost/replica:0/task:0/device:CPU:0"));
+      TF_CHECK_OK(op->AddInput(input.get()));
+      TF_CHECK_OK(op->AddInput(input.get()));
+      int num_retvals = 1;
+      TF_CHECK_OK(EagerExecute(op.get(), &retvals[i], &num_retvals));
+    }
+    TF_CHECK_OK(executor->WaitForAllPendingNodes());
+    for (TensorHandle* retval : retvals) {
+      retval->Unref();
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * width);
+
+  op.reset();
+  input.reset();
+  TF_CHECK_OK(executor->ShutDown());
+  // Destroying the executor unregisters it from the context.
+  executor.reset();
+  ctx->Unref();
+}
+BENCHMARK(BM_EagerAsyncWideProgram)
+    ->UseRealTime()
+    ->ArgPair(0, 16)
+    ->ArgPair(4, 16)
+    ->ArgPair(0, 128)
+    ->ArgPair(4, 128)
+    ->ArgPair(16, 128);
+
 }  // namespace
 }  // namespace tensorflow
@@ -127,6 +127,12 @@ class TensorHandle : public ImmediateExecutionTensorHandle {
   // defined.
   void Release();
 
+  // The TensorHandleData can either represent a local or remote tensor handle.
+  // Further, it can be in a non-ready state. It would become ready with a call
+  // to either SetTensor or SetRemoteShape which replaces the underlying data
+  // with a ready version of the tensor handle data.
+  bool IsReady() const;
+
   tensorflow::DataType DataType() const override;
   absl::Status Shape(tensorflow::PartialTensorShape* shape) const override;
   absl::Status NumDims(int* num_dims) const override;
@@ -293,11 +299,6 @@ class TensorHandle : public ImmediateExecutionTensorHandle {
 
   ~TensorHandle() override;
 
-  // The TensorHandleData can either represent a local or remote tensor handle.
-  // Further, it can be in a non-ready state. It would become ready with a call
-  // to either SetTensor or SetRemoteShape which replaces the underlying data
-  // with a ready version of the tensor handle data.
-  bool IsReady() const;
   absl::Status WaitReady(const char* caller) const;
 
   tensorflow::Device* device_;
@@ -54,6 +54,7 @@ limitations under the License.
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/public/version.h"
 
@@ -112,7 +113,8 @@ class GraphConstructor {
           importing(false),
           validate_nodes(in.validate_nodes),
           validate_colocation_constraints(false),
-          add_default_attributes(in.add_default_attributes) {}
+          add_default_attributes(in.add_default_attributes),
+          thread_pool(in.thread_pool) {}
     Options(const ImportGraphDefOptions& in)  // NOLINT(runtime/explicit)
         : allow_internal_ops(false),
           expect_device_spec(false),
@@ -167,6 +169,10 @@ class GraphConstructor {
     bool add_default_attributes = true;
 
     std::string default_device;
+
+    // If non-null, node preparation that does not depend on other nodes is
+    // sharded across this pool. Only used when `importing` is false.
+    thread::ThreadPool* thread_pool = nullptr;
   };
 
   typedef absl::Span<const NodeDef* const> NodeDefSlice;
@@ -228,6 +234,11 @@ class GraphConstructor {
   absl::Status BuildNodeIndex();
   absl::Status InitFromEdges();
   absl::Status Convert();
+  // Looks up the OpDef of `node_def`, adds missing default attributes and
+  // validates it, as requested by `opts_`.
+  absl::Status PrepareNodeDef(NodeDef* node_def) const;
+  // Runs PrepareNodeDef() on every node, sharded across `opts_.thread_pool`.
+  absl::Status PrepareNodeDefsInParallel();
   absl::Status AddBackEdges();
   absl::Status UpdateVersionDef();
   absl::Status PopulateReturnTensors();
@@ -306,6 +317,9 @@ class GraphConstructor {
   // possible. After calling this method, the result of get_node_def(i) is
   // undefined.
   virtual NodeDef consume_node_def(int i) = 0;
+  // Returns a mutable version of the i^th node, which is returned by a later
+  // consume_node_def(i). May be called concurrently for distinct values of i.
+  virtual NodeDef* mutable_node_def(int i) = 0;
   // Returns the version information for the graph, or nullptr if none is
   // available.
   virtual const VersionDef* versions() const = 0;
@@ -327,6 +341,9 @@ class GraphConstructor {
 
   ShapeRefiner* refiner_;
 
+  // True if PrepareNodeDefsInParallel() has already prepared every node.
+  bool node_defs_prepared_ = false;
+
   // May be null. Not owned.
   std::vector<std::pair<Node*, int>>* return_tensors_;
 
@@ -435,12 +452,24 @@ class NodeDefCopyingGraphConstructor : public GraphConstructor {
         node_defs_(node_defs),
         versions_(versions),
         library_(library),
-        debug_info_(debug_info) {}
+        debug_info_(debug_info) {
+    if (opts.thread_pool != nullptr && !opts.importing) {
+      prepared_node_defs_.resize(node_defs_.size());
+    }
+  }
 
  private:
   size_t node_def_count() const override { return node_defs_.size(); }
   const NodeDef& get_node_def(int i) const override { return *node_defs_[i]; }
-  NodeDef consume_node_def(int i) override { return *node_defs_[i]; }
+  NodeDef consume_node_def(int i) override {
+    if (prepared_node_defs_.empty()) return *node_defs_[i];
+    return std::move(prepared_node_defs_[i]);
+  }
+  NodeDef* mutable_node_def(int i) override {
+    DCHECK(!prepared_node_defs_.empty());
+    prepared_node_defs_[i] = *node_defs_[i];
+    return &prepared_node_defs_[i];
+  }
   const VersionDef* versions() const override { return versions_; }
   std::optional<FunctionDefLibrary> consume_library() override {
     if (library_ == nullptr) {
@@ -455,6 +484,8 @@ class NodeDefCopyingGraphConstructor : public GraphConstructor {
   const VersionDef* const versions_;
   const FunctionDefLibrary* const library_;
   const GraphDebugInfo* const debug_info_;
+  // Copies of `node_defs_` made in parallel when `opts.thread_pool` is set.
+  std::vector<NodeDef> prepared_node_defs_;
 };
 
 // Implementation of GraphConstructor that takes ownership of the input
@@ -483,6 +514,10 @@ class NodeDefMovingGraphConstructor : public GraphConstructor {
     is_consumed_[i] = true;
     return std::move(*graph_def_.mutable_node(i));
   }
+  NodeDef* mutable_node_def(int i) override {
+    DCHECK(!is_consumed_[i]);
+    return graph_def_.mutable_node(i);
+  }
   const VersionDef* versions() const override { return &graph_def_.versions(); }
   std::optional<FunctionDefLibrary> consume_library() override {
     return std::move(*graph_def_.mutable_library());
@@ -1170,6 +1205,46 @@ GraphConstructor::CreateStackTracesForFunctionDefLibrary(
   }
 }
 
+absl::Status GraphConstructor::PrepareNodeDef(NodeDef* node_def) const {
+  const OpDef* op_def;
+  TF_RETURN_IF_ERROR(g_->op_registry()->LookUpOpDef(node_def->op(), &op_def));
+  if (opts_.add_default_attributes) {
+    AddDefaultsToNodeDef(*op_def, node_def);
+  }
+  if (opts_.validate_nodes) {
+    TF_RETURN_IF_ERROR(ValidateNodeDef(*node_def, *op_def));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status GraphConstructor::PrepareNodeDefsInParallel() {
+  const int64_t num_nodes = node_def_count();
+  // Report the failure of the lowest-numbered node, so that the returned
+  // error does not depend on how the nodes were sharded.
+  mutex mu;
+  int64_t first_error_node = num_nodes;
+  absl::Status first_error;
+  auto prepare_shard = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      absl::Status s = PrepareNodeDef(mutable_node_def(i));
+      if (!s.ok()) {
+        mutex_lock l(mu);
+        if (i < first_error_node) {
+          first_error_node = i;
+          first_error = std::move(s);
+        }
+        return;
+      }
+    }
+  };
+  // Rough cost in cycles of copying, looking up and validating one NodeDef.
+  static constexpr int64_t kCostPerNode = 10000;
+  opts_.thread_pool->ParallelFor(num_nodes, kCostPerNode, prepare_shard);
+  TF_RETURN_IF_ERROR(first_error);
+  node_defs_prepared_ = true;
+  return absl::OkStatus();
+}
+
 absl::Status GraphConstructor::Convert() {
   if (debug_info() != nullptr) {
     traces_ = LoadTracesFromDebugInfo(*debug_info());
@@ -1194,6 +1269,12 @@ absl::Status GraphConstructor::Convert() {
         g_->AddFunctionLibrary(*std::move(library), library_traces));
   }
 
+  // Nodes may refer to the functions added above, so their OpDefs can only be
+  // looked up from here on.
+  if (!opts_.importing && opts_.thread_pool != nullptr) {
+    TF_RETURN_IF_ERROR(PrepareNodeDefsInParallel());
+  }
+
   std::vector<InputInfo> inputs;
   int processed = 0;
 
@@ -1306,16 +1387,8 @@ absl::Status GraphConstructor::Convert() {
 
     if (opts_.importing) {
       TF_RETURN_IF_ERROR(ModifyNodeDefForImport(&node_def));
-    } else {
-      const OpDef* op_def;
-      TF_RETURN_IF_ERROR(
-          g_->op_registry()->LookUpOpDef(node_def.op(), &op_def));
-      if (opts_.add_default_attributes) {
-        AddDefaultsToNodeDef(*op_def, &node_def);
-      }
-      if (opts_.validate_nodes) {
-        TF_RETURN_IF_ERROR(ValidateNodeDef(node_def, *op_def));
-      }
+    } else if (!node_defs_prepared_) {
+      TF_RETURN_IF_ERROR(PrepareNodeDef(&node_def));
     }
 
     TF_RETURN_IF_ERROR(MakeNode(std::move(node_def), &node));
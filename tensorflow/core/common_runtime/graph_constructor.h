@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/tensor_id.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 class ShapeRefiner;
@@ -57,6 +58,12 @@ struct GraphConstructorOptions {
   // If true, upgrade legacy features of the graph (for instance, functionalize
   // control-flow).
   bool upgrade_legacy = false;
+
+  // If non-null, the per-node OpDef lookup, default attribute insertion and
+  // validation are sharded across this pool before the nodes are added to
+  // the graph. Useful for graphs with hundreds of thousands of nodes. Not
+  // owned.
+  thread::ThreadPool* thread_pool = nullptr;
 };
 extern absl::Status ConvertGraphDefToGraph(const GraphConstructorOptions& opts,
                                            const GraphDef& gdef, Graph* g);
@@ -36,8 +36,10 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/public/release_version.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/version.h"
@@ -3606,5 +3608,61 @@ node{ name:'A' op:'TestDefaultAttr'}
   EXPECT_EQ(graph.op_nodes().begin()->attrs().Find("default_int")->i(), 31415);
 }
 
+TEST_F(GraphConstructorTest, ConvertGraphDefToGraphWithThreadPool) {
+  GraphDef graph_def;
+  for (int i = 0; i < 1000; ++i) {
+    NodeDef* w = graph_def.add_node();
+    w->set_name(absl::StrCat("W", i));
+    w->set_op("TestParams");
+    NodeDef* a = graph_def.add_node();
+    a->set_name(absl::StrCat("A", i));
+    a->set_op("TestDefaultAttr");
+    a->add_input(absl::StrCat("^W", i));
+  }
+  thread::ThreadPool pool(Env::Default(), "test", 4);
+  GraphConstructorOptions opts;
+  opts.validate_nodes = true;
+
+  Graph expected(OpRegistry::Global());
+  TF_ASSERT_OK(ConvertGraphDefToGraph(opts, graph_def, &expected));
+  GraphDef expected_def;
+  expected.ToGraphDef(&expected_def);
+
+  opts.thread_pool = &pool;
+  Graph copied(OpRegistry::Global());
+  TF_ASSERT_OK(ConvertGraphDefToGraph(opts, graph_def, &copied));
+  GraphDef copied_def;
+  copied.ToGraphDef(&copied_def);
+  EXPECT_EQ(expected_def.DebugString(), copied_def.DebugString());
+
+  Graph moved(OpRegistry::Global());
+  TF_ASSERT_OK(ConvertGraphDefToGraph(opts, GraphDef(graph_def), &moved));
+  GraphDef moved_def;
+  moved.ToGraphDef(&moved_def);
+  EXPECT_EQ(expected_def.DebugString(), moved_def.DebugString());
+  for (const Node* node : moved.op_nodes()) {
+    if (node->type_string() != "TestDefaultAttr") continue;
+    EXPECT_EQ(node->attrs().Find("default_int")->i(), 31415);
+  }
+}
+
+TEST_F(GraphConstructorTest, ConvertGraphDefToGraphWithThreadPoolErrors) {
+  GraphDef graph_def;
+  for (int i = 0; i < 1000; ++i) {
+    NodeDef* node = graph_def.add_node();
+    node->set_name(absl::StrCat("N", i));
+    node->set_op(i == 700 || i == 900 ? "NotARegisteredOp" : "TestParams");
+  }
+  thread::ThreadPool pool(Env::Default(), "test", 4);
+  GraphConstructorOptions opts;
+  opts.thread_pool = &pool;
+  Graph graph(OpRegistry::Global());
+  absl::Status s = ConvertGraphDefToGraph(opts, graph_def, &graph);
+  EXPECT_FALSE(s.ok());
+  EXPECT_TRUE(absl::StrContains(s.message(), "NotARegisteredOp")) << s;
+  // No nodes are added to the graph when a node fails validation.
+  EXPECT_EQ(graph.num_op_nodes(), 0);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -76,6 +76,7 @@ GraphExecutionState::GraphExecutionState(
     std::unique_ptr<FunctionLibraryDefinition>&& flib_def,
     const GraphExecutionStateOptions& options)
     : stateful_placements_(options.stateful_placements),
+      cached_placements_(options.cached_placements),
       original_graph_def_(std::move(graph_def)),
       device_set_(options.device_set),
       session_options_(options.session_options),
@@ -267,6 +268,16 @@ absl::Status GraphExecutionState::Extend(
   combined_options.session_options = session_options_;
   combined_options.session_handle = session_handle_;
   combined_options.stateful_placements = stateful_placements_;
+  if (graph_ != nullptr && run_placer_) {
+    // Carry over the placement of the existing nodes, so that the Placer only
+    // has to assign devices to the nodes in `extension_def`.
+    for (const Node* n : graph_->op_nodes()) {
+      if (n->has_assigned_device_name()) {
+        combined_options.cached_placements.emplace(n->name(),
+                                                   n->assigned_device_name());
+      }
+    }
+  }
 
   TF_RETURN_IF_ERROR(AddDefaultAttrsToGraphDef(&gdef, *flib_def_, 0));
   auto flib_def = std::make_unique<FunctionLibraryDefinition>(
@@ -311,6 +322,50 @@ void GraphExecutionState::RestoreStatefulNodes(Graph* graph) {
   }
 }
 
+std::vector<Node*> GraphExecutionState::RestoreCachedPlacements(Graph* graph) {
+  std::vector<Node*> restored;
+  if (cached_placements_.empty()) return restored;
+  restored.reserve(cached_placements_.size());
+  for (Node* n : graph->op_nodes()) {
+    if (n->has_assigned_device_name()) continue;
+    auto iter = cached_placements_.find(n->name());
+    if (iter != cached_placements_.end()) {
+      n->set_assigned_device_name(iter->second);
+      restored.push_back(n);
+    }
+  }
+  VLOG(1) << "Reusing the placement of " << restored.size() << " of "
+          << graph->num_op_nodes() << " nodes";
+  return restored;
+}
+
+absl::Status GraphExecutionState::PlaceGraph(Graph* graph) {
+  auto run_placer = [this, graph]() {
+    Placer placer(graph, "", flib_def_.get(), device_set_,
+                  /* default_local_device= */ nullptr,
+                  session_options_ == nullptr ||
+                      session_options_->config.allow_soft_placement(),
+                  session_options_ != nullptr &&
+                      session_options_->config.log_device_placement());
+    // TODO(mrry): Consider making the Placer cancellable.
+    return placer.Run();
+  };
+
+  std::vector<Node*> restored = RestoreCachedPlacements(graph);
+  cached_placements_.clear();
+  absl::Status s = run_placer();
+  if (s.ok() || restored.empty()) return s;
+
+  // The new nodes may impose constraints (e.g. colocation) that conflict with
+  // the previous placement. Fall back to placing every node from scratch.
+  VLOG(1) << "Placement with cached placements failed, placing the whole "
+          << "graph: " << s;
+  for (Node* n : restored) {
+    n->set_assigned_device_name("");
+  }
+  return run_placer();
+}
+
 namespace {
 
 class TensorConnectionPruneRewrite : public subgraph::PruneRewrite {
@@ -632,14 +687,7 @@ absl::Status GraphExecutionState::InitBaseGraph(
       OptimizationPassRegistry::PRE_PLACEMENT, optimization_options));
 
   if (run_placer_) {
-    Placer placer(new_graph.get(), "", flib_def_.get(), device_set_,
-                  /* default_local_device= */ nullptr,
-                  session_options_ == nullptr ||
-                      session_options_->config.allow_soft_placement(),
-                  session_options_ != nullptr &&
-                      session_options_->config.log_device_placement());
-    // TODO(mrry): Consider making the Placer cancellable.
-    TF_RETURN_IF_ERROR(placer.Run());
+    TF_RETURN_IF_ERROR(PlaceGraph(new_graph.get()));
   }
 
   TF_RETURN_IF_ERROR(OptimizationPassRegistry::Global()->RunGrouping(
@@ -799,8 +847,31 @@ absl::Status GraphExecutionState::OptimizeGraph(
       }
     }
 
-    // Convert Graph to GraphDef and add it to the GrapplerItem.
-    graph.ToGraphDef(&item.graph);
+    // Convert Graph to GraphDef and add it to the GrapplerItem. Only the nodes
+    // that the fetches, targets and feeds transitively depend on can end up in
+    // the client graph, so the rest of a (possibly very large) session graph
+    // is neither serialized nor optimized for every new signature.
+    absl::flat_hash_set<absl::string_view> endpoint_names;
+    for (const std::string& fetch : item.fetch) {
+      endpoint_names.insert(ParseTensorName(fetch).node());
+    }
+    for (const std::string& feed : options.callable_options.feed()) {
+      endpoint_names.insert(ParseTensorName(feed).node());
+    }
+    for (const TensorConnection& tensor_connection :
+         options.callable_options.tensor_connection()) {
+      endpoint_names.insert(
+          ParseTensorName(tensor_connection.to_tensor()).node());
+    }
+    std::vector<const Node*> endpoints;
+    for (const Node* node : graph.op_nodes()) {
+      if (endpoint_names.contains(node->name())) endpoints.push_back(node);
+    }
+    std::vector<bool> reachable(graph.num_node_ids(), false);
+    ReverseDFSFrom(
+        graph, endpoints,
+        [&reachable](const Node* n) { reachable[n->id()] = true; }, nullptr);
+    graph.ToGraphDefForNodes(&item.graph, reachable);
     // TODO(b/114748242): Add a unit test to test this bug fix.
     if (flib_def) {
       *item.graph.mutable_library() = flib_def->ToProto();
@@ -47,6 +47,12 @@ struct GraphExecutionStateOptions {
   // A map from node name to device name, representing the unchangeable
   // placement of stateful nodes.
   std::unordered_map<std::string, std::string> stateful_placements;
+  // A map from node name to device name for nodes that were placed by a
+  // previous GraphExecutionState (see GraphExecutionState::Extend()). Unlike
+  // `stateful_placements` these are only hints that let the Placer skip
+  // already-placed nodes: if placement fails with them applied, the graph is
+  // placed from scratch.
+  std::unordered_map<std::string, std::string> cached_placements;
   // Whether to run Placer on the graph.
   bool run_placer = true;
 
@@ -132,8 +138,9 @@ class GraphExecutionState {
   // used.
   //
   // NOTE(mrry): This method respects the placement of stateful nodes in
-  // in *this, but currently does not transfer any other placement
-  // or cost model information to the new graph.
+  // in *this. The placement of the remaining nodes in *this is reused as a
+  // starting point, so that only the nodes in "extension_def" need to be
+  // placed. Cost model information is not transferred to the new graph.
   //
   // Note that using this interface requires setting the value of
   // config.experimental().disable_optimize_for_static_graph() in the state
@@ -200,6 +207,17 @@ class GraphExecutionState {
   void SaveStatefulNodes(Graph* graph);
   void RestoreStatefulNodes(Graph* graph);
 
+  // Assigns the devices in `cached_placements_` to the unassigned nodes of
+  // `graph` and returns the nodes that were assigned.
+  std::vector<Node*> RestoreCachedPlacements(Graph* graph);
+
+  // Runs the Placer on `graph`, reusing `cached_placements_` if possible.
+  absl::Status PlaceGraph(Graph* graph);
+
+  // Placements inherited from the GraphExecutionState that was extended to
+  // create this one. Cleared once the base graph has been placed.
+  std::unordered_map<std::string, std::string> cached_placements_;
+
   // Extract the subset of the graph that needs to be run, adding feed/fetch
   // ops as needed.
   absl::Status PruneGraph(const BuildGraphOptions& options, Graph* graph,
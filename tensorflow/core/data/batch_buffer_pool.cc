@@ -0,0 +1,108 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/batch_buffer_pool.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace data {
+
+BatchBufferPool::BatchBufferPool(Allocator* allocator, size_t max_free_bytes)
+    : allocator_(allocator), max_free_bytes_(max_free_bytes) {}
+
+BatchBufferPool::~BatchBufferPool() { Close(); }
+
+void BatchBufferPool::Close() {
+  absl::flat_hash_map<BufferKey, std::vector<void*>> free_buffers;
+  {
+    mutex_lock l(mu_);
+    closed_ = true;
+    free_bytes_ = 0;
+    free_buffers.swap(free_buffers_);
+  }
+  for (const auto& [key, buffers] : free_buffers) {
+    for (void* buffer : buffers) {
+      allocator_->DeallocateRaw(buffer);
+    }
+  }
+}
+
+std::string BatchBufferPool::Name() {
+  return absl::StrCat("tf_data_batch_buffers_", allocator_->Name());
+}
+
+void* BatchBufferPool::AllocateRaw(size_t alignment, size_t num_bytes) {
+  const BufferKey key(num_bytes, alignment);
+  void* buffer = nullptr;
+  {
+    mutex_lock l(mu_);
+    auto it = free_buffers_.find(key);
+    if (it != free_buffers_.end() && !it->second.empty()) {
+      buffer = it->second.back();
+      it->second.pop_back();
+      free_bytes_ -= num_bytes;
+      buffers_in_use_[buffer] = key;
+    }
+  }
+  if (buffer == nullptr) {
+    buffer = allocator_->AllocateRaw(alignment, num_bytes);
+    if (buffer == nullptr) return nullptr;
+    mutex_lock l(mu_);
+    buffers_in_use_[buffer] = key;
+  }
+  Ref();
+  return buffer;
+}
+
+void BatchBufferPool::DeallocateRaw(void* ptr) {
+  bool pooled = false;
+  {
+    mutex_lock l(mu_);
+    auto it = buffers_in_use_.find(ptr);
+    DCHECK(it != buffers_in_use_.end());
+    const BufferKey key = it->second;
+    buffers_in_use_.erase(it);
+    if (!closed_ && free_bytes_ + key.first <= max_free_bytes_) {
+      free_buffers_[key].push_back(ptr);
+      free_bytes_ += key.first;
+      pooled = true;
+    }
+  }
+  if (!pooled) {
+    allocator_->DeallocateRaw(ptr);
+  }
+  // The buffer no longer needs the pool, which may be destroyed here.
+  Unref();
+}
+
+AllocatorMemoryType BatchBufferPool::GetMemoryType() const {
+  return allocator_->GetMemoryType();
+}
+
+size_t BatchBufferPool::free_bytes() const {
+  mutex_lock l(mu_);
+  return free_bytes_;
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,80 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_BATCH_BUFFER_POOL_H_
+#define TENSORFLOW_CORE_DATA_BATCH_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// An allocator which serves batch buffers from a pool of buffers previously
+// allocated through `allocator`. A buffer returns to the pool when the last
+// tensor referencing it is destroyed, e.g. after the consumer of
+// `IteratorGetNext` copied it to the device, so steady-state batching does not
+// allocate. Free buffers beyond `max_free_bytes` are returned to `allocator`.
+//
+// If `allocator` serves pinned host memory, e.g. the GPU-compatible host
+// allocator, the buffers can be copied to the device without staging.
+//
+// Each buffer in use holds a reference to the pool, so that batches may outlive
+// the iterator which owns the pool. The owner calls `Close` when it is
+// destroyed.
+class BatchBufferPool : public Allocator, public core::RefCounted {
+ public:
+  BatchBufferPool(Allocator* allocator, size_t max_free_bytes);
+
+  // Returns the free buffers to the underlying allocator. Buffers in use are
+  // returned to it when they are freed.
+  void Close();
+
+  std::string Name() override;
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+  AllocatorMemoryType GetMemoryType() const override;
+
+  // Returns the number of bytes held by free buffers.
+  size_t free_bytes() const;
+
+ private:
+  // Buffers are reused for allocations with the same size and alignment.
+  using BufferKey = std::pair<size_t, size_t>;
+
+  ~BatchBufferPool() override;
+
+  Allocator* const allocator_;  // Not owned.
+  const size_t max_free_bytes_;
+
+  mutable mutex mu_;
+  bool closed_ TF_GUARDED_BY(mu_) = false;
+  size_t free_bytes_ TF_GUARDED_BY(mu_) = 0;
+  absl::flat_hash_map<BufferKey, std::vector<void*>> free_buffers_
+      TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<void*, BufferKey> buffers_in_use_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_BATCH_BUFFER_POOL_H_
@@ -0,0 +1,167 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/batch_buffer_pool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/util/batch_util.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// An allocator which counts the allocations and deallocations it forwards to
+// the CPU allocator.
+class CountingAllocator : public Allocator {
+ public:
+  std::string Name() override { return "counting"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_allocations_;
+    return cpu_allocator()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    ++num_deallocations_;
+    cpu_allocator()->DeallocateRaw(ptr);
+  }
+  AllocatorMemoryType GetMemoryType() const override {
+    return AllocatorMemoryType::kHostPinned;
+  }
+
+  int64_t num_allocations() const { return num_allocations_; }
+  int64_t num_deallocations() const { return num_deallocations_; }
+
+ private:
+  std::atomic<int64_t> num_allocations_ = 0;
+  std::atomic<int64_t> num_deallocations_ = 0;
+};
+
+// Pools hold on to the allocators they are created for, so these never die.
+CountingAllocator* NewCountingAllocator() { return new CountingAllocator; }
+
+TEST(BatchBufferPoolTest, ReusesReleasedBuffers) {
+  CountingAllocator* allocator = NewCountingAllocator();
+  core::RefCountPtr<BatchBufferPool> pool(
+      new BatchBufferPool(allocator, /*max_free_bytes=*/1 << 20));
+  for (int i = 0; i < 10; ++i) {
+    Tensor batch(pool.get(), DT_FLOAT, TensorShape({32, 1024}));
+    ASSERT_TRUE(batch.IsInitialized());
+  }
+  EXPECT_EQ(allocator->num_allocations(), 1);
+  EXPECT_EQ(pool->free_bytes(), 32 * 1024 * sizeof(float));
+}
+
+TEST(BatchBufferPoolTest, KeepsBuffersWhileReferenced) {
+  CountingAllocator* allocator = NewCountingAllocator();
+  core::RefCountPtr<BatchBufferPool> pool(
+      new BatchBufferPool(allocator, /*max_free_bytes=*/1 << 20));
+  Tensor first(pool.get(), DT_FLOAT, TensorShape({32, 1024}));
+  Tensor shared = first;
+  Tensor second(pool.get(), DT_FLOAT, TensorShape({32, 1024}));
+  EXPECT_FALSE(second.SharesBufferWith(shared));
+  EXPECT_EQ(allocator->num_allocations(), 2);
+}
+
+TEST(BatchBufferPoolTest, BoundsFreeBytes) {
+  CountingAllocator* allocator = NewCountingAllocator();
+  const size_t batch_bytes = 32 * 1024 * sizeof(float);
+  core::RefCountPtr<BatchBufferPool> pool(
+      new BatchBufferPool(allocator, /*max_free_bytes=*/batch_bytes));
+  {
+    Tensor first(pool.get(), DT_FLOAT, TensorShape({32, 1024}));
+    Tensor second(pool.get(), DT_FLOAT, TensorShape({32, 1024}));
+    EXPECT_EQ(allocator->num_allocations(), 2);
+    EXPECT_EQ(allocator->num_deallocations(), 0);
+  }
+  EXPECT_EQ(pool->free_bytes(), batch_bytes);
+  EXPECT_EQ(allocator->num_deallocations(), 1);
+}
+
+TEST(BatchBufferPoolTest, ReleasesFreeBuffersOnClose) {
+  CountingAllocator* allocator = NewCountingAllocator();
+  core::RefCountPtr<BatchBufferPool> pool(
+      new BatchBufferPool(allocator, /*max_free_bytes=*/1 << 20));
+  { Tensor batch(pool.get(), DT_FLOAT, TensorShape({32, 1024})); }
+  pool->Close();
+  EXPECT_EQ(pool->free_bytes(), 0);
+  EXPECT_EQ(allocator->num_deallocations(), 1);
+}
+
+TEST(BatchBufferPoolTest, BatchesOutliveOwner) {
+  CountingAllocator* allocator = NewCountingAllocator();
+  BatchBufferPool* pool =
+      new BatchBufferPool(allocator, /*max_free_bytes=*/1 << 20);
+  Tensor batch(pool, DT_FLOAT, TensorShape({32, 1024}));
+  pool->Close();
+  pool->Unref();
+  EXPECT_EQ(allocator->num_deallocations(), 0);
+  batch = Tensor();
+  EXPECT_EQ(allocator->num_deallocations(), 1);
+}
+
+TEST(BatchBufferPoolTest, ForwardsMemoryType) {
+  core::RefCountPtr<BatchBufferPool> pool(
+      new BatchBufferPool(NewCountingAllocator(), /*max_free_bytes=*/0));
+  EXPECT_EQ(pool->GetMemoryType(), AllocatorMemoryType::kHostPinned);
+}
+
+// Args: whether to use the pool, batch size. Each step batches `batch_size`
+// elements of 1024 floats and releases the batch, like a consumer of
+// `IteratorGetNext` which copied it to the device.
+void BM_Batch(::testing::benchmark::State& state) {
+  const bool use_pool = state.range(0);
+  const int64_t batch_size = state.range(1);
+  CountingAllocator* allocator = NewCountingAllocator();
+  core::RefCountPtr<BatchBufferPool> pool(
+      new BatchBufferPool(allocator, /*max_free_bytes=*/size_t{1} << 30));
+  Allocator* batch_allocator = use_pool ? pool.get() : allocator;
+  std::vector<Tensor> elements;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    elements.emplace_back(DT_FLOAT, TensorShape({1024}));
+    elements.back().flat<float>().setConstant(i);
+  }
+
+  int64_t bytes_copied = 0;
+  for (auto s : state) {
+    Tensor batch(batch_allocator, DT_FLOAT, TensorShape({batch_size, 1024}));
+    for (int64_t i = 0; i < batch_size; ++i) {
+      TF_CHECK_OK(batch_util::CopyElementToSlice(elements[i], &batch, i));
+      bytes_copied += elements[i].TotalBytes();
+    }
+  }
+  state.SetBytesProcessed(bytes_copied);
+  state.counters["allocations_per_step"] =
+      static_cast<double>(allocator->num_allocations()) / state.iterations();
+}
+
+BENCHMARK(BM_Batch)
+    ->Args({0, 32})
+    ->Args({1, 32})
+    ->Args({0, 256})
+    ->Args({1, 256});
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -26,6 +26,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -35,15 +36,19 @@ limitations under the License.
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "tensorflow/core/common_runtime/function.h"
+#include "tensorflow/core/common_runtime/function_body.h"
+#include "tensorflow/core/common_runtime/function_def_utils.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/stats_utils.h"
+#include "tensorflow/core/data/vectorization_utils.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/function_handle_cache.h"
+#include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/op_def.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/stats_aggregator.h"
@@ -463,6 +468,18 @@ absl::Status FunctionMetadata::Create(
   const FunctionDef* fdef;
   TF_RETURN_IF_ERROR(LookupFunction(*(*out_metadata)->lib_def(),
                                     (*out_metadata)->func().name(), &fdef));
+  // Only instantiate the function body if the function may be elementwise.
+  if (absl::c_all_of(fdef->node_def(), [](const NodeDef& node) {
+        return node.op() == "Const" || IsElementwiseOp(node.op());
+      })) {
+    std::unique_ptr<FunctionBody> fbody;
+    if (FunctionDefToBodyHelper(*fdef,
+                                AttrSlice(&(*out_metadata)->func_.attr()),
+                                (*out_metadata)->lib_def(), &fbody)
+            .ok()) {
+      (*out_metadata)->elementwise_info_ = AnalyzeElementwiseFunction(*fbody);
+    }
+  }
 
   auto attr = fdef->attr().find(FunctionLibraryDefinition::kIntsOnDeviceAttr);
   if (attr != fdef->attr().end() && attr->second.b()) {
@@ -706,6 +723,13 @@ absl::Status CapturedFunction::CheckExternalState() const {
   return absl::OkStatus();
 }
 
+bool CapturedFunction::CanRunBatched(int num_element_components) const {
+  const std::optional<ElementwiseFunctionInfo>& info =
+      metadata_->elementwise_info();
+  return info.has_value() &&
+         data::CanRunBatched(*info, num_element_components, captured_inputs_);
+}
+
 CapturedFunction::CapturedFunction(
     std::shared_ptr<const FunctionMetadata> metadata,
     std::vector<Tensor> captured_inputs)
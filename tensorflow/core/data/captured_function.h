@@ -18,12 +18,14 @@ limitations under the License.
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "tensorflow/core/data/vectorization_utils.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -113,6 +115,12 @@ class FunctionMetadata {
   // Indicates whether the function should a multi-device function backend.
   bool use_multi_device_function() const { return use_multi_device_function_; }
 
+  // Returns the elementwise information of the function, if it only applies
+  // elementwise ops to its arguments.
+  const std::optional<ElementwiseFunctionInfo>& elementwise_info() const {
+    return elementwise_info_;
+  }
+
  private:
   FunctionMetadata(NameAttrList&& func, Params params)
       : func_(std::move(func)),
@@ -122,6 +130,7 @@ class FunctionMetadata {
   NameAttrList func_;
   std::unique_ptr<FunctionLibraryDefinition> lib_def_ = nullptr;
   ShortCircuitInfo short_circuit_info_;
+  std::optional<ElementwiseFunctionInfo> elementwise_info_;
   bool use_default_device_ = true;
   bool use_inter_op_parallelism_ = true;
   bool use_multi_device_function_ = true;
@@ -212,6 +221,11 @@ class CapturedFunction {
     return metadata_->use_inter_op_parallelism();
   }
 
+  // Indicates whether the function can be run over a batch of input elements
+  // with `num_element_components` components each, stacked along a new
+  // leading dimension, in a single invocation. See `CanRunBatched`.
+  bool CanRunBatched(int num_element_components) const;
+
  private:
   CapturedFunction(std::shared_ptr<const FunctionMetadata> metadata,
                    std::vector<Tensor> captured_inputs);
@@ -14,15 +14,24 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -31,10 +40,16 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/tstring.h"
 #include "tensorflow/core/platform/types.h"
+// NOTE: The way zstd is packaged in TF, we cannot include it as <zstd.h>.
+#define ZSTD_STATIC_LINKING_ONLY
+#include "zdict.h"  // NOLINT(build/include)
+#include "zstd.h"  // NOLINT(build/include)
 
 namespace tensorflow {
 namespace data {
@@ -43,7 +58,60 @@ namespace {
 // Increment this when making changes to the `CompressedElement` proto. The
 // `UncompressElement` function will determine what to read according to the
 // version.
-constexpr int kCompressedElementVersion = 0;
+constexpr int kCompressedElementVersion = 1;
+// Snappy-compressed elements are still written with the version that predates
+// the `codec` field, so that older readers can uncompress them.
+constexpr int kSnappyCompressedElementVersion = 0;
+
+struct ZstdCCtxDeleter {
+  void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+struct ZstdDCtxDeleter {
+  void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+};
+
+// zstd contexts are expensive to create relative to compressing a small
+// element, so each thread reuses one.
+ZSTD_CCtx* ThreadLocalZstdCCtx() {
+  thread_local std::unique_ptr<ZSTD_CCtx, ZstdCCtxDeleter> ctx(
+      ZSTD_createCCtx());
+  return ctx.get();
+}
+
+ZSTD_DCtx* ThreadLocalZstdDCtx() {
+  thread_local std::unique_ptr<ZSTD_DCtx, ZstdDCtxDeleter> ctx(
+      ZSTD_createDCtx());
+  return ctx.get();
+}
+
+absl::Status ValidateZstdLevel(int level) {
+  if (level < ZSTD_minCLevel() || level > ZSTD_maxCLevel()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("zstd compression level must be between ",
+                     ZSTD_minCLevel(), " and ", ZSTD_maxCLevel(), ", got ",
+                     level));
+  }
+  return absl::OkStatus();
+}
+
+struct ZstdDictionaryRegistry {
+  absl::Mutex mu;
+  absl::flat_hash_map<uint64_t, std::shared_ptr<const ZstdDictionary>>
+      dictionaries ABSL_GUARDED_BY(mu);
+};
+
+ZstdDictionaryRegistry& GlobalZstdDictionaryRegistry() {
+  static auto* registry = new ZstdDictionaryRegistry();
+  return *registry;
+}
+
+std::shared_ptr<const ZstdDictionary> LookupZstdDictionary(uint64_t id) {
+  ZstdDictionaryRegistry& registry = GlobalZstdDictionaryRegistry();
+  absl::MutexLock l(registry.mu);
+  auto it = registry.dictionaries.find(id);
+  if (it == registry.dictionaries.end()) return nullptr;
+  return it->second;
+}
 
 }  // namespace
 
@@ -70,8 +138,13 @@ class Iov {
   size_t num_bytes_;
 };
 
-absl::Status CompressElement(const std::vector<Tensor>& element,
-                             CompressedElement* out) {
+namespace {
+
+// Builds an iov array of the tensor data of `element` and fills out the
+// component metadata of `out`. Tensors that cannot be pointed to directly are
+// serialized into `nonmemcpyable`, which must outlive the returned iov.
+Iov ElementToIov(const std::vector<Tensor>& element, tstring& nonmemcpyable,
+                 CompressedElement* out) {
   // First pass: preprocess the non`memcpy`able tensors.
   size_t num_string_tensors = 0;
   size_t num_string_tensor_strings = 0;
@@ -96,7 +169,6 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
   // - All other tensors are serialized and copied into a string (a `tstring`
   // for access to `resize_unitialized`).
   Iov iov{element.size() + num_string_tensor_strings - num_string_tensors};
-  tstring nonmemcpyable;
   nonmemcpyable.resize_uninitialized(total_nonmemcpyable_size);
   char* nonmemcpyable_pos = nonmemcpyable.mdata();
   int nonmemcpyable_component_index = 0;
@@ -128,17 +200,197 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
       metadata->add_uncompressed_bytes(proto.ByteSizeLong());
     }
   }
+  return iov;
+}
+
+absl::Status ZstdCompress(Iov& iov, const CompressionOptions& options,
+                          std::string* out) {
+  ZSTD_CCtx* ctx = ThreadLocalZstdCCtx();
+  if (ctx == nullptr) {
+    return absl::InternalError("Failed to create zstd context");
+  }
+  ZSTD_CCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+  size_t result;
+  if (options.dictionary) {
+    result = ZSTD_CCtx_refCDict(ctx, options.dictionary->cdict());
+  } else {
+    result = ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel,
+                                    options.level);
+  }
+  if (!ZSTD_isError(result)) {
+    // Records the uncompressed size in the frame header, which lets
+    // `ZstdUncompress` check it against the component metadata up front.
+    result = ZSTD_CCtx_setPledgedSrcSize(ctx, iov.NumBytes());
+  }
+  if (ZSTD_isError(result)) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to configure zstd compression: ", ZSTD_getErrorName(result)));
+  }
+
+  out->resize(ZSTD_compressBound(iov.NumBytes()));
+  ZSTD_outBuffer output = {out->data(), out->size(), 0};
+  for (size_t i = 0; i < iov.NumPieces(); ++i) {
+    ZSTD_inBuffer input = {iov.Data()[i].iov_base, iov.Data()[i].iov_len, 0};
+    while (input.pos < input.size) {
+      result = ZSTD_compressStream2(ctx, &output, &input, ZSTD_e_continue);
+      if (ZSTD_isError(result)) {
+        return absl::InternalError(absl::StrCat(
+            "Failed to compress using zstd: ", ZSTD_getErrorName(result)));
+      }
+    }
+  }
+  ZSTD_inBuffer input = {nullptr, 0, 0};
+  do {
+    result = ZSTD_compressStream2(ctx, &output, &input, ZSTD_e_end);
+    if (ZSTD_isError(result)) {
+      return absl::InternalError(absl::StrCat(
+          "Failed to compress using zstd: ", ZSTD_getErrorName(result)));
+    }
+    // `ZSTD_compressBound` guarantees the frame fits.
+    if (result != 0 && output.pos == output.size) {
+      return absl::InternalError("zstd output exceeded its bound.");
+    }
+  } while (result != 0);
+  out->resize(output.pos);
+  return absl::OkStatus();
+}
+
+absl::Status SnappyUncompress(const CompressedElement& compressed, Iov& iov) {
+  const std::string& compressed_data = compressed.data();
+  size_t uncompressed_size;
+  if (!port::Snappy_GetUncompressedLength(
+          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
+    return absl::InternalError(absl::StrCat(
+        "Could not get snappy uncompressed length. Compressed data size: ",
+        compressed_data.size()));
+  }
+  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
+    return absl::InternalError(absl::StrCat(
+        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
+        " whereas the tensor metadata suggests ", iov.NumBytes()));
+  }
+  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
+                                      compressed_data.size(), iov.Data(),
+                                      iov.NumPieces())) {
+    return absl::InternalError("Failed to perform snappy decompression.");
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ZstdUncompress(const CompressedElement& compressed, Iov& iov) {
+  const std::string& compressed_data = compressed.data();
+  const unsigned long long uncompressed_size =  // NOLINT(runtime/int)
+      ZSTD_getFrameContentSize(compressed_data.data(), compressed_data.size());
+  if (uncompressed_size == ZSTD_CONTENTSIZE_ERROR ||
+      uncompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+    return absl::InternalError(absl::StrCat(
+        "Could not get zstd uncompressed length. Compressed data size: ",
+        compressed_data.size()));
+  }
+  if (uncompressed_size != iov.NumBytes()) {
+    return absl::InternalError(absl::StrCat(
+        "Uncompressed size mismatch. zstd expects ", uncompressed_size,
+        " whereas the tensor metadata suggests ", iov.NumBytes()));
+  }
+
+  ZSTD_DCtx* ctx = ThreadLocalZstdDCtx();
+  if (ctx == nullptr) {
+    return absl::InternalError("Failed to create zstd context");
+  }
+  ZSTD_DCtx_reset(ctx, ZSTD_reset_session_and_parameters);
+  // Keeps the dictionary alive while it is referenced by `ctx`.
+  std::shared_ptr<const ZstdDictionary> dictionary;
+  if (compressed.dictionary_id() != 0) {
+    dictionary = LookupZstdDictionary(compressed.dictionary_id());
+    if (!dictionary) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "Element was compressed with zstd dictionary ",
+          compressed.dictionary_id(),
+          ", which is not registered. Call RegisterZstdDictionary before "
+          "uncompressing it."));
+    }
+    const size_t result = ZSTD_DCtx_refDDict(ctx, dictionary->ddict());
+    if (ZSTD_isError(result)) {
+      return absl::InternalError(
+          absl::StrCat("Failed to configure zstd decompression: ",
+                       ZSTD_getErrorName(result)));
+    }
+  }
 
-  if (iov.NumBytes() > std::numeric_limits<uint32_t>::max()) {
-    return absl::OutOfRangeError(
-        absl::StrCat("Encountered dataset element of size ", iov.NumBytes(),
-                     ", exceeding the 4GB Snappy limit."));
+  ZSTD_inBuffer input = {compressed_data.data(), compressed_data.size(), 0};
+  // Number of bytes zstd still expects; 0 once the frame is fully decoded.
+  size_t remaining = 1;
+  auto decompress = [&](ZSTD_outBuffer& output) -> absl::Status {
+    const size_t input_pos = input.pos;
+    const size_t output_pos = output.pos;
+    remaining = ZSTD_decompressStream(ctx, &output, &input);
+    if (ZSTD_isError(remaining)) {
+      return absl::InternalError(
+          absl::StrCat("Failed to perform zstd decompression: ",
+                       ZSTD_getErrorName(remaining)));
+    }
+    if (input.pos == input_pos && output.pos == output_pos) {
+      return absl::InternalError("Truncated zstd frame.");
+    }
+    return absl::OkStatus();
+  };
+  for (size_t i = 0; i < iov.NumPieces(); ++i) {
+    ZSTD_outBuffer output = {iov.Data()[i].iov_base, iov.Data()[i].iov_len, 0};
+    while (output.pos < output.size) {
+      TF_RETURN_IF_ERROR(decompress(output));
+    }
+  }
+  if (remaining != 0) {
+    ZSTD_outBuffer output = {nullptr, 0, 0};
+    TF_RETURN_IF_ERROR(decompress(output));
   }
-  if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(),
-                                      out->mutable_data())) {
-    return absl::InternalError("Failed to compress using snappy.");
+  if (remaining != 0 || input.pos != input.size) {
+    return absl::InternalError(
+        "zstd frame does not match the tensor metadata.");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status CompressElement(const std::vector<Tensor>& element,
+                             CompressedElement* out) {
+  return CompressElement(element, CompressionOptions(), out);
+}
+
+absl::Status CompressElement(const std::vector<Tensor>& element,
+                             const CompressionOptions& options,
+                             CompressedElement* out) {
+  tstring nonmemcpyable;
+  Iov iov = ElementToIov(element, nonmemcpyable, out);
+  switch (options.codec) {
+    case CompressedElement::SNAPPY:
+      if (iov.NumBytes() > std::numeric_limits<uint32_t>::max()) {
+        return absl::OutOfRangeError(absl::StrCat(
+            "Encountered dataset element of size ", iov.NumBytes(),
+            ", exceeding the 4GB Snappy limit."));
+      }
+      if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(),
+                                          out->mutable_data())) {
+        return absl::InternalError("Failed to compress using snappy.");
+      }
+      out->set_version(kSnappyCompressedElementVersion);
+      break;
+    case CompressedElement::ZSTD:
+      if (!options.dictionary) {
+        TF_RETURN_IF_ERROR(ValidateZstdLevel(options.level));
+      }
+      TF_RETURN_IF_ERROR(ZstdCompress(iov, options, out->mutable_data()));
+      out->set_version(kCompressedElementVersion);
+      out->set_codec(CompressedElement::ZSTD);
+      if (options.dictionary) {
+        out->set_dictionary_id(options.dictionary->id());
+      }
+      break;
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported compression codec: ", options.codec));
   }
-  out->set_version(kCompressedElementVersion);
   VLOG(3) << "Compressed element from " << iov.NumBytes() << " bytes to "
           << out->data().size() << " bytes";
   return absl::OkStatus();
@@ -146,7 +398,8 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
 
 absl::Status UncompressElement(const CompressedElement& compressed,
                                std::vector<Tensor>* out) {
-  if (compressed.version() != kCompressedElementVersion) {
+  if (compressed.version() != kSnappyCompressedElementVersion &&
+      compressed.version() != kCompressedElementVersion) {
     return absl::InternalError(absl::StrCat(
         "Unsupported compressed element version: ", compressed.version()));
   }
@@ -224,23 +477,20 @@ absl::Status UncompressElement(const CompressedElement& compressed,
   }
 
   // Step 2: Uncompress into the iovec.
-  const std::string& compressed_data = compressed.data();
-  size_t uncompressed_size;
-  if (!port::Snappy_GetUncompressedLength(
-          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
-    return absl::InternalError(absl::StrCat(
-        "Could not get snappy uncompressed length. Compressed data size: ",
-        compressed_data.size()));
-  }
-  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
-    return absl::InternalError(absl::StrCat(
-        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
-        " whereas the tensor metadata suggests ", iov.NumBytes()));
-  }
-  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
-                                      compressed_data.size(), iov.Data(),
-                                      iov.NumPieces())) {
-    return absl::InternalError("Failed to perform snappy decompression.");
+  const CompressedElement::Codec codec =
+      compressed.version() == kSnappyCompressedElementVersion
+          ? CompressedElement::SNAPPY
+          : compressed.codec();
+  switch (codec) {
+    case CompressedElement::SNAPPY:
+      TF_RETURN_IF_ERROR(SnappyUncompress(compressed, iov));
+      break;
+    case CompressedElement::ZSTD:
+      TF_RETURN_IF_ERROR(ZstdUncompress(compressed, iov));
+      break;
+    default:
+      return absl::InternalError(
+          absl::StrCat("Unsupported compression codec: ", codec));
   }
 
   // Third pass: deserialize nonstring, non`memcpy`able tensors.
@@ -265,6 +515,141 @@ absl::Status UncompressElement(const CompressedElement& compressed,
   return absl::OkStatus();
 }
 
+ZstdDictionary::ZstdDictionary(std::string content, int level)
+    : content_(std::move(content)),
+      level_(level),
+      id_(std::max<uint64_t>(Fingerprint64(content_), 1)),
+      cdict_(ZSTD_createCDict(content_.data(), content_.size(), level_)),
+      ddict_(ZSTD_createDDict(content_.data(), content_.size())) {}
+
+ZstdDictionary::~ZstdDictionary() {
+  ZSTD_freeCDict(cdict_);
+  ZSTD_freeDDict(ddict_);
+}
+
+absl::StatusOr<std::shared_ptr<const ZstdDictionary>> ZstdDictionary::Create(
+    std::string content, int level) {
+  TF_RETURN_IF_ERROR(ValidateZstdLevel(level));
+  if (content.empty()) {
+    return absl::InvalidArgumentError("zstd dictionary must not be empty.");
+  }
+  std::shared_ptr<const ZstdDictionary> dictionary(
+      new ZstdDictionary(std::move(content), level));
+  if (dictionary->cdict() == nullptr || dictionary->ddict() == nullptr) {
+    return absl::InternalError("Failed to load zstd dictionary.");
+  }
+  return dictionary;
+}
+
+absl::StatusOr<std::shared_ptr<const ZstdDictionary>> ZstdDictionary::Train(
+    absl::Span<const std::vector<Tensor>> samples, size_t max_size,
+    int level) {
+  // zstd trains on the same bytes it later compresses, i.e. the concatenated
+  // iovs of each element.
+  std::string buffer;
+  std::vector<size_t> sample_sizes;
+  sample_sizes.reserve(samples.size());
+  for (const std::vector<Tensor>& sample : samples) {
+    CompressedElement unused;
+    tstring nonmemcpyable;
+    Iov iov = ElementToIov(sample, nonmemcpyable, &unused);
+    for (size_t i = 0; i < iov.NumPieces(); ++i) {
+      buffer.append(static_cast<const char*>(iov.Data()[i].iov_base),
+                    iov.Data()[i].iov_len);
+    }
+    sample_sizes.push_back(iov.NumBytes());
+  }
+  std::string content(max_size, '\0');
+  const size_t size =
+      ZDICT_trainFromBuffer(content.data(), content.size(), buffer.data(),
+                            sample_sizes.data(), sample_sizes.size());
+  if (ZDICT_isError(size)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Failed to train zstd dictionary on ", samples.size(),
+                     " samples: ", ZDICT_getErrorName(size)));
+  }
+  content.resize(size);
+  return Create(std::move(content), level);
+}
+
+void RegisterZstdDictionary(std::shared_ptr<const ZstdDictionary> dictionary) {
+  ZstdDictionaryRegistry& registry = GlobalZstdDictionaryRegistry();
+  absl::MutexLock l(registry.mu);
+  const uint64_t id = dictionary->id();
+  registry.dictionaries.insert_or_assign(id, std::move(dictionary));
+}
+
+absl::StatusOr<CodecSelection> SelectCompressionCodec(
+    absl::Span<const std::vector<Tensor>> samples,
+    const CodecSelectionOptions& options) {
+  if (samples.empty()) {
+    return absl::InvalidArgumentError(
+        "Selecting a compression codec requires at least one sample.");
+  }
+  if (options.network_bytes_per_second <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("network_bytes_per_second must be positive, got ",
+                     options.network_bytes_per_second));
+  }
+  std::vector<CompressionOptions> candidates(1);
+  for (int level : options.zstd_levels) {
+    TF_RETURN_IF_ERROR(ValidateZstdLevel(level));
+    CompressionOptions& candidate = candidates.emplace_back();
+    candidate.codec = CompressedElement::ZSTD;
+    candidate.level = level;
+  }
+  if (options.dictionary) {
+    CompressionOptions& candidate = candidates.emplace_back();
+    candidate.codec = CompressedElement::ZSTD;
+    candidate.level = options.dictionary->level();
+    candidate.dictionary = options.dictionary;
+    RegisterZstdDictionary(options.dictionary);
+  }
+
+  uint64_t uncompressed_bytes = 0;
+  CodecSelection best;
+  best.compress = false;
+  std::vector<Tensor> uncompressed;
+  for (const CompressionOptions& candidate : candidates) {
+    uint64_t compressed_bytes = 0;
+    absl::Duration elapsed;
+    for (const std::vector<Tensor>& sample : samples) {
+      CompressedElement compressed;
+      absl::Time start = absl::Now();
+      TF_RETURN_IF_ERROR(CompressElement(sample, candidate, &compressed));
+      TF_RETURN_IF_ERROR(UncompressElement(compressed, &uncompressed));
+      elapsed += absl::Now() - start;
+      compressed_bytes += compressed.data().size();
+      if (&candidate == &candidates.front()) {
+        for (const auto& metadata : compressed.component_metadata()) {
+          for (uint64_t bytes : metadata.uncompressed_bytes()) {
+            uncompressed_bytes += bytes;
+          }
+        }
+      }
+    }
+    if (&candidate == &candidates.front()) {
+      best.cost_seconds =
+          uncompressed_bytes / options.network_bytes_per_second;
+    }
+    const double cost = absl::ToDoubleSeconds(elapsed) +
+                        compressed_bytes / options.network_bytes_per_second;
+    VLOG(2) << "Compression codec " << candidate.codec << " at level "
+            << candidate.level << ": ratio "
+            << static_cast<double>(compressed_bytes) /
+                   std::max<uint64_t>(uncompressed_bytes, 1)
+            << ", estimated cost " << cost << "s";
+    if (cost < best.cost_seconds) {
+      best.compress = true;
+      best.options = candidate;
+      best.ratio = static_cast<double>(compressed_bytes) /
+                   std::max<uint64_t>(uncompressed_bytes, 1);
+      best.cost_seconds = cost;
+    }
+  }
+  return best;
+}
+
 REGISTER_UNARY_VARIANT_DECODE_FUNCTION(CompressedElement,
                                        "tensorflow.data.CompressedElement");
 
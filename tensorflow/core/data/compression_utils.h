@@ -15,16 +15,78 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_COMPRESSION_UTILS_H_
 #define TENSORFLOW_CORE_DATA_COMPRESSION_UTILS_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/platform/status.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 namespace tensorflow {
 namespace data {
 
+inline constexpr int kDefaultZstdLevel = 3;
+
+// A zstd dictionary, shared by the compressor and the decompressor. Small,
+// repetitive elements compress much better against a dictionary trained on
+// similar elements, since each element no longer has to carry its own
+// vocabulary.
+class ZstdDictionary {
+ public:
+  // Uses `content` as the dictionary. `content` may be a trained zstd
+  // dictionary or raw bytes resembling the data to compress. Elements are
+  // compressed at `level`.
+  static absl::StatusOr<std::shared_ptr<const ZstdDictionary>> Create(
+      std::string content, int level = kDefaultZstdLevel);
+
+  // Trains a dictionary of at most `max_size` bytes on `samples`.
+  static absl::StatusOr<std::shared_ptr<const ZstdDictionary>> Train(
+      absl::Span<const std::vector<Tensor>> samples, size_t max_size,
+      int level = kDefaultZstdLevel);
+
+  ~ZstdDictionary();
+
+  // Fingerprint of `content()`, never 0.
+  uint64_t id() const { return id_; }
+  int level() const { return level_; }
+  const std::string& content() const { return content_; }
+
+  const ZSTD_CDict_s* cdict() const { return cdict_; }
+  const ZSTD_DDict_s* ddict() const { return ddict_; }
+
+ private:
+  ZstdDictionary(std::string content, int level);
+
+  const std::string content_;
+  const int level_;
+  const uint64_t id_;
+  ZSTD_CDict_s* cdict_ = nullptr;
+  ZSTD_DDict_s* ddict_ = nullptr;
+};
+
+// Makes `dictionary` available to `UncompressElement` for elements that were
+// compressed with it. Dictionaries stay registered for the process lifetime.
+void RegisterZstdDictionary(std::shared_ptr<const ZstdDictionary> dictionary);
+
+struct CompressionOptions {
+  CompressedElement::Codec codec = CompressedElement::SNAPPY;
+  // zstd compression level. Ignored for other codecs and when `dictionary` is
+  // set, since the dictionary fixes the level.
+  int level = kDefaultZstdLevel;
+  // Optional zstd dictionary. It must be registered with
+  // `RegisterZstdDictionary` wherever the element is uncompressed.
+  std::shared_ptr<const ZstdDictionary> dictionary;
+};
+
 // Compresses the components of `element` into the `CompressedElement` proto.
 //
 // In addition to writing the actual compressed bytes, `Compress` fills
@@ -34,10 +96,43 @@ namespace data {
 absl::Status CompressElement(const std::vector<Tensor>& element,
                              CompressedElement* out);
 
+// Same as above, but with the codec chosen by `options`. Snappy-compressed
+// elements keep version 0 so that older readers can still uncompress them.
+absl::Status CompressElement(const std::vector<Tensor>& element,
+                             const CompressionOptions& options,
+                             CompressedElement* out);
+
 // Uncompresses a `CompressedElement` into a vector of tensor components.
 absl::Status UncompressElement(const CompressedElement& compressed,
                                std::vector<Tensor>* out);
 
+struct CodecSelectionOptions {
+  // Throughput of the link compressed elements are sent over. Time spent
+  // sending bytes is weighed against time spent (un)compressing them.
+  double network_bytes_per_second = 1e9;
+  // zstd levels to try.
+  std::vector<int> zstd_levels = {1, kDefaultZstdLevel};
+  // If set, zstd is also tried with this dictionary.
+  std::shared_ptr<const ZstdDictionary> dictionary;
+};
+
+struct CodecSelection {
+  // False if sending elements uncompressed is estimated to be fastest.
+  bool compress = true;
+  CompressionOptions options;
+  // Compressed bytes over uncompressed bytes for the chosen codec.
+  double ratio = 1.0;
+  // Estimated seconds to compress, send and uncompress the samples.
+  double cost_seconds = 0.0;
+};
+
+// Compresses and uncompresses `samples` with every candidate codec and picks
+// the one that minimizes the estimated end-to-end transfer time. Registers
+// `options.dictionary`, if any.
+absl::StatusOr<CodecSelection> SelectCompressionCodec(
+    absl::Span<const std::vector<Tensor>> samples,
+    const CodecSelectionOptions& options);
+
 }  // namespace data
 }  // namespace tensorflow
 
@@ -15,16 +15,21 @@ limitations under the License.
 #include "tensorflow/core/data/compression_utils.h"
 
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <gmock/gmock.h>
 #include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
 #include "xla/tsl/platform/status_matchers.h"
+#include "xla/tsl/platform/statusor.h"
 #include "xla/tsl/protobuf/error_codes.pb.h"
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 
 namespace tensorflow {
@@ -103,15 +108,198 @@ TEST_P(ParameterizedCompressionUtilsTest, VersionMismatch) {
   CompressedElement compressed;
   TF_ASSERT_OK(CompressElement(element, &compressed));
 
-  compressed.set_version(1);
+  compressed.set_version(2);
   std::vector<Tensor> round_trip_element;
   EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
               absl_testing::StatusIs(error::INTERNAL));
 }
 
+TEST_P(ParameterizedCompressionUtilsTest, ZstdRoundTrip) {
+  std::vector<Tensor> element = GetParam();
+  for (int level : {-5, 1, 3, 19}) {
+    CompressionOptions options;
+    options.codec = CompressedElement::ZSTD;
+    options.level = level;
+    CompressedElement compressed;
+    TF_ASSERT_OK(CompressElement(element, options, &compressed));
+    EXPECT_EQ(compressed.version(), 1);
+    EXPECT_EQ(compressed.codec(), CompressedElement::ZSTD);
+    std::vector<Tensor> round_trip_element;
+    TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+    TF_EXPECT_OK(
+        ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+  }
+}
+
+TEST_P(ParameterizedCompressionUtilsTest, ZstdDictionaryRoundTrip) {
+  std::vector<Tensor> element = GetParam();
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<const ZstdDictionary> dictionary,
+                          ZstdDictionary::Create("abcxyzijkmnk"));
+  RegisterZstdDictionary(dictionary);
+  CompressionOptions options;
+  options.codec = CompressedElement::ZSTD;
+  options.dictionary = dictionary;
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, options, &compressed));
+  EXPECT_EQ(compressed.dictionary_id(), dictionary->id());
+  std::vector<Tensor> round_trip_element;
+  TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+  TF_EXPECT_OK(
+      ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+}
+
+TEST_P(ParameterizedCompressionUtilsTest, ZstdSizeMismatch) {
+  std::vector<Tensor> element = GetParam();
+  CompressionOptions options;
+  options.codec = CompressedElement::ZSTD;
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, options, &compressed));
+  // An extra int64 component the frame does not hold.
+  CompressedComponentMetadata* metadata = compressed.add_component_metadata();
+  metadata->set_dtype(DT_INT64);
+  metadata->mutable_tensor_shape()->add_dim()->set_size(1);
+  metadata->add_uncompressed_bytes(sizeof(int64_t));
+  std::vector<Tensor> round_trip_element;
+  EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
+              absl_testing::StatusIs(error::INTERNAL,
+                                     HasSubstr("Uncompressed size mismatch")));
+}
+
 INSTANTIATE_TEST_SUITE_P(Instantiation, ParameterizedCompressionUtilsTest,
                          ::testing::ValuesIn(TestCases()));
 
+std::vector<std::vector<Tensor>> RepetitiveSamples(int num_samples) {
+  std::vector<std::vector<Tensor>> samples;
+  for (int i = 0; i < num_samples; ++i) {
+    samples.push_back({CreateTensor<tstring>(
+        TensorShape{2},
+        {absl::StrCat("{\"user_id\": ", i * 7919 % 100003,
+                      ", \"country\": \"", i % 3 == 0 ? "CH" : "US",
+                      "\", \"clicks\": [", i % 17, ", ", i % 5, "]}"),
+         absl::StrCat("session-", i % 11, "-", i * 31 % 997)})});
+  }
+  return samples;
+}
+
+TEST(CompressionUtilsTest, TrainedZstdDictionary) {
+  const std::vector<std::vector<Tensor>> samples = RepetitiveSamples(1000);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<const ZstdDictionary> dictionary,
+                          ZstdDictionary::Train(samples, /*max_size=*/4096));
+  EXPECT_LE(dictionary->content().size(), 4096);
+  RegisterZstdDictionary(dictionary);
+
+  CompressionOptions plain_options;
+  plain_options.codec = CompressedElement::ZSTD;
+  CompressionOptions dictionary_options = plain_options;
+  dictionary_options.dictionary = dictionary;
+  int64_t plain_bytes = 0;
+  int64_t dictionary_bytes = 0;
+  for (const std::vector<Tensor>& sample : samples) {
+    CompressedElement plain, with_dictionary;
+    TF_ASSERT_OK(CompressElement(sample, plain_options, &plain));
+    TF_ASSERT_OK(
+        CompressElement(sample, dictionary_options, &with_dictionary));
+    plain_bytes += plain.data().size();
+    dictionary_bytes += with_dictionary.data().size();
+    std::vector<Tensor> round_trip_element;
+    TF_ASSERT_OK(UncompressElement(with_dictionary, &round_trip_element));
+    test::ExpectEqual(sample[0], round_trip_element[0]);
+  }
+  EXPECT_LT(dictionary_bytes, plain_bytes / 2);
+}
+
+TEST(CompressionUtilsTest, UnregisteredZstdDictionary) {
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<const ZstdDictionary> dictionary,
+                          ZstdDictionary::Create("never registered"));
+  CompressionOptions options;
+  options.codec = CompressedElement::ZSTD;
+  options.dictionary = dictionary;
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(
+      CreateTensors<tstring>(TensorShape{1}, {{"never"}}).front(), options,
+      &compressed));
+  std::vector<Tensor> round_trip_element;
+  EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
+              absl_testing::StatusIs(error::FAILED_PRECONDITION,
+                                     HasSubstr("not registered")));
+}
+
+TEST(CompressionUtilsTest, InvalidZstdLevel) {
+  CompressionOptions options;
+  options.codec = CompressedElement::ZSTD;
+  options.level = 1000;
+  CompressedElement compressed;
+  EXPECT_THAT(CompressElement(RepetitiveSamples(1).front(), options,
+                              &compressed),
+              absl_testing::StatusIs(error::INVALID_ARGUMENT));
+  EXPECT_THAT(ZstdDictionary::Create("abc", /*level=*/1000).status(),
+              absl_testing::StatusIs(error::INVALID_ARGUMENT));
+}
+
+TEST(CompressionUtilsTest, SelectCompressionCodec) {
+  const std::vector<std::vector<Tensor>> samples = {
+      {CreateTensor<int64_t>(TensorShape{256, 256})}};
+
+  CodecSelectionOptions slow_network;
+  slow_network.network_bytes_per_second = 1e3;
+  TF_ASSERT_OK_AND_ASSIGN(CodecSelection selection,
+                          SelectCompressionCodec(samples, slow_network));
+  EXPECT_TRUE(selection.compress);
+  EXPECT_EQ(selection.options.codec, CompressedElement::ZSTD);
+  EXPECT_LT(selection.ratio, 0.01);
+
+  CodecSelectionOptions fast_network;
+  fast_network.network_bytes_per_second = 1e18;
+  TF_ASSERT_OK_AND_ASSIGN(selection,
+                          SelectCompressionCodec(samples, fast_network));
+  EXPECT_FALSE(selection.compress);
+
+  EXPECT_THAT(SelectCompressionCodec({}, slow_network).status(),
+              absl_testing::StatusIs(error::INVALID_ARGUMENT));
+}
+
+// Args: codec, zstd level, and whether to use a trained dictionary. Elements
+// are small, repetitive records, the case dictionaries are meant for.
+void BM_CompressElement(::testing::benchmark::State& state) {
+  const auto codec = static_cast<CompressedElement::Codec>(state.range(0));
+  const std::vector<std::vector<Tensor>> samples = RepetitiveSamples(1000);
+  CompressionOptions options;
+  options.codec = codec;
+  options.level = state.range(1);
+  if (state.range(2)) {
+    options.dictionary =
+        ZstdDictionary::Train(samples, /*max_size=*/16 << 10, options.level)
+            .value();
+    RegisterZstdDictionary(options.dictionary);
+  }
+
+  int64_t uncompressed_bytes = 0;
+  int64_t compressed_bytes = 0;
+  std::vector<Tensor> uncompressed;
+  for (auto s : state) {
+    for (const std::vector<Tensor>& sample : samples) {
+      CompressedElement compressed;
+      TF_CHECK_OK(CompressElement(sample, options, &compressed));
+      TF_CHECK_OK(UncompressElement(compressed, &uncompressed));
+      compressed_bytes += compressed.data().size();
+      const auto records = sample[0].flat<tstring>();
+      for (int i = 0; i < records.size(); ++i) {
+        uncompressed_bytes += records(i).size();
+      }
+    }
+  }
+  state.SetBytesProcessed(uncompressed_bytes);
+  state.counters["ratio"] =
+      static_cast<double>(compressed_bytes) / uncompressed_bytes;
+}
+
+BENCHMARK(BM_CompressElement)
+    ->Args({CompressedElement::SNAPPY, 0, 0})
+    ->Args({CompressedElement::ZSTD, 1, 0})
+    ->Args({CompressedElement::ZSTD, 3, 0})
+    ->Args({CompressedElement::ZSTD, 1, 1})
+    ->Args({CompressedElement::ZSTD, 3, 1});
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -0,0 +1,80 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/numa_utils.h"
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/pool_allocator.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
+
+namespace tensorflow {
+namespace data {
+
+int CurrentNumaNode() {
+  if (!port::NUMAEnabled()) {
+    return port::kNUMANoAffinity;
+  }
+  return port::NUMAGetThreadNodeAffinity();
+}
+
+int64_t NumaThreadPoolSize(int64_t private_threadpool_size, int numa_node) {
+  if (private_threadpool_size > 0) {
+    return private_threadpool_size;
+  }
+  return port::MaxParallelism(numa_node);
+}
+
+Allocator* GetNumaAllocator(int numa_node) {
+  static mutex& mu = *new mutex;
+  static auto& allocators TF_GUARDED_BY(mu) =
+      *new absl::flat_hash_map<int, Allocator*>;
+  mutex_lock l(mu);
+  Allocator*& allocator = allocators[numa_node];
+  if (allocator == nullptr) {
+    allocator = new PoolAllocator(
+        /*pool_size_limit=*/100, /*auto_resize=*/true,
+        new BasicCPUAllocator(numa_node, /*alloc_visitors=*/{},
+                              /*free_visitors=*/{}),
+        new NoopRounder, absl::StrCat("tf_data_numa_", numa_node));
+  }
+  return allocator;
+}
+
+std::function<Allocator*(AllocatorAttributes)> NumaLocalAllocatorGetter(
+    std::function<Allocator*(AllocatorAttributes)> allocator_getter,
+    Allocator* numa_allocator) {
+  if (!allocator_getter) {
+    return allocator_getter;
+  }
+  return [allocator_getter = std::move(allocator_getter),
+          numa_allocator](AllocatorAttributes attrs) {
+    Allocator* allocator = allocator_getter(attrs);
+    if (allocator != nullptr &&
+        allocator->GetMemoryType() == AllocatorMemoryType::kHostPageable) {
+      return numa_allocator;
+    }
+    return allocator;
+  };
+}
+
+}  // namespace data
+}  // namespace tensorflow
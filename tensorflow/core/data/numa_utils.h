@@ -0,0 +1,51 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_NUMA_UTILS_H_
+#define TENSORFLOW_CORE_DATA_NUMA_UTILS_H_
+
+#include <cstdint>
+#include <functional>
+
+#include "tensorflow/core/framework/allocator.h"
+
+namespace tensorflow {
+namespace data {
+
+// Returns the NUMA node whose CPUs the calling thread is bound to, or
+// `port::kNUMANoAffinity` if NUMA is not supported or the thread may run on
+// the CPUs of several nodes.
+int CurrentNumaNode();
+
+// Returns the size of the private thread pool of an input pipeline running on
+// `numa_node`. A positive `private_threadpool_size` is kept; otherwise the pool
+// is sized to the CPUs of `numa_node`.
+int64_t NumaThreadPoolSize(int64_t private_threadpool_size, int numa_node);
+
+// Returns an allocator of host memory local to `numa_node`, shared by all input
+// pipelines on that node. Memory comes from `port::NUMAMalloc` and is pooled,
+// since NUMA allocations are much slower than regular ones.
+Allocator* GetNumaAllocator(int numa_node);
+
+// Returns an allocator getter which serves the requests `allocator_getter`
+// would serve from pageable host memory with `numa_allocator`. Other requests,
+// e.g. for pinned or device memory, are forwarded unchanged.
+std::function<Allocator*(AllocatorAttributes)> NumaLocalAllocatorGetter(
+    std::function<Allocator*(AllocatorAttributes)> allocator_getter,
+    Allocator* numa_allocator);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_NUMA_UTILS_H_
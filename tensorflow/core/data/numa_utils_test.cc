@@ -0,0 +1,104 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/numa_utils.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// An allocator which only reports its memory type.
+class FakeAllocator : public Allocator {
+ public:
+  explicit FakeAllocator(AllocatorMemoryType memory_type)
+      : memory_type_(memory_type) {}
+
+  std::string Name() override { return "fake"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    return nullptr;
+  }
+  void DeallocateRaw(void* ptr) override {}
+  AllocatorMemoryType GetMemoryType() const override { return memory_type_; }
+
+ private:
+  const AllocatorMemoryType memory_type_;
+};
+
+std::function<Allocator*(AllocatorAttributes)> Getter(Allocator* allocator) {
+  return [allocator](AllocatorAttributes) { return allocator; };
+}
+
+TEST(NumaUtilsTest, SharesAllocatorPerNode) {
+  EXPECT_EQ(GetNumaAllocator(0), GetNumaAllocator(0));
+}
+
+TEST(NumaUtilsTest, AllocatesFromNode) {
+  Allocator* allocator = GetNumaAllocator(0);
+  void* ptr = allocator->AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+  ASSERT_NE(ptr, nullptr);
+  if (port::NUMAEnabled()) {
+    EXPECT_EQ(port::NUMAGetMemAffinity(ptr), 0);
+  }
+  allocator->DeallocateRaw(ptr);
+}
+
+TEST(NumaUtilsTest, ReplacesPageableHostAllocator) {
+  FakeAllocator host(AllocatorMemoryType::kHostPageable);
+  auto getter = NumaLocalAllocatorGetter(Getter(&host), GetNumaAllocator(0));
+  EXPECT_EQ(getter(AllocatorAttributes()), GetNumaAllocator(0));
+}
+
+TEST(NumaUtilsTest, ForwardsOtherAllocators) {
+  FakeAllocator pinned(AllocatorMemoryType::kHostPinned);
+  FakeAllocator device(AllocatorMemoryType::kDevice);
+  Allocator* numa_allocator = GetNumaAllocator(0);
+  EXPECT_EQ(NumaLocalAllocatorGetter(Getter(&pinned), numa_allocator)(
+                AllocatorAttributes()),
+            &pinned);
+  EXPECT_EQ(NumaLocalAllocatorGetter(Getter(&device), numa_allocator)(
+                AllocatorAttributes()),
+            &device);
+}
+
+TEST(NumaUtilsTest, SizesThreadPoolToNode) {
+  EXPECT_EQ(NumaThreadPoolSize(/*private_threadpool_size=*/0, /*numa_node=*/0),
+            port::MaxParallelism(0));
+}
+
+TEST(NumaUtilsTest, KeepsExplicitThreadPoolSize) {
+  EXPECT_EQ(NumaThreadPoolSize(/*private_threadpool_size=*/3, /*numa_node=*/0),
+            3);
+}
+
+TEST(NumaUtilsTest, CurrentNumaNode) {
+  int numa_node = CurrentNumaNode();
+  if (port::NUMAEnabled()) {
+    EXPECT_LT(numa_node, port::NUMANumNodes());
+  } else {
+    EXPECT_EQ(numa_node, port::kNUMANoAffinity);
+  }
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,142 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/pipeline_stats.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/platform/errors.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/model.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/random.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kRootNodeName[] = "Root";
+constexpr char kStatsSuffix[] = ".pipeline_stats";
+
+const model::ModelProto::Node* FindNode(const model::ModelProto& model,
+                                        int64_t id) {
+  auto it = model.nodes().find(id);
+  return it == model.nodes().end() ? nullptr : &it->second;
+}
+
+const model::ModelProto::Node* FirstInput(const model::ModelProto& model,
+                                          const model::ModelProto::Node& node) {
+  if (node.inputs_size() == 0) return nullptr;
+  return FindNode(model, node.inputs(0));
+}
+
+int64_t NumOutputElements(const model::ModelProto& model) {
+  const model::ModelProto::Node* output = FindNode(model, model.output());
+  return output == nullptr ? 0 : output->num_elements();
+}
+
+}  // namespace
+
+std::string PipelineStatsFilename(absl::string_view stats_dir,
+                                  uint64_t fingerprint) {
+  return io::JoinPath(
+      stats_dir,
+      absl::StrCat(absl::Hex(fingerprint, absl::kZeroPad16), kStatsSuffix));
+}
+
+absl::Status SavePipelineStats(Env* env, model::Model& model,
+                               const std::string& filename) {
+  model::ModelProto model_proto;
+  TF_RETURN_IF_ERROR(model.ToProto(&model_proto));
+  int64_t num_elements = NumOutputElements(model_proto);
+  if (num_elements < kMinPipelineStatsElements) {
+    VLOG(1) << "Not saving the input pipeline statistics of a run producing "
+            << num_elements << " elements";
+    return absl::OkStatus();
+  }
+  if (env->FileExists(filename).ok()) {
+    absl::StatusOr<model::ModelProto> recorded =
+        LoadPipelineStats(env, filename);
+    if (recorded.ok() && NumOutputElements(*recorded) >= num_elements) {
+      VLOG(1) << "Not overwriting the input pipeline statistics in "
+              << filename << " with those of a shorter run";
+      return absl::OkStatus();
+    }
+  }
+  TF_RETURN_IF_ERROR(
+      env->RecursivelyCreateDir(std::string(io::Dirname(filename))));
+  // Writes to a temporary file first so that concurrent readers never observe
+  // a partially written file.
+  std::string tmp_filename = absl::StrCat(filename, ".tmp_", random::New64());
+  TF_RETURN_IF_ERROR(WriteBinaryProto(env, tmp_filename, model_proto));
+  TF_RETURN_IF_ERROR(env->RenameFile(tmp_filename, filename));
+  VLOG(1) << "Saved the input pipeline statistics to " << filename;
+  return absl::OkStatus();
+}
+
+absl::StatusOr<model::ModelProto> LoadPipelineStats(
+    Env* env, const std::string& filename) {
+  model::ModelProto model_proto;
+  TF_RETURN_IF_ERROR(ReadBinaryProto(env, filename, &model_proto));
+  return model_proto;
+}
+
+std::vector<PipelineNodeStats> GetPipelineStats(
+    const model::ModelProto& model) {
+  double total_processing_time = 0;
+  for (const auto& [id, node] : model.nodes()) {
+    total_processing_time += node.processing_time();
+  }
+  std::vector<PipelineNodeStats> result;
+  const model::ModelProto::Node* node = FindNode(model, model.output());
+  if (node != nullptr && node->name() == kRootNodeName) {
+    node = FirstInput(model, *node);
+  }
+  for (; node != nullptr; node = FirstInput(model, *node)) {
+    PipelineNodeStats stats;
+    stats.name = node->name();
+    stats.num_elements = node->num_elements();
+    if (node->num_elements() > 0) {
+      stats.processing_time_per_element_nsec =
+          static_cast<double>(node->processing_time()) / node->num_elements();
+    }
+    if (total_processing_time > 0) {
+      stats.processing_time_share =
+          node->processing_time() / total_processing_time;
+    }
+    const model::ModelProto::Node* input = FirstInput(model, *node);
+    if (input != nullptr && input->num_elements() > 0) {
+      stats.selectivity =
+          static_cast<double>(node->num_elements()) / input->num_elements();
+    }
+    if (node->bytes_consumed() > 0) {
+      stats.bytes_ratio = static_cast<double>(node->bytes_produced()) /
+                          node->bytes_consumed();
+    }
+    result.push_back(std::move(stats));
+  }
+  return result;
+}
+
+}  // namespace data
+}  // namespace tensorflow
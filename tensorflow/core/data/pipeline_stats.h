@@ -0,0 +1,79 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_PIPELINE_STATS_H_
+#define TENSORFLOW_CORE_DATA_PIPELINE_STATS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/model.pb.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace tensorflow {
+namespace data {
+
+// Statistics of an input pipeline iterator, recorded by the autotuning model
+// of a previous run.
+struct PipelineNodeStats {
+  // The name of the model node, e.g. "ParallelMapV2".
+  std::string name;
+  int64_t num_elements = 0;
+  // Time spent in the node itself, excluding its inputs, per produced element.
+  double processing_time_per_element_nsec = 0;
+  // Fraction of the processing time of the whole pipeline spent in the node.
+  double processing_time_share = 0;
+  // Elements produced per element of the first input. 1 if unknown.
+  double selectivity = 1;
+  // Bytes produced per byte consumed. 1 if unknown.
+  double bytes_ratio = 1;
+};
+
+// Returns the file under `stats_dir` holding the statistics of the input
+// pipeline with the given fingerprint.
+std::string PipelineStatsFilename(absl::string_view stats_dir,
+                                  uint64_t fingerprint);
+
+// Runs whose output produced fewer elements are too short to be representative
+// and are not recorded.
+inline constexpr int64_t kMinPipelineStatsElements = 50;
+
+// Writes the state of `model` to `filename` if its output produced at least
+// `kMinPipelineStatsElements` elements and more elements than the run already
+// recorded in `filename`, if any. Later runs may have been rewritten using the
+// recorded statistics, in which case the rewrites only use their statistics up
+// to the first rewritten node.
+absl::Status SavePipelineStats(Env* env, model::Model& model,
+                               const std::string& filename);
+
+// Reads the statistics written by `SavePipelineStats`. Returns `NotFound` if
+// no statistics were recorded.
+absl::StatusOr<model::ModelProto> LoadPipelineStats(
+    Env* env, const std::string& filename);
+
+// Returns the statistics of the nodes reached from the output of `model` by
+// following first inputs, from the output to the source. The root node, which
+// has no counterpart in the dataset graph, is skipped.
+std::vector<PipelineNodeStats> GetPipelineStats(
+    const model::ModelProto& model);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_PIPELINE_STATS_H_
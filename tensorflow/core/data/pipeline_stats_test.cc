@@ -0,0 +1,170 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/pipeline_stats.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/model.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::DoubleEq;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::SizeIs;
+
+model::ModelProto::Node* AddNode(int64_t id, absl::string_view name,
+                                 int64_t num_elements, int64_t processing_time,
+                                 model::ModelProto* model) {
+  model::ModelProto::Node& node = (*model->mutable_nodes())[id];
+  node.set_id(id);
+  node.set_name(std::string(name));
+  node.set_num_elements(num_elements);
+  node.set_processing_time(processing_time);
+  return &node;
+}
+
+// Root <- Prefetch <- Filter <- ParallelMapV2 <- TensorSlice
+model::ModelProto MakeModel() {
+  model::ModelProto model;
+  AddNode(0, "Root", 50, 0, &model)->add_inputs(1);
+  AddNode(1, "Prefetch", 50, 1000, &model)->add_inputs(2);
+  AddNode(2, "Filter", 50, 2000, &model)->add_inputs(3);
+  model::ModelProto::Node* map = AddNode(3, "ParallelMapV2", 100, 6000, &model);
+  map->add_inputs(4);
+  map->set_bytes_consumed(400);
+  map->set_bytes_produced(1600);
+  AddNode(4, "TensorSlice", 100, 1000, &model);
+  model.set_output(0);
+  return model;
+}
+
+TEST(PipelineStatsTest, FollowsFirstInputs) {
+  EXPECT_THAT(GetPipelineStats(MakeModel()),
+              ElementsAre(Field(&PipelineNodeStats::name, "Prefetch"),
+                          Field(&PipelineNodeStats::name, "Filter"),
+                          Field(&PipelineNodeStats::name, "ParallelMapV2"),
+                          Field(&PipelineNodeStats::name, "TensorSlice")));
+}
+
+TEST(PipelineStatsTest, DerivedStats) {
+  std::vector<PipelineNodeStats> stats = GetPipelineStats(MakeModel());
+  ASSERT_THAT(stats, SizeIs(4));
+  const PipelineNodeStats& filter = stats[1];
+  EXPECT_THAT(filter.selectivity, DoubleEq(0.5));
+  EXPECT_THAT(filter.processing_time_per_element_nsec, DoubleEq(40));
+  const PipelineNodeStats& map = stats[2];
+  EXPECT_THAT(map.processing_time_share, DoubleEq(0.6));
+  EXPECT_THAT(map.bytes_ratio, DoubleEq(4));
+  EXPECT_THAT(map.selectivity, DoubleEq(1));
+  const PipelineNodeStats& source = stats[3];
+  EXPECT_THAT(source.selectivity, DoubleEq(1));
+  EXPECT_THAT(source.bytes_ratio, DoubleEq(1));
+}
+
+TEST(PipelineStatsTest, EmptyModel) {
+  EXPECT_THAT(GetPipelineStats(model::ModelProto()), SizeIs(0));
+}
+
+TEST(PipelineStatsTest, SaveAndLoad) {
+  std::string filename =
+      PipelineStatsFilename(io::JoinPath(testing::TmpDir(), "save_and_load"),
+                            /*fingerprint=*/42);
+  EXPECT_TRUE(absl::IsNotFound(
+      LoadPipelineStats(Env::Default(), filename).status()));
+
+  std::unique_ptr<model::Model> model;
+  TF_ASSERT_OK(model::Model::FromProto(MakeModel(), &model));
+  TF_ASSERT_OK(SavePipelineStats(Env::Default(), *model, filename));
+  TF_ASSERT_OK_AND_ASSIGN(model::ModelProto loaded,
+                          LoadPipelineStats(Env::Default(), filename));
+  EXPECT_THAT(GetPipelineStats(loaded), SizeIs(4));
+}
+
+// A source producing `num_elements` elements.
+model::ModelProto MakeSingleNodeModel(int64_t num_elements) {
+  model::ModelProto model;
+  AddNode(0, "TensorSlice", num_elements, 10, &model);
+  model.set_output(0);
+  return model;
+}
+
+TEST(PipelineStatsTest, DoesNotSaveShortRuns) {
+  std::string filename =
+      PipelineStatsFilename(io::JoinPath(testing::TmpDir(), "short_run"),
+                            /*fingerprint=*/42);
+  std::unique_ptr<model::Model> model;
+  TF_ASSERT_OK(model::Model::FromProto(
+      MakeSingleNodeModel(kMinPipelineStatsElements - 1), &model));
+  TF_ASSERT_OK(SavePipelineStats(Env::Default(), *model, filename));
+  EXPECT_TRUE(absl::IsNotFound(
+      LoadPipelineStats(Env::Default(), filename).status()));
+}
+
+TEST(PipelineStatsTest, DoesNotOverwriteWithShorterRun) {
+  std::string filename =
+      PipelineStatsFilename(io::JoinPath(testing::TmpDir(), "no_overwrite"),
+                            /*fingerprint=*/42);
+  std::unique_ptr<model::Model> model;
+  TF_ASSERT_OK(model::Model::FromProto(MakeModel(), &model));
+  TF_ASSERT_OK(SavePipelineStats(Env::Default(), *model, filename));
+
+  // The output of `MakeModel` produced 50 elements.
+  std::unique_ptr<model::Model> shorter_model;
+  TF_ASSERT_OK(
+      model::Model::FromProto(MakeSingleNodeModel(50), &shorter_model));
+  TF_ASSERT_OK(SavePipelineStats(Env::Default(), *shorter_model, filename));
+
+  TF_ASSERT_OK_AND_ASSIGN(model::ModelProto loaded,
+                          LoadPipelineStats(Env::Default(), filename));
+  EXPECT_THAT(GetPipelineStats(loaded), SizeIs(4));
+}
+
+TEST(PipelineStatsTest, OverwritesWithLongerRun) {
+  std::string filename =
+      PipelineStatsFilename(io::JoinPath(testing::TmpDir(), "overwrite"),
+                            /*fingerprint=*/42);
+  std::unique_ptr<model::Model> model;
+  TF_ASSERT_OK(model::Model::FromProto(MakeModel(), &model));
+  TF_ASSERT_OK(SavePipelineStats(Env::Default(), *model, filename));
+
+  std::unique_ptr<model::Model> longer_model;
+  TF_ASSERT_OK(
+      model::Model::FromProto(MakeSingleNodeModel(51), &longer_model));
+  TF_ASSERT_OK(SavePipelineStats(Env::Default(), *longer_model, filename));
+
+  TF_ASSERT_OK_AND_ASSIGN(model::ModelProto loaded,
+                          LoadPipelineStats(Env::Default(), filename));
+  EXPECT_THAT(GetPipelineStats(loaded),
+              ElementsAre(Field(&PipelineNodeStats::num_elements, 51)));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
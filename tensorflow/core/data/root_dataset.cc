@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/data/root_dataset.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -23,9 +24,17 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/log/log.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/batch_buffer_pool.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/numa_utils.h"
+#include "tensorflow/core/data/pipeline_stats.h"
 #include "tensorflow/core/data/rewrite_utils.h"
+#include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/data/unbounded_thread_pool.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -39,6 +48,10 @@ limitations under the License.
 #include "tensorflow/core/platform/stringprintf.h"
 #include "tsl/platform/host_info.h"
 
+#if !defined(IS_MOBILE_PLATFORM)
+#include "tensorflow/core/data/hash_utils.h"
+#endif  // !IS_MOBILE_PLATFORM
+
 namespace tensorflow {
 namespace data {
 namespace {
@@ -52,12 +65,16 @@ constexpr char kReadRoundtripLatency[] = "read_latency_usec";
 constexpr char kReadResponseBytes[] = "read_bytes";
 constexpr char kIntraOpParallelism[] = "intra_op_parallelism";
 constexpr char kMemBandwidth[] = "mem_bw_used_megabytes_per_sec";
+constexpr char kNumaNode[] = "numa_node";
 constexpr char kPrivateThreadpoolSize[] = "threadpool_size";
 constexpr char kRamBudget[] = "ram_budget_megabytes";
 constexpr char kRamUsage[] = "ram_usage_megabytes";
 constexpr char kMaxBufferBytes[] = "max_buffered_megabytes";
 constexpr char kWarmStart[] = "warm_start";
 
+// Free batch buffers kept for reuse beyond this are released.
+constexpr size_t kMaxFreeBatchBufferBytes = size_t{256} << 20;  // 256MB
+
 // If value `x` matches `y`, returns default value `z`. Otherwise, return `x`.
 inline int64_t value_or_default(int64_t x, int64_t y, int64_t z) {
   return x == y ? z : x;
@@ -72,6 +89,10 @@ void SetRootDatasetParams(const Options& options, RootDataset::Params* params) {
     params->private_threadpool_size =
         options.threading_options().private_threadpool_size();
   }
+  params->numa_aware = options.threading_options().numa_aware();
+  params->batch_buffer_pool = options.optional_batch_buffer_pool_case() ==
+                                  Options::kBatchBufferPool &&
+                              options.batch_buffer_pool();
   params->autotune = ShouldUseAutotuning(options);
   params->autotune_algorithm = model::AutotuneAlgorithm::DEFAULT;
   auto experiments = GetExperiments();
@@ -146,10 +167,12 @@ void AddTraceMetadata(const RootDataset::Params& params, const Options& options,
 }  // namespace
 
 // static
-absl::Status RootDataset::FromOptions(const DatasetBase* input,
-                                      DatasetBase** output) {
+absl::Status RootDataset::FromOptions(
+    const DatasetBase* input, DatasetBase** output,
+    const std::string& pipeline_stats_filename) {
   Params params;
   SetRootDatasetParams(input->options(), &params);
+  params.pipeline_stats_filename = pipeline_stats_filename;
   *output = new RootDataset(input, params);
   (*output)->Initialize(input->metadata());
   for (const auto& framework : input->options().framework_type()) {
@@ -158,13 +181,15 @@ absl::Status RootDataset::FromOptions(const DatasetBase* input,
   return absl::OkStatus();
 }
 
-absl::Status RootDataset::FromOptions(core::RefCountPtr<DatasetBase> input,
-                                      DatasetBase** output) {
+absl::Status RootDataset::FromOptions(
+    core::RefCountPtr<DatasetBase> input, DatasetBase** output,
+    const std::string& pipeline_stats_filename) {
   Params params;
   for (const auto& framework : input->options().framework_type()) {
     metrics::RecordTFDataFrameworkType(framework);
   }
   SetRootDatasetParams(input->options(), &params);
+  params.pipeline_stats_filename = pipeline_stats_filename;
   Metadata metadata = input->metadata();
   *output = new RootDataset(std::move(input), params);
   (*output)->Initialize(metadata);
@@ -180,18 +205,45 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
           value_or_default(dataset()->params_.max_intra_op_parallelism, 0,
                            port::MaxParallelism());
     }
-    if (dataset()->params_.private_threadpool_size >= 0) {
+    if (dataset()->params_.numa_aware) {
+      numa_node_ = CurrentNumaNode();
+      if (numa_node_ == port::kNUMANoAffinity) {
+        LOG_FIRST_N(WARNING, 1)
+            << "Ignoring the `numa_aware` option because the thread creating "
+               "the iterator is not bound to the CPUs of a single NUMA node.";
+      }
+    }
+    if (numa_node_ != port::kNUMANoAffinity) {
+      // The shared inter-op threads may run on any node, so functions run on a
+      // thread pool bound to the node instead.
+      threadpool_size_ = NumaThreadPoolSize(
+          dataset()->params_.private_threadpool_size, numa_node_);
+    } else if (dataset()->params_.private_threadpool_size >= 0) {
       threadpool_size_ =
           value_or_default(dataset()->params_.private_threadpool_size, 0,
                            port::MaxParallelism());
+    }
+    ThreadOptions thread_options;
+    thread_options.numa_node = numa_node_;
+    if (threadpool_size_ > 0) {
       thread_pool_ = std::make_unique<thread::ThreadPool>(
-          Env::Default(), ThreadOptions{}, "data_private_threadpool",
+          Env::Default(), thread_options, "data_private_threadpool",
           threadpool_size_);
     }
+    if (numa_node_ != port::kNUMANoAffinity) {
+      numa_thread_pool_ = std::make_unique<UnboundedThreadPool>(
+          Env::Default(), "tf_data_numa_thread_pool", thread_options);
+      numa_allocator_ = GetNumaAllocator(numa_node_);
+    }
     cancellation_manager_ = std::make_unique<CancellationManager>();
   }
 
-  ~Iterator() override { cancellation_manager_->StartCancel(); }
+  ~Iterator() override {
+    MaybeSavePipelineStats();
+    cancellation_manager_->StartCancel();
+    // Batches still referenced by the consumer keep the pool alive.
+    if (batch_buffer_pool_) batch_buffer_pool_->Close();
+  }
 
   bool SymbolicCheckpointCompatible() const override { return true; }
 
@@ -283,6 +335,10 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
           kMemBandwidth,
           absl::StrFormat("%lld", static_cast<long long>(mem_bw))));
     }
+    if (numa_node_ != port::kNUMANoAffinity) {
+      traceme_metadata.push_back(
+          std::make_pair(kNumaNode, absl::StrFormat("%d", numa_node_)));
+    }
     const auto memory_info = port::GetMemoryInfo();
     const auto memory_usage = memory_info.total - memory_info.free;
     traceme_metadata.push_back(std::make_pair(
@@ -328,7 +384,7 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
     // been set to a valid model in `Initialize()` if autotuning is on. We
     // should simply set `params.model` to `model_` here.
     params.model = model_;
-    if (dataset()->params_.private_threadpool_size >= 0) {
+    if (thread_pool_ != nullptr) {
       params.runner = [pool = thread_pool_.get()](std::function<void()> c) {
         pool->Schedule(std::move(c));
       };
@@ -338,10 +394,45 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
       params.runner =
           RunnerWithMaxParallelism(params.runner, max_intra_op_parallelism_);
     }
+    if (numa_node_ != port::kNUMANoAffinity) {
+      params.numa_node = numa_node_;
+      params.thread_factory = numa_thread_pool_->get_thread_factory();
+      params.thread_pool = numa_thread_pool_.get();
+      params.allocator_getter = NumaLocalAllocatorGetter(
+          std::move(params.allocator_getter), numa_allocator_);
+    }
+    if (dataset()->params_.batch_buffer_pool && params.allocator_getter) {
+      // Batches are usually copied to an accelerator, so they come from
+      // GPU-compatible (i.e. pinned, if there is a GPU) host memory.
+      AllocatorAttributes attrs;
+      attrs.set_gpu_compatible(true);
+      mutex_lock l(mu_);
+      if (!batch_buffer_pool_) {
+        batch_buffer_pool_.reset(new BatchBufferPool(
+            params.allocator_getter(attrs), kMaxFreeBatchBufferBytes));
+      }
+      params.batch_allocator = batch_buffer_pool_.get();
+      params.batch_allocator_attrs = attrs;
+    }
     params.options = &dataset()->options();
     return params;
   }
 
+  // Saves the statistics used by cost-based graph rewrites, if requested. The
+  // input iterators are still alive, so the model covers the whole pipeline.
+  void MaybeSavePipelineStats() {
+    const std::string& filename = dataset()->params_.pipeline_stats_filename;
+    if (filename.empty() || model_ == nullptr || node_ == nullptr ||
+        node_->num_elements() < kMinPipelineStatsElements) {
+      return;
+    }
+    absl::Status s = SavePipelineStats(Env::Default(), *model_, filename);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to save the input pipeline statistics to "
+                   << filename << ": " << s;
+    }
+  }
+
   absl::Status EnsureModelThreadStarted(IteratorContext* ctx) {
     mutex_lock l(mu_);
     if (!model_thread_) {
@@ -378,8 +469,13 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
   mutex mu_;
   std::unique_ptr<Thread> model_thread_ TF_GUARDED_BY(mu_);
   int64_t max_intra_op_parallelism_;
-  int64_t threadpool_size_;
+  int64_t threadpool_size_ = 0;
   std::unique_ptr<thread::ThreadPool> thread_pool_;
+  // The NUMA node the iterator runs on, if it is NUMA-aware.
+  int numa_node_ = port::kNUMANoAffinity;
+  std::unique_ptr<UnboundedThreadPool> numa_thread_pool_;
+  Allocator* numa_allocator_ = nullptr;  // Not owned.
+  core::RefCountPtr<BatchBufferPool> batch_buffer_pool_ TF_GUARDED_BY(mu_);
 
   // The end time of the previous `GetNextInternal` call.
   uint64_t end_time_usec_ TF_GUARDED_BY(mu_) = 0;
@@ -461,6 +557,27 @@ absl::Status RootDataset::AsGraphDefInternal(SerializationContext* ctx,
 #if !defined(IS_MOBILE_PLATFORM)
 
 namespace {
+
+constexpr char kCostBasedOptimization[] = "cost_based_optimization";
+constexpr char kStatsFilename[] = "stats_filename";
+
+// Returns the file holding the recorded statistics of `input`. It is keyed by
+// the fingerprint of the graph before any rewrite, which does not depend on
+// the contents of in-memory inputs.
+absl::StatusOr<std::string> GetPipelineStatsFilename(OpKernelContext* ctx,
+                                                     const DatasetBase* input) {
+  std::vector<std::pair<std::string, Tensor>> input_list;
+  GraphDef graph_def;
+  std::string output_node;
+  TF_RETURN_IF_ERROR(
+      AsGraphDefForRewrite(ctx, input, &input_list, &graph_def, &output_node));
+  uint64_t fingerprint = 0;
+  TF_RETURN_IF_ERROR(HashGraph(graph_def, &fingerprint));
+  return PipelineStatsFilename(
+      input->options().optimization_options().pipeline_stats_dir(),
+      fingerprint);
+}
+
 // Initialize the rewritten output dataset with the metadata from the input
 // dataset. Note: Do not override the `name` field in the metadata.
 void InitializeRewrittenDatasetMetadata(const DatasetBase* input,
@@ -488,11 +605,28 @@ absl::Status FinalizeDataset(OpKernelContext* ctx, const DatasetBase* input,
   auto optimizations =
       SelectOptimizations(experiments, optimizations_enabled,
                           optimizations_disabled, optimizations_default);
+  auto optimization_configs = CreateGraphRewriteConfigs(options);
+
+  std::string pipeline_stats_filename;
+  if (!options.optimization_options().pipeline_stats_dir().empty()) {
+    absl::StatusOr<std::string> filename =
+        GetPipelineStatsFilename(ctx, input);
+    if (filename.ok()) {
+      pipeline_stats_filename = *std::move(filename);
+      optimizations.insert(kCostBasedOptimization);
+      optimization_configs.insert(absl::StrCat(
+          kCostBasedOptimization, ":", kStatsFilename, ":",
+          pipeline_stats_filename));
+    } else {
+      LOG(WARNING) << "Cost-based optimizations are disabled because the "
+                      "input pipeline could not be fingerprinted: "
+                   << filename.status();
+    }
+  }
   if (optimizations.empty()) {
     return RootDataset::FromOptions(input, output);
   }
 
-  auto optimization_configs = CreateGraphRewriteConfigs(options);
   auto config_factory = [&optimizations, &optimization_configs]() {
     return CreateRewriterConfig(optimizations, optimization_configs);
   };
@@ -511,10 +645,11 @@ absl::Status FinalizeDataset(OpKernelContext* ctx, const DatasetBase* input,
     return s;
   }
   if (!rewritten) {
-    return RootDataset::FromOptions(input, output);
+    return RootDataset::FromOptions(input, output, pipeline_stats_filename);
   } else {
     InitializeRewrittenDatasetMetadata(input, rewritten_output.get());
-    return RootDataset::FromOptions(std::move(rewritten_output), output);
+    return RootDataset::FromOptions(std::move(rewritten_output), output,
+                                    pipeline_stats_filename);
   }
   return absl::OkStatus();
 }
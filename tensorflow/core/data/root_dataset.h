@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -42,6 +43,14 @@ class RootDataset : public DatasetBase {
     int64_t autotune_ram_budget_from_options;
     int64_t max_intra_op_parallelism = 1;
     int64_t private_threadpool_size = 0;
+    // If true, the iterator runs on the NUMA node of the thread creating it.
+    bool numa_aware = false;
+    // If true, batching transformations allocate their output from a pool of
+    // recycled buffers.
+    bool batch_buffer_pool = false;
+    // If set, the autotuning statistics of the pipeline are saved to this file
+    // when an iterator which produced elements is destroyed.
+    std::string pipeline_stats_filename;
 
     int64_t ComputeInitialAutotuneRamBudget() const {
       if (autotune_ram_budget_from_options > 0) {
@@ -52,10 +61,12 @@ class RootDataset : public DatasetBase {
     }
   };
 
-  static absl::Status FromOptions(const DatasetBase* input,
-                                  DatasetBase** output);
-  static absl::Status FromOptions(core::RefCountPtr<DatasetBase> input,
-                                  DatasetBase** output);
+  static absl::Status FromOptions(
+      const DatasetBase* input, DatasetBase** output,
+      const std::string& pipeline_stats_filename = "");
+  static absl::Status FromOptions(
+      core::RefCountPtr<DatasetBase> input, DatasetBase** output,
+      const std::string& pipeline_stats_filename = "");
 
   ~RootDataset() override;
 
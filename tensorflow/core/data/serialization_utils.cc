@@ -16,6 +16,7 @@ limitations under the License.
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -31,6 +32,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
 #include "tensorflow/core/common_runtime/graph_runner.h"
 #include "tensorflow/core/data/compression_utils.h"
@@ -58,6 +60,10 @@ constexpr char kIsDataset[] = ".is_dataset";
 constexpr char kIteratorVariantTypeName[] = "tensorflow::Iterator";
 constexpr char kOutputNode[] = ".output_node";
 
+// Tensors larger than this are only considered unchanged between checkpoints if
+// they share their buffer, to keep the comparison cheap.
+constexpr int64_t kMaxComparedBytes = 1024;
+
 absl::Status FromGraphDef(
     FunctionLibraryRuntime* flr, const GraphDef& graph_def,
     const std::vector<std::pair<std::string, Tensor>>& input_list,
@@ -105,6 +111,54 @@ absl::Status FindStatefulOps(const GraphDef& graph_def,
   return absl::OkStatus();
 }
 
+// Returns whether `a` and `b` hold the same value, as far as this can be
+// determined cheaply.
+bool SameTensor(const Tensor& a, const Tensor& b) {
+  if (a.dtype() != b.dtype() || a.shape() != b.shape()) {
+    return false;
+  }
+  if (a.NumElements() == 0) {
+    return true;
+  }
+  // Aligned slices of one tensor share its buffer at different offsets, so
+  // only the same data pointer implies the same value.
+  if (a.tensor_data().data() == b.tensor_data().data()) {
+    return true;
+  }
+  if (a.TotalBytes() > kMaxComparedBytes) {
+    return false;
+  }
+  if (DataTypeCanUseMemcpy(a.dtype())) {
+    return a.tensor_data() == b.tensor_data();
+  }
+  if (a.dtype() == DT_STRING) {
+    auto a_flat = a.flat<tstring>();
+    auto b_flat = b.flat<tstring>();
+    for (int64_t i = 0; i < a.NumElements(); ++i) {
+      if (a_flat(i) != b_flat(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+// Returns whether `a` and `b` hold the same iterator state. The metadata holds
+// the checkpoint keys, so equal metadata and tensors mean equal state.
+bool SameState(const VariantTensorData& a, const VariantTensorData& b) {
+  if (a.metadata_string() != b.metadata_string() ||
+      a.tensors_size() != b.tensors_size()) {
+    return false;
+  }
+  for (int i = 0; i < a.tensors_size(); ++i) {
+    if (!SameTensor(a.tensors(i), b.tensors(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 absl::Status ReadElementsFromCheckpoint(
@@ -495,7 +549,8 @@ std::string IteratorStateVariant::TypeName() {
   return kIteratorVariantTypeName;
 }
 
-IteratorStateVariant::IteratorStateVariant(const IteratorStateVariant& other) {
+IteratorStateVariant::IteratorStateVariant(const IteratorStateVariant& other)
+    : encoding_(other.encoding_) {
   if (other.data_) {
     data_ = std::make_unique<VariantTensorData>(*other.data_);
   }
@@ -504,29 +559,81 @@ IteratorStateVariant::IteratorStateVariant(const IteratorStateVariant& other) {
 absl::Status IteratorStateVariant::InitializeFromVariantData(
     std::unique_ptr<VariantTensorData> data) {
   data_ = std::move(data);
+  encoding_.reset();
   return absl::OkStatus();
 }
 
 void IteratorStateVariant::Encode(VariantTensorData* data) const {
+  if (encoding_) {
+    encoding_->done.WaitForNotification();
+    *data = encoding_->data;
+    return;
+  }
+  EncodeData(*data_, data);
+}
+
+void IteratorStateVariant::EncodeAsync(
+    std::function<void(std::function<void()>)> runner) {
+  // Encodes the state when run. If `runner` drops the task without running
+  // it, e.g. because its thread pool was destroyed first, the state is encoded
+  // when the task is destroyed instead, so that `Encode` never waits forever.
+  class EncodeTask {
+   public:
+    EncodeTask(const VariantTensorData& data,
+               std::shared_ptr<Encoding> encoding)
+        : data_(data), encoding_(std::move(encoding)) {}
+    ~EncodeTask() { Run(); }
+
+    void Run() {
+      if (encoding_->done.HasBeenNotified()) {
+        return;
+      }
+      EncodeData(data_, &encoding_->data);
+      encoding_->done.Notify();
+    }
+
+   private:
+    const VariantTensorData data_;
+    const std::shared_ptr<Encoding> encoding_;
+  };
+
+  auto encoding = std::make_shared<Encoding>();
+  encoding_ = encoding;
+  auto task = std::make_shared<EncodeTask>(*data_, std::move(encoding));
+  runner([task = std::move(task)]() { task->Run(); });
+}
+
+bool IteratorStateVariant::ReuseEncoding(const IteratorStateVariant& other) {
+  if (!data_ || !other.data_ || !other.encoding_ ||
+      !SameState(*data_, *other.data_)) {
+    return false;
+  }
+  encoding_ = other.encoding_;
+  return true;
+}
+
+void IteratorStateVariant::EncodeData(const VariantTensorData& data,
+                                      VariantTensorData* encoded) {
   CompressedElement compressed_tensors;
-  absl::Status s = CompressElement(data_->tensors(), &compressed_tensors);
+  absl::Status s = CompressElement(data.tensors(), &compressed_tensors);
   if (!s.ok()) {
     LOG(WARNING) << "Failed to compress iterator state variant: " << s;
-    *data = *data_;
+    *encoded = data;
     return;
   }
 
-  data->set_type_name(TypeName());
-  data->set_metadata(data_->metadata_string());
+  encoded->set_type_name(TypeName());
+  encoded->set_metadata(data.metadata_string());
   Tensor tensor(DT_VARIANT, TensorShape({}));
   tensor.scalar<Variant>()() = std::move(compressed_tensors);
-  *data->add_tensors() = std::move(tensor);
+  *encoded->add_tensors() = std::move(tensor);
 }
 
 bool IteratorStateVariant::Decode(VariantTensorData data) {
   if (data.type_name() != TypeName()) {
     return false;
   }
+  encoding_.reset();
 
   const CompressedElement* compressed = GetCompressedElement(data);
   if (!compressed) {
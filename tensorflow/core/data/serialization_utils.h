@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -29,6 +30,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
 #include "xla/tsl/platform/statusor.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset.pb.h"
@@ -201,6 +203,18 @@ class IteratorStateVariant {
   // compression fails.
   void Encode(VariantTensorData* data) const;
 
+  // Starts encoding this `IteratorStateVariant` using `runner`, so that
+  // `Encode` only has to wait for the result. The tensors of the state are
+  // refcounted and never mutated by iterators, so the encoding works on a
+  // snapshot of the state while iteration continues.
+  void EncodeAsync(std::function<void(std::function<void()>)> runner);
+
+  // Shares the (possibly pending) encoding of `other` if it was started by
+  // `EncodeAsync` and both hold the same iterator state, e.g. the state of a
+  // shuffle buffer which did not change between two checkpoints. Returns
+  // whether the encoding was reused.
+  bool ReuseEncoding(const IteratorStateVariant& other);
+
   // Decodes from `data`. If `data` contains a single scalar `CompressedElement`
   // tensor, it is assumed to be compressed by `Encode`, and will be
   // uncompressed as part of `Decode`.
@@ -214,7 +228,18 @@ class IteratorStateVariant {
   static const CompressedElement* GetCompressedElement(
       const VariantTensorData& data);
 
+  // Compresses `data` into `*encoded`, as described in `Encode`.
+  static void EncodeData(const VariantTensorData& data,
+                         VariantTensorData* encoded);
+
+  // The result of `EncodeAsync`, shared by the copies of this variant.
+  struct Encoding {
+    absl::Notification done;
+    VariantTensorData data;
+  };
+
   std::unique_ptr<VariantTensorData> data_;
+  std::shared_ptr<const Encoding> encoding_;
 };
 
 // Returns a GraphDef representation of the given dataset.
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/data/serialization_utils.h"
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -212,6 +213,20 @@ class ParameterizedIteratorStateVariantTest
     return *decoder.GetData();
   }
 
+  absl::StatusOr<VariantTensorData> EncodeAsyncAndDecode(
+      const VariantTensorData& data) const {
+    IteratorStateVariant encoder;
+    TF_RETURN_IF_ERROR(encoder.InitializeFromVariantData(
+        std::make_unique<VariantTensorData>(data)));
+    encoder.EncodeAsync([](std::function<void()> fn) { fn(); });
+    VariantTensorData encoded_data;
+    encoder.Encode(&encoded_data);
+
+    IteratorStateVariant decoder;
+    decoder.Decode(encoded_data);
+    return *decoder.GetData();
+  }
+
   absl::StatusOr<VariantTensorData> DecodeUncompressed(
       const VariantTensorData& data) const {
     IteratorStateVariant decoder;
@@ -265,6 +280,18 @@ TEST_P(ParameterizedIteratorStateVariantTest, EncodeAndDecode) {
   }
 }
 
+TEST_P(ParameterizedIteratorStateVariantTest, EncodeAsyncAndDecode) {
+  VariantTensorData data = GetVariantTensorData();
+  TF_ASSERT_OK_AND_ASSIGN(VariantTensorData result,
+                          EncodeAsyncAndDecode(data));
+
+  EXPECT_EQ(result.type_name(), data.type_name());
+  ASSERT_EQ(result.tensors_size(), data.tensors_size());
+  for (int i = 0; i < result.tensors_size(); ++i) {
+    test::ExpectEqual(result.tensors(i), data.tensors(i));
+  }
+}
+
 TEST_P(ParameterizedIteratorStateVariantTest, DecodeUncompressed) {
   VariantTensorData data = GetVariantTensorData();
   TF_ASSERT_OK_AND_ASSIGN(VariantTensorData result, DecodeUncompressed(data));
@@ -275,6 +302,125 @@ TEST_P(ParameterizedIteratorStateVariantTest, DecodeUncompressed) {
   }
 }
 
+TEST(IteratorStateVariantTest, EncodeAfterRunnerDropsTask) {
+  std::vector<std::vector<Tensor>> elements = {
+      {CreateTensor<int64_t>(TensorShape{256})}};
+  VariantTensorDataWriter writer;
+  TF_ASSERT_OK(WriteElementsToCheckpoint(&writer, "buffer", elements));
+  std::vector<std::unique_ptr<VariantTensorData>> data;
+  writer.ReleaseData(&data);
+  ASSERT_EQ(data.size(), 1);
+
+  IteratorStateVariant encoder;
+  TF_ASSERT_OK(encoder.InitializeFromVariantData(std::move(data[0])));
+  // Mimics a thread pool which is destroyed with pending work, like the one of
+  // an iterator resource destroyed before its checkpoint is written.
+  encoder.EncodeAsync([](std::function<void()> fn) {});
+  VariantTensorData encoded_data;
+  encoder.Encode(&encoded_data);
+
+  IteratorStateVariant decoder;
+  decoder.Decode(encoded_data);
+  ASSERT_EQ(decoder.GetData()->tensors_size(),
+            encoder.GetData()->tensors_size());
+  for (int i = 0; i < decoder.GetData()->tensors_size(); ++i) {
+    test::ExpectEqual(decoder.GetData()->tensors(i),
+                      encoder.GetData()->tensors(i));
+  }
+}
+
+TEST(IteratorStateVariantTest, ReuseEncodingOfUnchangedState) {
+  std::vector<std::vector<Tensor>> elements = {
+      {CreateTensor<int64_t>(TensorShape{256})},
+      {CreateTensor<int64_t>(TensorShape{256})}};
+  std::vector<std::unique_ptr<VariantTensorData>> data;
+  for (int i = 0; i < 2; ++i) {
+    VariantTensorDataWriter writer;
+    TF_ASSERT_OK(WriteElementsToCheckpoint(&writer, "buffer", elements));
+    writer.ReleaseData(&data);
+  }
+  ASSERT_EQ(data.size(), 2);
+
+  IteratorStateVariant previous;
+  TF_ASSERT_OK(previous.InitializeFromVariantData(std::move(data[0])));
+  previous.EncodeAsync([](std::function<void()> fn) { fn(); });
+  IteratorStateVariant current;
+  TF_ASSERT_OK(current.InitializeFromVariantData(std::move(data[1])));
+  EXPECT_TRUE(current.ReuseEncoding(previous));
+
+  VariantTensorData encoded_data;
+  current.Encode(&encoded_data);
+  IteratorStateVariant decoder;
+  decoder.Decode(encoded_data);
+  ASSERT_EQ(decoder.GetData()->tensors_size(),
+            previous.GetData()->tensors_size());
+  for (int i = 0; i < decoder.GetData()->tensors_size(); ++i) {
+    test::ExpectEqual(decoder.GetData()->tensors(i),
+                      previous.GetData()->tensors(i));
+  }
+}
+
+TEST(IteratorStateVariantTest, DoNotReuseEncodingOfChangedState) {
+  std::vector<std::vector<Tensor>> elements = {
+      {CreateTensor<int64_t>(TensorShape{256})}};
+  VariantTensorDataWriter writer;
+  TF_ASSERT_OK(WriteElementsToCheckpoint(&writer, "buffer", elements));
+  std::vector<std::unique_ptr<VariantTensorData>> data;
+  writer.ReleaseData(&data);
+  elements[0] = {CreateTensor<int64_t>(TensorShape{256})};
+  TF_ASSERT_OK(WriteElementsToCheckpoint(&writer, "buffer", elements));
+  writer.ReleaseData(&data);
+  ASSERT_EQ(data.size(), 2);
+
+  IteratorStateVariant previous;
+  TF_ASSERT_OK(previous.InitializeFromVariantData(std::move(data[0])));
+  previous.EncodeAsync([](std::function<void()> fn) { fn(); });
+  IteratorStateVariant current;
+  TF_ASSERT_OK(current.InitializeFromVariantData(std::move(data[1])));
+  EXPECT_FALSE(current.ReuseEncoding(previous));
+}
+
+TEST(IteratorStateVariantTest, DoNotReuseEncodingOfOtherSlice) {
+  // Slices of one tensor share its buffer, like the elements produced by
+  // `from_tensor_slices`. They are too large to be compared by value.
+  Tensor root(DT_INT64, TensorShape{2, 256});
+  for (int64_t i = 0; i < root.NumElements(); ++i) {
+    root.flat<int64_t>()(i) = i;
+  }
+  std::vector<std::unique_ptr<VariantTensorData>> data;
+  for (int i = 0; i < 2; ++i) {
+    std::vector<std::vector<Tensor>> elements = {{root.Slice(i, i + 1)}};
+    VariantTensorDataWriter writer;
+    TF_ASSERT_OK(WriteElementsToCheckpoint(&writer, "buffer", elements));
+    writer.ReleaseData(&data);
+  }
+  ASSERT_EQ(data.size(), 2);
+
+  IteratorStateVariant previous;
+  TF_ASSERT_OK(previous.InitializeFromVariantData(std::move(data[0])));
+  previous.EncodeAsync([](std::function<void()> fn) { fn(); });
+  IteratorStateVariant current;
+  TF_ASSERT_OK(current.InitializeFromVariantData(std::move(data[1])));
+  EXPECT_FALSE(current.ReuseEncoding(previous));
+}
+
+TEST(IteratorStateVariantTest, DoNotReuseEncodingWithoutEncodeAsync) {
+  std::vector<std::vector<Tensor>> elements = {
+      CreateTensors<int64_t>(TensorShape{1}, {{1}})};
+  std::vector<std::unique_ptr<VariantTensorData>> data;
+  for (int i = 0; i < 2; ++i) {
+    VariantTensorDataWriter writer;
+    TF_ASSERT_OK(WriteElementsToCheckpoint(&writer, "buffer", elements));
+    writer.ReleaseData(&data);
+  }
+
+  IteratorStateVariant previous;
+  TF_ASSERT_OK(previous.InitializeFromVariantData(std::move(data[0])));
+  IteratorStateVariant current;
+  TF_ASSERT_OK(current.InitializeFromVariantData(std::move(data[1])));
+  EXPECT_FALSE(current.ReuseEncoding(previous));
+}
+
 TEST_P(ParemeterizedCheckpointIndicesTest,
        CheckpointElementsRoundTripUsingIndices) {
   std::vector<std::vector<Tensor>> elements;
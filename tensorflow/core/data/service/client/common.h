@@ -42,6 +42,9 @@ struct DataServiceParams final {
   TargetWorkers target_workers = TargetWorkers::TARGET_WORKERS_UNSPECIFIED;
   DataServiceMetadata metadata;
   std::optional<CrossTrainerCacheOptions> cross_trainer_cache_options;
+  // Whether uncoordinated reads favor workers on the same host and with less
+  // load. If false, tasks are read round-robin.
+  bool load_aware_task_selection = false;
 };
 
 }  // namespace data
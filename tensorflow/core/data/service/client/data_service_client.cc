@@ -48,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/worker.pb.h"
 #include "tensorflow/core/data/service/worker_client.h"
 #include "tensorflow/core/data/service/worker_impl.h"
+#include "tensorflow/core/data/service/worker_load.h"
 #include "tensorflow/core/data/utils.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -56,6 +57,7 @@ limitations under the License.
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/host_info.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
@@ -87,6 +89,14 @@ absl::StatusOr<DataTransferServerInfo> GetTransferServer(
                                           task_info.worker_address(), "'."));
 }
 
+bool IsSameHostTask(const TaskInfo& task) {
+  static const std::string* const kHostname =
+      new std::string(port::Hostname());
+  return LocalWorkers::Get(task.worker_address()) != nullptr ||
+         (!task.worker_load().host().empty() &&
+          task.worker_load().host() == *kHostname);
+}
+
 }  // namespace
 
 DataServiceClient::DataServiceClient(const DataServiceParams& params)
@@ -440,6 +450,8 @@ absl::Status DataServiceClient::AddTask(const TaskInfo& task_info)
       worker->GetDataTransferProtocol(),
       /*user_specified=*/!params_.data_transfer_protocol.empty());
   tasks_.push_back(std::make_shared<Task>(task_info, std::move(worker)));
+  tasks_.back()->read_weight =
+      TaskReadWeight(task_info, IsSameHostTask(task_info));
   worker_thread_cv_.notify_one();
   if (IsCoordinatedRead()) {
     VLOG(1) << "Consumer " << params_.consumer_index.value() << " adding task "
@@ -509,10 +521,13 @@ void DataServiceClient::UpdateTasks(const ClientHeartbeatResponse& resp)
   int index = 0;
   while (index < tasks_.size()) {
     std::shared_ptr<Task> task = tasks_[index];
-    if (task_id_to_task.contains(task->info.task_id())) {
+    auto it = task_id_to_task.find(task->info.task_id());
+    if (it != task_id_to_task.end()) {
+      task->read_weight =
+          TaskReadWeight(it->second, IsSameHostTask(it->second));
       // Remove already-known tasks from `task_id_to_task`, so that at the
       // end of the loop, only new tasks remain.
-      task_id_to_task.erase(task->info.task_id());
+      task_id_to_task.erase(it);
       ++index;
     } else {
       // Task has been removed.
@@ -733,6 +748,9 @@ std::shared_ptr<DataServiceClient::Task> DataServiceClient::GetTaskToProcess()
   if (!ShouldProcessTask()) {
     return nullptr;
   }
+  if (!IsCoordinatedRead() && params_.load_aware_task_selection) {
+    return GetWeightedTaskToProcess();
+  }
 
   for (int i = 0; i < tasks_.size(); ++i) {
     std::shared_ptr<Task>& task = tasks_[next_task_index_];
@@ -764,6 +782,33 @@ std::shared_ptr<DataServiceClient::Task> DataServiceClient::GetTaskToProcess()
   return nullptr;
 }
 
+// Smooth weighted round-robin: every available task accumulates its weight,
+// and the task with the most accumulated weight is picked and pays back the
+// total. Each task is picked in proportion to its weight, interleaved rather
+// than in bursts, and a task that is busy does not accumulate weight.
+std::shared_ptr<DataServiceClient::Task>
+DataServiceClient::GetWeightedTaskToProcess() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::shared_ptr<Task> selected;
+  double total_weight = 0.0;
+  for (const std::shared_ptr<Task>& task : tasks_) {
+    if (task->in_use || task->end_of_sequence || task->removed) {
+      continue;
+    }
+    task->accumulated_weight += task->read_weight;
+    total_weight += task->read_weight;
+    if (selected == nullptr ||
+        task->accumulated_weight > selected->accumulated_weight) {
+      selected = task;
+    }
+  }
+  if (selected != nullptr) {
+    selected->accumulated_weight -= total_weight;
+    VLOG(3) << "Selected task " << selected->info.task_id()
+            << " with read weight " << selected->read_weight;
+  }
+  return selected;
+}
+
 // Increments the next task index, starting over if all tasks have been
 // processed.
 void DataServiceClient::AdvanceTaskIndex() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -118,6 +118,12 @@ class DataServiceClient {
     // Number of retries. The more it is retried, the longer it should wait
     // before the next retry.
     int64_t num_retries = 0;
+    // Relative rate at which to read from the task when reads are not
+    // coordinated, refreshed from the worker load on every heartbeat.
+    double read_weight TF_GUARDED_BY(&DataServiceClient::mu_) = 1.0;
+    // Weight accumulated since the task was last picked, see
+    // `GetWeightedTaskToProcess`.
+    double accumulated_weight TF_GUARDED_BY(&DataServiceClient::mu_) = 0.0;
   };
 
   struct Result {
@@ -180,6 +186,9 @@ class DataServiceClient {
   // Searches for a task to process, visiting tasks in-order and giving every
   // task a chance to proceed.
   std::shared_ptr<Task> GetTaskToProcess();
+  // Picks a task to process for uncoordinated reads, reading from each task
+  // in proportion to its `read_weight`.
+  std::shared_ptr<Task> GetWeightedTaskToProcess();
   void AdvanceTaskIndex();
   absl::Status TryGetElement(const Task& task, bool allow_skip,
                              GetElementResult& result);
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/service/client/data_service_client.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -36,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/protobuf/data_service.pb.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
@@ -236,6 +238,60 @@ TEST(DataServiceClientTest, ValidationError) {
               "Local reads require local tf.data workers, but no local worker "
               "is found.")));
 }
+
+// Measures the tail latency of `GetNext` when some workers are slow to serve
+// elements. Args: number of slow workers (out of 4), and whether the client
+// steers reads by worker load.
+void BM_TailFetchLatency(::testing::benchmark::State& state) {
+  const int num_slow_workers = state.range(0);
+  const bool load_aware = state.range(1);
+  TestCluster::Config config;
+  config.num_workers = 4;
+  config.worker_heartbeat_interval_ms = 100;
+  TestCluster test_cluster(config);
+  TF_CHECK_OK(test_cluster.Initialize());
+  for (int i = 0; i < num_slow_workers; ++i) {
+    TF_CHECK_OK(
+        test_cluster.SetWorkerGetElementDelay(i, absl::Milliseconds(20)));
+  }
+  DatasetClient<int64_t> dataset_client(test_cluster);
+  const std::string dataset_id =
+      dataset_client.RegisterDataset(RangeDataset(1 << 30)).value();
+
+  DataServiceParams params = GetDataServiceParams(
+      dataset_id, test_cluster.DispatcherAddress(), ProcessingModeDef::OFF);
+  params.max_outstanding_requests = 4;
+  params.load_aware_task_selection = load_aware;
+  DataServiceClient client(params);
+  TF_CHECK_OK(client.Initialize(/*accelerator_device_info=*/nullptr,
+                                /*allocator=*/nullptr));
+  // Reads until workers have reported their load to the client.
+  const absl::Time warmup_end = absl::Now() + absl::Milliseconds(500);
+  while (absl::Now() < warmup_end) {
+    TF_CHECK_OK(GetNext<int64_t>(client).status());
+  }
+
+  std::vector<double> latencies_us;
+  for (auto s : state) {
+    const absl::Time start = absl::Now();
+    TF_CHECK_OK(GetNext<int64_t>(client).status());
+    latencies_us.push_back(absl::ToDoubleMicroseconds(absl::Now() - start));
+  }
+  client.Cancel();
+  std::sort(latencies_us.begin(), latencies_us.end());
+  state.counters["p50_us"] = latencies_us[latencies_us.size() / 2];
+  state.counters["p99_us"] = latencies_us[latencies_us.size() * 99 / 100];
+}
+
+BENCHMARK(BM_TailFetchLatency)
+    ->UseRealTime()
+    ->ArgPair(0, 0)
+    ->ArgPair(0, 1)
+    ->ArgPair(1, 0)
+    ->ArgPair(1, 1)
+    ->ArgPair(2, 0)
+    ->ArgPair(2, 1);
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -15,18 +15,25 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/byte_size.h"
+#include "tensorflow/core/data/service/disk_ring_log.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
@@ -46,6 +53,12 @@ namespace data {
 // collected when the cache becomes full. Consequently, trainers read from a
 // sliding window through the dataset and may not read the full dataset.
 //
+// Optionally, elements evicted from memory are spilled to a bounded log on
+// local disk, which serves trainers lagging behind the memory window. This
+// widens the window by the disk budget, so trainers of different speeds can
+// share the cache without skipping data. Spilling requires the sequence to
+// implement `SerializeElement` and `DeserializeElement`.
+//
 // The `CrossTrainerCache` class is thread-safe.
 //
 // Example usage:
@@ -89,6 +102,43 @@ class CachableSequence {
 
   // Returns the estimated size of the element in bytes.
   virtual size_t GetElementSizeBytes(const ElementType&) const = 0;
+
+  // Serializes `element` for the disk tier of the cache. Sequences which do
+  // not support spilling keep the default, and their cache stays in memory.
+  virtual absl::Status SerializeElement(const ElementType& element,
+                                        std::string& out) const {
+    return absl::UnimplementedError(
+        "The cachable sequence does not support spilling to disk.");
+  }
+
+  // Parses an element serialized by `SerializeElement`. It may be called
+  // concurrently with `GetNext`.
+  virtual StatusOr<ElementType> DeserializeElement(
+      absl::string_view data) const {
+    return absl::UnimplementedError(
+        "The cachable sequence does not support spilling to disk.");
+  }
+};
+
+// Configures the disk tier of a `CrossTrainerCache`.
+struct CrossTrainerCacheDiskTierOptions {
+  // Local directory for spilled elements. If empty, the cache only uses
+  // memory.
+  std::string directory;
+  // Maximum size in bytes of the spilled elements.
+  int64_t max_size_bytes = 0;
+};
+
+// Per-tier query counts of a `CrossTrainerCache`.
+struct CrossTrainerCacheTierStats {
+  // Elements read from memory which another trainer had produced.
+  int64_t memory_hits = 0;
+  // Elements read from the disk tier.
+  int64_t disk_hits = 0;
+  // Elements the reading trainer had to produce.
+  int64_t misses = 0;
+  // Elements skipped by trainers because they had been evicted from all tiers.
+  int64_t skipped_elements = 0;
 };
 
 // Sliding-window cache shared across concurrent trainers.
@@ -101,6 +151,15 @@ class CrossTrainerCache {
   explicit CrossTrainerCache(
       size_t max_cache_size_bytes,
       std::unique_ptr<CachableSequence<ElementType>> cachable_sequence);
+  // Creates a `CrossTrainerCache` which spills elements evicted from memory to
+  // local disk as configured by `disk_tier_options`. If the disk tier cannot be
+  // created, the cache logs a warning and only uses memory. Only trainers which
+  // fall behind the memory window read from disk; new trainers start at the
+  // oldest element in memory.
+  CrossTrainerCache(
+      size_t max_cache_size_bytes,
+      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+      const CrossTrainerCacheDiskTierOptions& disk_tier_options);
   virtual ~CrossTrainerCache() = default;
   CrossTrainerCache(const CrossTrainerCache&) = delete;
   CrossTrainerCache& operator=(const CrossTrainerCache&) = delete;
@@ -120,10 +179,14 @@ class CrossTrainerCache {
   // Returns true if the cache has been cancelled.
   bool IsCancelled() const;
 
+  // Returns the number of queries served by each tier.
+  CrossTrainerCacheTierStats GetTierStats() const;
+
  private:
   struct CacheQueryResult {
     std::shared_ptr<const ElementType> element;
     bool cache_hit;
+    bool from_disk = false;
   };
 
   // Returns the next element and metrics about this query.
@@ -135,9 +198,22 @@ class CrossTrainerCache {
   bool IsElementReady(const std::string& trainer_id);
 
   // Returns the absolute element index relative to the dataset (not relative to
-  // the cached elements).
+  // the cached elements). Registers new trainers at `cache_start_index_`, and
+  // moves trainers whose next element has been evicted from all tiers to the
+  // oldest cached element.
   size_t GetElementIndex(const std::string& trainer_id);
 
+  // Returns the index of the oldest element in either tier.
+  size_t GetFirstCachedIndex() const;
+
+  // Reads element `element_index` from the disk tier.
+  StatusOr<std::shared_ptr<const ElementType>> ReadFromDisk(
+      const std::shared_ptr<DiskRingLog>& disk_tier, size_t element_index);
+
+  // Writes the elements `FreeSpace` is about to evict to the disk tier. Only
+  // the thread extending the cache may call this.
+  void SpillElements(size_t new_element_size_bytes);
+
   // Returns the next element for `trainer_id`.
   StatusOr<std::shared_ptr<const ElementType>> GetElement(
       const std::string& trainer_id);
@@ -173,6 +249,12 @@ class CrossTrainerCache {
   // True if one thread is extending the cache.
   bool extending_cache_ TF_GUARDED_BY(mu_) = false;
 
+  // Disk tier holding elements evicted from `cache_`, or nullptr if spilling
+  // is disabled or has failed. Its records use absolute element indices and,
+  // once the extending thread has spilled, end where `cache_` starts.
+  std::shared_ptr<DiskRingLog> disk_tier_ TF_GUARDED_BY(mu_);
+  CrossTrainerCacheTierStats tier_stats_ TF_GUARDED_BY(mu_);
+
   // Maps trainer IDs to element indices. The indices are absolute indices
   // within the dataset. The actual index to use with `cache_` would be
   // `trainer_to_element_index_map_[trainer_id] - cache_start_index_`.
@@ -192,6 +274,33 @@ CrossTrainerCache<ElementType>::CrossTrainerCache(
           << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
 }
 
+template <class ElementType>
+CrossTrainerCache<ElementType>::CrossTrainerCache(
+    size_t max_cache_size_bytes,
+    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+    const CrossTrainerCacheDiskTierOptions& disk_tier_options)
+    : CrossTrainerCache(max_cache_size_bytes, std::move(cachable_sequence)) {
+  if (disk_tier_options.directory.empty()) {
+    return;
+  }
+  DiskRingLog::Options options;
+  options.directory = disk_tier_options.directory;
+  options.max_size_bytes = disk_tier_options.max_size_bytes;
+  StatusOr<std::unique_ptr<DiskRingLog>> disk_tier =
+      DiskRingLog::Create(Env::Default(), options);
+  if (!disk_tier.ok()) {
+    LOG(WARNING) << "Failed to create the disk tier of the tf.data service "
+                 << "cross-trainer cache; only memory will be used: "
+                 << disk_tier.status();
+    return;
+  }
+  mutex_lock l(mu_);
+  disk_tier_ = std::move(*disk_tier);
+  VLOG(2) << "Initialized tf.data service cross-trainer cache disk tier with "
+          << ByteSize::Bytes(disk_tier_options.max_size_bytes) << " in "
+          << disk_tier_options.directory << ".";
+}
+
 template <class ElementType>
 StatusOr<std::shared_ptr<const ElementType>>
 CrossTrainerCache<ElementType>::Get(const std::string& trainer_id)
@@ -212,9 +321,12 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
     const std::string& trainer_id) {
   bool should_extend_cache = false;
   while (true) {
+    std::shared_ptr<DiskRingLog> disk_tier;
+    size_t disk_element_index = 0;
     {
       mutex_lock l(mu_);
       TF_RETURN_IF_ERROR(status_);
+      const size_t element_index = GetElementIndex(trainer_id);
       if (IsElementReady(trainer_id)) {
         TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
                             GetElement(trainer_id));
@@ -222,10 +334,16 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
                                 /*is_cache_hit=*/!should_extend_cache};
       }
 
-      // Extends the cache or waits for another thread to extend the cache. When
-      // concurrent trainers wait for the next element, only one of them should
-      // extend the cache.
-      if (extending_cache_) {
+      // Elements before the memory window are read from the disk tier without
+      // holding the lock.
+      if (element_index < cache_start_index_) {
+        disk_tier = disk_tier_;
+        disk_element_index = element_index;
+        trainer_to_element_index_map_[trainer_id] = element_index + 1;
+      } else if (extending_cache_) {
+        // Extends the cache or waits for another thread to extend the cache.
+        // When concurrent trainers wait for the next element, only one of them
+        // should extend the cache.
         should_extend_cache = false;
         cv_.wait(l);
       } else {
@@ -234,6 +352,23 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
       }
     }
 
+    if (disk_tier != nullptr) {
+      StatusOr<std::shared_ptr<const ElementType>> element =
+          ReadFromDisk(disk_tier, disk_element_index);
+      if (element.ok()) {
+        return CacheQueryResult{*element, /*is_cache_hit=*/true,
+                                /*from_disk=*/true};
+      }
+      // The element has been evicted from disk since the lookup, or could not
+      // be read. Either way the trainer moves on to the next cached element.
+      if (!absl::IsOutOfRange(element.status())) {
+        LOG(WARNING) << "Failed to read element " << disk_element_index
+                     << " from the tf.data service cross-trainer cache disk "
+                     << "tier: " << element.status();
+      }
+      continue;
+    }
+
     if (should_extend_cache) {
       absl::Status s = ExtendCache();
       mutex_lock l(mu_);
@@ -247,7 +382,9 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
 template <class ElementType>
 bool CrossTrainerCache<ElementType>::IsElementReady(
     const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-  return GetElementIndex(trainer_id) < cache_start_index_ + cache_.size();
+  const size_t element_index = GetElementIndex(trainer_id);
+  return element_index >= cache_start_index_ &&
+         element_index < cache_start_index_ + cache_.size();
 }
 
 template <class ElementType>
@@ -270,11 +407,42 @@ CrossTrainerCache<ElementType>::GetElement(const std::string& trainer_id)
 template <class ElementType>
 size_t CrossTrainerCache<ElementType>::GetElementIndex(
     const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-  size_t element_index = trainer_to_element_index_map_[trainer_id];
-  if (element_index < cache_start_index_) {
-    element_index = cache_start_index_;
+  // New trainers start at the memory window. Only known trainers that have
+  // fallen behind it read from the disk tier.
+  auto it =
+      trainer_to_element_index_map_.try_emplace(trainer_id, cache_start_index_)
+          .first;
+  const size_t first_cached_index = GetFirstCachedIndex();
+  if (it->second < first_cached_index) {
+    // Records the skip once by moving the trainer past the evicted elements.
+    tier_stats_.skipped_elements += first_cached_index - it->second;
+    it->second = first_cached_index;
   }
-  return element_index;
+  return it->second;
+}
+
+template <class ElementType>
+size_t CrossTrainerCache<ElementType>::GetFirstCachedIndex() const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (disk_tier_ == nullptr) {
+    return cache_start_index_;
+  }
+  const int64_t disk_start_index = disk_tier_->start_index();
+  if (disk_start_index == disk_tier_->end_index()) {
+    return cache_start_index_;
+  }
+  return std::min(cache_start_index_, static_cast<size_t>(disk_start_index));
+}
+
+template <class ElementType>
+StatusOr<std::shared_ptr<const ElementType>>
+CrossTrainerCache<ElementType>::ReadFromDisk(
+    const std::shared_ptr<DiskRingLog>& disk_tier, size_t element_index)
+    TF_LOCKS_EXCLUDED(mu_) {
+  TF_ASSIGN_OR_RETURN(std::string data, disk_tier->Read(element_index));
+  TF_ASSIGN_OR_RETURN(ElementType element,
+                      cachable_sequence_->DeserializeElement(data));
+  return std::make_shared<const ElementType>(std::move(element));
 }
 
 template <class ElementType>
@@ -290,6 +458,7 @@ absl::Status CrossTrainerCache<ElementType>::ExtendCache()
         " and cache size: ", max_cache_size_bytes_));
   }
 
+  SpillElements(new_element_size_bytes);
   mutex_lock l(mu_);
   TF_RETURN_IF_ERROR(status_);
   FreeSpace(new_element_size_bytes);
@@ -317,6 +486,48 @@ void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
           << ByteSize::Bytes(cache_size_bytes_) << ".";
 }
 
+template <class ElementType>
+void CrossTrainerCache<ElementType>::SpillElements(
+    size_t new_element_size_bytes) TF_LOCKS_EXCLUDED(mu_) {
+  // Only the extending thread modifies `cache_`, so the elements collected here
+  // are the ones `FreeSpace` evicts next. They stay readable from memory while
+  // they are written.
+  std::shared_ptr<DiskRingLog> disk_tier;
+  std::vector<std::shared_ptr<const ElementType>> elements;
+  size_t first_index = 0;
+  {
+    mutex_lock l(mu_);
+    if (disk_tier_ == nullptr) {
+      return;
+    }
+    disk_tier = disk_tier_;
+    first_index = cache_start_index_;
+    size_t cache_size_bytes = cache_size_bytes_;
+    for (const std::shared_ptr<const ElementType>& element : cache_) {
+      if (cache_size_bytes + new_element_size_bytes <= max_cache_size_bytes_) {
+        break;
+      }
+      elements.push_back(element);
+      cache_size_bytes -= cachable_sequence_->GetElementSizeBytes(*element);
+    }
+  }
+
+  for (size_t i = 0; i < elements.size(); ++i) {
+    std::string data;
+    absl::Status s = cachable_sequence_->SerializeElement(*elements[i], data);
+    if (s.ok()) {
+      s = disk_tier->Append(first_index + i, data);
+    }
+    if (!s.ok()) {
+      LOG(WARNING) << "Disabling the disk tier of the tf.data service "
+                   << "cross-trainer cache: " << s;
+      mutex_lock l(mu_);
+      disk_tier_.reset();
+      return;
+    }
+  }
+}
+
 template <class ElementType>
 void CrossTrainerCache<ElementType>::Cancel(absl::Status status)
     TF_LOCKS_EXCLUDED(mu_) {
@@ -341,12 +552,33 @@ template <class ElementType>
 void CrossTrainerCache<ElementType>::RecordMetrics(
     const CacheQueryResult& result) {
   metrics::RecordTFDataServiceCrossTrainerCacheQuery(result.cache_hit);
+  metrics::RecordTFDataServiceCrossTrainerCacheTierQuery(
+      result.from_disk ? "disk" : (result.cache_hit ? "memory" : "miss"));
   size_t cache_size_bytes = 0;
+  int64_t disk_size_bytes = 0;
   {
     mutex_lock l(mu_);
     cache_size_bytes = cache_size_bytes_;
+    if (disk_tier_ != nullptr) {
+      disk_size_bytes = disk_tier_->size_bytes();
+    }
+    if (result.from_disk) {
+      ++tier_stats_.disk_hits;
+    } else if (result.cache_hit) {
+      ++tier_stats_.memory_hits;
+    } else {
+      ++tier_stats_.misses;
+    }
   }
   metrics::RecordTFDataServiceCrossTrainerCacheSizeBytes(cache_size_bytes);
+  metrics::RecordTFDataServiceCrossTrainerCacheDiskSizeBytes(disk_size_bytes);
+}
+
+template <class ElementType>
+CrossTrainerCacheTierStats CrossTrainerCache<ElementType>::GetTierStats() const
+    TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  return tier_stats_;
 }
 
 }  // namespace data
@@ -22,7 +22,9 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
@@ -61,6 +63,25 @@ class InfiniteRange : public CachableSequence<int64_t> {
   int64_t next_ = 0;
 };
 
+// An `InfiniteRange` which can be spilled to disk.
+class SpillableInfiniteRange : public InfiniteRange {
+ public:
+  absl::Status SerializeElement(const int64_t& element,
+                                std::string& out) const override {
+    out = absl::StrCat(element);
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<int64_t> DeserializeElement(
+      absl::string_view data) const override {
+    int64_t element = 0;
+    if (!absl::SimpleAtoi(data, &element)) {
+      return absl::DataLossError(absl::StrCat("Invalid element ", data));
+    }
+    return element;
+  }
+};
+
 class TensorDataset : public CachableSequence<Tensor> {
  public:
   absl::StatusOr<Tensor> GetNext() override { return Tensor("Test Tensor"); }
@@ -220,6 +241,110 @@ TEST(CrossTrainerCacheTest, NewTrainersStartLate) {
   }
 }
 
+TEST(CrossTrainerCacheTest, SlowTrainersReadFromDisk) {
+  CellReader<int64_t> cell_reader(
+      "/tensorflow/data/service/cross_trainer_cache_tier_queries");
+  CrossTrainerCacheDiskTierOptions disk_tier_options;
+  disk_tier_options.directory =
+      absl::StrCat(testing::TmpDir(), "/slow_trainers_read_from_disk");
+  disk_tier_options.max_size_bytes = 1000;
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(), disk_tier_options);
+  EXPECT_THAT(cache.Get("Slow trainer"),
+              absl_testing::IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+
+  // All elements fit in memory and on disk, so the slow trainer reads every
+  // element, elements 1 to 94 from disk.
+  for (int i = 1; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+  CrossTrainerCacheTierStats stats = cache.GetTierStats();
+  EXPECT_EQ(stats.misses, 100);
+  EXPECT_EQ(stats.disk_hits, 94);
+  EXPECT_EQ(stats.memory_hits, 6);
+  EXPECT_EQ(stats.skipped_elements, 0);
+  EXPECT_EQ(cell_reader.Delta("miss"), 100);
+  EXPECT_EQ(cell_reader.Delta("disk"), 94);
+  EXPECT_EQ(cell_reader.Delta("memory"), 6);
+}
+
+TEST(CrossTrainerCacheTest, NewTrainersDoNotReadFromDisk) {
+  CrossTrainerCacheDiskTierOptions disk_tier_options;
+  disk_tier_options.directory =
+      absl::StrCat(testing::TmpDir(), "/new_trainers_do_not_read_from_disk");
+  disk_tier_options.max_size_bytes = 1000;
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(), disk_tier_options);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Old trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+
+  // New trainers start at the oldest element in memory even though older
+  // elements are on disk.
+  EXPECT_THAT(cache.Get("New trainer"),
+              absl_testing::IsOkAndHolds(Pointee(95)));
+  CrossTrainerCacheTierStats stats = cache.GetTierStats();
+  EXPECT_EQ(stats.disk_hits, 0);
+  EXPECT_EQ(stats.skipped_elements, 0);
+}
+
+TEST(CrossTrainerCacheTest, DiskTierEvictsOldElements) {
+  CrossTrainerCacheDiskTierOptions disk_tier_options;
+  disk_tier_options.directory =
+      absl::StrCat(testing::TmpDir(), "/disk_tier_evicts_old_elements");
+  disk_tier_options.max_size_bytes = 100;
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(), disk_tier_options);
+  EXPECT_THAT(cache.Get("Slow trainer"),
+              absl_testing::IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+
+  // The slow trainer resumes at the oldest element on disk, and then reads
+  // consecutive elements.
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<const int64_t> first,
+                          cache.Get("Slow trainer"));
+  EXPECT_GT(*first, 900);
+  EXPECT_LT(*first, 995);
+  for (int64_t i = *first + 1; i < 1000; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_EQ(cache.GetTierStats().skipped_elements, *first - 1);
+}
+
+TEST(CrossTrainerCacheTest, DiskTierRequiresSerialization) {
+  CrossTrainerCacheDiskTierOptions disk_tier_options;
+  disk_tier_options.directory =
+      absl::StrCat(testing::TmpDir(), "/disk_tier_requires_serialization");
+  disk_tier_options.max_size_bytes = 1000;
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<InfiniteRange>(), disk_tier_options);
+  EXPECT_THAT(cache.Get("Slow trainer"),
+              absl_testing::IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"),
+                absl_testing::IsOkAndHolds(Pointee(i)));
+  }
+
+  // Spilling is disabled, so the slow trainer skips evicted elements.
+  EXPECT_THAT(cache.Get("Slow trainer"),
+              absl_testing::IsOkAndHolds(Pointee(95)));
+  EXPECT_EQ(cache.GetTierStats().skipped_elements, 94);
+}
+
 TEST(CrossTrainerCacheTest, AlternateTrainerExtendsCache) {
   // The cache size is smaller than one int64_t.
   CrossTrainerCache<int64_t> cache(
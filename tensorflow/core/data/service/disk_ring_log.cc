@@ -0,0 +1,264 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/disk_ring_log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/random.h"
+
+namespace tensorflow {
+namespace data {
+
+absl::StatusOr<std::unique_ptr<DiskRingLog>> DiskRingLog::Create(
+    Env* env, const Options& options) {
+  if (options.directory.empty()) {
+    return absl::InvalidArgumentError(
+        "A disk ring log requires a non-empty directory.");
+  }
+  if (options.max_size_bytes <= 0 || options.num_segments <= 0 ||
+      options.readahead_bytes <= 0 || options.max_readahead_chunks < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid disk ring log options: max_size_bytes=",
+        options.max_size_bytes, ", num_segments=", options.num_segments,
+        ", readahead_bytes=", options.readahead_bytes,
+        ", max_readahead_chunks=", options.max_readahead_chunks));
+  }
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(options.directory));
+  // Several logs may share a directory, e.g. one per task on a worker.
+  std::string filename_prefix =
+      absl::StrCat(options.directory, "/ring_log_",
+                   absl::Hex(random::New64(), absl::kZeroPad16), "_");
+  return absl::WrapUnique(
+      new DiskRingLog(env, options, std::move(filename_prefix)));
+}
+
+DiskRingLog::DiskRingLog(Env* env, const Options& options,
+                         std::string filename_prefix)
+    : env_(env),
+      options_(options),
+      segment_size_bytes_(
+          std::max<int64_t>(1, options.max_size_bytes / options.num_segments)),
+      filename_prefix_(std::move(filename_prefix)) {}
+
+DiskRingLog::~DiskRingLog() {
+  mutex_lock l(mu_);
+  chunks_.clear();
+  for (const std::shared_ptr<Segment>& segment : segments_) {
+    if (segment->writer != nullptr) {
+      segment->writer->Close().IgnoreError();
+    }
+    env_->DeleteFile(segment->filename).IgnoreError();
+  }
+}
+
+absl::Status DiskRingLog::Append(int64_t index, absl::string_view record) {
+  std::shared_ptr<Segment> segment;
+  {
+    mutex_lock l(mu_);
+    if (!segments_.empty() && index != segments_.back()->end_index()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Disk ring log records must be appended in order. Expected index ",
+          segments_.back()->end_index(), ", got ", index, "."));
+    }
+    if (segments_.empty() || segments_.back()->writer == nullptr ||
+        segments_.back()->size_bytes() >= segment_size_bytes_) {
+      if (!segments_.empty() && segments_.back()->writer != nullptr) {
+        std::unique_ptr<WritableFile> writer =
+            std::move(segments_.back()->writer);
+        TF_RETURN_IF_ERROR(writer->Close());
+      }
+      TF_RETURN_IF_ERROR(AddSegment(index));
+    }
+    segment = segments_.back();
+  }
+
+  // Only the appending thread uses the writer, and readers only read records
+  // which have been flushed, so the write happens without holding `mu_`.
+  absl::Status status = segment->writer->Append(record);
+  if (status.ok()) {
+    status = segment->writer->Flush();
+  }
+  mutex_lock l(mu_);
+  if (!status.ok()) {
+    // The segment may end with a partial record. Seal it so that the next
+    // append starts a new segment.
+    segment->writer.reset();
+    return status;
+  }
+  segment->offsets.push_back(segment->offsets.back() + record.size());
+  segment->crcs.push_back(crc32c::Value(record.data(), record.size()));
+  size_bytes_ += record.size();
+  EvictSegments();
+  return absl::OkStatus();
+}
+
+absl::Status DiskRingLog::AddSegment(int64_t first_index) {
+  auto segment = std::make_shared<Segment>();
+  segment->first_index = first_index;
+  segment->filename = absl::StrCat(filename_prefix_, next_segment_id_++);
+  TF_RETURN_IF_ERROR(env_->NewWritableFile(segment->filename,
+                                           &segment->writer));
+  TF_RETURN_IF_ERROR(
+      env_->NewRandomAccessFile(segment->filename, &segment->reader));
+  segments_.push_back(std::move(segment));
+  return absl::OkStatus();
+}
+
+void DiskRingLog::EvictSegments() {
+  while (size_bytes_ > options_.max_size_bytes && segments_.size() > 1) {
+    std::shared_ptr<Segment> segment = std::move(segments_.front());
+    segments_.pop_front();
+    size_bytes_ -= segment->size_bytes();
+    chunks_.remove_if([&segment](const Chunk& chunk) {
+      return chunk.segment == segment;
+    });
+    absl::Status s = env_->DeleteFile(segment->filename);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to delete disk ring log segment "
+                   << segment->filename << ": " << s;
+    }
+  }
+}
+
+std::shared_ptr<DiskRingLog::Segment> DiskRingLog::FindSegment(
+    int64_t index) const {
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), index,
+      [](int64_t index, const std::shared_ptr<Segment>& segment) {
+        return index < segment->first_index;
+      });
+  if (it == segments_.begin()) {
+    return nullptr;
+  }
+  --it;
+  return index < (*it)->end_index() ? *it : nullptr;
+}
+
+bool DiskRingLog::ReadFromChunks(const Segment* segment, int64_t offset,
+                                 int64_t size, std::string& out) {
+  for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+    if (it->segment.get() == segment && offset >= it->offset &&
+        offset + size <=
+            it->offset + static_cast<int64_t>(it->data.size())) {
+      out.assign(it->data, offset - it->offset, size);
+      chunks_.splice(chunks_.begin(), chunks_, it);
+      return true;
+    }
+  }
+  return false;
+}
+
+absl::StatusOr<std::string> DiskRingLog::Read(int64_t index) {
+  std::shared_ptr<const Segment> segment;
+  int64_t offset = 0;
+  int64_t size = 0;
+  int64_t segment_size = 0;
+  uint32_t crc = 0;
+  std::string record;
+  bool cached = false;
+  {
+    mutex_lock l(mu_);
+    std::shared_ptr<Segment> found = FindSegment(index);
+    if (found == nullptr) {
+      return absl::OutOfRangeError(absl::StrCat(
+          "Record ", index,
+          " is not in the disk ring log, which holds records [",
+          segments_.empty() ? 0 : segments_.front()->first_index, ", ",
+          segments_.empty() ? 0 : segments_.back()->end_index(), ")."));
+    }
+    const int64_t i = index - found->first_index;
+    offset = found->offsets[i];
+    size = found->offsets[i + 1] - offset;
+    segment_size = found->size_bytes();
+    crc = found->crcs[i];
+    cached = ReadFromChunks(found.get(), offset, size, record);
+    segment = std::move(found);
+  }
+
+  if (!cached) {
+    Chunk chunk;
+    chunk.segment = segment;
+    chunk.offset = offset;
+    chunk.data.resize(std::min(std::max(size, options_.readahead_bytes),
+                               segment_size - offset));
+    absl::string_view data;
+    absl::Status s =
+        segment->reader->Read(offset, data, absl::MakeSpan(chunk.data));
+    if (!s.ok() &&
+        !(absl::IsOutOfRange(s) && data.size() == chunk.data.size())) {
+      return s;
+    }
+    if (static_cast<int64_t>(data.size()) < size) {
+      return absl::DataLossError(absl::StrCat(
+          "Truncated record ", index, " in disk ring log segment ",
+          segment->filename));
+    }
+    if (data.data() != chunk.data.data()) {
+      chunk.data.assign(data.data(), data.size());
+    } else {
+      chunk.data.resize(data.size());
+    }
+    record = chunk.data.substr(0, size);
+
+    mutex_lock l(mu_);
+    // Drop the chunk if its segment has been evicted in the meantime.
+    if (options_.max_readahead_chunks > 0 && FindSegment(index) == segment) {
+      chunks_.push_front(std::move(chunk));
+      if (chunks_.size() > static_cast<size_t>(options_.max_readahead_chunks)) {
+        chunks_.pop_back();
+      }
+    }
+  }
+
+  if (crc32c::Value(record.data(), record.size()) != crc) {
+    return absl::DataLossError(absl::StrCat(
+        "Corrupted record ", index, " in disk ring log segment ",
+        segment->filename));
+  }
+  return record;
+}
+
+int64_t DiskRingLog::start_index() const {
+  mutex_lock l(mu_);
+  return segments_.empty() ? 0 : segments_.front()->first_index;
+}
+
+int64_t DiskRingLog::end_index() const {
+  mutex_lock l(mu_);
+  return segments_.empty() ? 0 : segments_.back()->end_index();
+}
+
+int64_t DiskRingLog::size_bytes() const {
+  mutex_lock l(mu_);
+  return size_bytes_;
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,138 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_DISK_RING_LOG_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_DISK_RING_LOG_H_
+
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// A bounded log of records on local disk, indexed by consecutive integers.
+// Records are appended to segment files; once the log exceeds its size budget
+// the oldest segment is deleted, so the log holds a sliding window of the most
+// recent records. Reads fetch `readahead_bytes` at a time and keep the last
+// few chunks in memory, so that readers moving forward through the log read
+// the disk sequentially.
+//
+// The segment files are deleted when the log is destroyed. This class is
+// thread-safe, but `Append` must be called by one thread at a time.
+class DiskRingLog {
+ public:
+  struct Options {
+    // Directory of the segment files. It is created if it does not exist.
+    std::string directory;
+    // Maximum total size of the segments. The log may exceed it by up to one
+    // segment while the newest segment is being written.
+    int64_t max_size_bytes = 0;
+    // Number of segments the budget is split into. Each eviction drops about
+    // `1 / num_segments` of the log.
+    int num_segments = 8;
+    // Number of bytes fetched from disk by a read that misses the readahead
+    // chunks.
+    int64_t readahead_bytes = 4 << 20;
+    // Number of readahead chunks kept in memory.
+    int max_readahead_chunks = 4;
+  };
+
+  static absl::StatusOr<std::unique_ptr<DiskRingLog>> Create(
+      Env* env, const Options& options);
+  ~DiskRingLog();
+  DiskRingLog(const DiskRingLog&) = delete;
+  DiskRingLog& operator=(const DiskRingLog&) = delete;
+
+  // Appends `record` with index `index`, evicting the oldest segments to stay
+  // within the size budget.
+  // REQUIRES: `index == end_index()` unless the log is empty.
+  absl::Status Append(int64_t index, absl::string_view record)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Reads the record with index `index`. Returns `OutOfRange` if the record is
+  // not in [start_index(), end_index()), and `DataLoss` if it is corrupted.
+  absl::StatusOr<std::string> Read(int64_t index) TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the index of the oldest record in the log.
+  int64_t start_index() const TF_LOCKS_EXCLUDED(mu_);
+  // Returns one past the index of the newest record in the log.
+  int64_t end_index() const TF_LOCKS_EXCLUDED(mu_);
+  // Returns the total size of the segment files.
+  int64_t size_bytes() const TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct Segment {
+    int64_t first_index = 0;
+    std::string filename;
+    std::unique_ptr<WritableFile> writer;
+    std::unique_ptr<RandomAccessFile> reader;
+    // `offsets[i]` is where record `first_index + i` starts; the last entry is
+    // the end of the segment.
+    std::vector<int64_t> offsets = {0};
+    std::vector<uint32_t> crcs;
+
+    int64_t end_index() const { return first_index + crcs.size(); }
+    int64_t size_bytes() const { return offsets.back(); }
+  };
+
+  // A contiguous range of a segment held in memory.
+  struct Chunk {
+    std::shared_ptr<const Segment> segment;
+    int64_t offset = 0;
+    std::string data;
+  };
+
+  DiskRingLog(Env* env, const Options& options, std::string filename_prefix);
+
+  // Creates a new segment whose first record is `first_index`.
+  absl::Status AddSegment(int64_t first_index) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Deletes the oldest segments while the log exceeds its budget.
+  void EvictSegments() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Returns the segment holding `index`, or nullptr if there is none.
+  std::shared_ptr<Segment> FindSegment(int64_t index) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Copies bytes [offset, offset + size) of `segment` into `out` if a
+  // readahead chunk covers them.
+  bool ReadFromChunks(const Segment* segment, int64_t offset, int64_t size,
+                      std::string& out) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  Env* const env_;
+  const Options options_;
+  const int64_t segment_size_bytes_;
+  const std::string filename_prefix_;
+
+  mutable mutex mu_;
+  std::deque<std::shared_ptr<Segment>> segments_ TF_GUARDED_BY(mu_);
+  int64_t size_bytes_ TF_GUARDED_BY(mu_) = 0;
+  int64_t next_segment_id_ TF_GUARDED_BY(mu_) = 0;
+  // Most recently used first.
+  std::list<Chunk> chunks_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_DISK_RING_LOG_H_
@@ -0,0 +1,119 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/disk_ring_log.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+std::string Record(int64_t index) {
+  return std::string(50, 'a' + index % 26);
+}
+
+DiskRingLog::Options TestOptions(const std::string& name) {
+  DiskRingLog::Options options;
+  options.directory = absl::StrCat(testing::TmpDir(), "/", name);
+  options.max_size_bytes = 1000;
+  options.readahead_bytes = 256;
+  return options;
+}
+
+TEST(DiskRingLogTest, AppendAndRead) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DiskRingLog> log,
+      DiskRingLog::Create(Env::Default(), TestOptions("append_and_read")));
+  EXPECT_EQ(log->start_index(), 0);
+  EXPECT_EQ(log->end_index(), 0);
+  for (int64_t i = 5; i < 15; ++i) {
+    TF_ASSERT_OK(log->Append(i, Record(i)));
+  }
+  EXPECT_EQ(log->start_index(), 5);
+  EXPECT_EQ(log->end_index(), 15);
+  EXPECT_EQ(log->size_bytes(), 500);
+  // Reads out of order, so some reads hit readahead chunks and some do not.
+  for (int64_t i : {14, 5, 6, 7, 10, 9, 8, 11, 12, 13}) {
+    TF_ASSERT_OK_AND_ASSIGN(std::string record, log->Read(i));
+    EXPECT_EQ(record, Record(i));
+  }
+  EXPECT_TRUE(absl::IsOutOfRange(log->Read(4).status()));
+  EXPECT_TRUE(absl::IsOutOfRange(log->Read(15).status()));
+}
+
+TEST(DiskRingLogTest, EvictsOldestSegments) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DiskRingLog> log,
+      DiskRingLog::Create(Env::Default(), TestOptions("evicts")));
+  for (int64_t i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(log->Append(i, Record(i)));
+    EXPECT_LE(log->size_bytes(), 1000);
+  }
+  EXPECT_EQ(log->end_index(), 100);
+  EXPECT_GT(log->start_index(), 70);
+  EXPECT_TRUE(absl::IsOutOfRange(log->Read(0).status()));
+  for (int64_t i = log->start_index(); i < log->end_index(); ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(std::string record, log->Read(i));
+    EXPECT_EQ(record, Record(i));
+  }
+}
+
+TEST(DiskRingLogTest, RequiresConsecutiveIndices) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<DiskRingLog> log,
+      DiskRingLog::Create(Env::Default(), TestOptions("consecutive")));
+  TF_ASSERT_OK(log->Append(0, Record(0)));
+  EXPECT_TRUE(absl::IsInvalidArgument(log->Append(2, Record(2))));
+  TF_EXPECT_OK(log->Append(1, Record(1)));
+}
+
+TEST(DiskRingLogTest, DeletesSegmentsOnDestruction) {
+  const DiskRingLog::Options options = TestOptions("deletes");
+  {
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<DiskRingLog> log,
+                            DiskRingLog::Create(Env::Default(), options));
+    for (int64_t i = 0; i < 10; ++i) {
+      TF_ASSERT_OK(log->Append(i, Record(i)));
+    }
+  }
+  std::vector<std::string> children;
+  TF_ASSERT_OK(Env::Default()->GetChildren(options.directory, &children));
+  EXPECT_TRUE(children.empty());
+}
+
+TEST(DiskRingLogTest, InvalidOptions) {
+  DiskRingLog::Options options = TestOptions("invalid");
+  options.max_size_bytes = 0;
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      DiskRingLog::Create(Env::Default(), options).status()));
+  options = TestOptions("invalid");
+  options.directory.clear();
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      DiskRingLog::Create(Env::Default(), options).status()));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
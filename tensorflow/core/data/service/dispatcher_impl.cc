@@ -63,6 +63,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/utils.h"
 #include "tensorflow/core/data/service/validate_utils.h"
 #include "tensorflow/core/data/service/worker.grpc.pb.h"
+#include "tensorflow/core/data/service/worker_load.h"
 #include "tensorflow/core/data/snapshot_utils.h"
 #include "tensorflow/core/data/standalone.h"
 #include "tensorflow/core/data/utils.h"
@@ -463,6 +464,9 @@ absl::Status DataServiceDispatcherImpl::WorkerHeartbeat(
     const std::string& worker_address = request->worker_address();
     latest_worker_heartbeats_time_[worker_address] =
         absl::FromUnixMicros(env_->NowMicros());
+    if (request->has_load()) {
+      worker_loads_.Update(worker_address, request->load());
+    }
     // Assigned tasks from the perspective of the dispatcher.
     std::vector<std::shared_ptr<const Task>> assigned_tasks;
     absl::Status s = state_.TasksForWorker(worker_address, assigned_tasks);
@@ -1208,6 +1212,10 @@ absl::Status DataServiceDispatcherImpl::ClientHeartbeat(
     task_info->set_iteration_id(iteration->iteration_id);
     task_info->set_worker_uid(task->worker_uid);
     task_info->set_starting_round(task->starting_round);
+    if (std::optional<WorkerLoad> load =
+            worker_loads_.Get(task->worker_address)) {
+      *task_info->mutable_worker_load() = *std::move(load);
+    }
   }
   response->set_iteration_finished(iteration->finished);
   response->set_deployment_mode(config_.deployment_mode());
@@ -1540,6 +1548,7 @@ void DataServiceDispatcherImpl::DetectMissingWorkers()
         it->second + absl::Milliseconds(config_.worker_timeout_ms())) {
       LOG(INFO) << "Lost worker " << it->first << " due to timeout";
       RemoveWorkerFromAutoScaler(it->first);
+      worker_loads_.Remove(it->first);
 
       latest_worker_heartbeats_time_.erase(it++);
     } else {
@@ -35,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/snapshot/snapshot_manager.h"
 #include "tensorflow/core/data/service/task_remover.h"
 #include "tensorflow/core/data/service/worker.grpc.pb.h"
+#include "tensorflow/core/data/service/worker_load.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
@@ -384,6 +385,9 @@ class DataServiceDispatcherImpl {
   // Map from worker address to the time of the worker's last heartbeat.
   absl::flat_hash_map<std::string, absl::Time> latest_worker_heartbeats_time_
       TF_GUARDED_BY(mu_);
+  // Latest load reported by each worker, forwarded to clients so that they
+  // can steer reads away from overloaded workers.
+  WorkerLoadTracker worker_loads_ TF_GUARDED_BY(mu_);
 
   // A manager for each snapshot resumed or started during the lifetime of this
   // dispatcher instance.  Note that these are *not* garbage collected; managers
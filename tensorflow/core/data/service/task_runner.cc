@@ -15,11 +15,15 @@ limitations under the License.
 #include "tensorflow/core/data/service/task_runner.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/data/metric_utils.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/data/service/common.h"
@@ -50,6 +54,8 @@ namespace {
 constexpr int64_t kWaitBeforeSkipUs = 100 * 1000;  // 100ms.
 constexpr size_t kDefaultCrossTrainerCacheSizeBytes =
     10 * (size_t{1} << 30);  // 10GB
+constexpr int64_t kDefaultCrossTrainerCacheDiskSizeBytes =
+    100 * (int64_t{1} << 30);  // 100GB
 
 }  // namespace
 
@@ -116,8 +122,15 @@ absl::Status TaskRunner::Create(const experimental::WorkerConfig& worker_config,
         worker_config.cross_trainer_cache_size_bytes() > 0
             ? worker_config.cross_trainer_cache_size_bytes()
             : kDefaultCrossTrainerCacheSizeBytes;
-    out = std::make_unique<CachingTaskRunner>(std::move(iterator),
-                                              max_cache_size_bytes);
+    CrossTrainerCacheDiskTierOptions disk_tier_options;
+    disk_tier_options.directory =
+        worker_config.cross_trainer_cache_disk_directory();
+    disk_tier_options.max_size_bytes =
+        worker_config.cross_trainer_cache_disk_size_bytes() > 0
+            ? worker_config.cross_trainer_cache_disk_size_bytes()
+            : kDefaultCrossTrainerCacheDiskSizeBytes;
+    out = std::make_unique<CachingTaskRunner>(
+        std::move(iterator), max_cache_size_bytes, disk_tier_options);
   } else {
     out = std::make_unique<FirstComeFirstServedTaskRunner>(std::move(iterator));
   }
@@ -198,6 +211,10 @@ std::shared_ptr<model::Model> FirstComeFirstServedTaskRunner::model() const {
   return model_;
 }
 
+int64_t FirstComeFirstServedTaskRunner::NumBufferedElements() const {
+  return buffer_.Size();
+}
+
 CachingTaskRunner::CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
                                      size_t max_cache_size_bytes)
     : fcfs_task_runner_(std::move(iterator)),
@@ -207,6 +224,22 @@ CachingTaskRunner::CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
             << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
 }
 
+CachingTaskRunner::CachingTaskRunner(
+    std::unique_ptr<TaskIterator> iterator, size_t max_cache_size_bytes,
+    const CrossTrainerCacheDiskTierOptions& disk_tier_options)
+    : fcfs_task_runner_(std::move(iterator)),
+      cache_(max_cache_size_bytes,
+             std::make_unique<GetElementResultSequence>(fcfs_task_runner_),
+             disk_tier_options) {
+  LOG(INFO) << "Initialized tf.data service cross-trainer cache with "
+            << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
+  if (!disk_tier_options.directory.empty()) {
+    LOG(INFO) << "Cross-trainer cache elements evicted from memory spill to "
+              << disk_tier_options.directory << ", using up to "
+              << ByteSize::Bytes(disk_tier_options.max_size_bytes) << ".";
+  }
+}
+
 CachingTaskRunner::~CachingTaskRunner() { Cancel(); }
 
 absl::Status CachingTaskRunner::GetNext(const GetElementRequest& req,
@@ -238,6 +271,38 @@ size_t CachingTaskRunner::GetElementResultSequence::GetElementSizeBytes(
   return element.EstimatedMemoryUsageBytes();
 }
 
+absl::Status CachingTaskRunner::GetElementResultSequence::SerializeElement(
+    const GetElementResult& element, std::string& out) const {
+  GetElementResponse response;
+  TF_RETURN_IF_ERROR(
+      CompressElement(element.components, response.mutable_compressed()));
+  response.set_element_index(element.element_index);
+  response.set_end_of_sequence(element.end_of_sequence);
+  response.set_skip_task(element.skip);
+  if (!response.SerializeToString(&out)) {
+    return absl::InternalError(
+        "Failed to serialize a cross-trainer cache element.");
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<GetElementResult>
+CachingTaskRunner::GetElementResultSequence::DeserializeElement(
+    absl::string_view data) const {
+  GetElementResponse response;
+  if (!response.ParseFromString(data)) {
+    return absl::DataLossError(
+        "Failed to parse a spilled cross-trainer cache element.");
+  }
+  GetElementResult result;
+  TF_RETURN_IF_ERROR(
+      UncompressElement(response.compressed(), &result.components));
+  result.element_index = response.element_index();
+  result.end_of_sequence = response.end_of_sequence();
+  result.skip = response.skip_task();
+  return result;
+}
+
 void CachingTaskRunner::Cancel() {
   VLOG(2) << "Cancelling tf.data service cross-trainer cache task.";
   if (!cache_.IsCancelled()) {
@@ -251,6 +316,10 @@ std::shared_ptr<model::Model> CachingTaskRunner::model() const {
   return fcfs_task_runner_.model();
 }
 
+int64_t CachingTaskRunner::NumBufferedElements() const {
+  return fcfs_task_runner_.NumBufferedElements();
+}
+
 RoundRobinTaskRunner::RoundRobinTaskRunner(
     std::unique_ptr<TaskIterator> iterator, int64_t num_consumers,
     std::string worker_address)
@@ -391,6 +460,11 @@ std::shared_ptr<model::Model> RoundRobinTaskRunner::model() const {
   return prefetch_thread_.model();
 }
 
+int64_t RoundRobinTaskRunner::NumBufferedElements() const {
+  // Does not lock `mu_`, which is held while waiting for a round to fill up.
+  return prefetch_thread_.NumBufferedElements();
+}
+
 PrefetchThread::PrefetchThread(std::unique_ptr<TaskIterator> iterator,
                                int64_t round_size)
     : iterator_(std::move(iterator)), round_size_(round_size) {
@@ -481,5 +555,10 @@ absl::Status PrefetchThread::GetStatus() {
 std::shared_ptr<model::Model> PrefetchThread::model() const {
   return iterator_->model();
 }
+
+int64_t PrefetchThread::NumBufferedElements() const {
+  tf_shared_lock l(mu_);
+  return buffer_.size();
+}
 }  // namespace data
 }  // namespace tensorflow
@@ -17,8 +17,10 @@ limitations under the License.
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
 #include "tensorflow/core/data/service/data_transfer.h"
@@ -111,6 +113,8 @@ class TaskRunner {
   virtual void Cancel() = 0;
   // Returns the dataset model for performance analysis.
   virtual std::shared_ptr<model::Model> model() const = 0;
+  // Returns the number of elements produced but not yet requested.
+  virtual int64_t NumBufferedElements() const = 0;
 };
 
 // A task runner which provides elements on a first-come first-served basis.
@@ -130,6 +134,8 @@ class FirstComeFirstServedTaskRunner : public TaskRunner {
 
   std::shared_ptr<model::Model> model() const override;
 
+  int64_t NumBufferedElements() const override;
+
  private:
   // Function to continually prefetch the next element. Returns an error if the
   // task has been cancelled.
@@ -164,6 +170,12 @@ class CachingTaskRunner : public TaskRunner {
  public:
   explicit CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
                              size_t max_cache_size_bytes);
+  // Creates a task runner whose cache spills elements evicted from memory to
+  // local disk, so that trainers lagging behind the memory window are served
+  // from disk instead of skipping data.
+  CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
+                    size_t max_cache_size_bytes,
+                    const CrossTrainerCacheDiskTierOptions& disk_tier_options);
   ~CachingTaskRunner() override;
 
   // Gets the next element from the cross-trainer cache, blocking if the data is
@@ -179,6 +191,8 @@ class CachingTaskRunner : public TaskRunner {
   // Returns the dataset model for performance analysis.
   std::shared_ptr<model::Model> model() const override;
 
+  int64_t NumBufferedElements() const override;
+
  private:
   // The `GetElementResultSequence` generates a sequence of elements from the
   // `FirstComeFirstServedTaskRunner`. It is used for the `CrossTrainerCache` to
@@ -189,6 +203,11 @@ class CachingTaskRunner : public TaskRunner {
         FirstComeFirstServedTaskRunner& fcfs_task_runner);
     absl::StatusOr<GetElementResult> GetNext() override;
     size_t GetElementSizeBytes(const GetElementResult& element) const override;
+    // Spilled elements are stored as compressed `GetElementResponse`s.
+    absl::Status SerializeElement(const GetElementResult& element,
+                                  std::string& out) const override;
+    absl::StatusOr<GetElementResult> DeserializeElement(
+        absl::string_view data) const override;
 
    private:
     FirstComeFirstServedTaskRunner& fcfs_task_runner_;
@@ -230,11 +249,13 @@ class PrefetchThread {
   absl::Status GetStatus();
   // Returns the dataset model for performance analysis.
   std::shared_ptr<model::Model> model() const;
+  // Returns the number of elements buffered for the next round.
+  int64_t NumBufferedElements() const;
 
  private:
   const std::unique_ptr<TaskIterator> iterator_;
   const int64_t round_size_;
-  mutex mu_;
+  mutable mutex mu_;
   int64_t index_ TF_GUARDED_BY(mu_) = 0;
   // Buffered results for the next round.
   std::vector<std::unique_ptr<Element>> buffer_ TF_GUARDED_BY(mu_);
@@ -275,6 +296,7 @@ class RoundRobinTaskRunner : public TaskRunner {
                        GetElementResult& result) override;
   void Cancel() override;
   std::shared_ptr<model::Model> model() const override;
+  int64_t NumBufferedElements() const override;
 
  private:
   // Prepares a full round of data. `wait_us` indicates how long to wait before
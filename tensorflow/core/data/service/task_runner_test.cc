@@ -361,6 +361,31 @@ TEST(CachingTaskRunnerTest, SlowClientSkipsData) {
   EXPECT_THAT(slow_trainer_output[0], Gt(0));
 }
 
+TEST(CachingTaskRunnerTest, SlowClientReadsFromDisk) {
+  size_t range = 1000;
+  CrossTrainerCacheDiskTierOptions disk_tier_options;
+  disk_tier_options.directory =
+      absl::StrCat(testing::TmpDir(), "/slow_client_reads_from_disk");
+  disk_tier_options.max_size_bytes = 10 * (int64_t{1} << 20);
+  CachingTaskRunner runner(std::make_unique<InfiniteRangeIterator>(),
+                           /*max_cache_size_bytes=*/kSmallCache,
+                           disk_tier_options);
+
+  GetElementRequest request;
+  request.set_trainer_id("Fast trainer");
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<int64_t> fast_trainer_output,
+      GetElementsFromTaskRunner<int64_t>(runner, request, range));
+  EXPECT_THAT(fast_trainer_output, ElementsAreArray(GetRange(range)));
+
+  // Elements evicted from memory are read back from disk.
+  request.set_trainer_id("Slow trainer");
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<int64_t> slow_trainer_output,
+      GetElementsFromTaskRunner<int64_t>(runner, request, range));
+  EXPECT_THAT(slow_trainer_output, ElementsAreArray(GetRange(range)));
+}
+
 TEST(CachingTaskRunnerTest, ConcurrentTrainers) {
   size_t range = 100;
   size_t num_readers = 10;
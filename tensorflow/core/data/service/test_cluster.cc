@@ -24,9 +24,13 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "xla/tsl/platform/env.h"
 #include "tensorflow/core/data/service/export.pb.h"
 #include "tensorflow/core/data/service/server_lib.h"
+#include "tensorflow/core/data/service/task_runner.h"
+#include "tensorflow/core/data/service/worker_impl.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/protobuf/data_service.pb.h"
@@ -36,6 +40,32 @@ namespace tensorflow {
 namespace data {
 namespace {
 constexpr const char kProtocol[] = "grpc";
+
+// A task runner which delays every request before forwarding it.
+class DelayedTaskRunner : public TaskRunner {
+ public:
+  DelayedTaskRunner(std::unique_ptr<TaskRunner> task_runner,
+                    absl::Duration delay)
+      : task_runner_(std::move(task_runner)), delay_(delay) {}
+
+  absl::Status GetNext(const GetElementRequest& req,
+                       GetElementResult& result) override {
+    tsl::Env::Default()->SleepForMicroseconds(
+        absl::ToInt64Microseconds(delay_));
+    return task_runner_->GetNext(req, result);
+  }
+  void Cancel() override { task_runner_->Cancel(); }
+  std::shared_ptr<model::Model> model() const override {
+    return task_runner_->model();
+  }
+  int64_t NumBufferedElements() const override {
+    return task_runner_->NumBufferedElements();
+  }
+
+ private:
+  const std::unique_ptr<TaskRunner> task_runner_;
+  const absl::Duration delay_;
+};
 }  // namespace
 
 TestCluster::TestCluster(int num_workers,
@@ -123,6 +153,22 @@ std::string TestCluster::WorkerAddress(int index) const {
   return worker_addresses_[index];
 }
 
+absl::Status TestCluster::SetWorkerGetElementDelay(size_t index,
+                                                   absl::Duration delay) {
+  std::shared_ptr<DataServiceWorkerImpl> worker =
+      LocalWorkers::Get(WorkerAddress(index));
+  if (worker == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("Worker ", WorkerAddress(index), " is not running."));
+  }
+  worker->SetTaskRunnerWrapperForTesting(
+      [delay](std::unique_ptr<TaskRunner> task_runner) {
+        return std::make_unique<DelayedTaskRunner>(std::move(task_runner),
+                                                   delay);
+      });
+  return absl::OkStatus();
+}
+
 void TestCluster::StopWorker(size_t index) {
   DCHECK_GE(index, 0);
   DCHECK_LT(index, worker_addresses_.size());
@@ -24,6 +24,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/data_transfer.h"
@@ -89,6 +90,11 @@ class TestCluster {
   // workers in the cluster.
   std::string WorkerAddress(int index) const;
 
+  // Delays every element request served by the worker at `index` by `delay`,
+  // to simulate a straggler. Only applies to tasks the worker starts serving
+  // after the call.
+  absl::Status SetWorkerGetElementDelay(size_t index, absl::Duration delay);
+
   // Stops one worker.
   void StopWorker(size_t index);
   // Stops all workers.
@@ -50,6 +50,9 @@ class ThreadSafeBuffer final {
   // Returns whether the buffer is empty.
   bool Empty() const;
 
+  // Returns the number of buffered elements.
+  size_t Size() const;
+
  private:
   const size_t buffer_size_;
 
@@ -77,6 +80,12 @@ bool ThreadSafeBuffer<T>::Empty() const {
   return results_.empty();
 }
 
+template <class T>
+size_t ThreadSafeBuffer<T>::Size() const {
+  tf_shared_lock l(mu_);
+  return results_.size();
+}
+
 template <class T>
 StatusOr<T> ThreadSafeBuffer<T>::Pop() {
   mutex_lock l(mu_);
@@ -356,6 +356,13 @@ absl::Status DataServiceWorkerImpl::EnsureTaskInitialized(
       std::move(dataset), std::move(iterator));
   TF_RETURN_IF_ERROR(TaskRunner::Create(
       config_, task.task_def, std::move(task_iterator), task.task_runner));
+  {
+    mutex_lock worker_lock(mu_);
+    if (task_runner_wrapper_for_testing_) {
+      task.task_runner =
+          task_runner_wrapper_for_testing_(std::move(task.task_runner));
+    }
+  }
 
   task.initialized = true;
   VLOG(3) << "Created iterator for task " << task.task_def.task_id();
@@ -651,6 +658,44 @@ std::vector<int64_t> DataServiceWorkerImpl::GetTaskIds(
   return task_ids;
 }
 
+void DataServiceWorkerImpl::SetTaskRunnerWrapperForTesting(
+    TaskRunnerWrapper wrapper) TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  task_runner_wrapper_for_testing_ = std::move(wrapper);
+}
+
+WorkerLoad DataServiceWorkerImpl::GetLoad() const TF_LOCKS_EXCLUDED(mu_) {
+  WorkerLoad load;
+  std::vector<std::shared_ptr<Task>> tasks;
+  {
+    mutex_lock l(mu_);
+    int64_t outstanding_requests = 0;
+    for (const auto& [task_id, task] : tasks_) {
+      if (task == nullptr) {
+        continue;
+      }
+      outstanding_requests += task->outstanding_requests;
+      tasks.push_back(task);
+    }
+    load.set_outstanding_requests(outstanding_requests);
+  }
+  int64_t buffered_elements = 0;
+  for (const std::shared_ptr<Task>& task : tasks) {
+    bool task_initialized = false;
+    {
+      mutex_lock task_lock(task->mu);
+      task_initialized = task->initialized;
+    }
+    if (task_initialized && task->task_runner != nullptr) {
+      buffered_elements += task->task_runner->NumBufferedElements();
+    }
+  }
+  load.set_buffered_elements(buffered_elements);
+  load.set_cpu_utilization(cpu_utilization_.Get());
+  load.set_host(port::Hostname());
+  return load;
+}
+
 WorkerHeartbeatRequest DataServiceWorkerImpl::BuildWorkerHeartbeatRequest()
     const TF_LOCKS_EXCLUDED(mu_) {
   std::vector<ActiveTask> active_tasks = GetActiveTasks();
@@ -670,6 +715,7 @@ WorkerHeartbeatRequest DataServiceWorkerImpl::BuildWorkerHeartbeatRequest()
          snapshot_task_progress});
   }
   *request.mutable_active_tasks() = {active_tasks.begin(), active_tasks.end()};
+  *request.mutable_load() = GetLoad();
   return request;
 }
 
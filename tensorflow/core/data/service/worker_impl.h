@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DATA_SERVICE_WORKER_IMPL_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -32,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/snapshot/snapshot_stream_writer.h"
 #include "tensorflow/core/data/service/task_runner.h"
 #include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/data/service/worker_load.h"
 #include "tensorflow/core/data/standalone.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/platform/env.h"
@@ -90,6 +92,13 @@ class DataServiceWorkerImpl {
   // Exports the worker state for debugging.
   WorkerStateExport ExportState() const;
 
+  // Wraps the task runners of tasks initialized from now on, e.g. to simulate a
+  // slow worker.
+  using TaskRunnerWrapper = std::function<std::unique_ptr<TaskRunner>(
+      std::unique_ptr<TaskRunner>)>;
+  void SetTaskRunnerWrapperForTesting(TaskRunnerWrapper wrapper)
+      TF_LOCKS_EXCLUDED(mu_);
+
  private:
   struct Task {
     explicit Task(TaskDef task_def) : task_def(std::move(task_def)) {}
@@ -149,6 +158,8 @@ class DataServiceWorkerImpl {
   // Returns the task IDs of `active_tasks`.
   std::vector<int64_t> GetTaskIds(
       const std::vector<ActiveTask>& active_tasks) const;
+  // Returns the current load of this worker.
+  WorkerLoad GetLoad() const TF_LOCKS_EXCLUDED(mu_);
   // Builds a heartbeat request.
   WorkerHeartbeatRequest BuildWorkerHeartbeatRequest() const
       TF_LOCKS_EXCLUDED(mu_);
@@ -196,6 +207,7 @@ class DataServiceWorkerImpl {
   // again, the worker will return a non-retriable FailedPrecondition error.
   absl::flat_hash_set<int64_t> deleted_tasks_ TF_GUARDED_BY(mu_);
   bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  TaskRunnerWrapper task_runner_wrapper_for_testing_ TF_GUARDED_BY(mu_);
   // Whether the worker has registered with the dispatcher yet.
   bool registered_ TF_GUARDED_BY(mu_) = false;
   condition_variable task_completion_cv_ TF_GUARDED_BY(mu_);
@@ -210,6 +222,8 @@ class DataServiceWorkerImpl {
   std::unique_ptr<Thread> task_completion_thread_;
   // A thread for performing regular heartbeats to the dispatcher.
   std::unique_ptr<Thread> heartbeat_thread_;
+  // CPU utilization reported in heartbeats.
+  mutable ProcessCpuUtilization cpu_utilization_;
 
   DataServiceWorkerImpl(const DataServiceWorkerImpl&) = delete;
   void operator=(const DataServiceWorkerImpl&) = delete;
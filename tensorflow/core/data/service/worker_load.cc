@@ -0,0 +1,121 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/worker_load.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Read rate multiplier for tasks on the client's host, which avoid a network
+// hop.
+constexpr double kSameHostWeight = 4.0;
+// Read rate multiplier for stragglers.
+constexpr double kStragglerWeight = 0.1;
+
+}  // namespace
+
+double LoadScore(const WorkerLoad& load) {
+  const double queueing =
+      static_cast<double>(std::max<int64_t>(load.outstanding_requests(), 0)) /
+      (1 + std::max<int64_t>(load.buffered_elements(), 0));
+  return queueing + std::clamp(load.cpu_utilization(), 0.0, 1.0);
+}
+
+double TaskReadWeight(const TaskInfo& task, bool same_host) {
+  double weight = 1.0 / (1.0 + LoadScore(task.worker_load()));
+  if (same_host) {
+    weight *= kSameHostWeight;
+  }
+  if (task.worker_load().straggler()) {
+    weight *= kStragglerWeight;
+  }
+  return weight;
+}
+
+ProcessCpuUtilization::ProcessCpuUtilization()
+    : last_cpu_time_(std::clock()), last_wall_time_(absl::Now()) {}
+
+double ProcessCpuUtilization::Get() {
+  mutex_lock l(mu_);
+  const std::clock_t cpu_time = std::clock();
+  const absl::Time wall_time = absl::Now();
+  const double cpu_seconds =
+      static_cast<double>(cpu_time - last_cpu_time_) / CLOCKS_PER_SEC;
+  const double wall_seconds =
+      absl::ToDoubleSeconds(wall_time - last_wall_time_);
+  last_cpu_time_ = cpu_time;
+  last_wall_time_ = wall_time;
+  if (wall_seconds <= 0 || cpu_seconds < 0) {
+    return 0.0;
+  }
+  return std::clamp(
+      cpu_seconds / wall_seconds / std::max(port::NumSchedulableCPUs(), 1),
+      0.0, 1.0);
+}
+
+void WorkerLoadTracker::Update(const std::string& worker_address,
+                               const WorkerLoad& load) {
+  loads_[worker_address] = load;
+  threshold_stale_ = true;
+}
+
+void WorkerLoadTracker::Remove(const std::string& worker_address) {
+  loads_.erase(worker_address);
+  threshold_stale_ = true;
+}
+
+std::optional<WorkerLoad> WorkerLoadTracker::Get(
+    const std::string& worker_address) {
+  auto it = loads_.find(worker_address);
+  if (it == loads_.end()) {
+    return std::nullopt;
+  }
+  MaybeUpdateStragglerThreshold();
+  WorkerLoad load = it->second;
+  load.set_straggler(LoadScore(load) > straggler_threshold_);
+  return load;
+}
+
+void WorkerLoadTracker::MaybeUpdateStragglerThreshold() {
+  if (!threshold_stale_) {
+    return;
+  }
+  threshold_stale_ = false;
+  std::vector<double> scores;
+  scores.reserve(loads_.size());
+  for (const auto& [address, load] : loads_) {
+    scores.push_back(LoadScore(load));
+  }
+  auto median = scores.begin() + scores.size() / 2;
+  std::nth_element(scores.begin(), median, scores.end());
+  straggler_threshold_ =
+      std::max(kMinStragglerLoadScore, kStragglerLoadFactor * *median);
+}
+
+}  // namespace data
+}  // namespace tensorflow
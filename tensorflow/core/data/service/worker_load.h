@@ -0,0 +1,95 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_WORKER_LOAD_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_WORKER_LOAD_H_
+
+#include <ctime>
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// Workers report a `WorkerLoad` in every heartbeat. The dispatcher forwards
+// the latest load of each worker to clients with the task list, and clients
+// read more often from workers that are on their host and lightly loaded.
+
+// A worker is flagged as a straggler if its load score exceeds the median
+// score of all workers by this factor.
+inline constexpr double kStragglerLoadFactor = 3.0;
+// Load scores below this are never considered stragglers, so that idle
+// clusters do not flag workers over noise.
+inline constexpr double kMinStragglerLoadScore = 1.0;
+
+// Returns a non-negative estimate of how long the worker will take to serve
+// the next request: requests queue up on workers that cannot keep their
+// buffers full, and busy CPUs slow down all of them. 0 for an idle worker.
+double LoadScore(const WorkerLoad& load);
+
+// Returns the relative rate at which a client should read from `task`.
+// Tasks on the client's host are preferred, less loaded workers next, and
+// stragglers are read from rarely but never starved, since every task must
+// eventually be read to its end.
+double TaskReadWeight(const TaskInfo& task, bool same_host);
+
+// Measures the CPU utilization of the current process.
+class ProcessCpuUtilization {
+ public:
+  ProcessCpuUtilization();
+
+  // Returns the fraction of the host's CPUs used by this process since the
+  // previous call, or since construction for the first call.
+  double Get() TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  mutex mu_;
+  std::clock_t last_cpu_time_ TF_GUARDED_BY(mu_);
+  absl::Time last_wall_time_ TF_GUARDED_BY(mu_);
+};
+
+// Tracks the latest load of each worker and flags stragglers. This class is
+// not thread-safe.
+class WorkerLoadTracker {
+ public:
+  // Records the latest `load` of `worker_address`.
+  void Update(const std::string& worker_address, const WorkerLoad& load);
+
+  // Forgets the load of a worker which has been lost.
+  void Remove(const std::string& worker_address);
+
+  // Returns the latest load of `worker_address`, with `straggler` set relative
+  // to the other workers, or nullopt if the worker has not reported a load.
+  std::optional<WorkerLoad> Get(const std::string& worker_address);
+
+ private:
+  // Recomputes `straggler_threshold_` if loads changed since the last call.
+  void MaybeUpdateStragglerThreshold();
+
+  absl::flat_hash_map<std::string, WorkerLoad> loads_;
+  // Scores above this mark a straggler.
+  double straggler_threshold_ = 0.0;
+  bool threshold_stale_ = false;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_WORKER_LOAD_H_
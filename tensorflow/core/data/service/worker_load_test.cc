@@ -0,0 +1,120 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/worker_load.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+WorkerLoad Load(int64_t outstanding_requests, int64_t buffered_elements,
+                double cpu_utilization = 0.0) {
+  WorkerLoad load;
+  load.set_outstanding_requests(outstanding_requests);
+  load.set_buffered_elements(buffered_elements);
+  load.set_cpu_utilization(cpu_utilization);
+  return load;
+}
+
+TEST(WorkerLoadTest, LoadScore) {
+  EXPECT_EQ(LoadScore(WorkerLoad()), 0.0);
+  EXPECT_EQ(LoadScore(Load(/*outstanding_requests=*/4,
+                           /*buffered_elements=*/0)),
+            4.0);
+  EXPECT_EQ(LoadScore(Load(/*outstanding_requests=*/4,
+                           /*buffered_elements=*/7, /*cpu_utilization=*/0.5)),
+            1.0);
+  EXPECT_EQ(LoadScore(Load(/*outstanding_requests=*/-1,
+                           /*buffered_elements=*/-1, /*cpu_utilization=*/3)),
+            1.0);
+}
+
+TEST(WorkerLoadTest, TaskReadWeight) {
+  TaskInfo idle;
+  TaskInfo loaded;
+  *loaded.mutable_worker_load() = Load(/*outstanding_requests=*/3,
+                                       /*buffered_elements=*/0);
+  TaskInfo straggler = loaded;
+  straggler.mutable_worker_load()->set_straggler(true);
+
+  EXPECT_EQ(TaskReadWeight(idle, /*same_host=*/false), 1.0);
+  EXPECT_GT(TaskReadWeight(idle, /*same_host=*/true),
+            TaskReadWeight(idle, /*same_host=*/false));
+  EXPECT_LT(TaskReadWeight(loaded, /*same_host=*/false),
+            TaskReadWeight(idle, /*same_host=*/false));
+  EXPECT_LT(TaskReadWeight(straggler, /*same_host=*/false),
+            TaskReadWeight(loaded, /*same_host=*/false));
+  EXPECT_GT(TaskReadWeight(straggler, /*same_host=*/false), 0.0);
+}
+
+TEST(WorkerLoadTrackerTest, FlagsStragglers) {
+  WorkerLoadTracker tracker;
+  EXPECT_EQ(tracker.Get("worker0"), std::nullopt);
+  for (int i = 0; i < 4; ++i) {
+    tracker.Update(absl::StrCat("worker", i),
+                   Load(/*outstanding_requests=*/2, /*buffered_elements=*/1));
+  }
+  tracker.Update("slow", Load(/*outstanding_requests=*/20,
+                              /*buffered_elements=*/0));
+
+  std::optional<WorkerLoad> load = tracker.Get("worker0");
+  ASSERT_TRUE(load.has_value());
+  EXPECT_EQ(load->outstanding_requests(), 2);
+  EXPECT_FALSE(load->straggler());
+  load = tracker.Get("slow");
+  ASSERT_TRUE(load.has_value());
+  EXPECT_TRUE(load->straggler());
+
+  // Once the slow worker catches up, it is no longer a straggler.
+  tracker.Update("slow", Load(/*outstanding_requests=*/2,
+                              /*buffered_elements=*/1));
+  EXPECT_FALSE(tracker.Get("slow")->straggler());
+
+  tracker.Remove("slow");
+  EXPECT_EQ(tracker.Get("slow"), std::nullopt);
+}
+
+TEST(WorkerLoadTrackerTest, IdleClusterHasNoStragglers) {
+  WorkerLoadTracker tracker;
+  tracker.Update("worker0", Load(/*outstanding_requests=*/0,
+                                 /*buffered_elements=*/10));
+  tracker.Update("worker1", Load(/*outstanding_requests=*/1,
+                                 /*buffered_elements=*/2));
+  EXPECT_FALSE(tracker.Get("worker0")->straggler());
+  EXPECT_FALSE(tracker.Get("worker1")->straggler());
+}
+
+TEST(ProcessCpuUtilizationTest, IsAFraction) {
+  ProcessCpuUtilization cpu_utilization;
+  volatile double sink = 0;
+  for (int i = 0; i < 1000000; ++i) {
+    sink = sink + i;
+  }
+  const double utilization = cpu_utilization.Get();
+  EXPECT_GE(utilization, 0.0);
+  EXPECT_LE(utilization, 1.0);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
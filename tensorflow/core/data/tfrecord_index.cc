@@ -0,0 +1,280 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tfrecord_index.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "xla/tsl/platform/errors.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/platform/coding.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Index layout: magic, fixed64 number of offsets, the offsets as fixed64 and a
+// masked crc32c of everything before it.
+constexpr char kIndexMagic[] = "TFRIDX01";
+constexpr size_t kIndexMagicSize = sizeof(kIndexMagic) - 1;
+constexpr size_t kIndexHeaderSize = kIndexMagicSize + sizeof(uint64_t);
+constexpr size_t kIndexFooterSize = sizeof(uint32_t);
+
+// Serialized record framing, see `io::RecordWriter`.
+constexpr size_t kRecordHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+constexpr size_t kRecordFooterSize = sizeof(uint32_t);
+constexpr int64_t kMinRecordSize = kRecordHeaderSize + kRecordFooterSize;
+
+// Buffer used to stream through a file while building its index.
+constexpr int64_t kBuildIndexBufferSize = 1 << 20;
+
+}  // namespace
+
+std::string TFRecordIndexFilename(absl::string_view filename) {
+  return absl::StrCat(filename, kTFRecordIndexSuffix);
+}
+
+absl::StatusOr<std::vector<int64_t>> BuildTFRecordIndex(
+    Env* env, const std::string& filename) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+  io::RecordReaderOptions options;
+  options.buffer_size = kBuildIndexBufferSize;
+  io::SequentialRecordReader reader(file.get(), options);
+  std::vector<int64_t> offsets = {0};
+  while (true) {
+    int num_skipped = 0;
+    absl::Status s = reader.SkipRecords(1, &num_skipped);
+    if (absl::IsOutOfRange(s)) break;
+    TF_RETURN_IF_ERROR(s);
+    offsets.push_back(reader.TellOffset());
+  }
+  return offsets;
+}
+
+absl::Status WriteTFRecordIndex(Env* env, const std::string& index_filename,
+                                absl::Span<const int64_t> offsets) {
+  std::string contents(kIndexMagic, kIndexMagicSize);
+  contents.reserve(kIndexHeaderSize + offsets.size() * sizeof(uint64_t) +
+                   kIndexFooterSize);
+  core::PutFixed64(&contents, offsets.size());
+  for (const int64_t offset : offsets) {
+    core::PutFixed64(&contents, offset);
+  }
+  const uint32_t crc = crc32c::Value(contents.data(), contents.size());
+  core::PutFixed32(&contents, crc32c::Mask(crc));
+  // Write to a temporary file first so that readers never observe a partially
+  // written index.
+  const std::string tmp_filename = absl::StrCat(index_filename, ".tmp");
+  TF_RETURN_IF_ERROR(WriteStringToFile(env, tmp_filename, contents));
+  return env->RenameFile(tmp_filename, index_filename);
+}
+
+absl::StatusOr<std::vector<int64_t>> ReadTFRecordIndex(
+    Env* env, const std::string& index_filename) {
+  std::string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, index_filename, &contents));
+  if (contents.size() < kIndexHeaderSize + kIndexFooterSize ||
+      absl::string_view(contents).substr(0, kIndexMagicSize) != kIndexMagic) {
+    return absl::DataLossError(
+        absl::StrCat(index_filename, " is not a TFRecord index."));
+  }
+  const size_t payload_size = contents.size() - kIndexFooterSize;
+  const uint32_t masked_crc =
+      core::DecodeFixed32(contents.data() + payload_size);
+  if (crc32c::Unmask(masked_crc) !=
+      crc32c::Value(contents.data(), payload_size)) {
+    return absl::DataLossError(
+        absl::StrCat("Corrupted TFRecord index ", index_filename));
+  }
+  const uint64_t num_offsets =
+      core::DecodeFixed64(contents.data() + kIndexMagicSize);
+  if (num_offsets == 0 ||
+      num_offsets != (payload_size - kIndexHeaderSize) / sizeof(uint64_t) ||
+      (payload_size - kIndexHeaderSize) % sizeof(uint64_t) != 0) {
+    return absl::DataLossError(absl::StrCat(
+        "TFRecord index ", index_filename, " has an invalid size."));
+  }
+  std::vector<int64_t> offsets(num_offsets);
+  const char* p = contents.data() + kIndexHeaderSize;
+  for (uint64_t i = 0; i < num_offsets; ++i, p += sizeof(uint64_t)) {
+    offsets[i] = core::DecodeFixed64(p);
+    if (offsets[i] < 0 ||
+        (i > 0 && offsets[i] - offsets[i - 1] < kMinRecordSize)) {
+      return absl::DataLossError(absl::StrCat(
+          "TFRecord index ", index_filename, " has an invalid offset at ", i));
+    }
+  }
+  return offsets;
+}
+
+absl::Status WriteTFRecordIndexForFile(Env* env, const std::string& filename) {
+  TF_ASSIGN_OR_RETURN(std::vector<int64_t> offsets,
+                      BuildTFRecordIndex(env, filename));
+  return WriteTFRecordIndex(env, TFRecordIndexFilename(filename), offsets);
+}
+
+absl::Status DecodeTFRecord(absl::string_view data, int64_t offset,
+                            tstring* record) {
+  if (static_cast<int64_t>(data.size()) < kMinRecordSize) {
+    return absl::DataLossError(absl::StrCat("truncated record at ", offset));
+  }
+  const uint64_t length = core::DecodeFixed64(data.data());
+  const uint32_t length_crc =
+      core::DecodeFixed32(data.data() + sizeof(uint64_t));
+  if (crc32c::Unmask(length_crc) !=
+      crc32c::Value(data.data(), sizeof(uint64_t))) {
+    return absl::DataLossError(absl::StrCat("corrupted record at ", offset));
+  }
+  if (length != data.size() - kRecordHeaderSize - kRecordFooterSize) {
+    return absl::DataLossError(absl::StrCat(
+        "record at ", offset, " has length ", length,
+        " which does not match its index entry"));
+  }
+  const char* payload = data.data() + kRecordHeaderSize;
+  const uint32_t payload_crc = core::DecodeFixed32(payload + length);
+  if (crc32c::Unmask(payload_crc) != crc32c::Value(payload, length)) {
+    return absl::DataLossError(absl::StrCat("corrupted record at ", offset));
+  }
+  record->assign(payload, length);
+  return absl::OkStatus();
+}
+
+IndexedRecordReader::IndexedRecordReader(RandomAccessFile* file,
+                                         absl::Span<const int64_t> offsets,
+                                         thread::ThreadPool* io_pool,
+                                         const Options& options)
+    : file_(file), offsets_(offsets), io_pool_(io_pool), options_(options) {}
+
+IndexedRecordReader::~IndexedRecordReader() { CancelReads(); }
+
+void IndexedRecordReader::ScheduleReads() {
+  while (ranges_.size() < static_cast<size_t>(options_.max_inflight_ranges) &&
+         next_unscheduled_record_ < num_records()) {
+    auto range = std::make_shared<Range>();
+    range->begin = next_unscheduled_record_;
+    // Extend the range to whole records until it covers `range_size` bytes;
+    // a record larger than that gets a range of its own.
+    const int64_t limit = offsets_[range->begin] + options_.range_size;
+    range->end = std::max<int64_t>(
+        range->begin + 1,
+        std::upper_bound(offsets_.begin() + range->begin + 1, offsets_.end(),
+                         limit) -
+            offsets_.begin() - 1);
+    next_unscheduled_record_ = range->end;
+    ranges_.push_back(range);
+    {
+      absl::MutexLock l(mu_);
+      ++num_inflight_;
+    }
+    io_pool_->Schedule([this, range]() {
+      const uint64_t offset = offsets_[range->begin];
+      const size_t size = offsets_[range->end] - offset;
+      range->scratch.resize(size);
+      absl::string_view data;
+      absl::Status s =
+          file_->Read(offset, data, absl::MakeSpan(range->scratch));
+      if (s.ok() || (absl::IsOutOfRange(s) && data.size() == size)) {
+        s = absl::OkStatus();
+      } else if (absl::IsOutOfRange(s)) {
+        s = absl::DataLossError(absl::StrCat("truncated records at ", offset,
+                                             ": ", s.message()));
+      }
+      absl::MutexLock l(mu_);
+      range->data = data;
+      range->status = std::move(s);
+      range->done = true;
+      --num_inflight_;
+    });
+  }
+}
+
+void IndexedRecordReader::CancelReads() {
+  absl::MutexLock l(mu_);
+  mu_.Await(absl::Condition(
+      +[](int* num_inflight) { return *num_inflight == 0; }, &num_inflight_));
+  ranges_.clear();
+  next_unscheduled_record_ = next_record_;
+}
+
+absl::Status IndexedRecordReader::ReadRecord(tstring* record) {
+  if (next_record_ >= num_records()) {
+    return absl::OutOfRangeError("eof");
+  }
+  if (!ranges_.empty() && ranges_.front()->end <= next_record_) {
+    ranges_.pop_front();
+  }
+  ScheduleReads();
+  const std::shared_ptr<Range>& range = ranges_.front();
+  {
+    absl::MutexLock l(mu_);
+    mu_.Await(absl::Condition(&range->done));
+  }
+  const int64_t offset = offsets_[next_record_];
+  absl::Status s = range->status;
+  if (s.ok()) {
+    const int64_t start = offset - offsets_[range->begin];
+    s = DecodeTFRecord(
+        range->data.substr(start, offsets_[next_record_ + 1] - offset), offset,
+        record);
+  }
+  // Move past a bad record so that the next call makes progress.
+  ++next_record_;
+  return s;
+}
+
+absl::Status IndexedRecordReader::SkipRecords(int num_to_skip,
+                                              int* num_skipped) {
+  const int64_t target =
+      std::min<int64_t>(next_record_ + num_to_skip, num_records());
+  *num_skipped = target - next_record_;
+  Seek(target);
+  if (*num_skipped < num_to_skip) {
+    return absl::OutOfRangeError("eof");
+  }
+  return absl::OkStatus();
+}
+
+void IndexedRecordReader::Seek(int64_t index) {
+  next_record_ = std::clamp<int64_t>(index, 0, num_records());
+  // Ranges wholly before the new position are dropped; a seek outside the
+  // scheduled window restarts read-ahead from there.
+  while (!ranges_.empty() && ranges_.front()->end <= next_record_) {
+    ranges_.pop_front();
+  }
+  if (ranges_.empty() || ranges_.front()->begin > next_record_) {
+    CancelReads();
+  }
+}
+
+}  // namespace data
+}  // namespace tensorflow
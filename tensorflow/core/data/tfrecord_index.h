@@ -0,0 +1,152 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
+#define TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+
+// A TFRecord index is a sidecar file listing the byte offset of every record
+// in an uncompressed TFRecord file, which lets readers split a file into
+// record-aligned ranges and fetch any record with a single positioned read.
+//
+// The offsets are stored as `num_records + 1` values: entry `i` is where
+// record `i` starts and the last entry is where the last record ends, which
+// for a well-formed file is the file size.
+
+// Suffix appended to a TFRecord filename to name its sidecar index.
+inline constexpr char kTFRecordIndexSuffix[] = ".tfrecord-index";
+
+// Returns the name of the sidecar index for the TFRecord file `filename`.
+std::string TFRecordIndexFilename(absl::string_view filename);
+
+// Scans the uncompressed TFRecord file `filename` and returns its record
+// offsets. Only record headers are checksummed; record payloads are skipped.
+absl::StatusOr<std::vector<int64_t>> BuildTFRecordIndex(
+    Env* env, const std::string& filename);
+
+// Writes `offsets` to `index_filename`.
+absl::Status WriteTFRecordIndex(Env* env, const std::string& index_filename,
+                                absl::Span<const int64_t> offsets);
+
+// Reads the offsets written by `WriteTFRecordIndex`. Returns a `DataLoss`
+// error if the index is truncated, corrupted or not sorted.
+absl::StatusOr<std::vector<int64_t>> ReadTFRecordIndex(
+    Env* env, const std::string& index_filename);
+
+// Builds the index of `filename` and writes it next to the file.
+absl::Status WriteTFRecordIndexForFile(Env* env, const std::string& filename);
+
+// Decodes the record framed by `data`, which must hold exactly one serialized
+// record (length, length checksum, payload and payload checksum). `offset` is
+// the position of `data` in its file and is only used in error messages.
+absl::Status DecodeTFRecord(absl::string_view data, int64_t offset,
+                            tstring* record);
+
+// Reads the records of one indexed TFRecord file in order. Records are
+// fetched in record-aligned ranges of about `Options::range_size` bytes, with
+// up to `Options::max_inflight_ranges` ranges read ahead on `io_pool` so that
+// the latency of storage is overlapped with consuming the previous range.
+//
+// This class is not thread-safe; `file`, `offsets` and `io_pool` must outlive
+// it.
+class IndexedRecordReader {
+ public:
+  struct Options {
+    int64_t range_size = 8 << 20;
+    int max_inflight_ranges = 4;
+  };
+
+  IndexedRecordReader(RandomAccessFile* file, absl::Span<const int64_t> offsets,
+                      thread::ThreadPool* io_pool, const Options& options);
+
+  // Waits for the ranges still being read.
+  ~IndexedRecordReader();
+
+  // Reads the next record. Returns `OutOfRange` at the end of the file.
+  absl::Status ReadRecord(tstring* record);
+
+  // Skips up to `num_to_skip` records without reading them and sets
+  // `num_skipped` to the number of records skipped. Returns `OutOfRange` if
+  // the end of the file was reached first.
+  absl::Status SkipRecords(int num_to_skip, int* num_skipped);
+
+  // Positions the reader before record `index`. `index` may be the number of
+  // records, which positions the reader at the end of the file.
+  void Seek(int64_t index);
+
+  // Returns the index of the next record to read.
+  int64_t index() const { return next_record_; }
+
+  int64_t num_records() const {
+    return static_cast<int64_t>(offsets_.size()) - 1;
+  }
+
+ private:
+  // A record-aligned byte range holding records [begin, end).
+  struct Range {
+    int64_t begin;
+    int64_t end;
+    std::string scratch;
+    absl::string_view data;
+    absl::Status status;
+    bool done = false;
+  };
+
+  // Schedules reads until `max_inflight_ranges` ranges are pending or the end
+  // of the file is reached.
+  void ScheduleReads();
+  // Drops all pending ranges, waiting for the reads still in flight.
+  void CancelReads();
+
+  RandomAccessFile* const file_;
+  const absl::Span<const int64_t> offsets_;
+  thread::ThreadPool* const io_pool_;
+  const Options options_;
+
+  // Index of the next record returned by `ReadRecord`.
+  int64_t next_record_ = 0;
+  // Index of the first record not covered by `ranges_`.
+  int64_t next_unscheduled_record_ = 0;
+  // Ranges in file order. The front range holds `next_record_` unless it is
+  // empty.
+  std::deque<std::shared_ptr<Range>> ranges_;
+
+  absl::Mutex mu_;
+  int num_inflight_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
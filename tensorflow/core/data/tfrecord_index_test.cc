@@ -0,0 +1,206 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tfrecord_index.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Writes `records` to an uncompressed TFRecord file and returns its name.
+std::string WriteRecords(const std::string& name,
+                         const std::vector<std::string>& records) {
+  const std::string filename = absl::StrCat(testing::TmpDir(), "/", name);
+  std::unique_ptr<WritableFile> file;
+  TF_CHECK_OK(Env::Default()->NewWritableFile(filename, &file));
+  io::RecordWriter writer(file.get());
+  for (const std::string& record : records) {
+    TF_CHECK_OK(writer.WriteRecord(record));
+  }
+  TF_CHECK_OK(writer.Close());
+  TF_CHECK_OK(file->Close());
+  return filename;
+}
+
+std::vector<std::string> MakeRecords(int num_records) {
+  std::vector<std::string> records;
+  for (int i = 0; i < num_records; ++i) {
+    records.push_back(std::string(i * 7 % 50, 'a' + i % 26));
+  }
+  return records;
+}
+
+TEST(TFRecordIndexTest, RoundTrip) {
+  const std::vector<std::string> records = MakeRecords(20);
+  const std::string filename = WriteRecords("round_trip", records);
+  TF_ASSERT_OK(WriteTFRecordIndexForFile(Env::Default(), filename));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<int64_t> offsets,
+      ReadTFRecordIndex(Env::Default(), TFRecordIndexFilename(filename)));
+
+  ASSERT_EQ(offsets.size(), records.size() + 1);
+  uint64_t file_size = 0;
+  TF_ASSERT_OK(Env::Default()->GetFileSize(filename, &file_size));
+  EXPECT_EQ(offsets.back(), static_cast<int64_t>(file_size));
+  for (size_t i = 0; i < records.size(); ++i) {
+    // Each record is framed by a 12-byte header and a 4-byte footer.
+    EXPECT_EQ(offsets[i + 1] - offsets[i],
+              static_cast<int64_t>(records[i].size()) + 16);
+  }
+}
+
+TEST(TFRecordIndexTest, EmptyFile) {
+  const std::string filename = WriteRecords("empty", {});
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<int64_t> offsets,
+                          BuildTFRecordIndex(Env::Default(), filename));
+  EXPECT_EQ(offsets, std::vector<int64_t>({0}));
+}
+
+TEST(TFRecordIndexTest, RejectsCorruptedIndex) {
+  const std::string filename = WriteRecords("corrupted_index", MakeRecords(5));
+  const std::string index_filename = TFRecordIndexFilename(filename);
+  TF_ASSERT_OK(WriteTFRecordIndexForFile(Env::Default(), filename));
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), index_filename, &contents));
+  contents[contents.size() / 2] ^= 1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), index_filename, contents));
+  EXPECT_TRUE(absl::IsDataLoss(
+      ReadTFRecordIndex(Env::Default(), index_filename).status()));
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), index_filename, "TFRIDX0"));
+  EXPECT_TRUE(absl::IsDataLoss(
+      ReadTFRecordIndex(Env::Default(), index_filename).status()));
+}
+
+TEST(TFRecordIndexTest, DecodeDetectsCorruption) {
+  const std::string filename = WriteRecords("decode", {"hello"});
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), filename, &contents));
+  tstring record;
+  TF_ASSERT_OK(DecodeTFRecord(contents, 0, &record));
+  EXPECT_EQ(record, "hello");
+
+  EXPECT_TRUE(absl::IsDataLoss(
+      DecodeTFRecord(contents.substr(0, contents.size() - 1), 0, &record)));
+  contents[13] ^= 1;
+  EXPECT_TRUE(absl::IsDataLoss(DecodeTFRecord(contents, 0, &record)));
+}
+
+class IndexedRecordReaderTest : public ::testing::TestWithParam<int64_t> {};
+
+TEST_P(IndexedRecordReaderTest, ReadsSkipsAndSeeks) {
+  const std::vector<std::string> records = MakeRecords(100);
+  const std::string filename = WriteRecords("indexed_reader", records);
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<int64_t> offsets,
+                          BuildTFRecordIndex(Env::Default(), filename));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(filename, &file));
+  thread::ThreadPool pool(Env::Default(), "indexed_reader_test", 3);
+  IndexedRecordReader::Options options;
+  options.range_size = GetParam();
+  options.max_inflight_ranges = 3;
+  IndexedRecordReader reader(file.get(), offsets, &pool, options);
+
+  tstring record;
+  for (int i = 0; i < 10; ++i) {
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+    EXPECT_EQ(record, records[i]);
+  }
+  int num_skipped = 0;
+  TF_ASSERT_OK(reader.SkipRecords(25, &num_skipped));
+  EXPECT_EQ(num_skipped, 25);
+  TF_ASSERT_OK(reader.ReadRecord(&record));
+  EXPECT_EQ(record, records[35]);
+
+  reader.Seek(3);
+  TF_ASSERT_OK(reader.ReadRecord(&record));
+  EXPECT_EQ(record, records[3]);
+  reader.Seek(90);
+  for (int i = 90; i < 100; ++i) {
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+    EXPECT_EQ(record, records[i]);
+  }
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&record)));
+  EXPECT_TRUE(absl::IsOutOfRange(reader.SkipRecords(1, &num_skipped)));
+  EXPECT_EQ(num_skipped, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(RangeSizes, IndexedRecordReaderTest,
+                         ::testing::Values(1, 100, 1 << 20));
+
+// Compares sequential reads with indexed range reads of local files. Args:
+// record size in bytes, and whether to use the indexed reader.
+void BM_ReadTFRecords(::testing::benchmark::State& state) {
+  const int record_size = state.range(0);
+  const bool indexed = state.range(1);
+  const int num_records = std::max(1, (64 << 20) / record_size);
+  const std::string filename = WriteRecords(
+      absl::StrCat("bm_read_", record_size),
+      std::vector<std::string>(num_records, std::string(record_size, 'x')));
+  const std::vector<int64_t> offsets =
+      BuildTFRecordIndex(Env::Default(), filename).value();
+  std::unique_ptr<RandomAccessFile> file;
+  TF_CHECK_OK(Env::Default()->NewRandomAccessFile(filename, &file));
+  thread::ThreadPool pool(Env::Default(), "bm_read_tfrecords", 4);
+
+  tstring record;
+  for (auto s : state) {
+    if (indexed) {
+      IndexedRecordReader reader(file.get(), offsets, &pool,
+                                 IndexedRecordReader::Options());
+      while (reader.ReadRecord(&record).ok()) {
+      }
+    } else {
+      io::RecordReaderOptions options;
+      options.buffer_size = 256 << 10;
+      io::SequentialRecordReader reader(file.get(), options);
+      while (reader.ReadRecord(&record).ok()) {
+      }
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          offsets.back());
+}
+
+BENCHMARK(BM_ReadTFRecords)
+    ->UseRealTime()
+    ->ArgPair(100, 0)
+    ->ArgPair(100, 1)
+    ->ArgPair(10 << 10, 0)
+    ->ArgPair(10 << 10, 1)
+    ->ArgPair(1 << 20, 0)
+    ->ArgPair(1 << 20, 1);
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
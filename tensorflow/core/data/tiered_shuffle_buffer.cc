@@ -0,0 +1,320 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tiered_shuffle_buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/platform/errors.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Shards are read sequentially, so each keeps a read buffer. The buffers of
+// all open shards share the memory budget, within these bounds.
+constexpr int64_t kMinShardReadBufferSize = 4 << 10;
+constexpr int64_t kMaxShardReadBufferSize = 256 << 10;
+
+constexpr char kMemorySize[] = "tiered_buffer_memory_size";
+constexpr char kMemoryElement[] = "tiered_buffer_memory_element";
+constexpr char kNumShards[] = "tiered_buffer_num_shards";
+constexpr char kShardSize[] = "tiered_buffer_shard_size";
+constexpr char kShardElement[] = "tiered_buffer_shard_element";
+
+absl::Status ParseElement(absl::string_view serialized,
+                          std::vector<Tensor>* out) {
+  CompressedElement compressed;
+  if (!compressed.ParseFromArray(serialized.data(), serialized.size())) {
+    return absl::DataLossError(
+        "Failed to parse a compressed shuffle buffer element.");
+  }
+  return UncompressElement(compressed, out);
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<TieredShuffleBuffer>>
+TieredShuffleBuffer::Create(Env* env,
+                            const TieredShuffleBufferOptions& options) {
+  if (!options.spill_directory.empty()) {
+    if (options.memory_budget_bytes <= 0) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "The memory budget of a shuffle buffer spilling to ",
+          options.spill_directory, " must be positive, got ",
+          options.memory_budget_bytes, "."));
+    }
+    if (options.max_open_shards <= 0) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "The maximum number of open shards of a shuffle buffer must be "
+          "positive, got ",
+          options.max_open_shards, "."));
+    }
+    TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(options.spill_directory));
+  }
+  std::string shard_prefix = absl::StrCat(
+      "shuffle_buffer_", env->NowMicros(), "_", random::New64());
+  return absl::WrapUnique(
+      new TieredShuffleBuffer(env, options, std::move(shard_prefix)));
+}
+
+TieredShuffleBuffer::TieredShuffleBuffer(
+    Env* env, const TieredShuffleBufferOptions& options,
+    std::string shard_prefix)
+    : env_(env),
+      options_(options),
+      shard_prefix_(std::move(shard_prefix)),
+      shard_read_buffer_size_(std::clamp(
+          options.memory_budget_bytes / std::max<int64_t>(
+                                            options.max_open_shards, 1),
+          kMinShardReadBufferSize, kMaxShardReadBufferSize)) {}
+
+TieredShuffleBuffer::~TieredShuffleBuffer() { Clear(); }
+
+absl::Status TieredShuffleBuffer::Add(const std::vector<Tensor>& element,
+                                      absl::FunctionRef<uint64_t()> random) {
+  CompressedElement compressed;
+  TF_RETURN_IF_ERROR(
+      CompressElement(element, options_.compression, &compressed));
+  memory_.push_back(compressed.SerializeAsString());
+  memory_bytes_ += memory_.back().size();
+  if (!options_.spill_directory.empty() &&
+      memory_bytes_ > options_.memory_budget_bytes) {
+    return Spill(random);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status TieredShuffleBuffer::Remove(absl::FunctionRef<uint64_t()> random,
+                                         std::vector<Tensor>* out) {
+  if (size() == 0) {
+    return absl::FailedPreconditionError(
+        "Cannot remove an element from an empty shuffle buffer.");
+  }
+  uint64_t position = random() % size();
+  if (position < memory_.size()) {
+    std::string serialized = std::move(memory_[position]);
+    memory_[position] = std::move(memory_.back());
+    memory_.pop_back();
+    memory_bytes_ -= serialized.size();
+    return ParseElement(serialized, out);
+  }
+  size_t shard_index;
+  tstring record;
+  TF_RETURN_IF_ERROR(
+      ReadShardRecord(position - memory_.size(), &shard_index, &record));
+  if (shards_[shard_index].num_elements == 0) {
+    DeleteShard(shards_[shard_index]);
+    shards_.erase(shards_.begin() + shard_index);
+  }
+  return ParseElement(record, out);
+}
+
+absl::Status TieredShuffleBuffer::ReadShardRecord(uint64_t position,
+                                                  size_t* shard_index,
+                                                  tstring* record) {
+  *shard_index = 0;
+  while (position >=
+         static_cast<uint64_t>(shards_[*shard_index].num_elements)) {
+    position -= shards_[*shard_index].num_elements;
+    ++*shard_index;
+  }
+  Shard& shard = shards_[*shard_index];
+  TF_RETURN_IF_ERROR(shard.reader->ReadRecord(record));
+  --shard.num_elements;
+  --num_spilled_elements_;
+  return absl::OkStatus();
+}
+
+absl::Status TieredShuffleBuffer::Spill(absl::FunctionRef<uint64_t()> random) {
+  for (size_t i = memory_.size(); i > 1; --i) {
+    std::swap(memory_[i - 1], memory_[random() % i]);
+  }
+  const bool merge =
+      static_cast<int64_t>(shards_.size()) >= options_.max_open_shards;
+  std::string filename = NextShardFilename();
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env_->NewWritableFile(filename, &file));
+  io::RecordWriter writer(file.get());
+  int64_t num_elements = memory_.size();
+  if (merge) {
+    // Draws the records like `Remove` does, so the merged shard is in random
+    // order too. The memory tier is shuffled, so it is consumed in order.
+    num_elements += num_spilled_elements_;
+    size_t memory_index = 0;
+    for (int64_t remaining = num_elements; remaining > 0; --remaining) {
+      const uint64_t position = random() % remaining;
+      const size_t memory_remaining = memory_.size() - memory_index;
+      if (position < memory_remaining) {
+        TF_RETURN_IF_ERROR(writer.WriteRecord(memory_[memory_index++]));
+        continue;
+      }
+      size_t shard_index;
+      tstring record;
+      TF_RETURN_IF_ERROR(
+          ReadShardRecord(position - memory_remaining, &shard_index, &record));
+      TF_RETURN_IF_ERROR(writer.WriteRecord(record));
+    }
+    for (const Shard& shard : shards_) {
+      DeleteShard(shard);
+    }
+    shards_.clear();
+  } else {
+    for (const std::string& serialized : memory_) {
+      TF_RETURN_IF_ERROR(writer.WriteRecord(serialized));
+    }
+  }
+  TF_RETURN_IF_ERROR(writer.Close());
+  TF_RETURN_IF_ERROR(file->Close());
+  TF_RETURN_IF_ERROR(AddShard(std::move(filename), num_elements));
+  VLOG(2) << (merge ? "Merged " : "Spilled ") << num_elements
+          << " shuffle buffer elements to " << shards_.back().filename;
+  memory_.clear();
+  memory_bytes_ = 0;
+  return absl::OkStatus();
+}
+
+absl::Status TieredShuffleBuffer::AddShard(std::string filename,
+                                           int64_t num_elements) {
+  Shard shard;
+  shard.filename = std::move(filename);
+  shard.num_elements = num_elements;
+  TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(shard.filename, &shard.file));
+  io::RecordReaderOptions reader_options;
+  reader_options.buffer_size = shard_read_buffer_size_;
+  shard.reader = std::make_unique<io::SequentialRecordReader>(
+      shard.file.get(), reader_options);
+  shards_.push_back(std::move(shard));
+  num_spilled_elements_ += num_elements;
+  return absl::OkStatus();
+}
+
+std::string TieredShuffleBuffer::NextShardFilename() {
+  return io::JoinPath(options_.spill_directory,
+                      absl::StrCat(shard_prefix_, "_", next_shard_index_++));
+}
+
+void TieredShuffleBuffer::DeleteShard(const Shard& shard) {
+  absl::Status s = env_->DeleteFile(shard.filename);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to delete shuffle buffer shard " << shard.filename
+                 << ": " << s;
+  }
+}
+
+void TieredShuffleBuffer::Clear() {
+  for (const Shard& shard : shards_) {
+    DeleteShard(shard);
+  }
+  shards_.clear();
+  num_spilled_elements_ = 0;
+  memory_.clear();
+  memory_bytes_ = 0;
+}
+
+absl::Status TieredShuffleBuffer::Save(absl::string_view name,
+                                       IteratorStateWriter* writer) const {
+  TF_RETURN_IF_ERROR(writer->WriteScalar(
+      name, kMemorySize, static_cast<int64_t>(memory_.size())));
+  for (size_t i = 0; i < memory_.size(); ++i) {
+    TF_RETURN_IF_ERROR(writer->WriteScalar(
+        name, absl::StrCat(kMemoryElement, "_", i), tstring(memory_[i])));
+  }
+  TF_RETURN_IF_ERROR(writer->WriteScalar(
+      name, kNumShards, static_cast<int64_t>(shards_.size())));
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    const Shard& shard = shards_[i];
+    TF_RETURN_IF_ERROR(writer->WriteScalar(
+        name, absl::StrCat(kShardSize, "_", i), shard.num_elements));
+    // Reads the remaining records with a separate reader, leaving `shard`
+    // positioned where it was.
+    io::SequentialRecordReader reader(shard.file.get());
+    TF_RETURN_IF_ERROR(reader.SeekOffset(shard.reader->TellOffset()));
+    for (int64_t j = 0; j < shard.num_elements; ++j) {
+      tstring record;
+      TF_RETURN_IF_ERROR(reader.ReadRecord(&record));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          name, absl::StrCat(kShardElement, "_", i, "_", j), record));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status TieredShuffleBuffer::Restore(absl::string_view name,
+                                          IteratorStateReader* reader) {
+  Clear();
+  int64_t memory_size;
+  TF_RETURN_IF_ERROR(reader->ReadScalar(name, kMemorySize, &memory_size));
+  memory_.reserve(memory_size);
+  for (int64_t i = 0; i < memory_size; ++i) {
+    tstring serialized;
+    TF_RETURN_IF_ERROR(reader->ReadScalar(
+        name, absl::StrCat(kMemoryElement, "_", i), &serialized));
+    memory_bytes_ += serialized.size();
+    memory_.emplace_back(serialized);
+  }
+  int64_t num_shards;
+  TF_RETURN_IF_ERROR(reader->ReadScalar(name, kNumShards, &num_shards));
+  if (num_shards > 0 && options_.spill_directory.empty()) {
+    return absl::FailedPreconditionError(
+        "The checkpoint has shuffle buffer elements spilled to disk, but the "
+        "shuffle buffer has no spill directory.");
+  }
+  for (int64_t i = 0; i < num_shards; ++i) {
+    int64_t shard_size;
+    TF_RETURN_IF_ERROR(reader->ReadScalar(
+        name, absl::StrCat(kShardSize, "_", i), &shard_size));
+    std::string filename = NextShardFilename();
+    std::unique_ptr<WritableFile> file;
+    TF_RETURN_IF_ERROR(env_->NewWritableFile(filename, &file));
+    io::RecordWriter writer(file.get());
+    for (int64_t j = 0; j < shard_size; ++j) {
+      tstring record;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(
+          name, absl::StrCat(kShardElement, "_", i, "_", j), &record));
+      TF_RETURN_IF_ERROR(writer.WriteRecord(record));
+    }
+    TF_RETURN_IF_ERROR(writer.Close());
+    TF_RETURN_IF_ERROR(file->Close());
+    TF_RETURN_IF_ERROR(AddShard(std::move(filename), shard_size));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
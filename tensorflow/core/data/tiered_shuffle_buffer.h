@@ -0,0 +1,161 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_TIERED_SHUFFLE_BUFFER_H_
+#define TENSORFLOW_CORE_DATA_TIERED_SHUFFLE_BUFFER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+
+struct TieredShuffleBufferOptions {
+  // Budget for the compressed elements kept in memory. Must be positive if
+  // `spill_directory` is set.
+  int64_t memory_budget_bytes = 0;
+  // Local directory for elements which do not fit in the memory budget. If
+  // empty, all elements are kept in memory, compressed.
+  std::string spill_directory;
+  // Maximum number of shard files open at a time. Once reached, the next spill
+  // merges the memory tier and all shards into a single shard.
+  int64_t max_open_shards = 16;
+  CompressionOptions compression;
+};
+
+// A shuffle buffer whose elements are stored compressed, in two tiers: memory,
+// bounded by `memory_budget_bytes`, and local disk. When the memory tier
+// exceeds its budget, its elements are written in random order to a new shard
+// file and memory is cleared. If `max_open_shards` shards are already open,
+// the memory tier and the shards are instead merged into a single shard, which
+// rewrites the spilled elements but bounds the number of open files.
+//
+// The budget only covers the elements. Each open shard additionally holds a
+// file descriptor and a read buffer; read buffers are sized so that together
+// they use about the budget, within [4KB, 256KB] each.
+//
+// `Remove` samples an element uniformly across both tiers: a random position
+// either picks an element of the memory tier or picks a shard with probability
+// proportional to its remaining elements, in which case the next record of
+// the shard is read. Since shards are written in random order, their next
+// record is a uniform sample of their remaining elements, so shards are only
+// ever read sequentially.
+//
+// All randomness comes from the `random` callbacks, so a buffer restored from
+// a checkpoint with the same callbacks produces the same elements.
+//
+// This class is not thread-safe.
+class TieredShuffleBuffer {
+ public:
+  static absl::StatusOr<std::unique_ptr<TieredShuffleBuffer>> Create(
+      Env* env, const TieredShuffleBufferOptions& options);
+
+  // Deletes the remaining shard files.
+  ~TieredShuffleBuffer();
+
+  TieredShuffleBuffer(const TieredShuffleBuffer&) = delete;
+  TieredShuffleBuffer& operator=(const TieredShuffleBuffer&) = delete;
+
+  // Adds `element` to the buffer, spilling the memory tier to disk if it
+  // exceeds its budget. `random` is used to order the spilled elements.
+  absl::Status Add(const std::vector<Tensor>& element,
+                   absl::FunctionRef<uint64_t()> random);
+
+  // Removes an element chosen uniformly at random and stores it in `out`.
+  // Requires `size() > 0`.
+  absl::Status Remove(absl::FunctionRef<uint64_t()> random,
+                      std::vector<Tensor>* out);
+
+  // Returns the number of buffered elements across both tiers.
+  int64_t size() const { return memory_.size() + num_spilled_elements_; }
+  // Returns the number of compressed bytes held in memory.
+  int64_t memory_bytes() const { return memory_bytes_; }
+  int64_t num_spilled_elements() const { return num_spilled_elements_; }
+  int64_t num_shards() const { return shards_.size(); }
+
+  // Writes the buffered elements of both tiers, in order, under `name`. Shards
+  // are read but not consumed.
+  absl::Status Save(absl::string_view name, IteratorStateWriter* writer) const;
+
+  // Replaces the contents of the buffer with those saved under `name`. Spilled
+  // elements are written to new shards in the same order.
+  absl::Status Restore(absl::string_view name, IteratorStateReader* reader);
+
+ private:
+  // A spill file. Its first `num_elements` remaining records are read through
+  // `reader`.
+  struct Shard {
+    std::string filename;
+    std::unique_ptr<RandomAccessFile> file;
+    std::unique_ptr<io::SequentialRecordReader> reader;
+    int64_t num_elements = 0;
+  };
+
+  TieredShuffleBuffer(Env* env, const TieredShuffleBufferOptions& options,
+                      std::string shard_prefix);
+
+  // Writes the memory tier to a new shard in random order and clears it,
+  // merging all shards into the new one if `max_open_shards` are open.
+  absl::Status Spill(absl::FunctionRef<uint64_t()> random);
+
+  // Reads the next record of the shard holding the spilled element at
+  // `position`, and stores the index of the shard in `shard_index`.
+  absl::Status ReadShardRecord(uint64_t position, size_t* shard_index,
+                               tstring* record);
+
+  // Deletes the file of `shard`.
+  void DeleteShard(const Shard& shard);
+
+  // Opens the shard written to `filename` for reading.
+  absl::Status AddShard(std::string filename, int64_t num_elements);
+
+  // Returns the name of the next shard file.
+  std::string NextShardFilename();
+
+  // Deletes all shards and clears the memory tier.
+  void Clear();
+
+  Env* const env_;
+  const TieredShuffleBufferOptions options_;
+  // Prefix of the shard filenames, unique to this buffer.
+  const std::string shard_prefix_;
+  int64_t next_shard_index_ = 0;
+
+  // Serialized `CompressedElement`s.
+  std::vector<std::string> memory_;
+  int64_t memory_bytes_ = 0;
+  std::vector<Shard> shards_;
+  int64_t num_spilled_elements_ = 0;
+  // Size of the read buffer of each shard.
+  const int64_t shard_read_buffer_size_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_TIERED_SHUFFLE_BUFFER_H_
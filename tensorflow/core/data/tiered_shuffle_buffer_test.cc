@@ -0,0 +1,354 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tiered_shuffle_buffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include "absl/status/status.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/variant_tensor_data.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAreArray;
+
+constexpr char kBufferName[] = "buffer";
+
+// Returns an element with an id and `size` compressible floats.
+std::vector<Tensor> MakeElement(int64_t id, int64_t size = 256) {
+  Tensor values(DT_FLOAT, TensorShape({size}));
+  auto flat = values.flat<float>();
+  for (int64_t i = 0; i < size; ++i) {
+    flat(i) = (id + i) % 16;
+  }
+  return {test::AsScalar<int64_t>(id), values};
+}
+
+int64_t ElementId(const std::vector<Tensor>& element) {
+  return element[0].scalar<int64_t>()();
+}
+
+std::string SpillDirectory(absl::string_view name) {
+  return io::JoinPath(testing::TmpDir(), name);
+}
+
+std::vector<std::string> ShardFiles(const std::string& directory) {
+  std::vector<std::string> children;
+  TF_CHECK_OK(Env::Default()->GetChildren(directory, &children));
+  return children;
+}
+
+class TieredShuffleBufferTest : public ::testing::Test {
+ protected:
+  uint64_t Random() { return rng_.Rand64(); }
+
+  random::PhiloxRandom philox_{/*seed=*/42};
+  random::SimplePhilox rng_{&philox_};
+};
+
+TEST_F(TieredShuffleBufferTest, MemoryOnly) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredShuffleBuffer> buffer,
+                          TieredShuffleBuffer::Create(
+                              Env::Default(), TieredShuffleBufferOptions()));
+  std::vector<int64_t> ids;
+  for (int64_t i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(buffer->Add(MakeElement(i), [this] { return Random(); }));
+    ids.push_back(i);
+  }
+  EXPECT_EQ(buffer->size(), 100);
+  EXPECT_EQ(buffer->num_shards(), 0);
+  EXPECT_GT(buffer->memory_bytes(), 0);
+
+  std::vector<int64_t> removed;
+  while (buffer->size() > 0) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer->Remove([this] { return Random(); }, &element));
+    test::ExpectEqual(element[1], MakeElement(ElementId(element))[1]);
+    removed.push_back(ElementId(element));
+  }
+  EXPECT_THAT(removed, UnorderedElementsAreArray(ids));
+  EXPECT_NE(removed, ids);
+  EXPECT_EQ(buffer->memory_bytes(), 0);
+}
+
+TEST_F(TieredShuffleBufferTest, SpillsOverBudget) {
+  TieredShuffleBufferOptions options;
+  options.memory_budget_bytes = 1024;
+  options.spill_directory = SpillDirectory("spills_over_budget");
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredShuffleBuffer> buffer,
+                          TieredShuffleBuffer::Create(Env::Default(), options));
+  std::vector<int64_t> ids;
+  std::vector<int64_t> removed;
+  for (int64_t i = 0; i < 200; ++i) {
+    TF_ASSERT_OK(buffer->Add(MakeElement(i), [this] { return Random(); }));
+    ids.push_back(i);
+    EXPECT_LE(buffer->memory_bytes(), options.memory_budget_bytes);
+    // Interleaves removals so that shards are partially consumed.
+    if (i % 3 == 0) {
+      std::vector<Tensor> element;
+      TF_ASSERT_OK(buffer->Remove([this] { return Random(); }, &element));
+      removed.push_back(ElementId(element));
+    }
+  }
+  EXPECT_GT(buffer->num_shards(), 1);
+  EXPECT_GT(buffer->num_spilled_elements(), 0);
+  EXPECT_EQ(ShardFiles(options.spill_directory).size(), buffer->num_shards());
+
+  while (buffer->size() > 0) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer->Remove([this] { return Random(); }, &element));
+    test::ExpectEqual(element[1], MakeElement(ElementId(element))[1]);
+    removed.push_back(ElementId(element));
+  }
+  EXPECT_THAT(removed, UnorderedElementsAreArray(ids));
+  EXPECT_THAT(ShardFiles(options.spill_directory), IsEmpty());
+}
+
+TEST_F(TieredShuffleBufferTest, SamplesUniformlyAcrossTiers) {
+  constexpr int kNumElements = 10;
+  constexpr int kNumTrials = 1000;
+  // With a single open shard, every spill merges.
+  for (int64_t max_open_shards : {16, 1}) {
+    TieredShuffleBufferOptions options;
+    options.memory_budget_bytes = 256;
+    options.max_open_shards = max_open_shards;
+    options.spill_directory = SpillDirectory("samples_uniformly");
+    // Counts how often each element is the first one removed.
+    std::vector<int> counts(kNumElements);
+    for (int trial = 0; trial < kNumTrials; ++trial) {
+      TF_ASSERT_OK_AND_ASSIGN(
+          std::unique_ptr<TieredShuffleBuffer> buffer,
+          TieredShuffleBuffer::Create(Env::Default(), options));
+      for (int64_t i = 0; i < kNumElements; ++i) {
+        TF_ASSERT_OK(
+            buffer->Add(MakeElement(i), [this] { return Random(); }));
+      }
+      ASSERT_GT(buffer->num_shards(), 0);
+      std::vector<Tensor> element;
+      TF_ASSERT_OK(buffer->Remove([this] { return Random(); }, &element));
+      ++counts[ElementId(element)];
+    }
+    for (int count : counts) {
+      EXPECT_GT(count, kNumTrials / kNumElements / 2);
+      EXPECT_LT(count, kNumTrials / kNumElements * 3 / 2);
+    }
+  }
+}
+
+TEST_F(TieredShuffleBufferTest, SaveAndRestore) {
+  TieredShuffleBufferOptions options;
+  options.memory_budget_bytes = 1024;
+  options.spill_directory = SpillDirectory("save_and_restore");
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredShuffleBuffer> buffer,
+                          TieredShuffleBuffer::Create(Env::Default(), options));
+  for (int64_t i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(buffer->Add(MakeElement(i), [this] { return Random(); }));
+  }
+  for (int i = 0; i < 10; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer->Remove([this] { return Random(); }, &element));
+  }
+  ASSERT_GT(buffer->num_shards(), 0);
+
+  VariantTensorDataWriter writer;
+  TF_ASSERT_OK(buffer->Save(kBufferName, &writer));
+  std::vector<const VariantTensorData*> data;
+  writer.GetData(&data);
+  VariantTensorDataReader reader(data);
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredShuffleBuffer> restored,
+                          TieredShuffleBuffer::Create(Env::Default(), options));
+  TF_ASSERT_OK(restored->Restore(kBufferName, &reader));
+  EXPECT_EQ(restored->size(), buffer->size());
+  EXPECT_EQ(restored->num_spilled_elements(), buffer->num_spilled_elements());
+  EXPECT_EQ(restored->memory_bytes(), buffer->memory_bytes());
+
+  // Both buffers produce the same elements from the same random numbers.
+  random::PhiloxRandom philox(/*seed=*/7);
+  random::SimplePhilox rng(&philox);
+  random::PhiloxRandom restored_philox(/*seed=*/7);
+  random::SimplePhilox restored_rng(&restored_philox);
+  while (buffer->size() > 0) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer->Remove([&] { return rng.Rand64(); }, &element));
+    std::vector<Tensor> restored_element;
+    TF_ASSERT_OK(restored->Remove([&] { return restored_rng.Rand64(); },
+                                  &restored_element));
+    EXPECT_EQ(ElementId(restored_element), ElementId(element));
+  }
+  EXPECT_EQ(restored->size(), 0);
+}
+
+TEST_F(TieredShuffleBufferTest, DeletesShardsOnDestruction) {
+  TieredShuffleBufferOptions options;
+  options.memory_budget_bytes = 1024;
+  options.spill_directory = SpillDirectory("deletes_shards");
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredShuffleBuffer> buffer,
+                          TieredShuffleBuffer::Create(Env::Default(), options));
+  for (int64_t i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(buffer->Add(MakeElement(i), [this] { return Random(); }));
+  }
+  EXPECT_THAT(ShardFiles(options.spill_directory), ::testing::Not(IsEmpty()));
+  buffer.reset();
+  EXPECT_THAT(ShardFiles(options.spill_directory), IsEmpty());
+}
+
+TEST_F(TieredShuffleBufferTest, MergesShardsPastLimit) {
+  TieredShuffleBufferOptions options;
+  // Every element spills.
+  options.memory_budget_bytes = 64;
+  options.max_open_shards = 3;
+  options.spill_directory = SpillDirectory("merges_shards");
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TieredShuffleBuffer> buffer,
+                          TieredShuffleBuffer::Create(Env::Default(), options));
+  std::vector<int64_t> ids;
+  std::vector<int64_t> removed;
+  for (int64_t i = 0; i < 100; ++i) {
+    TF_ASSERT_OK(buffer->Add(MakeElement(i), [this] { return Random(); }));
+    ids.push_back(i);
+    EXPECT_LE(buffer->num_shards(), options.max_open_shards);
+    EXPECT_EQ(ShardFiles(options.spill_directory).size(),
+              buffer->num_shards());
+    if (i % 4 == 0) {
+      std::vector<Tensor> element;
+      TF_ASSERT_OK(buffer->Remove([this] { return Random(); }, &element));
+      removed.push_back(ElementId(element));
+    }
+  }
+  EXPECT_EQ(buffer->size(), ids.size() - removed.size());
+
+  while (buffer->size() > 0) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer->Remove([this] { return Random(); }, &element));
+    test::ExpectEqual(element[1], MakeElement(ElementId(element))[1]);
+    removed.push_back(ElementId(element));
+  }
+  EXPECT_THAT(removed, UnorderedElementsAreArray(ids));
+  EXPECT_THAT(ShardFiles(options.spill_directory), IsEmpty());
+}
+
+TEST(TieredShuffleBufferCreateTest, RequiresPositiveMaxOpenShards) {
+  TieredShuffleBufferOptions options;
+  options.memory_budget_bytes = 1024;
+  options.max_open_shards = 0;
+  options.spill_directory = SpillDirectory("requires_max_open_shards");
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      TieredShuffleBuffer::Create(Env::Default(), options).status()));
+}
+
+TEST(TieredShuffleBufferCreateTest, RequiresBudgetToSpill) {
+  TieredShuffleBufferOptions options;
+  options.spill_directory = SpillDirectory("requires_budget");
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      TieredShuffleBuffer::Create(Env::Default(), options).status()));
+}
+
+// Returns the resident set size of this process, or 0 if it is unknown.
+int64_t ResidentSetBytes() {
+  std::string status;
+  if (!ReadFileToString(Env::Default(), "/proc/self/status", &status).ok()) {
+    return 0;
+  }
+  for (absl::string_view line : absl::StrSplit(status, '\n')) {
+    if (!absl::ConsumePrefix(&line, "VmRSS:")) continue;
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(line, ' ', absl::SkipEmpty());
+    int64_t kilobytes;
+    if (!fields.empty() && absl::SimpleAtoi(fields[0], &kilobytes)) {
+      return kilobytes * 1024;
+    }
+  }
+  return 0;
+}
+
+// Args: shuffle window in elements, and memory budget in KB. A budget of -1
+// keeps uncompressed elements in a vector, like the default shuffle buffer,
+// and 0 keeps compressed elements in memory without spilling. Elements have
+// 16KB of repetitive floats. Reports the growth of the resident set size once
+// the window is full.
+void BM_TieredShuffleBuffer(::testing::benchmark::State& state) {
+  const int64_t window = state.range(0);
+  const int64_t budget_kb = state.range(1);
+  constexpr int64_t kElementSize = 4096;
+  random::PhiloxRandom philox(/*seed=*/42);
+  random::SimplePhilox rng(&philox);
+  auto random = [&rng] { return rng.Rand64(); };
+
+  const int64_t rss_before = ResidentSetBytes();
+  std::vector<std::vector<Tensor>> vector_buffer;
+  std::unique_ptr<TieredShuffleBuffer> buffer;
+  if (budget_kb < 0) {
+    for (int64_t i = 0; i < window; ++i) {
+      vector_buffer.push_back(MakeElement(i, kElementSize));
+    }
+  } else {
+    TieredShuffleBufferOptions options;
+    if (budget_kb > 0) {
+      options.memory_budget_bytes = budget_kb << 10;
+      options.spill_directory = SpillDirectory("benchmark");
+    }
+    buffer = TieredShuffleBuffer::Create(Env::Default(), options).value();
+    for (int64_t i = 0; i < window; ++i) {
+      TF_CHECK_OK(buffer->Add(MakeElement(i, kElementSize), random));
+    }
+  }
+  state.counters["rss_mb"] =
+      static_cast<double>(ResidentSetBytes() - rss_before) / (1 << 20);
+
+  int64_t next_id = window;
+  std::vector<Tensor> element;
+  for (auto s : state) {
+    if (buffer == nullptr) {
+      const int64_t index = random() % vector_buffer.size();
+      element = std::move(vector_buffer[index]);
+      vector_buffer[index] = MakeElement(next_id++, kElementSize);
+    } else {
+      TF_CHECK_OK(buffer->Remove(random, &element));
+      TF_CHECK_OK(buffer->Add(MakeElement(next_id++, kElementSize), random));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TieredShuffleBuffer)
+    ->ArgPair(10000, -1)
+    ->ArgPair(10000, 0)
+    ->ArgPair(10000, 4 << 10)
+    ->ArgPair(10000, 1 << 10);
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
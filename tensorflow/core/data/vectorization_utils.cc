@@ -0,0 +1,247 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/vectorization_utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xla/tsl/platform/errors.h"
+#include "tensorflow/core/common_runtime/function_body.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/util/batch_util.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Elementwise ops that are cheap enough for per-call overhead to matter. Ops
+// with attributes that change how inputs are aligned (e.g. `Select`, which
+// broadcasts a vector condition along the first dimension) are excluded.
+const absl::flat_hash_set<absl::string_view>& ElementwiseOps() {
+  static const auto* const kOps = new absl::flat_hash_set<absl::string_view>({
+      "Abs",
+      "Add",
+      "AddV2",
+      "BitwiseAnd",
+      "BitwiseOr",
+      "BitwiseXor",
+      "Cast",
+      "Ceil",
+      "Cos",
+      "Div",
+      "DivNoNan",
+      "Elu",
+      "Equal",
+      "Erf",
+      "Exp",
+      "Expm1",
+      "Floor",
+      "FloorDiv",
+      "FloorMod",
+      "Greater",
+      "GreaterEqual",
+      "Identity",
+      "IsFinite",
+      "IsInf",
+      "IsNan",
+      "Less",
+      "LessEqual",
+      "Log",
+      "Log1p",
+      "LogicalAnd",
+      "LogicalNot",
+      "LogicalOr",
+      "Maximum",
+      "Minimum",
+      "Mul",
+      "Neg",
+      "NotEqual",
+      "Pow",
+      "RealDiv",
+      "Reciprocal",
+      "Relu",
+      "Relu6",
+      "Rint",
+      "Round",
+      "Rsqrt",
+      "SelectV2",
+      "Sigmoid",
+      "Sign",
+      "Sin",
+      "Sqrt",
+      "Square",
+      "SquaredDifference",
+      "Sub",
+      "Tanh",
+      "TruncateDiv",
+  });
+  return *kOps;
+}
+
+bool IsScalarConstant(const Node& node) {
+  const TensorProto* value;
+  if (!GetNodeAttr(node.attrs(), "value", &value).ok()) {
+    return false;
+  }
+  return value->tensor_shape().dim_size() == 0 &&
+         !value->tensor_shape().unknown_rank();
+}
+
+}  // namespace
+
+bool IsElementwiseOp(absl::string_view op) {
+  return ElementwiseOps().contains(op);
+}
+
+std::optional<ElementwiseFunctionInfo> AnalyzeElementwiseFunction(
+    const FunctionBody& fbody) {
+  if (!fbody.control_ret_nodes.empty()) {
+    return std::nullopt;
+  }
+  const Graph& graph = *fbody.graph;
+  // The arguments that each node is computed from, indexed by node id.
+  std::vector<std::set<int>> node_args(graph.num_node_ids());
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+  for (const Node* node : order) {
+    if (!node->IsOp()) continue;
+    std::set<int>& args = node_args[node->id()];
+    if (node->IsArg()) {
+      int index;
+      if (!GetNodeAttr(node->attrs(), "index", &index).ok()) {
+        return std::nullopt;
+      }
+      args.insert(index);
+      continue;
+    }
+    if (node->IsConstant()) {
+      if (!IsScalarConstant(*node)) return std::nullopt;
+      continue;
+    }
+    if (!node->IsRetval() && !IsElementwiseOp(node->type_string())) {
+      return std::nullopt;
+    }
+    for (const Edge* edge : node->in_edges()) {
+      if (edge->IsControlEdge()) continue;
+      const std::set<int>& src_args = node_args[edge->src()->id()];
+      args.insert(src_args.begin(), src_args.end());
+    }
+  }
+  ElementwiseFunctionInfo info;
+  info.output_arg_indices.reserve(fbody.ret_nodes.size());
+  for (const Node* ret_node : fbody.ret_nodes) {
+    const std::set<int>& args = node_args[ret_node->id()];
+    info.output_arg_indices.emplace_back(args.begin(), args.end());
+  }
+  return info;
+}
+
+bool CanRunBatched(const ElementwiseFunctionInfo& info, int num_element_args,
+                   absl::Span<const Tensor> captured_inputs) {
+  for (const Tensor& captured_input : captured_inputs) {
+    if (captured_input.dims() != 0) return false;
+  }
+  for (const std::vector<int>& args : info.output_arg_indices) {
+    // `args` is sorted, so it reads an element component iff its smallest
+    // argument does.
+    if (args.empty() || args.front() >= num_element_args) return false;
+  }
+  return true;
+}
+
+absl::Status StackElements(absl::Span<const std::vector<Tensor>> elements,
+                           std::vector<Tensor>* batch) {
+  if (elements.empty()) {
+    return absl::InvalidArgumentError("Cannot stack an empty list of elements");
+  }
+  const std::vector<Tensor>& first = elements.front();
+  for (size_t i = 1; i < first.size(); ++i) {
+    if (first[i].dims() != first[0].dims()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Element components have different ranks: ", first[0].dims(),
+          " and ", first[i].dims()));
+    }
+  }
+  batch->clear();
+  batch->reserve(first.size());
+  const int64_t num_elements = elements.size();
+  for (size_t i = 0; i < first.size(); ++i) {
+    TensorShape shape = first[i].shape();
+    shape.InsertDim(0, num_elements);
+    batch->emplace_back(first[i].dtype(), shape);
+  }
+  for (int64_t index = 0; index < num_elements; ++index) {
+    const std::vector<Tensor>& element = elements[index];
+    if (element.size() != first.size()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Elements have different numbers of components: ", first.size(),
+          " and ", element.size()));
+    }
+    for (size_t i = 0; i < element.size(); ++i) {
+      if (element[i].dtype() != first[i].dtype() ||
+          element[i].shape() != first[i].shape()) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Component ", i, " of element ", index, " has shape ",
+            element[i].shape().DebugString(), " but expected ",
+            first[i].shape().DebugString()));
+      }
+      TF_RETURN_IF_ERROR(
+          batch_util::CopyElementToSlice(element[i], &(*batch)[i], index));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status UnstackElements(const std::vector<Tensor>& batch,
+                             int64_t num_elements,
+                             std::vector<std::vector<Tensor>>* elements) {
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (batch[i].dims() == 0 || batch[i].dim_size(0) != num_elements) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Component ", i, " of the batch has shape ",
+          batch[i].shape().DebugString(), " but expected ", num_elements,
+          " rows"));
+    }
+  }
+  elements->assign(num_elements, std::vector<Tensor>());
+  for (int64_t index = 0; index < num_elements; ++index) {
+    std::vector<Tensor>& element = (*elements)[index];
+    element.reserve(batch.size());
+    for (const Tensor& component : batch) {
+      TensorShape shape = component.shape();
+      shape.RemoveDim(0);
+      element.emplace_back(component.dtype(), shape);
+      TF_RETURN_IF_ERROR(
+          batch_util::CopySliceToElement(component, &element.back(), index));
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,79 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_VECTORIZATION_UTILS_H_
+#define TENSORFLOW_CORE_DATA_VECTORIZATION_UTILS_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/common_runtime/function_body.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+namespace data {
+
+// A function is elementwise if it only applies elementwise ops (see
+// `IsElementwiseOp`) to its arguments and to scalar constants. Such a function
+// can be applied to a batch of elements, stacked along a new leading
+// dimension, in one invocation: every op maps slice `i` of its batched inputs
+// to slice `i` of its output, and scalars broadcast to every slice.
+struct ElementwiseFunctionInfo {
+  // For each function output, the sorted indices of the arguments that it is
+  // computed from.
+  std::vector<std::vector<int>> output_arg_indices;
+};
+
+// Returns whether `op` computes each output value from the values at the same
+// position of its (broadcast) inputs.
+bool IsElementwiseOp(absl::string_view op);
+
+// Returns the elementwise information of `fbody`, or `std::nullopt` if the
+// function uses an op that is not elementwise, reads a non-scalar constant or
+// has control outputs.
+std::optional<ElementwiseFunctionInfo> AnalyzeElementwiseFunction(
+    const FunctionBody& fbody);
+
+// Returns whether a function described by `info` can be run over a batch of
+// elements. The first `num_element_args` function arguments are the
+// components of an input element and the remaining ones are
+// `captured_inputs`, which are passed unbatched. This requires all captured
+// inputs to be scalars, so that they broadcast to every element, and every
+// output to be computed from at least one element component, so that it has
+// the batch dimension.
+bool CanRunBatched(const ElementwiseFunctionInfo& info, int num_element_args,
+                   absl::Span<const Tensor> captured_inputs);
+
+// Stacks `elements` component-wise along a new leading dimension. Returns an
+// `InvalidArgument` error if a component differs in type or shape across
+// elements, or if the components of an element differ in rank, in which case
+// broadcasting between them would not be preserved by batching.
+absl::Status StackElements(absl::Span<const std::vector<Tensor>> elements,
+                           std::vector<Tensor>* batch);
+
+// Splits every component of `batch` along its leading dimension into
+// `num_elements` elements. Returns an `InvalidArgument` error if a component
+// does not have `num_elements` rows.
+absl::Status UnstackElements(const std::vector<Tensor>& batch,
+                             int64_t num_elements,
+                             std::vector<std::vector<Tensor>>* elements);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_VECTORIZATION_UTILS_H_
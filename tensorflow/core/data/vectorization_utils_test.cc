@@ -0,0 +1,151 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/vectorization_utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include "absl/status/status.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/common_runtime/function_body.h"
+#include "tensorflow/core/common_runtime/function_def_utils.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+std::optional<ElementwiseFunctionInfo> Analyze(const FunctionDef& fdef) {
+  FunctionLibraryDefinition lib_def(OpRegistry::Global(),
+                                    FunctionDefLibrary());
+  TF_CHECK_OK(lib_def.AddFunctionDef(fdef));
+  std::unique_ptr<FunctionBody> fbody;
+  TF_CHECK_OK(FunctionDefToBodyHelper(
+      fdef, test::function::Attrs({{"T", DT_FLOAT}}), &lib_def, &fbody));
+  return AnalyzeElementwiseFunction(*fbody);
+}
+
+TEST(AnalyzeElementwiseFunctionTest, ElementwiseFunctions) {
+  std::optional<ElementwiseFunctionInfo> info =
+      Analyze(test::function::XTimesTwo());
+  ASSERT_TRUE(info.has_value());
+  EXPECT_THAT(info->output_arg_indices, ElementsAre(ElementsAre(0)));
+
+  info = Analyze(test::function::XAddY());
+  ASSERT_TRUE(info.has_value());
+  EXPECT_THAT(info->output_arg_indices, ElementsAre(ElementsAre(0, 1)));
+
+  info = Analyze(test::function::Swap());
+  ASSERT_TRUE(info.has_value());
+  EXPECT_THAT(info->output_arg_indices,
+              ElementsAre(ElementsAre(1), ElementsAre(0)));
+}
+
+TEST(AnalyzeElementwiseFunctionTest, NonElementwiseFunctions) {
+  EXPECT_FALSE(Analyze(test::function::WXPlusB()).has_value());
+  EXPECT_FALSE(Analyze(FunctionDefHelper::Define(
+                           "XShape", {"x: float"}, {"y: int32"}, {},
+                           {{{"y"},
+                             "Shape",
+                             {"x"},
+                             {{"T", DT_FLOAT}, {"out_type", DT_INT32}}}}))
+                   .has_value());
+  EXPECT_FALSE(
+      Analyze(test::function::XTimesTwoWithControlOutput()).has_value());
+  EXPECT_FALSE(Analyze(FunctionDefHelper::Define(
+                           "XTimesVector", {"x: float"}, {"y: float"}, {},
+                           {FunctionDefHelper::Const<float>("v", {1.0, 2.0}),
+                            {{"y"}, "Mul", {"x", "v"}, {{"T", DT_FLOAT}}}}))
+                   .has_value());
+}
+
+TEST(CanRunBatchedTest, CapturedInputs) {
+  ElementwiseFunctionInfo info;
+  info.output_arg_indices = {{0, 1}};
+  EXPECT_TRUE(CanRunBatched(info, /*num_element_args=*/1,
+                            {test::AsScalar<float>(1.0)}));
+  EXPECT_FALSE(CanRunBatched(info, /*num_element_args=*/1,
+                             {test::AsTensor<float>({1.0, 2.0})}));
+  // An output computed only from captured inputs has no batch dimension.
+  info.output_arg_indices = {{0}, {1}};
+  EXPECT_FALSE(CanRunBatched(info, /*num_element_args=*/1,
+                             {test::AsScalar<float>(1.0)}));
+  EXPECT_TRUE(CanRunBatched(info, /*num_element_args=*/2, {}));
+  info.output_arg_indices = {{}};
+  EXPECT_FALSE(CanRunBatched(info, /*num_element_args=*/1, {}));
+}
+
+TEST(StackElementsTest, RoundTrip) {
+  std::vector<std::vector<Tensor>> elements = {
+      {test::AsTensor<int64_t>({1, 2}), test::AsTensor<float>({0.5, 1.5})},
+      {test::AsTensor<int64_t>({3, 4}), test::AsTensor<float>({2.5, 3.5})},
+      {test::AsTensor<int64_t>({5, 6}), test::AsTensor<float>({4.5, 5.5})}};
+  std::vector<Tensor> batch;
+  TF_ASSERT_OK(StackElements(elements, &batch));
+  ASSERT_EQ(batch.size(), 2);
+  test::ExpectEqual(batch[0], test::AsTensor<int64_t>({1, 2, 3, 4, 5, 6},
+                                                      TensorShape({3, 2})));
+
+  std::vector<std::vector<Tensor>> unstacked;
+  TF_ASSERT_OK(UnstackElements(batch, /*num_elements=*/3, &unstacked));
+  ASSERT_EQ(unstacked.size(), elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    ASSERT_EQ(unstacked[i].size(), 2);
+    test::ExpectEqual(unstacked[i][0], elements[i][0]);
+    test::ExpectEqual(unstacked[i][1], elements[i][1]);
+  }
+}
+
+TEST(StackElementsTest, RejectsIncompatibleElements) {
+  std::vector<Tensor> batch;
+  EXPECT_TRUE(absl::IsInvalidArgument(StackElements({}, &batch)));
+  // Different shapes across elements.
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      StackElements({{test::AsTensor<int64_t>({1, 2})},
+                     {test::AsTensor<int64_t>({3})}},
+                    &batch)));
+  // Different ranks across components, which broadcast differently once
+  // batched.
+  EXPECT_TRUE(absl::IsInvalidArgument(StackElements(
+      {{test::AsScalar<int64_t>(1), test::AsTensor<int64_t>({1, 2})}},
+      &batch)));
+}
+
+TEST(UnstackElementsTest, RejectsUnbatchedComponents) {
+  std::vector<std::vector<Tensor>> elements;
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      UnstackElements({test::AsScalar<int64_t>(1)}, 1, &elements)));
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      UnstackElements({test::AsTensor<int64_t>({1, 2})}, 3, &elements)));
+  TF_ASSERT_OK(UnstackElements({}, 2, &elements));
+  ASSERT_EQ(elements.size(), 2);
+  EXPECT_THAT(elements[0], IsEmpty());
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -60,6 +60,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/status.h"
 #include "tsl/platform/thread_annotations.h"
@@ -699,6 +700,8 @@ class IteratorContext {
     explicit Params(IteratorContext* ctx)
         : accelerator_device_info(ctx->accelerator_device_info()),
           allocator_getter(ctx->allocator_getter()),
+          batch_allocator(ctx->params_.batch_allocator),
+          batch_allocator_attrs(ctx->params_.batch_allocator_attrs),
           cancellation_manager(ctx->cancellation_manager()),
           collective_executor(ctx->collective_executor()),
           env(ctx->env()),
@@ -707,6 +710,7 @@ class IteratorContext {
           interleave_depth(ctx->interleave_depth()),
           is_restoring(ctx->is_restoring()),
           model(ctx->model()),
+          numa_node(ctx->numa_node()),
           options(ctx->options()),
           ram_budget_manager(ctx->ram_budget_manager()),
           resource_mgr(ctx->resource_mgr()),
@@ -758,6 +762,13 @@ class IteratorContext {
     // The Allocator to be used to allocate the output of an iterator.
     std::function<Allocator*(AllocatorAttributes)> allocator_getter = nullptr;
 
+    // If non-null, the Allocator to be used to allocate the output buffers of
+    // batching transformations, e.g. one which recycles them. Not owned.
+    Allocator* batch_allocator = nullptr;
+
+    // The attributes of the memory served by `batch_allocator`.
+    AllocatorAttributes batch_allocator_attrs;
+
     // The CancellationManager to be used to cancel execution of ops.
     CancellationManager* cancellation_manager = nullptr;
 
@@ -784,6 +795,10 @@ class IteratorContext {
     // If non-null, identifies the object used for performance modeling.
     std::shared_ptr<model::Model> model = nullptr;
 
+    // The NUMA node whose CPUs and memory the pipeline should use, or
+    // `port::kNUMANoAffinity`.
+    int numa_node = port::kNUMANoAffinity;
+
     // The input pipeline options.
     const Options* options = nullptr;
 
@@ -876,6 +891,17 @@ class IteratorContext {
     return params_.allocator_getter;
   }
 
+  // Returns the Allocator to be used to allocate the output buffers of batching
+  // transformations, falling back to `allocator(attrs)` if there is none or it
+  // does not serve memory with `attrs`.
+  Allocator* batch_allocator(AllocatorAttributes attrs) {
+    if (params_.batch_allocator != nullptr &&
+        attrs.IsEqualOrLessRestrictiveThan(params_.batch_allocator_attrs)) {
+      return params_.batch_allocator;
+    }
+    return allocator(attrs);
+  }
+
   CancellationManager* cancellation_manager() {
     return params_.cancellation_manager;
   }
@@ -900,6 +926,8 @@ class IteratorContext {
 
   const std::shared_ptr<model::Model>& model() const { return params_.model; }
 
+  int numa_node() const { return params_.numa_node; }
+
   const Options* options() const { return params_.options; }
 
   const std::shared_ptr<model::RamBudgetManager>& ram_budget_manager() {
@@ -1018,8 +1046,10 @@ class IteratorContext {
     if (params_.thread_factory) {
       return params_.thread_factory->StartThread(name, std::move(fn));
     } else {
+      ThreadOptions thread_options;
+      thread_options.numa_node = params_.numa_node;
       return absl::WrapUnique(
-          Env::Default()->StartThread({}, name, std::move(fn)));
+          Env::Default()->StartThread(thread_options, name, std::move(fn)));
     }
   }
 
@@ -226,6 +226,18 @@ auto* tf_data_service_cross_trainer_cache_size_bytes =
         "/tensorflow/data/service/cross_trainer_cache_size_bytes",
         "tf.data service cross-trainer cache memory usage in bytes.");
 
+auto* tf_data_service_cross_trainer_cache_tier_queries_counter =
+    tsl::monitoring::Counter<1>::New(
+        "/tensorflow/data/service/cross_trainer_cache_tier_queries",
+        "tf.data service cross-trainer cache queries by the tier which served "
+        "them: memory, disk or miss.",
+        "tier");
+
+auto* tf_data_service_cross_trainer_cache_disk_size_bytes =
+    tsl::monitoring::Gauge<int64_t, 0>::New(
+        "/tensorflow/data/service/cross_trainer_cache_disk_size_bytes",
+        "tf.data service cross-trainer cache disk usage in bytes.");
+
 auto* tf_data_service_snapshot_bytes_committed =
     tsl::monitoring::Counter<0>::New(
         "/tensorflow/data/service/snapshot_bytes_committed",
@@ -734,6 +746,15 @@ void RecordTFDataServiceCrossTrainerCacheSizeBytes(size_t bytes) {
       static_cast<int64_t>(bytes));
 }
 
+void RecordTFDataServiceCrossTrainerCacheTierQuery(const std::string& tier) {
+  tf_data_service_cross_trainer_cache_tier_queries_counter->GetCell(tier)
+      ->IncrementBy(1);
+}
+
+void RecordTFDataServiceCrossTrainerCacheDiskSizeBytes(int64_t bytes) {
+  tf_data_service_cross_trainer_cache_disk_size_bytes->GetCell()->Set(bytes);
+}
+
 void RecordTFDataServiceSnapshotBytesCommitted(int64_t bytes) {
   tf_data_service_snapshot_bytes_committed->GetCell()->IncrementBy(bytes);
 }
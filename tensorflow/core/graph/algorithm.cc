@@ -22,24 +22,65 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 
 namespace tensorflow {
+
+FrozenGraph::FrozenGraph(const Graph& g) : graph_(g) {
+  const int num_ids = g.num_node_ids();
+  nodes_.resize(num_ids, nullptr);
+  out_offsets_.assign(num_ids + 1, 0);
+  in_offsets_.assign(num_ids + 1, 0);
+  for (Node* n : g.nodes()) {
+    nodes_[n->id()] = n;
+    out_offsets_[n->id() + 1] = n->out_edges().size();
+    in_offsets_[n->id() + 1] = n->in_edges().size();
+  }
+  for (int i = 0; i < num_ids; ++i) {
+    out_offsets_[i + 1] += out_offsets_[i];
+    in_offsets_[i + 1] += in_offsets_[i];
+  }
+  out_node_ids_.resize(out_offsets_[num_ids]);
+  out_edges_.resize(out_offsets_[num_ids]);
+  in_node_ids_.resize(in_offsets_[num_ids]);
+  in_edges_.resize(in_offsets_[num_ids]);
+  for (const Node* n : g.nodes()) {
+    int32_t out = out_offsets_[n->id()];
+    for (const Edge* e : n->out_edges()) {
+      out_node_ids_[out] = e->dst()->id();
+      out_edges_[out] = e;
+      ++out;
+    }
+    int32_t in = in_offsets_[n->id()];
+    for (const Edge* e : n->in_edges()) {
+      in_node_ids_[in] = e->src()->id();
+      in_edges_[in] = e;
+      ++in;
+    }
+  }
+}
+
 namespace {
-template <typename T>
-void DFSFromHelper(const Graph& g, gtl::ArraySlice<T> start,
-                   const std::function<void(T)>& enter,
-                   const std::function<void(T)>& leave,
-                   const NodeComparator& stable_comparator,
-                   const EdgeFilter& edge_filter) {
+
+// Iterative depth-first search over `num_node_ids` nodes.
+// `for_each_neighbor(n, id, visit)` must call `visit(neighbor_id, neighbor)`
+// for each neighbor of `n` (whose id is `id`) that should be traversed.
+template <typename T, typename ForEachNeighbor>
+void DepthFirstHelper(int num_node_ids, gtl::ArraySlice<T> start,
+                      const std::function<void(T)>& enter,
+                      const std::function<void(T)>& leave,
+                      const NodeComparator& stable_comparator,
+                      const ForEachNeighbor& for_each_neighbor) {
   // Stack of work to do.
   struct Work {
     T node;
+    int id;
     bool leave;  // Are we entering or leaving n?
   };
   std::vector<Work> stack(start.size());
   for (int i = 0; i < start.size(); ++i) {
-    stack[i] = Work{start[i], false};
+    stack[i] = Work{start[i], start[i]->id(), false};
   }
 
-  std::vector<bool> visited(g.num_node_ids(), false);
+  std::vector<bool> visited(num_node_ids, false);
+  std::vector<T> nodes_sorted;
   while (!stack.empty()) {
     Work w = stack.back();
     stack.pop_back();
@@ -50,40 +91,131 @@ void DFSFromHelper(const Graph& g, gtl::ArraySlice<T> start,
       continue;
     }
 
-    if (visited[n->id()]) continue;
-    visited[n->id()] = true;
+    if (visited[w.id]) continue;
+    visited[w.id] = true;
     if (enter) enter(n);
 
     // Arrange to call leave(n) when all done with descendants.
-    if (leave) stack.push_back(Work{n, true});
+    if (leave) stack.push_back(Work{n, w.id, true});
 
-    auto add_work = [&visited, &stack](Node* out) {
-      if (!visited[out->id()]) {
+    auto add_work = [&visited, &stack](int id, T node) {
+      if (!visited[id]) {
         // Note; we must not mark as visited until we actually process it.
-        stack.push_back(Work{out, false});
+        stack.push_back(Work{node, id, false});
       }
     };
 
     if (stable_comparator) {
-      std::vector<Node*> nodes_sorted;
-      for (const Edge* out_edge : n->out_edges()) {
-        if (!edge_filter || edge_filter(*out_edge)) {
-          nodes_sorted.emplace_back(out_edge->dst());
-        }
-      }
+      nodes_sorted.clear();
+      for_each_neighbor(n, w.id, [&nodes_sorted](int, T node) {
+        nodes_sorted.push_back(node);
+      });
       std::sort(nodes_sorted.begin(), nodes_sorted.end(), stable_comparator);
-      for (Node* out : nodes_sorted) {
-        add_work(out);
+      for (T node : nodes_sorted) {
+        add_work(node->id(), node);
       }
     } else {
-      for (const Edge* out_edge : n->out_edges()) {
-        if (!edge_filter || edge_filter(*out_edge)) {
-          add_work(out_edge->dst());
+      for_each_neighbor(n, w.id, add_work);
+    }
+  }
+}
+
+template <typename T>
+void DFSFromHelper(const Graph& g, gtl::ArraySlice<T> start,
+                   const std::function<void(T)>& enter,
+                   const std::function<void(T)>& leave,
+                   const NodeComparator& stable_comparator,
+                   const EdgeFilter& edge_filter) {
+  DepthFirstHelper(
+      g.num_node_ids(), start, enter, leave, stable_comparator,
+      [&edge_filter](T n, int, const auto& visit) {
+        for (const Edge* out_edge : n->out_edges()) {
+          if (!edge_filter || edge_filter(*out_edge)) {
+            visit(out_edge->dst()->id(), out_edge->dst());
+          }
         }
+      });
+}
+
+template <typename T>
+void ReverseDFSFromHelper(const Graph& g, gtl::ArraySlice<T> start,
+                          const std::function<void(T)>& enter,
+                          const std::function<void(T)>& leave,
+                          const NodeComparator& stable_comparator,
+                          const EdgeFilter& edge_filter) {
+  DepthFirstHelper(
+      g.num_node_ids(), start, enter, leave, stable_comparator,
+      [&edge_filter](T n, int, const auto& visit) {
+        for (const Edge* in_edge : n->in_edges()) {
+          if (!edge_filter || edge_filter(*in_edge)) {
+            visit(in_edge->src()->id(), in_edge->src());
+          }
+        }
+      });
+}
+
+// Calls `visit(neighbor_id, neighbor)` for the neighbors `ids` of a node in
+// `g`, whose connecting edges are `edges`. The edges themselves are only read
+// if there is an `edge_filter`.
+template <typename Visit>
+void VisitFrozenNeighbors(const FrozenGraph& g, absl::Span<const int32_t> ids,
+                          absl::Span<const Edge* const> edges,
+                          const EdgeFilter& edge_filter, const Visit& visit) {
+  if (!edge_filter) {
+    for (int32_t id : ids) {
+      visit(id, g.node(id));
+    }
+    return;
+  }
+  for (int i = 0; i < ids.size(); ++i) {
+    if (edge_filter(*edges[i])) {
+      visit(ids[i], g.node(ids[i]));
+    }
+  }
+}
+
+void DFSFromHelper(const FrozenGraph& g, absl::Span<Node* const> start,
+                   const std::function<void(Node*)>& enter,
+                   const std::function<void(Node*)>& leave,
+                   const NodeComparator& stable_comparator,
+                   const EdgeFilter& edge_filter) {
+  DepthFirstHelper(
+      g.num_node_ids(), start, enter, leave, stable_comparator,
+      [&g, &edge_filter](Node*, int id, const auto& visit) {
+        VisitFrozenNeighbors(g, g.out_node_ids(id), g.out_edges(id),
+                             edge_filter, visit);
+      });
+}
+
+void ReverseDFSFromHelper(const FrozenGraph& g, absl::Span<Node* const> start,
+                          const std::function<void(Node*)>& enter,
+                          const std::function<void(Node*)>& leave,
+                          const NodeComparator& stable_comparator,
+                          const EdgeFilter& edge_filter) {
+  DepthFirstHelper(
+      g.num_node_ids(), start, enter, leave, stable_comparator,
+      [&g, &edge_filter](Node*, int id, const auto& visit) {
+        VisitFrozenNeighbors(g, g.in_node_ids(id), g.in_edges(id),
+                             edge_filter, visit);
+      });
+}
+
+// Removes the nodes of `g` other than source and sink that are not marked in
+// `visited`. Returns true if any node was removed.
+bool RemoveUnvisitedNodes(Graph* g, const std::vector<bool>& visited) {
+  bool any_removed = false;
+  for (int i = 0; i < visited.size(); ++i) {
+    if (!visited[i]) {
+      Node* n = g->FindNodeId(i);
+      if (n != nullptr && !n->IsSource() && !n->IsSink()) {
+        g->RemoveNode(n);
+        any_removed = true;
       }
     }
   }
+  return any_removed;
 }
+
 }  // namespace
 
 void DFS(const Graph& g, const std::function<void(Node*)>& enter,
@@ -118,72 +250,6 @@ void ReverseDFS(const Graph& g, const std::function<void(Node*)>& enter,
                  edge_filter);
 }
 
-namespace {
-
-template <typename T>
-void ReverseDFSFromHelper(const Graph& g, gtl::ArraySlice<T> start,
-                          const std::function<void(T)>& enter,
-                          const std::function<void(T)>& leave,
-                          const NodeComparator& stable_comparator,
-                          const EdgeFilter& edge_filter) {
-  // Stack of work to do.
-  struct Work {
-    T node;
-    bool leave;  // Are we entering or leaving n?
-  };
-  std::vector<Work> stack(start.size());
-  for (int i = 0; i < start.size(); ++i) {
-    stack[i] = Work{start[i], false};
-  }
-
-  std::vector<bool> visited(g.num_node_ids(), false);
-  while (!stack.empty()) {
-    Work w = stack.back();
-    stack.pop_back();
-
-    T n = w.node;
-    if (w.leave) {
-      leave(n);
-      continue;
-    }
-
-    if (visited[n->id()]) continue;
-    visited[n->id()] = true;
-    if (enter) enter(n);
-
-    // Arrange to call leave(n) when all done with descendants.
-    if (leave) stack.push_back(Work{n, true});
-
-    auto add_work = [&visited, &stack](T out) {
-      if (!visited[out->id()]) {
-        // Note; we must not mark as visited until we actually process it.
-        stack.push_back(Work{out, false});
-      }
-    };
-
-    if (stable_comparator) {
-      std::vector<T> nodes_sorted;
-      for (const Edge* in_edge : n->in_edges()) {
-        if (!edge_filter || edge_filter(*in_edge)) {
-          nodes_sorted.emplace_back(in_edge->src());
-        }
-      }
-      std::sort(nodes_sorted.begin(), nodes_sorted.end(), stable_comparator);
-      for (T in : nodes_sorted) {
-        add_work(in);
-      }
-    } else {
-      for (const Edge* in_edge : n->in_edges()) {
-        if (!edge_filter || edge_filter(*in_edge)) {
-          add_work(in_edge->src());
-        }
-      }
-    }
-  }
-}
-
-}  // namespace
-
 void ReverseDFSFrom(const Graph& g, absl::Span<const Node* const> start,
                     const std::function<void(const Node*)>& enter,
                     const std::function<void(const Node*)>& leave,
@@ -200,6 +266,38 @@ void ReverseDFSFrom(const Graph& g, absl::Span<Node* const> start,
   ReverseDFSFromHelper(g, start, enter, leave, stable_comparator, edge_filter);
 }
 
+void DFS(const FrozenGraph& g, const std::function<void(Node*)>& enter,
+         const std::function<void(Node*)>& leave,
+         const NodeComparator& stable_comparator,
+         const EdgeFilter& edge_filter) {
+  DFSFromHelper(g, {g.graph().source_node()}, enter, leave, stable_comparator,
+                edge_filter);
+}
+
+void DFSFrom(const FrozenGraph& g, absl::Span<Node* const> start,
+             const std::function<void(Node*)>& enter,
+             const std::function<void(Node*)>& leave,
+             const NodeComparator& stable_comparator,
+             const EdgeFilter& edge_filter) {
+  DFSFromHelper(g, start, enter, leave, stable_comparator, edge_filter);
+}
+
+void ReverseDFS(const FrozenGraph& g, const std::function<void(Node*)>& enter,
+                const std::function<void(Node*)>& leave,
+                const NodeComparator& stable_comparator,
+                const EdgeFilter& edge_filter) {
+  ReverseDFSFromHelper(g, {g.graph().sink_node()}, enter, leave,
+                       stable_comparator, edge_filter);
+}
+
+void ReverseDFSFrom(const FrozenGraph& g, absl::Span<Node* const> start,
+                    const std::function<void(Node*)>& enter,
+                    const std::function<void(Node*)>& leave,
+                    const NodeComparator& stable_comparator,
+                    const EdgeFilter& edge_filter) {
+  ReverseDFSFromHelper(g, start, enter, leave, stable_comparator, edge_filter);
+}
+
 void GetPostOrder(const Graph& g, std::vector<Node*>* order,
                   const NodeComparator& stable_comparator,
                   const EdgeFilter& edge_filter) {
@@ -216,6 +314,23 @@ void GetReversePostOrder(const Graph& g, std::vector<Node*>* order,
   std::reverse(order->begin(), order->end());
 }
 
+void GetPostOrder(const FrozenGraph& g, std::vector<Node*>* order,
+                  const NodeComparator& stable_comparator,
+                  const EdgeFilter& edge_filter) {
+  order->clear();
+  order->reserve(g.graph().num_nodes());
+  DFS(
+      g, nullptr, [order](Node* n) { order->push_back(n); }, stable_comparator,
+      edge_filter);
+}
+
+void GetReversePostOrder(const FrozenGraph& g, std::vector<Node*>* order,
+                         const NodeComparator& stable_comparator,
+                         const EdgeFilter& edge_filter) {
+  GetPostOrder(g, order, stable_comparator, edge_filter);
+  std::reverse(order->begin(), order->end());
+}
+
 bool PruneForReverseReachability(Graph* g,
                                  std::unordered_set<const Node*> start) {
   // Compute set of nodes that we need to traverse in order to reach
@@ -239,17 +354,31 @@ bool PruneForReverseReachability(Graph* g,
   }
 
   // Make a pass over the graph to remove nodes not in "visited".
-  bool any_removed = false;
-  for (int i = 0; i < visited.size(); ++i) {
-    if (!visited[i]) {
-      Node* n = g->FindNodeId(i);
-      if (n != nullptr && !n->IsSource() && !n->IsSink()) {
-        g->RemoveNode(n);
-        any_removed = true;
+  return RemoveUnvisitedNodes(g, visited);
+}
+
+bool PruneForReverseReachability(Graph* g, const FrozenGraph& frozen,
+                                 std::unordered_set<const Node*> start) {
+  DCHECK_EQ(&frozen.graph(), g);
+  std::vector<bool> visited(frozen.num_node_ids());
+  std::vector<int32_t> queue;
+  queue.reserve(start.size());
+  for (auto node : start) {
+    visited[node->id()] = true;
+    queue.push_back(node->id());
+  }
+  // The visit order does not matter, so use the queue as a stack.
+  while (!queue.empty()) {
+    const int32_t id = queue.back();
+    queue.pop_back();
+    for (int32_t in : frozen.in_node_ids(id)) {
+      if (!visited[in]) {
+        visited[in] = true;
+        queue.push_back(in);
       }
     }
   }
-  return any_removed;
+  return RemoveUnvisitedNodes(g, visited);
 }
 
 bool FixupSourceAndSinkEdges(Graph* g) {
@@ -16,10 +16,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_GRAPH_ALGORITHM_H_
 #define TENSORFLOW_CORE_GRAPH_ALGORITHM_H_
 
+#include <cstdint>
 #include <functional>
 #include <unordered_set>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 
@@ -44,6 +46,66 @@ struct NodeComparatorName {
   }
 };
 
+// A read-only snapshot of the topology of a Graph in compressed sparse row
+// form. The in- and out-neighbors of every node are stored in flat arrays
+// indexed by node id, so traversals read contiguous memory instead of chasing
+// Node, EdgeSet and Edge pointers. Neighbors are listed in the same order as
+// Node::in_edges() and Node::out_edges(), so the traversals below visit nodes
+// in the same order as their Graph counterparts.
+//
+// Building a FrozenGraph costs one pass over the graph, which pays off when
+// several traversals run over a large graph that is not being modified. The
+// Graph must outlive the FrozenGraph, and the FrozenGraph must not be used
+// after the Graph is mutated.
+class FrozenGraph {
+ public:
+  explicit FrozenGraph(const Graph& g);
+
+  FrozenGraph(const FrozenGraph&) = delete;
+  FrozenGraph& operator=(const FrozenGraph&) = delete;
+
+  const Graph& graph() const { return graph_; }
+  int num_node_ids() const { return nodes_.size(); }
+
+  // Returns the node with the given id, or nullptr if it has been removed.
+  Node* node(int id) const { return nodes_[id]; }
+
+  // Returns the ids of the destinations of the out edges of node `id`,
+  // including control edges. out_edges(id)[i] is the edge to
+  // out_node_ids(id)[i].
+  absl::Span<const int32_t> out_node_ids(int id) const {
+    return absl::MakeConstSpan(out_node_ids_)
+        .subspan(out_offsets_[id], out_offsets_[id + 1] - out_offsets_[id]);
+  }
+  absl::Span<const Edge* const> out_edges(int id) const {
+    return absl::MakeConstSpan(out_edges_)
+        .subspan(out_offsets_[id], out_offsets_[id + 1] - out_offsets_[id]);
+  }
+
+  // Returns the ids of the sources of the in edges of node `id`, including
+  // control edges. in_edges(id)[i] is the edge from in_node_ids(id)[i].
+  absl::Span<const int32_t> in_node_ids(int id) const {
+    return absl::MakeConstSpan(in_node_ids_)
+        .subspan(in_offsets_[id], in_offsets_[id + 1] - in_offsets_[id]);
+  }
+  absl::Span<const Edge* const> in_edges(int id) const {
+    return absl::MakeConstSpan(in_edges_)
+        .subspan(in_offsets_[id], in_offsets_[id + 1] - in_offsets_[id]);
+  }
+
+ private:
+  const Graph& graph_;
+  std::vector<Node*> nodes_;
+
+  // Neighbors of node `id` are at [offsets[id], offsets[id + 1]).
+  std::vector<int32_t> out_offsets_;
+  std::vector<int32_t> out_node_ids_;
+  std::vector<const Edge*> out_edges_;
+  std::vector<int32_t> in_offsets_;
+  std::vector<int32_t> in_node_ids_;
+  std::vector<const Edge*> in_edges_;
+};
+
 // Perform a depth-first-search on g starting at the source node.
 // If enter is not empty, calls enter(n) before visiting any children of n.
 // If leave is not empty, calls leave(n) after visiting all children of n.
@@ -100,6 +162,26 @@ void ReverseDFSFrom(const Graph& g, absl::Span<const Node* const> start,
                     const NodeComparator& stable_comparator = {},
                     const EdgeFilter& edge_filter = {});
 
+// Same as the Graph versions above, but traverse a FrozenGraph.
+void DFS(const FrozenGraph& g, const std::function<void(Node*)>& enter,
+         const std::function<void(Node*)>& leave,
+         const NodeComparator& stable_comparator = {},
+         const EdgeFilter& edge_filter = {});
+void DFSFrom(const FrozenGraph& g, absl::Span<Node* const> start,
+             const std::function<void(Node*)>& enter,
+             const std::function<void(Node*)>& leave,
+             const NodeComparator& stable_comparator = {},
+             const EdgeFilter& edge_filter = {});
+void ReverseDFS(const FrozenGraph& g, const std::function<void(Node*)>& enter,
+                const std::function<void(Node*)>& leave,
+                const NodeComparator& stable_comparator = {},
+                const EdgeFilter& edge_filter = {});
+void ReverseDFSFrom(const FrozenGraph& g, absl::Span<Node* const> start,
+                    const std::function<void(Node*)>& enter,
+                    const std::function<void(Node*)>& leave,
+                    const NodeComparator& stable_comparator = {},
+                    const EdgeFilter& edge_filter = {});
+
 void BreadthFirstTraversal(
     const Graph& g, absl::Span<const Node* const> start,
     const std::function<void(const Node*)>& visit,
@@ -137,12 +219,25 @@ void GetReversePostOrder(const Graph& g, std::vector<Node*>* order,
                          const NodeComparator& stable_comparator = {},
                          const EdgeFilter& edge_filter = {});
 
+// Same as above, but traverse a FrozenGraph.
+void GetPostOrder(const FrozenGraph& g, std::vector<Node*>* order,
+                  const NodeComparator& stable_comparator = {},
+                  const EdgeFilter& edge_filter = {});
+void GetReversePostOrder(const FrozenGraph& g, std::vector<Node*>* order,
+                         const NodeComparator& stable_comparator = {},
+                         const EdgeFilter& edge_filter = {});
+
 // Prune nodes in "g" that are not in some path from the source node
 // to any node in 'nodes'. Returns true if changes were made to the graph.
 // Does not fix up source and sink edges.
 bool PruneForReverseReachability(Graph* g,
                                  std::unordered_set<const Node*> nodes);
 
+// Same as above, but computes reachability over `frozen`, which must be a
+// FrozenGraph of *g. `frozen` must not be used once this returns true.
+bool PruneForReverseReachability(Graph* g, const FrozenGraph& frozen,
+                                 std::unordered_set<const Node*> nodes);
+
 // Connect all nodes with no incoming edges to source.
 // Connect all nodes with no outgoing edges to sink.
 //
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/graph/algorithm.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -204,6 +205,85 @@ TEST(AlgorithmTest, PostOrderWithEdgeFilter) {
   }
 }
 
+TEST(AlgorithmTest, FrozenGraphMatchesGraph) {
+  const GraphDef graph_def = test::CreateGraphDef(1 << 8, 4);
+  Graph g(OpRegistry::Global());
+  TF_ASSERT_OK(ConvertGraphDefToGraph(GraphConstructorOptions(), graph_def,
+                                      &g));
+  // Leave a hole in the node ids.
+  g.RemoveNode(g.FindNodeId(g.num_node_ids() / 2));
+  FrozenGraph frozen(g);
+
+  ASSERT_EQ(frozen.num_node_ids(), g.num_node_ids());
+  for (int id = 0; id < g.num_node_ids(); ++id) {
+    const Node* n = g.FindNodeId(id);
+    EXPECT_EQ(frozen.node(id), n);
+    if (n == nullptr) continue;
+    ASSERT_EQ(frozen.out_edges(id).size(), n->out_edges().size());
+    ASSERT_EQ(frozen.in_edges(id).size(), n->in_edges().size());
+    int i = 0;
+    for (const Edge* e : n->out_edges()) {
+      EXPECT_EQ(frozen.out_edges(id)[i], e);
+      EXPECT_EQ(frozen.out_node_ids(id)[i], e->dst()->id());
+      ++i;
+    }
+    i = 0;
+    for (const Edge* e : n->in_edges()) {
+      EXPECT_EQ(frozen.in_edges(id)[i], e);
+      EXPECT_EQ(frozen.in_node_ids(id)[i], e->src()->id());
+      ++i;
+    }
+  }
+
+  std::vector<Node*> expected;
+  std::vector<Node*> actual;
+  GetReversePostOrder(g, &expected);
+  GetReversePostOrder(frozen, &actual);
+  EXPECT_EQ(expected, actual);
+
+  GetPostOrder(g, &expected, NodeComparatorName());
+  GetPostOrder(frozen, &actual, NodeComparatorName());
+  EXPECT_EQ(expected, actual);
+
+  auto no_control_edges = [](const Edge& e) { return !e.IsControlEdge(); };
+  GetPostOrder(g, &expected, /*stable_comparator=*/{}, no_control_edges);
+  GetPostOrder(frozen, &actual, /*stable_comparator=*/{}, no_control_edges);
+  EXPECT_EQ(expected, actual);
+
+  auto collect = [](std::vector<Node*>* order) {
+    order->clear();
+    return [order](Node* n) { order->push_back(n); };
+  };
+  ReverseDFS(g, collect(&expected), nullptr);
+  ReverseDFS(frozen, collect(&actual), nullptr);
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(AlgorithmTest, PruneForReverseReachabilityWithFrozenGraph) {
+  GraphDefBuilder b(GraphDefBuilder::kFailImmediately);
+  Node* n0 = ops::SourceOp("TestParams", b.opts().WithName("n0"));
+  Node* n1 = ops::UnaryOp("TestUnary", n0, b.opts().WithName("n1"));
+  ops::UnaryOp("TestUnary", n1, b.opts().WithName("n2"));
+  ops::UnaryOp("TestUnary", n0, b.opts().WithName("n3"));
+
+  Graph g(OpRegistry::Global());
+  TF_ASSERT_OK(GraphDefBuilderToGraph(b, &g));
+  const Node* target = nullptr;
+  for (const Node* n : g.op_nodes()) {
+    if (n->name() == "n1") target = n;
+  }
+  ASSERT_NE(target, nullptr);
+
+  FrozenGraph frozen(g);
+  EXPECT_TRUE(PruneForReverseReachability(&g, frozen, {target}));
+  std::vector<std::string> names;
+  for (const Node* n : g.op_nodes()) {
+    names.push_back(n->name());
+  }
+  std::sort(names.begin(), names.end());
+  EXPECT_EQ(names, std::vector<std::string>({"n0", "n1"}));
+}
+
 void BM_PruneForReverseReachability(::testing::benchmark::State& state) {
   const int num_nodes = state.range(0);
   const int num_edges_per_node = state.range(1);
@@ -242,5 +322,58 @@ BENCHMARK(BM_PruneForReverseReachability)->ArgPair(1 << 9, 16);
 BENCHMARK(BM_PruneForReverseReachability)->ArgPair(1 << 12, 16);
 BENCHMARK(BM_PruneForReverseReachability)->ArgPair(1 << 15, 16);
 
+void BM_PruneForReverseReachabilityFrozen(
+    ::testing::benchmark::State& state) {
+  const int num_nodes = state.range(0);
+  const int num_edges_per_node = state.range(1);
+  const GraphDef graph_def =
+      test::CreateGraphDef(num_nodes, num_edges_per_node);
+  const auto registry = OpRegistry::Global();
+  GraphConstructorOptions opts;
+  for (auto s : state) {
+    state.PauseTiming();
+    Graph graph(registry);
+    TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &graph));
+    std::unordered_set<const Node*> visited;
+    visited.insert(graph.FindNodeId(graph.num_nodes() - 1));
+    state.ResumeTiming();
+    // Includes the cost of building the FrozenGraph.
+    FrozenGraph frozen(graph);
+    PruneForReverseReachability(&graph, frozen, std::move(visited));
+  }
+}
+BENCHMARK(BM_PruneForReverseReachabilityFrozen)->ArgPair(1 << 12, 4);
+BENCHMARK(BM_PruneForReverseReachabilityFrozen)->ArgPair(1 << 15, 4);
+BENCHMARK(BM_PruneForReverseReachabilityFrozen)->ArgPair(1 << 18, 4);
+
+// Measures a reverse post-order traversal of a large graph, either directly
+// over the Graph (arg 2 == 0) or over a FrozenGraph built once up front.
+void BM_ReversePostOrder(::testing::benchmark::State& state) {
+  const int num_nodes = state.range(0);
+  const int num_edges_per_node = state.range(1);
+  const bool frozen = state.range(2) != 0;
+  const GraphDef graph_def =
+      test::CreateGraphDef(num_nodes, num_edges_per_node);
+  Graph graph(OpRegistry::Global());
+  TF_CHECK_OK(
+      ConvertGraphDefToGraph(GraphConstructorOptions(), graph_def, &graph));
+  FrozenGraph frozen_graph(graph);
+  std::vector<Node*> order;
+  for (auto s : state) {
+    if (frozen) {
+      GetReversePostOrder(frozen_graph, &order);
+    } else {
+      GetReversePostOrder(graph, &order);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * graph.num_nodes());
+}
+BENCHMARK(BM_ReversePostOrder)->Args({1 << 12, 4, 0});
+BENCHMARK(BM_ReversePostOrder)->Args({1 << 12, 4, 1});
+BENCHMARK(BM_ReversePostOrder)->Args({1 << 15, 4, 0});
+BENCHMARK(BM_ReversePostOrder)->Args({1 << 15, 4, 1});
+BENCHMARK(BM_ReversePostOrder)->Args({1 << 18, 4, 0});
+BENCHMARK(BM_ReversePostOrder)->Args({1 << 18, 4, 1});
+
 }  // namespace
 }  // namespace tensorflow
@@ -695,6 +695,15 @@ class Graph {
                           bool include_flib_def = true,
                           bool include_debug_info = false) const;
 
+  // Serialize the op nodes whose id `i` has `include_node_ids[i]` set to a
+  // GraphDef. Ids past the end of `include_node_ids` are excluded. Inputs are
+  // serialized for every in-edge, so to obtain a self-contained GraphDef the
+  // selected set must be closed under in-edges, e.g. the set of nodes visited
+  // by ReverseDFSFrom(). See ToGraphDef() for `include_flib_def`.
+  void ToGraphDefForNodes(GraphDef* graph_def,
+                          const std::vector<bool>& include_node_ids,
+                          bool include_flib_def = true) const;
+
   // Serialize to a GraphDef. `include_flib_def` indicates whether the function
   // library will be populated in the `graph_def`. `include_flib_def` should be
   // usually set to true so that the populated `graph_def` will be complete.
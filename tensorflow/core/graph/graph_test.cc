@@ -33,10 +33,12 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 
@@ -431,6 +433,31 @@ TEST_F(GraphTest, NewName) {
   EXPECT_TRUE(absl::StartsWith(a1, "A")) << a1;
 }
 
+TEST_F(GraphTest, ToGraphDefForNodes) {
+  FromGraphDef(
+      "node { name: 'A' op: 'OneOutput' }"
+      "node { name: 'B' op: 'OneOutput' }"
+      "node { name: 'C' op: 'OneInput' input: [ 'A:0', '^B' ] }"
+      "node { name: 'D' op: 'OneInput' input: [ 'B:0' ] }");
+  std::vector<bool> include(graph_.num_node_ids(), false);
+  include[FindNode("A")->id()] = true;
+  include[FindNode("B")->id()] = true;
+  include[FindNode("C")->id()] = true;
+
+  GraphDef graph_def;
+  graph_.ToGraphDefForNodes(&graph_def, include,
+                            /*include_flib_def=*/false);
+  ASSERT_EQ(graph_def.node_size(), 3);
+  for (const NodeDef& node_def : graph_def.node()) {
+    EXPECT_NE(node_def.name(), "D");
+    if (node_def.name() == "C") {
+      ASSERT_EQ(node_def.input_size(), 2);
+      EXPECT_EQ(node_def.input(0), "A");
+      EXPECT_EQ(node_def.input(1), "^B");
+    }
+  }
+}
+
 TEST_F(GraphTest, IsValidNode) {
   // Add 1 node to graph_
   Node* g1_node1;
@@ -940,6 +967,37 @@ BENCHMARK(BM_GraphCreation)->ArgPair(1 << 9, 16);
 BENCHMARK(BM_GraphCreation)->ArgPair(1 << 12, 16);
 BENCHMARK(BM_GraphCreation)->ArgPair(1 << 15, 16);
 
+// Measures ConvertGraphDefToGraph() throughput in nodes/sec, with per-node
+// preparation sharded across `num_threads` threads (0 for none).
+void BM_GraphCreationParallel(::testing::benchmark::State& state) {
+  const int num_nodes = state.range(0);
+  const int num_threads = state.range(1);
+  const GraphDef graph_def = test::CreateGraphDef(num_nodes, 4);
+  const auto registry = OpRegistry::Global();
+  std::unique_ptr<thread::ThreadPool> pool;
+  GraphConstructorOptions opts;
+  opts.validate_nodes = true;
+  if (num_threads > 0) {
+    pool = std::make_unique<thread::ThreadPool>(Env::Default(), "import",
+                                                num_threads);
+    opts.thread_pool = pool.get();
+  }
+  // Warmup step.
+  Graph graph(registry);
+  TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &graph));
+  for (auto s : state) {
+    Graph graph(registry);
+    TF_CHECK_OK(ConvertGraphDefToGraph(opts, graph_def, &graph));
+  }
+  state.SetItemsProcessed(state.iterations() * graph_def.node_size());
+}
+BENCHMARK(BM_GraphCreationParallel)->ArgPair(1 << 12, 0);
+BENCHMARK(BM_GraphCreationParallel)->ArgPair(1 << 12, 8);
+BENCHMARK(BM_GraphCreationParallel)->ArgPair(1 << 15, 0);
+BENCHMARK(BM_GraphCreationParallel)->ArgPair(1 << 15, 8);
+BENCHMARK(BM_GraphCreationParallel)->ArgPair(1 << 18, 0);
+BENCHMARK(BM_GraphCreationParallel)->ArgPair(1 << 18, 8);
+
 void BM_ToGraphDef(::testing::benchmark::State& state) {
   const int num_nodes = state.range(0);
   const int num_edges_per_node = state.range(1);
@@ -0,0 +1,569 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/cost_based_optimization.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/data/pipeline_stats.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/framework/model.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/function_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/fusion_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/statusor.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kMapDataset[] = "MapDataset";
+constexpr char kParallelMapDataset[] = "ParallelMapDatasetV2";
+constexpr char kFilterDataset[] = "FilterDataset";
+constexpr char kOptionsDataset[] = "OptionsDataset";
+constexpr char kPrefetchDataset[] = "PrefetchDataset";
+constexpr std::array<const char*, 2> kCacheDatasets = {"CacheDataset",
+                                                       "CacheDatasetV2"};
+constexpr std::array<const char*, 6> kAsyncDatasets = {
+    "MapAndBatchDataset",    "ParallelBatchDataset",
+    "ParallelFilterDataset", "ParallelInterleaveDataset",
+    "ParallelMapDataset",    "PrefetchDataset"};
+
+// Maps cheaper than this per element are dominated by per-element overhead.
+constexpr double kCheapNsecPerElement = 10 * 1000;
+// Filters keeping a larger fraction of their input are not worth moving.
+constexpr double kMaxFilterSelectivity = 0.9;
+// Maps must grow their elements at least this much to be moved after a cache.
+constexpr double kMinCacheBytesRatio = 2;
+// Synchronous transformations taking a larger share of the processing time
+// are followed by a prefetch.
+constexpr double kMinPrefetchTimeShare = 0.3;
+
+// A dataset node on the path from the output to the source, with the
+// statistics of its iterator.
+struct PathNode {
+  const NodeDef* node;
+  data::PipelineNodeStats stats;
+};
+
+struct RewriteContext {
+  MutableGraphView* graph;
+  FunctionLibraryDefinition* library;
+  FunctionDefLibrary* output_library;
+  absl::flat_hash_set<std::string> nodes_to_delete;
+};
+
+void LogDecision(absl::string_view decision) {
+  LOG(INFO) << "Cost-based tf.data optimization: " << decision;
+}
+
+// Strips a trailing version suffix, e.g. "ParallelMapV2" -> "ParallelMap".
+absl::string_view StripVersion(absl::string_view name) {
+  size_t pos = name.rfind('V');
+  if (pos == absl::string_view::npos || pos + 1 == name.size()) return name;
+  for (char c : name.substr(pos + 1)) {
+    if (!absl::ascii_isdigit(c)) return name;
+  }
+  return name.substr(0, pos);
+}
+
+// Returns true if the model node `model_name` may be the iterator of `op`.
+// Iterator names are the op name without "Dataset", possibly qualified, e.g.
+// "MemoryCache" for "CacheDatasetV2".
+bool MatchesModelNode(const std::string& op, absl::string_view model_name) {
+  std::string op_name = absl::StrReplaceAll(op, {{"Dataset", ""}});
+  return absl::EndsWith(StripVersion(model_name), StripVersion(op_name));
+}
+
+// Walks the graph from `last_node` and the recorded statistics from the
+// output, along first inputs, for as long as they agree.
+std::vector<PathNode> MatchPipeline(
+    const NodeDef* last_node, const MutableGraphView& graph,
+    const std::vector<data::PipelineNodeStats>& pipeline_stats) {
+  std::vector<PathNode> path;
+  const NodeDef* node = last_node;
+  for (const data::PipelineNodeStats& stats : pipeline_stats) {
+    // Options datasets forward their iterator to their input.
+    while (node != nullptr && node->op() == kOptionsDataset) {
+      node = graph_utils::GetInputNode(*node, graph);
+    }
+    if (node == nullptr) break;
+    if (!MatchesModelNode(node->op(), stats.name)) {
+      VLOG(1) << "Stopped matching the input pipeline with its statistics at "
+              << node->name() << ": " << node->op() << " vs " << stats.name;
+      break;
+    }
+    path.push_back({node, stats});
+    node = graph_utils::GetInputNode(*node, graph);
+  }
+  return path;
+}
+
+bool IsAsync(const NodeDef& node) {
+  return absl::c_any_of(kAsyncDatasets, [&node](const char* dataset) {
+    return data::MatchesAnyVersion(dataset, node.op());
+  });
+}
+
+// Returns true for maps without captured inputs.
+bool IsMap(const NodeDef& node) {
+  return (node.op() == kMapDataset && node.input_size() == 1) ||
+         (node.op() == kParallelMapDataset && node.input_size() == 2);
+}
+
+bool IsCheap(const data::PipelineNodeStats& stats) {
+  return stats.num_elements > 0 &&
+         stats.processing_time_per_element_nsec < kCheapNsecPerElement;
+}
+
+const FunctionDef* GetFunction(const NodeDef& node, absl::string_view attr,
+                               const FunctionLibraryDefinition& library) {
+  auto it = node.attr().find(attr);
+  if (it == node.attr().end()) return nullptr;
+  return library.Find(it->second.func().name());
+}
+
+bool IsStatelessMap(const NodeDef& node,
+                    const FunctionLibraryDefinition& library) {
+  const FunctionDef* func = GetFunction(node, "f", library);
+  return func != nullptr && !function_utils::IsFunctionStateful(library, *func);
+}
+
+// Returns true if `input` has a single consumer, so that it can be removed
+// along with that consumer.
+bool HasSingleFanout(const NodeDef& input, const MutableGraphView& graph) {
+  return graph.GetFanouts(input, /*include_controlling_edges=*/true).size() ==
+         1;
+}
+
+bool IsAutotune(const std::string& node_name, const MutableGraphView& graph) {
+  const NodeDef* node = graph.GetNode(node_name);
+  int64_t value;
+  return node != nullptr &&
+         graph_utils::GetScalarConstNodeValue(*node, &value).ok() &&
+         value == data::model::kAutotune;
+}
+
+std::string DeterministicAttr(const NodeDef& node) {
+  auto it = node.attr().find("deterministic");
+  return it == node.attr().end() ? "default" : it->second.s();
+}
+
+bool UsesUnboundedThreadPool(const NodeDef& node) {
+  auto it = node.attr().find("use_unbounded_threadpool");
+  return it != node.attr().end() && it->second.b();
+}
+
+bool IsInMemoryCache(const NodeDef& node, const MutableGraphView& graph) {
+  if (!absl::c_linear_search(kCacheDatasets, node.op()) ||
+      node.input_size() < 2) {
+    return false;
+  }
+  const NodeDef* filename = graph.GetNode(node.input(1));
+  Tensor value;
+  return filename != nullptr && filename->op() == "Const" &&
+         GetNodeAttr(*filename, "value", &value).ok() &&
+         value.dtype() == DT_STRING && value.NumElements() == 1 &&
+         value.flat<tstring>()(0).empty();
+}
+
+// Returns the index of the input of `func` which its output `output_index`
+// passes through unchanged, or -1. Follows the identities which tf.function
+// adds to returned values.
+int PassthroughInput(const FunctionDef& func, int output_index) {
+  const std::string& output_name =
+      func.signature().output_arg(output_index).name();
+  auto it = func.ret().find(output_name);
+  if (it == func.ret().end()) return -1;
+  std::string tensor = it->second;
+  while (true) {
+    int input_index = function_utils::FindFunctionInputWithName(tensor, func);
+    if (input_index >= 0) return input_index;
+    std::vector<absl::string_view> parts = absl::StrSplit(tensor, ':');
+    int node_index = function_utils::FindFunctionNodeWithName(parts[0], func);
+    if (node_index < 0) return -1;
+    const NodeDef& node = func.node_def(node_index);
+    if (node.op() != "Identity" || node.input_size() == 0) return -1;
+    tensor = node.input(0);
+  }
+}
+
+// Returns true if any node or output of `func` reads its input `name`.
+bool ReadsInput(const FunctionDef& func, absl::string_view name) {
+  auto refers_to = [name](absl::string_view tensor) {
+    return tensor == name || absl::StartsWith(tensor, absl::StrCat(name, ":"));
+  };
+  for (const NodeDef& node : func.node_def()) {
+    if (absl::c_any_of(node.input(), refers_to)) return true;
+  }
+  for (const auto& [output, tensor] : func.ret()) {
+    if (refers_to(tensor)) return true;
+  }
+  return false;
+}
+
+// Returns a copy of `predicate`, which reads the outputs of `map_func`,
+// rewritten to read the inputs of `map_func` instead. Returns nullptr if the
+// predicate reads an output which is not passed through by the map.
+FunctionDef* MakePredicateOnMapInputs(const FunctionDef& predicate,
+                                      const FunctionDef& map_func,
+                                      FunctionDefLibrary* library) {
+  const OpDef& predicate_signature = predicate.signature();
+  const OpDef& map_signature = map_func.signature();
+  if (predicate_signature.input_arg_size() != map_signature.output_arg_size()) {
+    return nullptr;
+  }
+  FunctionDef result = predicate;
+  result.mutable_signature()->clear_input_arg();
+  result.clear_arg_attr();
+  result.clear_resource_arg_unique_id();
+  for (int i = 0; i < map_signature.input_arg_size(); ++i) {
+    OpDef::ArgDef* arg = result.mutable_signature()->add_input_arg();
+    *arg = map_signature.input_arg(i);
+    arg->set_name(absl::StrCat("cost_based_input_", i));
+  }
+  for (int i = 0; i < predicate_signature.input_arg_size(); ++i) {
+    const std::string& name = predicate_signature.input_arg(i).name();
+    if (!ReadsInput(predicate, name)) continue;
+    int map_input = PassthroughInput(map_func, i);
+    if (map_input < 0) return nullptr;
+    function_utils::ReplaceReferences(
+        name, result.signature().input_arg(map_input).name(), &result);
+  }
+  graph_utils::SetUniqueGraphFunctionName(
+      absl::StrCat("cost_based/", predicate_signature.name()), library,
+      &result);
+  FunctionDef* added = library->add_function();
+  *added = std::move(result);
+  return added;
+}
+
+// Replaces `consumer(producer(x))` with `producer(new_consumer)`, where
+// `new_consumer` reads `x`.
+absl::Status SwapWithInput(const NodeDef& consumer, const NodeDef& producer,
+                           NodeDef new_consumer, RewriteContext* ctx) {
+  const NodeDef* added_consumer = ctx->graph->AddNode(std::move(new_consumer));
+  NodeDef new_producer = producer;
+  graph_utils::SetUniqueGraphNodeName(
+      absl::StrCat("cost_based/", producer.name()), ctx->graph->graph(),
+      &new_producer);
+  new_producer.set_input(0, added_consumer->name());
+  const NodeDef* added_producer = ctx->graph->AddNode(std::move(new_producer));
+  TF_RETURN_IF_ERROR(
+      ctx->graph->UpdateFanouts(consumer.name(), added_producer->name()));
+  ctx->nodes_to_delete.insert(consumer.name());
+  ctx->nodes_to_delete.insert(producer.name());
+  return absl::OkStatus();
+}
+
+// Returns a copy of `consumer` reading the input of `producer`.
+absl::StatusOr<NodeDef> CopyOnInputOf(const NodeDef& consumer,
+                                      const NodeDef& producer,
+                                      const RewriteContext& ctx) {
+  const NodeDef* input = graph_utils::GetInputNode(producer, *ctx.graph);
+  NodeDef result = consumer;
+  graph_utils::SetUniqueGraphNodeName(
+      absl::StrCat("cost_based/", consumer.name()), ctx.graph->graph(),
+      &result);
+  result.set_input(0, producer.input(0));
+  if (input == nullptr ||
+      !graph_utils::CopyShapesAndTypesAttrs(*input, &result)) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "The input of ", producer.name(), " has no element spec."));
+  }
+  return result;
+}
+
+absl::StatusOr<bool> MaybeMoveFilterBeforeMap(const PathNode& filter,
+                                              const PathNode& map,
+                                              RewriteContext* ctx) {
+  if (filter.node->op() != kFilterDataset || filter.node->input_size() != 1 ||
+      !IsMap(*map.node) || !IsStatelessMap(*map.node, *ctx->library) ||
+      !HasSingleFanout(*map.node, *ctx->graph)) {
+    return false;
+  }
+  if (filter.stats.selectivity > kMaxFilterSelectivity) {
+    VLOG(1) << "Not moving " << filter.node->name() << " before "
+            << map.node->name() << ": it keeps "
+            << filter.stats.selectivity * 100 << "% of the elements.";
+    return false;
+  }
+  absl::StatusOr<NodeDef> new_filter =
+      CopyOnInputOf(*filter.node, *map.node, *ctx);
+  if (!new_filter.ok()) {
+    VLOG(1) << new_filter.status();
+    return false;
+  }
+  const FunctionDef* predicate =
+      GetFunction(*filter.node, "predicate", *ctx->library);
+  const FunctionDef* map_func = GetFunction(*map.node, "f", *ctx->library);
+  if (predicate == nullptr || map_func == nullptr) return false;
+  FunctionDef* new_predicate =
+      MakePredicateOnMapInputs(*predicate, *map_func, ctx->output_library);
+  if (new_predicate == nullptr) {
+    VLOG(1) << "Not moving " << filter.node->name() << " before "
+            << map.node->name() << ": the predicate reads computed values.";
+    return false;
+  }
+  (*new_filter->mutable_attr())["predicate"].mutable_func()->set_name(
+      new_predicate->signature().name());
+  TF_RETURN_IF_ERROR(ctx->library->AddFunctionDef(*new_predicate));
+  LogDecision(absl::StrCat(
+      "moving ", filter.node->name(), " before ", map.node->name(),
+      ", which saves the map for ", (1 - filter.stats.selectivity) * 100,
+      "% of the elements at ",
+      map.stats.processing_time_per_element_nsec / 1000, "us each."));
+  TF_RETURN_IF_ERROR(SwapWithInput(*filter.node, *map.node,
+                                   *std::move(new_filter), ctx));
+  return true;
+}
+
+absl::StatusOr<bool> MaybeMoveCacheBeforeMap(const PathNode& cache,
+                                             const PathNode& map,
+                                             RewriteContext* ctx) {
+  if (!IsInMemoryCache(*cache.node, *ctx->graph) || !IsMap(*map.node) ||
+      !IsStatelessMap(*map.node, *ctx->library) ||
+      !HasSingleFanout(*map.node, *ctx->graph)) {
+    return false;
+  }
+  if (!IsCheap(map.stats) || map.stats.bytes_ratio < kMinCacheBytesRatio) {
+    VLOG(1) << "Not moving " << cache.node->name() << " before "
+            << map.node->name() << ": the map takes "
+            << map.stats.processing_time_per_element_nsec / 1000
+            << "us per element and grows elements "
+            << map.stats.bytes_ratio << "x.";
+    return false;
+  }
+  absl::StatusOr<NodeDef> new_cache =
+      CopyOnInputOf(*cache.node, *map.node, *ctx);
+  if (!new_cache.ok()) {
+    VLOG(1) << new_cache.status();
+    return false;
+  }
+  LogDecision(absl::StrCat(
+      "moving ", cache.node->name(), " before ", map.node->name(),
+      ", which grows elements ", map.stats.bytes_ratio, "x and takes ",
+      map.stats.processing_time_per_element_nsec / 1000, "us per element."));
+  TF_RETURN_IF_ERROR(
+      SwapWithInput(*cache.node, *map.node, *std::move(new_cache), ctx));
+  return true;
+}
+
+absl::StatusOr<bool> MaybeFuseMaps(const PathNode& map,
+                                   const PathNode& parent_map,
+                                   RewriteContext* ctx) {
+  const NodeDef& child = *map.node;
+  const NodeDef& parent = *parent_map.node;
+  if (!IsMap(child) || !IsMap(parent) || child.op() != parent.op() ||
+      !HasSingleFanout(parent, *ctx->graph)) {
+    return false;
+  }
+  if (child.op() == kParallelMapDataset &&
+      (!IsAutotune(child.input(1), *ctx->graph) ||
+       !IsAutotune(parent.input(1), *ctx->graph) ||
+       DeterministicAttr(child) != DeterministicAttr(parent) ||
+       UsesUnboundedThreadPool(child) || UsesUnboundedThreadPool(parent))) {
+    return false;
+  }
+  if (!IsCheap(map.stats) || !IsCheap(parent_map.stats)) {
+    VLOG(1) << "Not fusing " << parent.name() << " and " << child.name()
+            << ": they take "
+            << parent_map.stats.processing_time_per_element_nsec / 1000
+            << "us and "
+            << map.stats.processing_time_per_element_nsec / 1000
+            << "us per element.";
+    return false;
+  }
+  const FunctionDef* parent_func = GetFunction(parent, "f", *ctx->library);
+  const FunctionDef* func = GetFunction(child, "f", *ctx->library);
+  if (parent_func == nullptr || func == nullptr ||
+      !fusion_utils::CanCompose(parent_func->signature(), func->signature())) {
+    return false;
+  }
+  const FunctionDef* fused_func = fusion_utils::FuseFunctions(
+      *parent_func, *func,
+      absl::StrCat("cost_based/", parent_func->signature().name(), "/",
+                   func->signature().name()),
+      fusion_utils::ComposeSignature, fusion_utils::ComposeInput,
+      fusion_utils::ComposeOutput, fusion_utils::MergeNodes,
+      ctx->output_library);
+  TF_RETURN_IF_ERROR(ctx->library->AddFunctionDef(*fused_func));
+
+  NodeDef fused = child;
+  graph_utils::SetUniqueGraphNodeName(
+      absl::StrCat("cost_based/", parent.name(), "/", child.name()),
+      ctx->graph->graph(), &fused);
+  fused.set_input(0, parent.input(0));
+  (*fused.mutable_attr())["f"].mutable_func()->set_name(
+      fused_func->signature().name());
+  auto value_or_false = [](const NodeDef& node, absl::string_view attr) {
+    auto it = node.attr().find(attr);
+    return it != node.attr().end() && it->second.b();
+  };
+  (*fused.mutable_attr())["use_inter_op_parallelism"].set_b(
+      value_or_false(parent, "use_inter_op_parallelism") ||
+      value_or_false(child, "use_inter_op_parallelism"));
+  (*fused.mutable_attr())["preserve_cardinality"].set_b(
+      value_or_false(parent, "preserve_cardinality") &&
+      value_or_false(child, "preserve_cardinality"));
+  graph_utils::MaybeSetFusedMetadata(parent, child, &fused);
+
+  LogDecision(absl::StrCat(
+      "fusing ", parent.name(), " and ", child.name(), ", which take ",
+      parent_map.stats.processing_time_per_element_nsec / 1000, "us and ",
+      map.stats.processing_time_per_element_nsec / 1000, "us per element."));
+  const NodeDef* added = ctx->graph->AddNode(std::move(fused));
+  TF_RETURN_IF_ERROR(ctx->graph->UpdateFanouts(child.name(), added->name()));
+  ctx->nodes_to_delete.insert(child.name());
+  ctx->nodes_to_delete.insert(parent.name());
+  return true;
+}
+
+absl::StatusOr<bool> MaybeInjectPrefetch(const PathNode& consumer,
+                                         const PathNode& node,
+                                         RewriteContext* ctx) {
+  if (consumer.node->op() == kPrefetchDataset || IsAsync(*node.node) ||
+      node.stats.processing_time_share < kMinPrefetchTimeShare) {
+    return false;
+  }
+  NodeDef prefetch;
+  graph_utils::SetUniqueGraphNodeName(
+      absl::StrCat("cost_based/prefetch_", node.node->name()),
+      ctx->graph->graph(), &prefetch);
+  prefetch.set_op(kPrefetchDataset);
+  prefetch.add_input(node.node->name());
+  NodeDef* buffer_size =
+      graph_utils::AddScalarConstNode(data::model::kAutotune, ctx->graph);
+  prefetch.add_input(buffer_size->name());
+  if (!graph_utils::CopyShapesAndTypesAttrs(*node.node, &prefetch)) {
+    return false;
+  }
+  TF_RETURN_IF_ERROR(graph_utils::SetMetadataName(prefetch.name(), &prefetch));
+  LogDecision(absl::StrCat("prefetching after ", node.node->name(),
+                           ", which takes ",
+                           node.stats.processing_time_share * 100,
+                           "% of the processing time."));
+  const NodeDef* added = ctx->graph->AddNode(std::move(prefetch));
+  TF_RETURN_IF_ERROR(
+      ctx->graph->UpdateFanouts(node.node->name(), added->name()));
+  return true;
+}
+
+}  // namespace
+
+absl::Status CostBasedOptimization::OptimizeAndCollectStats(
+    Cluster* cluster, const GrapplerItem& item, GraphDef* output,
+    OptimizationStats* stats) {
+  *output = item.graph;
+  if (stats_filename_.empty()) return absl::OkStatus();
+  MutableGraphView graph(output);
+
+  // If the GrapplerItem is derived from a FunctionDef, we don't optimize it.
+  if (graph_utils::IsItemDerivedFromFunctionDef(item, graph)) {
+    return absl::OkStatus();
+  }
+  if (item.fetch.size() != 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected only one fetch node but there were ",
+                     item.fetch.size(), ": ", absl::StrJoin(item.fetch, ", ")));
+  }
+
+  absl::StatusOr<data::model::ModelProto> model =
+      data::LoadPipelineStats(Env::Default(), stats_filename_);
+  if (absl::IsNotFound(model.status())) {
+    VLOG(1) << "No input pipeline statistics were recorded in "
+            << stats_filename_ << " yet.";
+    return absl::OkStatus();
+  }
+  if (!model.ok()) {
+    LOG(WARNING) << "Failed to read the input pipeline statistics from "
+                 << stats_filename_ << ": " << model.status();
+    return absl::OkStatus();
+  }
+
+  NodeDef* sink_node = graph.GetNode(item.fetch.at(0));
+  std::vector<PathNode> path =
+      MatchPipeline(graph_utils::GetInputNode(*sink_node, graph), graph,
+                    data::GetPipelineStats(*model));
+  VLOG(1) << "Matched " << path.size()
+          << " nodes of the input pipeline with their statistics.";
+
+  FunctionLibraryDefinition library(OpRegistry::Global(), output->library());
+  RewriteContext ctx{&graph, &library, output->mutable_library()};
+  absl::flat_hash_set<const NodeDef*> rewritten;
+  // `path[i]` consumes `path[i + 1]`. Each node takes part in one rewrite.
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    const PathNode& consumer = path[i];
+    const PathNode& producer = path[i + 1];
+    if (rewritten.contains(consumer.node) ||
+        rewritten.contains(producer.node)) {
+      continue;
+    }
+    bool changed = false;
+    for (auto rewrite :
+         {MaybeMoveFilterBeforeMap, MaybeMoveCacheBeforeMap, MaybeFuseMaps}) {
+      TF_ASSIGN_OR_RETURN(changed, rewrite(consumer, producer, &ctx));
+      if (changed) break;
+    }
+    if (changed) {
+      rewritten.insert(consumer.node);
+      rewritten.insert(producer.node);
+      stats->num_changes++;
+    }
+  }
+  // A prefetch after the last transformation is injected by `inject_prefetch`.
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    if (rewritten.contains(path[i].node) ||
+        rewritten.contains(path[i + 1].node)) {
+      continue;
+    }
+    TF_ASSIGN_OR_RETURN(bool changed,
+                        MaybeInjectPrefetch(path[i], path[i + 1], &ctx));
+    if (changed) stats->num_changes++;
+  }
+  return graph.DeleteNodes(ctx.nodes_to_delete);
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(CostBasedOptimization, "cost_based_optimization");
+
+}  // namespace grappler
+}  // namespace tensorflow
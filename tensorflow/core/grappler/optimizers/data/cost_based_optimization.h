@@ -0,0 +1,78 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_COST_BASED_OPTIMIZATION_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_COST_BASED_OPTIMIZATION_H_
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/grappler/optimizers/data/optimizer_base.h"
+
+namespace tensorflow {
+namespace grappler {
+
+constexpr char kStatsFilename[] = "stats_filename";
+
+// Rewrites the input pipeline based on the statistics recorded by the
+// autotuning model of a previous run of the same pipeline, read from the
+// `stats_filename` parameter. The nodes of the graph are matched with the
+// model nodes by walking both from the output along first inputs. Along that
+// path, this optimization:
+//
+// - fuses adjacent maps when both are cheap, since their per-element overhead
+//   then dominates their processing time;
+// - moves a filter before the map producing its input when it drops elements
+//   and its predicate only reads components the map passes through;
+// - moves an in-memory cache before a stateless map when the map is cheap and
+//   grows the size of elements, so that the cache holds smaller elements;
+// - inserts a prefetch after a synchronous transformation taking a large share
+//   of the processing time, so that it overlaps with its consumer.
+//
+// Every decision is logged. If no statistics were recorded, the graph is left
+// unchanged.
+class CostBasedOptimization : public TFDataOptimizerBase {
+ public:
+  CostBasedOptimization() = default;
+  ~CostBasedOptimization() override = default;
+
+  std::string name() const override { return "cost_based_optimization"; };
+
+  bool UsesFunctionLibrary() const override { return true; }
+
+  absl::Status Init(
+      const tensorflow::RewriterConfig_CustomGraphOptimizer* config) override {
+    if (!config) return absl::OkStatus();
+    auto it = config->parameter_map().find(kStatsFilename);
+    if (it != config->parameter_map().end()) {
+      stats_filename_ = it->second.s();
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status OptimizeAndCollectStats(Cluster* cluster,
+                                       const GrapplerItem& item,
+                                       GraphDef* output,
+                                       OptimizationStats* stats) override;
+
+ private:
+  std::string stats_filename_;
+};
+
+}  // namespace grappler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_DATA_COST_BASED_OPTIMIZATION_H_
@@ -0,0 +1,311 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/cost_based_optimization.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/function_testlib.h"
+#include "tensorflow/core/framework/model.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_test_utils.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+using graph_tests_utils::MakeCacheV2Node;
+using graph_tests_utils::MakeFilterNode;
+using graph_tests_utils::MakeMapNode;
+using test::function::NDef;
+
+constexpr int64_t kCheapNsec = 1000;
+constexpr int64_t kExpensiveNsec = 1000 * 1000;
+
+// The recorded statistics of an iterator.
+struct IteratorStats {
+  std::string name;
+  int64_t num_elements;
+  int64_t nsec_per_element;
+  int64_t bytes_consumed = 0;
+  int64_t bytes_produced = 0;
+};
+
+// Writes the statistics of a pipeline whose iterators are listed from the
+// output to the source, and returns the file they were written to.
+std::string WriteStats(absl::string_view name,
+                       const std::vector<IteratorStats>& iterators) {
+  data::model::ModelProto model;
+  data::model::ModelProto::Node& root = (*model.mutable_nodes())[0];
+  root.set_name("Root");
+  root.add_inputs(1);
+  for (int i = 0; i < iterators.size(); ++i) {
+    const IteratorStats& iterator = iterators[i];
+    data::model::ModelProto::Node& node = (*model.mutable_nodes())[i + 1];
+    node.set_id(i + 1);
+    node.set_name(iterator.name);
+    node.set_num_elements(iterator.num_elements);
+    node.set_processing_time(iterator.num_elements *
+                             iterator.nsec_per_element);
+    node.set_bytes_consumed(iterator.bytes_consumed);
+    node.set_bytes_produced(iterator.bytes_produced);
+    if (i + 1 < iterators.size()) node.add_inputs(i + 2);
+  }
+  model.set_output(0);
+  std::string filename = io::JoinPath(
+      testing::TmpDir(), absl::StrCat(name, ".pipeline_stats"));
+  TF_CHECK_OK(WriteBinaryProto(Env::Default(), filename, model));
+  return filename;
+}
+
+absl::Status OptimizeWithStats(const GrapplerItem& item,
+                               const std::string& stats_filename,
+                               GraphDef* output) {
+  CostBasedOptimization optimizer;
+  RewriterConfig_CustomGraphOptimizer config;
+  (*config.mutable_parameter_map())[kStatsFilename].set_s(stats_filename);
+  TF_RETURN_IF_ERROR(optimizer.Init(&config));
+  return optimizer.Optimize(nullptr, item, output);
+}
+
+// Returns the dataset node read by the node `name`.
+const NodeDef& InputOf(absl::string_view name, const GraphDef& graph) {
+  const NodeDef& node =
+      graph.node(graph_utils::FindGraphNodeWithName(name, graph));
+  return graph.node(graph_utils::FindGraphNodeWithName(node.input(0), graph));
+}
+
+NodeDef MakeRangeNode() {
+  return NDef("range", "RangeDataset", {"start", "stop", "step"},
+              {{"output_shapes", absl::Span<const TensorShape>{}},
+               {"output_types", absl::Span<const DataType>{}}});
+}
+
+std::vector<NodeDef> RangeInputs() {
+  return {NDef("start", "Const", {}, {{"value", 0}, {"dtype", DT_INT32}}),
+          NDef("stop", "Const", {}, {{"value", 10}, {"dtype", DT_INT32}}),
+          NDef("step", "Const", {}, {{"value", 1}, {"dtype", DT_INT32}})};
+}
+
+// (x) -> (x, 2 * x), passing `x` through an identity like tf.function does.
+FunctionDef KeepAndDouble() {
+  return FunctionDefHelper::Create(
+      "KeepAndDouble", {"x: int64"}, {"kept: int64", "doubled: int64"}, {},
+      {{{"identity"}, "Identity", {"x"}, {{"T", DT_INT64}}},
+       FunctionDefHelper::Const<int64_t>("two", 2),
+       {{"mul"}, "Mul", {"x", "two:output:0"}, {{"T", DT_INT64}}}},
+      {{"kept", "identity:output:0"}, {"doubled", "mul:z:0"}});
+}
+
+// (kept, doubled) -> the input of `KeepAndDouble` is zero.
+FunctionDef KeptIsZero() {
+  return FunctionDefHelper::Create(
+      "KeptIsZero", {"kept: int64", "doubled: int64"}, {"equal: bool"}, {},
+      {FunctionDefHelper::Const<int64_t>("zero", 0),
+       {{"equal"}, "Equal", {"kept", "zero:output:0"}, {{"T", DT_INT64}}}},
+      {{"equal", "equal:z:0"}});
+}
+
+// (kept, doubled) -> the output of `KeepAndDouble` is zero.
+FunctionDef DoubledIsZero() {
+  return FunctionDefHelper::Create(
+      "DoubledIsZero", {"kept: int64", "doubled: int64"}, {"equal: bool"}, {},
+      {FunctionDefHelper::Const<int64_t>("zero", 0),
+       {{"equal"}, "Equal", {"doubled", "zero:output:0"}, {{"T", DT_INT64}}}},
+      {{"equal", "equal:z:0"}});
+}
+
+GrapplerItem MakeMapFilterItem(absl::string_view predicate) {
+  GrapplerItem item;
+  std::vector<NodeDef> nodes = RangeInputs();
+  nodes.push_back(MakeRangeNode());
+  nodes.push_back(MakeMapNode("map", "range", "KeepAndDouble"));
+  nodes.push_back(MakeFilterNode("filter", "map", predicate));
+  nodes.push_back(NDef("Sink", "Identity", {"filter"}, {}));
+  item.graph = test::function::GDef(
+      nodes, {KeepAndDouble(), KeptIsZero(), DoubledIsZero()});
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+TEST(CostBasedOptimizationTest, NoStatistics) {
+  GrapplerItem item = MakeMapFilterItem("KeptIsZero");
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(
+      item, io::JoinPath(testing::TmpDir(), "missing.pipeline_stats"),
+      &output));
+  EXPECT_TRUE(graph_utils::Compare(item.graph, output));
+}
+
+TEST(CostBasedOptimizationTest, MovesSelectiveFilterBeforeMap) {
+  GrapplerItem item = MakeMapFilterItem("KeptIsZero");
+  std::string stats = WriteStats("selective_filter",
+                                 {{"Filter", 10, kCheapNsec},
+                                  {"Map", 100, kExpensiveNsec},
+                                  {"Range", 100, kCheapNsec}});
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(item, stats, &output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("map", output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("filter", output));
+  const NodeDef& map = InputOf("Sink", output);
+  EXPECT_EQ(map.op(), "MapDataset");
+  const NodeDef& filter = InputOf(map.name(), output);
+  EXPECT_EQ(filter.op(), "FilterDataset");
+  EXPECT_EQ(filter.input(0), "range");
+  EXPECT_NE(filter.attr().at("predicate").func().name(), "KeptIsZero");
+}
+
+TEST(CostBasedOptimizationTest, KeepsFilterReadingComputedValues) {
+  GrapplerItem item = MakeMapFilterItem("DoubledIsZero");
+  std::string stats = WriteStats("computed_filter",
+                                 {{"Filter", 10, kCheapNsec},
+                                  {"Map", 100, kCheapNsec},
+                                  {"Range", 100, kCheapNsec}});
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(item, stats, &output));
+  EXPECT_EQ(InputOf("Sink", output).name(), "filter");
+  EXPECT_EQ(InputOf("filter", output).name(), "map");
+}
+
+TEST(CostBasedOptimizationTest, KeepsUnselectiveFilter) {
+  GrapplerItem item = MakeMapFilterItem("KeptIsZero");
+  std::string stats = WriteStats("unselective_filter",
+                                 {{"Filter", 95, kCheapNsec},
+                                  {"Map", 100, kCheapNsec},
+                                  {"Range", 100, kCheapNsec}});
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(item, stats, &output));
+  EXPECT_EQ(InputOf("Sink", output).name(), "filter");
+  EXPECT_EQ(InputOf("filter", output).name(), "map");
+}
+
+GrapplerItem MakeTwoMapsItem() {
+  GrapplerItem item;
+  std::vector<NodeDef> nodes = RangeInputs();
+  nodes.push_back(MakeRangeNode());
+  nodes.push_back(MakeMapNode("map1", "range"));
+  nodes.push_back(MakeMapNode("map2", "map1"));
+  nodes.push_back(NDef("Sink", "Identity", {"map2"}, {}));
+  item.graph = test::function::GDef(nodes, {test::function::XTimesTwo()});
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+TEST(CostBasedOptimizationTest, FusesCheapMaps) {
+  GrapplerItem item = MakeTwoMapsItem();
+  std::string stats = WriteStats("cheap_maps", {{"Map", 100, kCheapNsec},
+                                                {"Map", 100, kCheapNsec},
+                                                {"Range", 100, kCheapNsec}});
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(item, stats, &output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("map1", output));
+  EXPECT_FALSE(graph_utils::ContainsGraphNodeWithName("map2", output));
+  const NodeDef& fused = InputOf("Sink", output);
+  EXPECT_EQ(fused.op(), "MapDataset");
+  EXPECT_EQ(fused.input(0), "range");
+}
+
+TEST(CostBasedOptimizationTest, PrefetchesAfterExpensiveMap) {
+  GrapplerItem item = MakeTwoMapsItem();
+  std::string stats =
+      WriteStats("expensive_maps", {{"Map", 100, kCheapNsec},
+                                    {"Map", 100, kExpensiveNsec},
+                                    {"Range", 100, kCheapNsec}});
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(item, stats, &output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map1", output));
+  EXPECT_TRUE(graph_utils::ContainsGraphNodeWithName("map2", output));
+  const NodeDef& prefetch = InputOf("map2", output);
+  EXPECT_EQ(prefetch.op(), "PrefetchDataset");
+  EXPECT_EQ(prefetch.input(0), "map1");
+}
+
+TEST(CostBasedOptimizationTest, StopsAtMismatchedStatistics) {
+  GrapplerItem item = MakeTwoMapsItem();
+  std::string stats =
+      WriteStats("mismatched", {{"Batch", 100, kCheapNsec},
+                                {"Map", 100, kCheapNsec},
+                                {"Range", 100, kCheapNsec}});
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(item, stats, &output));
+  EXPECT_TRUE(graph_utils::Compare(item.graph, output));
+}
+
+GrapplerItem MakeMapCacheItem() {
+  GrapplerItem item;
+  std::vector<NodeDef> nodes = RangeInputs();
+  nodes.push_back(MakeRangeNode());
+  nodes.push_back(MakeMapNode("map", "range"));
+  nodes.push_back(NDef("filename", "Const", {},
+                       {{"value", Tensor(tstring(""))}, {"dtype", DT_STRING}}));
+  nodes.push_back(NDef("cache_resource", "DummyMemoryCache", {}, {}));
+  nodes.push_back(
+      MakeCacheV2Node("cache", "map", "filename", "cache_resource"));
+  nodes.push_back(NDef("Sink", "Identity", {"cache"}, {}));
+  item.graph = test::function::GDef(nodes, {test::function::XTimesTwo()});
+  item.fetch.push_back("Sink");
+  return item;
+}
+
+TEST(CostBasedOptimizationTest, MovesCacheBeforeExpandingMap) {
+  GrapplerItem item = MakeMapCacheItem();
+  std::string stats = WriteStats(
+      "expanding_map",
+      {{"MemoryCache", 100, kCheapNsec},
+       {"Map", 100, kCheapNsec, /*bytes_consumed=*/800,
+        /*bytes_produced=*/8000},
+       {"Range", 100, kCheapNsec}});
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(item, stats, &output));
+  const NodeDef& map = InputOf("Sink", output);
+  EXPECT_EQ(map.op(), "MapDataset");
+  const NodeDef& cache = InputOf(map.name(), output);
+  EXPECT_EQ(cache.op(), "CacheDatasetV2");
+  EXPECT_EQ(cache.input(0), "range");
+}
+
+TEST(CostBasedOptimizationTest, KeepsCacheAfterShrinkingMap) {
+  GrapplerItem item = MakeMapCacheItem();
+  std::string stats = WriteStats(
+      "shrinking_map",
+      {{"MemoryCache", 100, kCheapNsec},
+       {"Map", 100, kCheapNsec, /*bytes_consumed=*/8000,
+        /*bytes_produced=*/800},
+       {"Range", 100, kCheapNsec}});
+  GraphDef output;
+  TF_ASSERT_OK(OptimizeWithStats(item, stats, &output));
+  EXPECT_EQ(InputOf("Sink", output).name(), "cache");
+  EXPECT_EQ(InputOf("cache", output).name(), "map");
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -39,7 +39,7 @@ using ConfigMap =
 
 // tf.data optimizations, in the order we want to perform them.
 // clang-format off
-constexpr std::array<const char*, 22> kTFDataOptimizations = {
+constexpr std::array<const char*, 23> kTFDataOptimizations = {
     "noop_elimination",
     "disable_intra_op_parallelism",
     "use_private_thread_pool",
@@ -61,6 +61,7 @@ constexpr std::array<const char*, 22> kTFDataOptimizations = {
     "inject_io_prefetch",
     "disable_prefetch_legacy_autotune",
     "enable_gradient_descent",
+    "cost_based_optimization",
     "make_deterministic"};
 // clang-format on
 
@@ -75,8 +76,10 @@ absl::Status ToConfigMap(
   auto& options = found->list().s();
   for (const auto& option_string : options) {
     // The option string has the format
-    // <optimizer_name>:<config_key>:<config_value>
-    std::vector<std::string> split = absl::StrSplit(option_string, ':');
+    // <optimizer_name>:<config_key>:<config_value>. The value may itself
+    // contain colons, e.g. if it is a path.
+    std::vector<std::string> split =
+        absl::StrSplit(option_string, absl::MaxSplits(':', 2));
     if (split.size() != 3) {
       return absl::InternalError(absl::StrCat(
           "Wrong format for optimizer options. Expect <optimizer name>:<config "
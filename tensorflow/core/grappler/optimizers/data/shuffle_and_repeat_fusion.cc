@@ -40,6 +40,7 @@ constexpr char kShuffleAndRepeatDataset[] = "ShuffleAndRepeatDataset";
 constexpr char kShuffleAndRepeatDatasetV2[] = "ShuffleAndRepeatDatasetV2";
 
 constexpr char kReshuffleEachIteration[] = "reshuffle_each_iteration";
+constexpr char kBufferSizeBytes[] = "buffer_size_bytes";
 
 absl::Status FuseShuffleV1AndRepeat(const NodeDef& shuffle_node,
                                     const NodeDef& repeat_node,
@@ -178,6 +179,11 @@ absl::Status ShuffleAndRepeatFusion::OptimizeAndCollectStats(
                                                 &graph, output, &fused_node));
 
     } else if (shuffle_node.op() == kShuffleDatasetV3) {
+      // The fused op has no memory budget, so budgeted shuffles are kept.
+      auto budget = shuffle_node.attr().find(kBufferSizeBytes);
+      if (budget != shuffle_node.attr().end() && budget->second.i() > 0) {
+        continue;
+      }
       TF_RETURN_IF_ERROR(FuseShuffleV3AndRepeat(shuffle_node, repeat_node,
                                                 &graph, output, &fused_node));
     } else {
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdlib>
+#include <limits>
 #include <map>
 #include <set>
 #include <string>
@@ -40,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
+#include "tensorflow/core/util/block_sparse.h"
 #include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/use_cudnn.h"
 #include "tsl/platform/errors.h"
@@ -93,6 +95,8 @@ constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
 constexpr char kFusedBatchNormGradEx[] = "_FusedBatchNormGradEx";
 constexpr char kTensorToHashBucket[] = "_TensorToHashBucketFast";
+constexpr char kFusedSparseEmbeddingLookup[] = "_FusedSparseEmbeddingLookup";
+constexpr char kBlockSparseMatMul[] = "_BlockSparseMatMul";
 constexpr char kLeakyRelu[] = "LeakyRelu";
 constexpr char kMklFusedMish[] = "_MklFusedMish";
 constexpr char kRelu[] = "Relu";
@@ -171,6 +175,34 @@ struct TensorToHashBucket {
   int string_to_hash_bucket = kMissingIndex;
 };
 
+// Unique + GatherV2 + SparseSegment{Sum,Mean,SqrtN}[WithNumSegments] that can
+// be replaced with a single _FusedSparseEmbeddingLookup reading the embedding
+// rows directly from the Gather params.
+struct SparseEmbeddingLookup {
+  SparseEmbeddingLookup() = default;
+
+  int unique = kMissingIndex;
+  int gather = kMissingIndex;
+  int segment_reduction = kMissingIndex;
+  std::string combiner;
+  // True if the Unique has no consumers outside of the pattern.
+  bool remove_unique = false;
+};
+
+// MatMul with a mostly zero constant weight that can be replaced with a
+// _BlockSparseMatMul reading the weight in block compressed sparse row layout.
+struct BlockSparseMatMul {
+  BlockSparseMatMul() = default;
+
+  int matmul = kMissingIndex;
+  int weights = kMissingIndex;
+  int block_rows = 0;
+  int block_cols = 0;
+  Tensor weights_value;
+  // True if the weight constant has no consumers outside of the MatMul.
+  bool remove_weights = false;
+};
+
 // Pad followed by Conv3D/FusedConv3D
 struct PadWithConv3D {
   PadWithConv3D() = default;
@@ -2803,6 +2835,148 @@ bool FindTensorToHashBucket(const RemapperContext& ctx, int node_index,
   return true;
 }
 
+bool FindSparseEmbeddingLookup(const RemapperContext& ctx, int node_index,
+                               SparseEmbeddingLookup* matched) {
+  // Root of the pattern must be a CPU SparseSegment{Sum,Mean,SqrtN} reduction.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+  const std::string& op = node_def->op();
+  std::string combiner;
+  if (op == "SparseSegmentSum" || op == "SparseSegmentSumWithNumSegments") {
+    combiner = "sum";
+  } else if (op == "SparseSegmentMean" ||
+             op == "SparseSegmentMeanWithNumSegments") {
+    combiner = "mean";
+  } else if (op == "SparseSegmentSqrtN" ||
+             op == "SparseSegmentSqrtNWithNumSegments") {
+    combiner = "sqrtn";
+  } else {
+    return false;
+  }
+  if (!NodeIsOnCpu(node_def) || HasControlFaninOrFanout(*node_view) ||
+      node_view->NumRegularFanins() < 3) {
+    return false;
+  }
+  if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_DOUBLE) &&
+      !HasDataType(node_def, DT_HALF) && !HasDataType(node_def, DT_BFLOAT16)) {
+    return false;
+  }
+
+  // Data input must be a GatherV2 along axis 0 used only by the reduction.
+  const auto* gather_view = node_view->GetRegularFanin(0).node_view();
+  const auto* gather_def = gather_view->node();
+  if (gather_def->op() != "GatherV2" || !NodeIsOnCpu(gather_def) ||
+      HasControlFaninOrFanout(*gather_view) ||
+      !HasAtMostOneFanoutAtPort0(*gather_view) ||
+      IsInPreserveSet(ctx, gather_def) || gather_view->NumRegularFanins() < 3) {
+    return false;
+  }
+  int batch_dims = 0;
+  if (GetNodeAttr(*gather_def, "batch_dims", &batch_dims).ok() &&
+      batch_dims != 0) {
+    return false;
+  }
+  const auto* axis_def = gather_view->GetRegularFanin(2).node_view()->node();
+  Tensor axis;
+  if (!IsConstant(*axis_def) || !axis_def->attr().contains("value") ||
+      !axis.FromProto(axis_def->attr().at("value").tensor()) ||
+      axis.NumElements() != 1 ||
+      (axis.dtype() != DT_INT32 && axis.dtype() != DT_INT64)) {
+    return false;
+  }
+  const int64_t axis_value = axis.dtype() == DT_INT32
+                                 ? axis.flat<int32_t>()(0)
+                                 : axis.flat<int64_t>()(0);
+  if (axis_value != 0) return false;
+
+  // Gather indices and segment indices must be the two outputs of one Unique.
+  const auto& gather_indices = gather_view->GetRegularFanin(1);
+  const auto& indices = node_view->GetRegularFanin(1);
+  const auto* unique_view = gather_indices.node_view();
+  const auto* unique_def = unique_view->node();
+  if (unique_def->op() != "Unique" || gather_indices.index() != 0 ||
+      indices.node_view() != unique_view || indices.index() != 1 ||
+      HasControlFaninOrFanout(*unique_view)) {
+    return false;
+  }
+  if (!HasDataType(unique_def, DT_INT32) &&
+      !HasDataType(unique_def, DT_INT64)) {
+    return false;
+  }
+
+  matched->unique = unique_view->node_index();
+  matched->gather = gather_view->node_index();
+  matched->segment_reduction = node_index;
+  matched->combiner = combiner;
+  matched->remove_unique = !IsInPreserveSet(ctx, unique_def) &&
+                           unique_view->GetRegularFanout(0).size() == 1 &&
+                           unique_view->GetRegularFanout(1).size() == 1;
+  return true;
+}
+
+bool FindBlockSparseMatMul(const RemapperContext& ctx, int node_index,
+                           BlockSparseMatMul* matched) {
+  // Smaller weights are not worth the indirection of the sparse kernel.
+  constexpr int64_t kMinWeightElements = 4096;
+  // Fraction of the dense weight the stored blocks may hold; above this the
+  // dense Eigen contraction is faster.
+  constexpr double kMaxStoredFraction = 0.35;
+
+  // Root of the pattern must be a plain CPU float MatMul.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+  if (!IsMatMul(*node_def) || !NodeIsOnCpu(node_def) ||
+      !HasDataType(node_def, DT_FLOAT) || node_view->NumRegularFanins() != 2) {
+    return false;
+  }
+  bool transpose_a = false;
+  bool transpose_b = false;
+  if (!TryGetNodeAttr(*node_def, "transpose_a", &transpose_a) ||
+      !TryGetNodeAttr(*node_def, "transpose_b", &transpose_b) || transpose_a ||
+      transpose_b) {
+    return false;
+  }
+
+  // The weight must be a 2-D float constant.
+  const auto* weights_view = node_view->GetRegularFanin(1).node_view();
+  const auto* weights_def = weights_view->node();
+  Tensor weights;
+  if (!IsConstant(*weights_def) || !weights_def->attr().contains("value") ||
+      !weights.FromProto(weights_def->attr().at("value").tensor()) ||
+      weights.dtype() != DT_FLOAT || weights.dims() != 2 ||
+      weights.NumElements() < kMinWeightElements ||
+      weights.NumElements() > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+  const int64_t rows = weights.dim_size(0);
+  const int64_t cols = weights.dim_size(1);
+
+  // Pick the supported block shape that stores the fewest elements.
+  const float* data = weights.flat<float>().data();
+  int64_t best_stored = std::numeric_limits<int64_t>::max();
+  constexpr std::pair<int, int> kBlockShapes[] = {{8, 1}, {4, 4}, {1, 4}};
+  for (const auto& [block_rows, block_cols] : kBlockShapes) {
+    if (rows % block_rows != 0 || cols % block_cols != 0) continue;
+    const int64_t stored =
+        CountNonZeroBlocks(data, rows, cols, block_rows, block_cols) *
+        block_rows * block_cols;
+    if (stored < best_stored) {
+      best_stored = stored;
+      matched->block_rows = block_rows;
+      matched->block_cols = block_cols;
+    }
+  }
+  if (best_stored > kMaxStoredFraction * weights.NumElements()) return false;
+
+  matched->matmul = node_index;
+  matched->weights = weights_view->node_index();
+  matched->weights_value = std::move(weights);
+  matched->remove_weights = !IsInPreserveSet(ctx, weights_def) &&
+                            HasAtMostOneFanoutAtPort0(*weights_view) &&
+                            weights_view->NumControlledFanouts() == 0;
+  return true;
+}
+
 // clang-format off
 // HardSwish pattern
 //                        input     Const (value: 3)
@@ -4526,6 +4700,162 @@ absl::Status AddTensorToHashBucketNode(RemapperContext* ctx,
   return absl::OkStatus();
 }
 
+absl::Status AddSparseEmbeddingLookupNode(RemapperContext* ctx,
+                                         const SparseEmbeddingLookup& matched,
+                                         std::vector<bool>* invalidated_nodes,
+                                         std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& unique = graph->node(matched.unique);
+  const NodeDef& gather = graph->node(matched.gather);
+  const NodeDef& segment_reduction = graph->node(matched.segment_reduction);
+  VLOG(2) << "Fuse Unique with GatherV2 and " << segment_reduction.op()
+          << ": unique=" << unique.name() << " gather=" << gather.name()
+          << " segment_reduction=" << segment_reduction.name();
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  absl::Status status;
+
+  // Reductions without an explicit num_segments infer it from the last
+  // segment id, which the fused op does for a negative num_segments.
+  std::string num_segments;
+  DataType num_segments_type = DT_INT32;
+  if (segment_reduction.input_size() > 3 &&
+      !IsControlInput(segment_reduction.input(3))) {
+    num_segments = segment_reduction.input(3);
+    num_segments_type = GetDataTypeFromAttr(segment_reduction, "Tnumsegments");
+  } else {
+    NodeDef num_segments_node;
+    num_segments = AddPrefixToNodeName("NumSegments", segment_reduction.name());
+    num_segments_node.set_name(num_segments);
+    num_segments_node.set_op("Const");
+    num_segments_node.set_device(segment_reduction.device());
+    // Anchor the constant to the segment ids so it lives in the same frame.
+    *num_segments_node.add_input() =
+        AsControlDependency(NodeName(segment_reduction.input(2)));
+    (*num_segments_node.mutable_attr())["dtype"].set_type(DT_INT32);
+    Tensor t(DT_INT32, TensorShape({}));
+    t.scalar<int32_t>()() = -1;
+    t.AsProtoTensorContent(
+        (*num_segments_node.mutable_attr())["value"].mutable_tensor());
+    mutation->AddNode(std::move(num_segments_node), &status);
+    TF_RETURN_IF_ERROR(status);
+  }
+  if (num_segments_type == DT_INVALID) num_segments_type = DT_INT32;
+  DataType segment_ids_type =
+      GetDataTypeFromAttr(segment_reduction, "Tsegmentids");
+  if (segment_ids_type == DT_INVALID) segment_ids_type = DT_INT32;
+
+  NodeDef fused_op;
+  fused_op.set_name(segment_reduction.name());
+  fused_op.set_op(kFusedSparseEmbeddingLookup);
+  fused_op.set_device(segment_reduction.device());
+  fused_op.add_input(gather.input(0));             // 0: params
+  fused_op.add_input(unique.input(0));             // 1: ids
+  fused_op.add_input(segment_reduction.input(2));  // 2: segment_ids
+  fused_op.add_input(num_segments);                // 3: num_segments
+
+  auto* attr = fused_op.mutable_attr();
+  (*attr)["T"] = segment_reduction.attr().at("T");
+  (*attr)["Tidx"] = unique.attr().at("T");
+  (*attr)["Tsegmentids"].set_type(segment_ids_type);
+  (*attr)["Tnumsegments"].set_type(num_segments_type);
+  (*attr)["num_weights"].set_i(0);
+  (*attr)["combiner"].set_s(matched.combiner);
+
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.segment_reduction] = true;
+  (*nodes_to_delete)[matched.gather] = true;
+  if (matched.remove_unique) (*nodes_to_delete)[matched.unique] = true;
+
+  return absl::OkStatus();
+}
+
+absl::Status AddBlockSparseMatMulNode(RemapperContext* ctx,
+                                      const BlockSparseMatMul& matched,
+                                      std::vector<bool>* invalidated_nodes,
+                                      std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& matmul = graph->node(matched.matmul);
+  const NodeDef& weights = graph->node(matched.weights);
+  const int block_rows = matched.block_rows;
+  const int block_cols = matched.block_cols;
+  VLOG(2) << "Convert MatMul to block-sparse: matmul=" << matmul.name()
+          << " weights=" << weights.name() << " block=" << block_rows << "x"
+          << block_cols;
+
+  const Tensor& dense = matched.weights_value;
+  const int64_t rows = dense.dim_size(0);
+  const int64_t cols = dense.dim_size(1);
+  const float* data = dense.flat<float>().data();
+  const int64_t num_blocks =
+      CountNonZeroBlocks(data, rows, cols, block_rows, block_cols);
+  Tensor values(DT_FLOAT, TensorShape({num_blocks, block_rows, block_cols}));
+  Tensor col_indices(DT_INT32, TensorShape({num_blocks}));
+  Tensor row_ptr(DT_INT32, TensorShape({rows / block_rows + 1}));
+  DenseToBlockSparse(data, rows, cols, block_rows, block_cols,
+                     values.flat<float>().data(),
+                     col_indices.flat<int32_t>().data(),
+                     row_ptr.flat<int32_t>().data());
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  absl::Status status;
+
+  // The new constants keep the weight's device and control inputs so they
+  // live in the same frame.
+  auto add_const = [&](const std::string& prefix, const Tensor& value) {
+    NodeDef node;
+    node.set_name(AddPrefixToNodeName(prefix, matmul.name()));
+    node.set_op("Const");
+    node.set_device(weights.device());
+    for (const std::string& input : weights.input()) {
+      if (IsControlInput(input)) *node.add_input() = input;
+    }
+    (*node.mutable_attr())["dtype"].set_type(value.dtype());
+    value.AsProtoTensorContent(
+        (*node.mutable_attr())["value"].mutable_tensor());
+    std::string name = node.name();
+    mutation->AddNode(std::move(node), &status);
+    return name;
+  };
+  const std::string values_name = add_const("BlockSparseValues", values);
+  TF_RETURN_IF_ERROR(status);
+  const std::string col_indices_name =
+      add_const("BlockSparseColIndices", col_indices);
+  TF_RETURN_IF_ERROR(status);
+  const std::string row_ptr_name = add_const("BlockSparseRowPtr", row_ptr);
+  TF_RETURN_IF_ERROR(status);
+
+  NodeDef sparse_op;
+  sparse_op.set_name(matmul.name());
+  sparse_op.set_op(kBlockSparseMatMul);
+  sparse_op.set_device(matmul.device());
+  sparse_op.add_input(matmul.input(0));   // 0: a
+  sparse_op.add_input(values_name);       // 1: b_values
+  sparse_op.add_input(col_indices_name);  // 2: b_col_indices
+  sparse_op.add_input(row_ptr_name);      // 3: b_row_ptr
+  for (int i = 2; i < matmul.input_size(); ++i) {
+    *sparse_op.add_input() = matmul.input(i);
+  }
+
+  auto* attr = sparse_op.mutable_attr();
+  (*attr)["T"] = matmul.attr().at("T");
+  (*attr)["block_rows"].set_i(block_rows);
+  (*attr)["block_cols"].set_i(block_cols);
+  (*attr)["num_cols"].set_i(cols);
+
+  mutation->AddNode(std::move(sparse_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.matmul] = true;
+  if (matched.remove_weights) (*nodes_to_delete)[matched.weights] = true;
+
+  return absl::OkStatus();
+}
+
 absl::Status AddFusedBatchMatMul(
     RemapperContext* ctx, const std::map<std::string, int>& matched_nodes_map,
     const std::set<int>& remove_node_indices,
@@ -5047,6 +5377,18 @@ absl::Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
   bool allow_non_differentiable_rewrites =
       item.optimization_options().allow_non_differentiable_rewrites;
 
+  // MatMuls with pruned constant weights are converted before the main pass,
+  // which would otherwise fuse them with a following BiasAdd first.
+  if (allow_non_differentiable_rewrites) {
+    for (int i = 0; i < num_nodes; ++i) {
+      BlockSparseMatMul block_sparse_matmul;
+      if (FindBlockSparseMatMul(ctx, i, &block_sparse_matmul)) {
+        TF_RETURN_IF_ERROR(AddBlockSparseMatMulNode(
+            &ctx, block_sparse_matmul, &invalidated_nodes, &nodes_to_delete));
+      }
+    }
+  }
+
   for (int i = num_nodes - 1; i >= 0; --i) {
     // Check if node was invalidated by one of the previous remaps.
     if (invalidated_nodes[i] || nodes_to_delete[i]) {
@@ -5379,6 +5721,15 @@ absl::Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // The fused embedding lookup has no registered gradient.
+    SparseEmbeddingLookup sparse_embedding_lookup;
+    if (allow_non_differentiable_rewrites &&
+        FindSparseEmbeddingLookup(ctx, i, &sparse_embedding_lookup)) {
+      TF_RETURN_IF_ERROR(AddSparseEmbeddingLookupNode(
+          &ctx, sparse_embedding_lookup, &invalidated_nodes, &nodes_to_delete));
+      continue;
+    }
+
     // During inference, most of the inputs to FusedBatchNorm are constant, and
     // we can therefore replace the op with a much cheaper set of primitives.
     FusedBatchNorm fused_batch_norm;
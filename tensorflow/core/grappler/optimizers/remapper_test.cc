@@ -1769,6 +1769,154 @@ TEST_F(RemapperTensorToHashBucketTest, I32) { RunTest<DT_INT32>(); }
 
 TEST_F(RemapperTensorToHashBucketTest, I64) { RunTest<DT_INT64>(); }
 
+class RemapperFuseSparseEmbeddingLookupTest : public RemapperTest {
+ public:
+  void RunTest(bool with_num_segments) {
+    using ::tensorflow::ops::Placeholder;
+
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+    auto params = Placeholder(s.WithOpName("params"), DT_FLOAT,
+                              ops::Placeholder::Shape({16, 8}));
+    auto ids = Placeholder(s.WithOpName("ids"), DT_INT64,
+                           ops::Placeholder::Shape({10}));
+    auto segment_ids = Placeholder(s.WithOpName("segment_ids"), DT_INT32,
+                                   ops::Placeholder::Shape({10}));
+
+    auto unique = ops::Unique(s.WithOpName("unique"), ids);
+    auto axis = ops::Const(s.WithOpName("axis"), 0, {});
+    auto gather = ops::GatherV2(s.WithOpName("gather"), params, unique.y, axis);
+    Output lookup;
+    if (with_num_segments) {
+      auto num_segments = ops::Const(s.WithOpName("num_segments"), 5, {});
+      lookup = ops::SparseSegmentMeanWithNumSegments(
+          s.WithOpName("lookup"), gather, unique.idx, segment_ids,
+          num_segments);
+    } else {
+      lookup = ops::SparseSegmentSum(s.WithOpName("lookup"), gather,
+                                     unique.idx, segment_ids);
+    }
+    auto fetch = ops::Identity(s.WithOpName("fetch"), lookup);
+
+    auto params_t = GenerateRandomTensor<DT_FLOAT>({16, 8});
+    auto ids_t = test::AsTensor<int64_t>({3, 7, 3, 0, 15, 7, 7, 2, 9, 3});
+    auto segment_ids_t = test::AsTensor<int32>({0, 0, 0, 1, 1, 2, 2, 2, 3, 3});
+
+    GrapplerItem item;
+    item.fetch = {"fetch"};
+    item.feed = {{"params", params_t},
+                 {"ids", ids_t},
+                 {"segment_ids", segment_ids_t}};
+    TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+    // The fused kernel is CPU only.
+    for (int i = 0; i < item.graph.node_size(); ++i) {
+      item.graph.mutable_node(i)->set_device("/device:CPU:0");
+    }
+
+    Remapper optimizer(RewriterConfig::ON);
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+    int found = 0;
+    for (const NodeDef& node : output.node()) {
+      EXPECT_NE(node.name(), "unique");
+      EXPECT_NE(node.name(), "gather");
+      if (node.name() == "lookup") {
+        EXPECT_EQ(node.op(), "_FusedSparseEmbeddingLookup");
+        ASSERT_EQ(node.input_size(), 4);
+        EXPECT_EQ(node.input(0), "params");
+        EXPECT_EQ(node.input(1), "ids");
+        EXPECT_EQ(node.input(2), "segment_ids");
+        if (with_num_segments) EXPECT_EQ(node.input(3), "num_segments");
+        EXPECT_EQ(node.attr().at("combiner").s(),
+                  with_num_segments ? "mean" : "sum");
+        EXPECT_EQ(node.attr().at("Tidx").type(), DT_INT64);
+        found++;
+      }
+    }
+    EXPECT_EQ(found, 1);
+
+    auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+    ASSERT_EQ(tensors_expected.size(), 1);
+    auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+    ASSERT_EQ(tensors.size(), 1);
+    test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+  }
+};
+
+TEST_F(RemapperFuseSparseEmbeddingLookupTest, Sum) { RunTest(false); }
+
+TEST_F(RemapperFuseSparseEmbeddingLookupTest, MeanWithNumSegments) {
+  RunTest(true);
+}
+
+TEST_F(RemapperTest, BlockSparseMatMul) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  // A [64, 128] weight pruned to one non-zero 8x1 block in eight.
+  Tensor weights_t(DT_FLOAT, TensorShape({64, 128}));
+  auto weights_m = weights_t.matrix<float>();
+  weights_m.setZero();
+  for (int r = 0; r < 64; r += 8) {
+    for (int c = (r / 8) % 8; c < 128; c += 8) {
+      for (int i = 0; i < 8; ++i) weights_m(r + i, c) = 0.25f * (i + 1);
+    }
+  }
+
+  auto lhs = Placeholder(s.WithOpName("lhs"), DT_FLOAT,
+                         ops::Placeholder::Shape({8, 64}));
+  auto bias = Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                          ops::Placeholder::Shape({128}));
+  auto weights = ops::Const(s.WithOpName("weights"), weights_t);
+  auto matmul = ops::MatMul(s.WithOpName("matmul"), lhs, weights);
+  auto bias_add = ops::BiasAdd(s.WithOpName("bias_add"), matmul, bias);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), bias_add);
+
+  auto lhs_t = GenerateRandomTensor<DT_FLOAT>({8, 64});
+  auto bias_t = GenerateRandomTensor<DT_FLOAT>({128});
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"lhs", lhs_t}, {"bias", bias_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  // The block-sparse kernel is CPU only.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "weights");
+    if (node.name() == "matmul") {
+      EXPECT_EQ(node.op(), "_BlockSparseMatMul");
+      ASSERT_EQ(node.input_size(), 4);
+      EXPECT_EQ(node.input(0), "lhs");
+      EXPECT_EQ(node.attr().at("block_rows").i(), 8);
+      EXPECT_EQ(node.attr().at("block_cols").i(), 1);
+      EXPECT_EQ(node.attr().at("num_cols").i(), 128);
+      found++;
+    } else if (node.name() == "bias_add") {
+      EXPECT_EQ(node.op(), "BiasAdd");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 2);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-5);
+}
+
 class RemapperFuseMatMulWithBiasTest : public RemapperTest {
  public:
   template <DataType DTYPE>
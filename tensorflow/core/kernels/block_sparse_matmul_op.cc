@@ -0,0 +1,274 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/math_ops.cc.
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/util/block_sparse.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Rows of `a` that are multiplied together, so that every stored block is
+// loaded once per group rather than once per row.
+constexpr int kRowsPerGroup = 4;
+
+// Accumulates the product of kRows rows of `a` with the BSR matrix into the
+// matching rows of the output. The block shape is a compile time constant so
+// the block loops unroll fully and the column loop maps onto SIMD lanes.
+template <int BR, int BC, int kRows>
+void MultiplyRowGroup(const float* const* a_rows, const float* values,
+                      const int32_t* col_indices, const int32_t* row_ptr,
+                      int64_t num_block_rows, float* const* out_rows) {
+  for (int64_t block_row = 0; block_row < num_block_rows; ++block_row) {
+    float x[kRows][BR];
+    for (int r = 0; r < kRows; ++r) {
+      for (int i = 0; i < BR; ++i) x[r][i] = a_rows[r][block_row * BR + i];
+    }
+    for (int32_t b = row_ptr[block_row]; b < row_ptr[block_row + 1]; ++b) {
+      const float* block = values + int64_t{b} * BR * BC;
+      const int64_t col = int64_t{col_indices[b]} * BC;
+      for (int r = 0; r < kRows; ++r) {
+        float* out = out_rows[r] + col;
+        float acc[BC];
+        for (int j = 0; j < BC; ++j) acc[j] = out[j];
+        for (int i = 0; i < BR; ++i) {
+          for (int j = 0; j < BC; ++j) acc[j] += x[r][i] * block[i * BC + j];
+        }
+        for (int j = 0; j < BC; ++j) out[j] = acc[j];
+      }
+    }
+  }
+}
+
+template <int BR, int BC>
+void BlockSparseMatMul(OpKernelContext* context, const float* a, int64_t m,
+                       int64_t k, const float* values,
+                       const int32_t* col_indices, const int32_t* row_ptr,
+                       float* out, int64_t n) {
+  const int64_t num_block_rows = k / BR;
+  const int64_t num_groups = (m + kRowsPerGroup - 1) / kRowsPerGroup;
+  auto work = [&](int64_t begin, int64_t end) {
+    for (int64_t group = begin; group < end; ++group) {
+      const int64_t row = group * kRowsPerGroup;
+      const int64_t rows = std::min<int64_t>(kRowsPerGroup, m - row);
+      std::fill(out + row * n, out + (row + rows) * n, 0.0f);
+      const float* a_rows[kRowsPerGroup];
+      float* out_rows[kRowsPerGroup];
+      for (int r = 0; r < rows; ++r) {
+        a_rows[r] = a + (row + r) * k;
+        out_rows[r] = out + (row + r) * n;
+      }
+      if (rows == kRowsPerGroup) {
+        MultiplyRowGroup<BR, BC, kRowsPerGroup>(
+            a_rows, values, col_indices, row_ptr, num_block_rows, out_rows);
+      } else {
+        for (int r = 0; r < rows; ++r) {
+          MultiplyRowGroup<BR, BC, 1>(&a_rows[r], values, col_indices, row_ptr,
+                                      num_block_rows, &out_rows[r]);
+        }
+      }
+    }
+  };
+  const int64_t stored = int64_t{row_ptr[num_block_rows]} * BR * BC;
+  const int64_t cost_per_group = kRowsPerGroup * (2 * stored + n);
+  auto* worker_threads = context->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads->num_threads, worker_threads->workers, num_groups,
+        cost_per_group, work);
+}
+
+}  // namespace
+
+class DenseToBlockSparseOp : public OpKernel {
+ public:
+  explicit DenseToBlockSparseOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("block_rows", &block_rows_));
+    OP_REQUIRES_OK(context, context->GetAttr("block_cols", &block_cols_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& dense = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsMatrix(dense.shape()),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "dense must be a matrix, got shape ",
+                    dense.shape().DebugString())));
+    const int64_t rows = dense.dim_size(0);
+    const int64_t cols = dense.dim_size(1);
+    OP_REQUIRES(context, rows % block_rows_ == 0 && cols % block_cols_ == 0,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "dense shape ", dense.shape().DebugString(),
+                    " is not a multiple of the block shape [", block_rows_,
+                    ", ", block_cols_, "]")));
+    OP_REQUIRES(
+        context, rows / block_rows_ < std::numeric_limits<int32_t>::max(),
+        absl::InvalidArgumentError("dense has too many block rows"));
+
+    const float* dense_data = dense.flat<float>().data();
+    const int64_t num_blocks = CountNonZeroBlocks(
+        dense_data, rows, cols, block_rows_, block_cols_);
+    OP_REQUIRES(context, num_blocks <= std::numeric_limits<int32_t>::max(),
+                absl::InvalidArgumentError("dense has too many blocks"));
+
+    Tensor* values = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({num_blocks, block_rows_, block_cols_}),
+                       &values));
+    Tensor* col_indices = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                1, TensorShape({num_blocks}), &col_indices));
+    Tensor* row_ptr = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       2, TensorShape({rows / block_rows_ + 1}), &row_ptr));
+    DenseToBlockSparse(dense_data, rows, cols, block_rows_, block_cols_,
+                       values->flat<float>().data(),
+                       col_indices->flat<int32_t>().data(),
+                       row_ptr->flat<int32_t>().data());
+  }
+
+ private:
+  int block_rows_;
+  int block_cols_;
+};
+
+class BlockSparseMatMulOp : public OpKernel {
+ public:
+  explicit BlockSparseMatMulOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("block_rows", &block_rows_));
+    OP_REQUIRES_OK(context, context->GetAttr("block_cols", &block_cols_));
+    OP_REQUIRES_OK(context, context->GetAttr("num_cols", &num_cols_));
+    OP_REQUIRES(context, IsSupportedBlockShape(block_rows_, block_cols_),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "Unsupported block shape [", block_rows_, ", ",
+                    block_cols_, "]; expected [1, 4], [4, 4] or [8, 1]")));
+    OP_REQUIRES(context, num_cols_ % block_cols_ == 0,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "num_cols ", num_cols_,
+                    " is not a multiple of block_cols ", block_cols_)));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& a = context->input(0);
+    const Tensor& values = context->input(1);
+    const Tensor& col_indices = context->input(2);
+    const Tensor& row_ptr = context->input(3);
+    OP_REQUIRES(context, TensorShapeUtils::IsMatrix(a.shape()),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "a must be a matrix, got shape ",
+                    a.shape().DebugString())));
+    OP_REQUIRES(context,
+                values.dims() == 3 && values.dim_size(1) == block_rows_ &&
+                    values.dim_size(2) == block_cols_,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "b_values must have shape [num_blocks, ", block_rows_,
+                    ", ", block_cols_, "], got ",
+                    values.shape().DebugString())));
+    const int64_t num_blocks = values.dim_size(0);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(col_indices.shape()) &&
+                    col_indices.NumElements() == num_blocks,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "b_col_indices must be a vector of ", num_blocks,
+                    " elements, got shape ",
+                    col_indices.shape().DebugString())));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(row_ptr.shape()) &&
+                    row_ptr.NumElements() >= 1,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "b_row_ptr must be a non-empty vector, got shape ",
+                    row_ptr.shape().DebugString())));
+    const int64_t num_block_rows = row_ptr.NumElements() - 1;
+    const int64_t k = a.dim_size(1);
+    OP_REQUIRES(context, num_block_rows * block_rows_ == k,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "b has ", num_block_rows * block_rows_,
+                    " rows but a has ", k, " columns")));
+
+    // The indices come from a graph input, so validate them before use.
+    const auto row_ptr_vec = row_ptr.vec<int32_t>();
+    OP_REQUIRES(context,
+                row_ptr_vec(0) == 0 &&
+                    row_ptr_vec(num_block_rows) == num_blocks,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "b_row_ptr must start at 0 and end at ", num_blocks)));
+    for (int64_t r = 0; r < num_block_rows; ++r) {
+      OP_REQUIRES(context, row_ptr_vec(r) <= row_ptr_vec(r + 1),
+                  absl::InvalidArgumentError(
+                      absl::StrCat("b_row_ptr is not sorted at ", r)));
+    }
+    const auto col_indices_vec = col_indices.vec<int32_t>();
+    const int64_t num_block_cols = num_cols_ / block_cols_;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      OP_REQUIRES(context,
+                  col_indices_vec(b) >= 0 &&
+                      col_indices_vec(b) < num_block_cols,
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "b_col_indices[", b, "] = ", col_indices_vec(b),
+                      " is out of range [0, ", num_block_cols, ")")));
+    }
+
+    const int64_t m = a.dim_size(0);
+    Tensor* product = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({m, num_cols_}), &product));
+    if (m == 0 || num_cols_ == 0) return;
+
+    const float* a_data = a.flat<float>().data();
+    const float* values_data = values.flat<float>().data();
+    float* out = product->flat<float>().data();
+    if (block_rows_ == 1) {
+      BlockSparseMatMul<1, 4>(context, a_data, m, k, values_data,
+                              col_indices_vec.data(), row_ptr_vec.data(), out,
+                              num_cols_);
+    } else if (block_rows_ == 4) {
+      BlockSparseMatMul<4, 4>(context, a_data, m, k, values_data,
+                              col_indices_vec.data(), row_ptr_vec.data(), out,
+                              num_cols_);
+    } else {
+      BlockSparseMatMul<8, 1>(context, a_data, m, k, values_data,
+                              col_indices_vec.data(), row_ptr_vec.data(), out,
+                              num_cols_);
+    }
+  }
+
+ private:
+  int block_rows_;
+  int block_cols_;
+  int64_t num_cols_;
+};
+
+REGISTER_KERNEL_BUILDER(
+    Name("_DenseToBlockSparse").Device(DEVICE_CPU).TypeConstraint<float>("T"),
+    DenseToBlockSparseOp);
+REGISTER_KERNEL_BUILDER(
+    Name("_BlockSparseMatMul").Device(DEVICE_CPU).TypeConstraint<float>("T"),
+    BlockSparseMatMulOp);
+
+}  // namespace tensorflow
@@ -0,0 +1,224 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/util/block_sparse.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns a [rows, cols] matrix in which roughly `density` of the
+// block_rows x block_cols blocks are non-zero.
+Tensor RandomBlockSparseMatrix(int64_t rows, int64_t cols, int block_rows,
+                               int block_cols, float density) {
+  Tensor t(DT_FLOAT, TensorShape({rows, cols}));
+  auto m = t.matrix<float>();
+  m.setZero();
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  for (int64_t r = 0; r < rows; r += block_rows) {
+    for (int64_t c = 0; c < cols; c += block_cols) {
+      if (uniform(rng) >= density) continue;
+      for (int i = 0; i < block_rows; ++i) {
+        for (int j = 0; j < block_cols; ++j) {
+          m(r + i, c + j) = static_cast<int>(rng() % 7) - 3;
+        }
+      }
+    }
+  }
+  return t;
+}
+
+class BlockSparseMatMulOpTest : public OpsTestBase {
+ protected:
+  // Converts `b` with _DenseToBlockSparse and returns the three outputs.
+  std::vector<Tensor> Convert(const Tensor& b, int block_rows,
+                              int block_cols) {
+    TF_CHECK_OK(NodeDefBuilder("convert", "_DenseToBlockSparse")
+                    .Input(FakeInput(DT_FLOAT))
+                    .Attr("block_rows", block_rows)
+                    .Attr("block_cols", block_cols)
+                    .Finalize(node_def()));
+    TF_CHECK_OK(InitOp());
+    AddInputFromArray<float>(b.shape(), b.flat<float>());
+    TF_CHECK_OK(RunOpKernel());
+    return {*GetOutput(0), *GetOutput(1), *GetOutput(2)};
+  }
+
+  absl::Status MatMul(const Tensor& a, const std::vector<Tensor>& b,
+                      int block_rows, int block_cols, int num_cols) {
+    inputs_.clear();
+    TF_CHECK_OK(NodeDefBuilder("matmul", "_BlockSparseMatMul")
+                    .Input(FakeInput(DT_FLOAT))
+                    .Input(FakeInput(DT_FLOAT))
+                    .Input(FakeInput(DT_INT32))
+                    .Input(FakeInput(DT_INT32))
+                    .Attr("block_rows", block_rows)
+                    .Attr("block_cols", block_cols)
+                    .Attr("num_cols", num_cols)
+                    .Finalize(node_def()));
+    TF_RETURN_IF_ERROR(InitOp());
+    AddInputFromArray<float>(a.shape(), a.flat<float>());
+    AddInputFromArray<float>(b[0].shape(), b[0].flat<float>());
+    AddInputFromArray<int32_t>(b[1].shape(), b[1].flat<int32_t>());
+    AddInputFromArray<int32_t>(b[2].shape(), b[2].flat<int32_t>());
+    return RunOpKernel();
+  }
+
+  void TestBlockShape(int block_rows, int block_cols) {
+    const int64_t m = 7, k = 32, n = 24;
+    Tensor a = RandomBlockSparseMatrix(m, k, 1, 1, 1.0f);
+    Tensor b = RandomBlockSparseMatrix(k, n, block_rows, block_cols, 0.3f);
+    const std::vector<Tensor> bsr = Convert(b, block_rows, block_cols);
+    TF_ASSERT_OK(MatMul(a, bsr, block_rows, block_cols, n));
+
+    Tensor expected(DT_FLOAT, TensorShape({m, n}));
+    auto a_m = a.matrix<float>();
+    auto b_m = b.matrix<float>();
+    for (int64_t i = 0; i < m; ++i) {
+      for (int64_t j = 0; j < n; ++j) {
+        float sum = 0;
+        for (int64_t t = 0; t < k; ++t) sum += a_m(i, t) * b_m(t, j);
+        expected.matrix<float>()(i, j) = sum;
+      }
+    }
+    test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+  }
+};
+
+TEST_F(BlockSparseMatMulOpTest, ConvertKeepsNonZeroBlocks) {
+  Tensor b(DT_FLOAT, TensorShape({2, 8}));
+  test::FillValues<float>(&b, {0, 0, 0, 0, 1, 0, 0, 2,  //
+                               0, 0, 0, 0, 0, 0, 0, 0});
+  const std::vector<Tensor> bsr = Convert(b, 1, 4);
+  test::ExpectTensorEqual<float>(
+      bsr[0], test::AsTensor<float>({1, 0, 0, 2}, TensorShape({1, 1, 4})));
+  test::ExpectTensorEqual<int32_t>(bsr[1], test::AsTensor<int32_t>({1}));
+  test::ExpectTensorEqual<int32_t>(bsr[2], test::AsTensor<int32_t>({0, 1, 1}));
+}
+
+TEST_F(BlockSparseMatMulOpTest, Blocks1x4) { TestBlockShape(1, 4); }
+
+TEST_F(BlockSparseMatMulOpTest, Blocks4x4) { TestBlockShape(4, 4); }
+
+TEST_F(BlockSparseMatMulOpTest, Blocks8x1) { TestBlockShape(8, 1); }
+
+TEST_F(BlockSparseMatMulOpTest, RejectsOutOfRangeBlockColumn) {
+  Tensor a(DT_FLOAT, TensorShape({1, 4}));
+  a.flat<float>().setZero();
+  Tensor values(DT_FLOAT, TensorShape({1, 4, 4}));
+  values.flat<float>().setZero();
+  const absl::Status s =
+      MatMul(a,
+             {values, test::AsTensor<int32_t>({2}),
+              test::AsTensor<int32_t>({0, 1})},
+             4, 4, /*num_cols=*/8);
+  EXPECT_TRUE(absl::StrContains(s.message(), "out of range")) << s;
+}
+
+// Args: m, k (= n), block rows, block cols and block density in percent.
+void BM_BlockSparseMatMul(::testing::benchmark::State& state) {
+  const int m = state.range(0);
+  const int k = state.range(1);
+  const int block_rows = state.range(2);
+  const int block_cols = state.range(3);
+  const float density = state.range(4) / 100.0f;
+
+  Tensor a = RandomBlockSparseMatrix(m, k, 1, 1, 1.0f);
+  Tensor b = RandomBlockSparseMatrix(k, k, block_rows, block_cols, density);
+  const float* b_data = b.flat<float>().data();
+  const int64_t num_blocks =
+      CountNonZeroBlocks(b_data, k, k, block_rows, block_cols);
+  Tensor values(DT_FLOAT, TensorShape({num_blocks, block_rows, block_cols}));
+  Tensor col_indices(DT_INT32, TensorShape({num_blocks}));
+  Tensor row_ptr(DT_INT32, TensorShape({k / block_rows + 1}));
+  DenseToBlockSparse(b_data, k, k, block_rows, block_cols,
+                     values.flat<float>().data(),
+                     col_indices.flat<int32_t>().data(),
+                     row_ptr.flat<int32_t>().data());
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "_BlockSparseMatMul")
+                  .Input(test::graph::Constant(g, a))
+                  .Input(test::graph::Constant(g, values))
+                  .Input(test::graph::Constant(g, col_indices))
+                  .Input(test::graph::Constant(g, row_ptr))
+                  .Attr("block_rows", block_rows)
+                  .Attr("block_cols", block_cols)
+                  .Attr("num_cols", k)
+                  .Finalize(g, &node));
+  test::Benchmark("cpu", g, /*old_benchmark_api*/ false).Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * m * k *
+                          k * 2);
+}
+
+BENCHMARK(BM_BlockSparseMatMul)
+    ->UseRealTime()
+    ->Args({1, 1024, 1, 4, 10})
+    ->Args({1, 1024, 4, 4, 10})
+    ->Args({1, 1024, 8, 1, 10})
+    ->Args({64, 1024, 1, 4, 5})
+    ->Args({64, 1024, 1, 4, 10})
+    ->Args({64, 1024, 1, 4, 25})
+    ->Args({64, 1024, 1, 4, 50})
+    ->Args({64, 1024, 4, 4, 5})
+    ->Args({64, 1024, 4, 4, 10})
+    ->Args({64, 1024, 4, 4, 25})
+    ->Args({64, 1024, 4, 4, 50})
+    ->Args({64, 1024, 8, 1, 5})
+    ->Args({64, 1024, 8, 1, 10})
+    ->Args({64, 1024, 8, 1, 25})
+    ->Args({64, 1024, 8, 1, 50});
+
+// Dense Eigen baseline for BM_BlockSparseMatMul. Args: m, k (= n).
+void BM_DenseMatMulBaseline(::testing::benchmark::State& state) {
+  const int m = state.range(0);
+  const int k = state.range(1);
+  Tensor a = RandomBlockSparseMatrix(m, k, 1, 1, 1.0f);
+  Tensor b = RandomBlockSparseMatrix(k, k, 1, 1, 1.0f);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  test::graph::Matmul(g, test::graph::Constant(g, a),
+                      test::graph::Constant(g, b), false, false);
+  test::Benchmark("cpu", g, /*old_benchmark_api*/ false).Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * m * k *
+                          k * 2);
+}
+
+BENCHMARK(BM_DenseMatMulBaseline)
+    ->UseRealTime()
+    ->Args({1, 1024})
+    ->Args({64, 1024});
+
+}  // namespace
+}  // namespace tensorflow
@@ -250,7 +250,9 @@ class BatchDatasetOp::Dataset : public DatasetBase {
       // respective slice locations. This would require a different GetNext()
       // overload that supports zero-copy, and might make sense in an
       // optimization pass.
-      TF_RETURN_IF_ERROR(CopyBatch(AnyContext(ctx), std::move(batch_elements),
+      AnyContext batch_ctx(ctx);
+      batch_ctx.allocator = ctx->batch_allocator({});
+      TF_RETURN_IF_ERROR(CopyBatch(batch_ctx, std::move(batch_elements),
                                    dataset()->parallel_copy_, out_tensors));
 
       *end_of_sequence = false;
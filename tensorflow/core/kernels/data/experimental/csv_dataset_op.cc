@@ -12,6 +12,8 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <cstring>
+
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/op.h"
@@ -20,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/util/csv_scanner.h"
 
 namespace tensorflow {
 namespace data {
@@ -516,7 +519,8 @@ class CSVDatasetOp : public DatasetOpKernel {
         pos_++;  // Starting quotation mark
 
         absl::Status parse_result;
-        while (true) {  // Each iter reads 1 char, filling buffer if necessary
+        // Each iter reads up to the next quote, filling buffer if necessary.
+        while (true) {
           if (pos_ >= buffer_.size()) {
             absl::Status s =
                 SaveAndFillBuffer(&earlier_pieces, &start, include);
@@ -573,7 +577,11 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
 
           } else {
-            pos_++;
+            // Only a quote can end a quoted field, so jump straight to the
+            // next one.
+            const char* quote = static_cast<const char*>(std::memchr(
+                buffer_.data() + pos_, '"', buffer_.size() - pos_));
+            pos_ = quote == nullptr ? buffer_.size() : quote - buffer_.data();
           }
         }
       }
@@ -654,7 +662,9 @@ class CSVDatasetOp : public DatasetOpKernel {
         size_t start = pos_;
         absl::Status parse_result;
 
-        while (true) {  // Each iter reads 1 char, filling buffer if necessary
+        // Each iter reads up to the next special char, filling buffer if
+        // necessary.
+        while (true) {
           if (pos_ >= buffer_.size()) {
             absl::Status s =
                 SaveAndFillBuffer(&earlier_pieces, &start, include);
@@ -671,6 +681,11 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
           }
 
+          pos_ += FindCsvSpecialChar(buffer_.data() + pos_,
+                                     buffer_.size() - pos_, dataset()->delim_,
+                                     dataset()->use_quote_delim_);
+          if (pos_ >= buffer_.size()) continue;
+
           char ch = buffer_[pos_];
 
           if (ch == dataset()->delim_) {
@@ -90,6 +90,8 @@ namespace data {
 /* static */ constexpr const char* const DataServiceDatasetOp::kUncompressFn;
 /* static */ constexpr const char* const
     DataServiceDatasetOp::kCrossTrainerCacheOptions;
+/* static */ constexpr const char* const
+    DataServiceDatasetOp::kLoadAwareTaskSelection;
 
 namespace {
 constexpr char kDataServiceDatasetV1[] = "DataServiceDataset";
@@ -123,7 +125,7 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
       std::unique_ptr<CapturedFunction> captured_uncompress_func,
       const std::optional<CrossTrainerCacheOptions>&
           cross_trainer_cache_options,
-      const DataTypeVector& output_types,
+      bool load_aware_task_selection, const DataTypeVector& output_types,
       const std::vector<PartialTensorShape>& output_shapes)
       : DatasetBase(DatasetContext(ctx)),
         op_version_(op_version),
@@ -146,6 +148,7 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
         resource_mgr_(ctx->resource_manager()),
         captured_uncompress_func_(std::move(captured_uncompress_func)),
         cross_trainer_cache_options_(cross_trainer_cache_options),
+        load_aware_task_selection_(load_aware_task_selection),
         output_types_(output_types),
         output_shapes_(output_shapes) {}
 
@@ -172,7 +175,8 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
                           num_consumers_, consumer_index_,
                           max_outstanding_requests_, task_refresh_interval_,
                           target_workers_, metadata_,
-                          cross_trainer_cache_options_});
+                          cross_trainer_cache_options_,
+                          load_aware_task_selection_});
   }
 
   const DataTypeVector& output_dtypes() const override { return output_types_; }
@@ -311,6 +315,13 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
                       &cross_trainer_cache_options_attr);
     attrs.push_back(
         {kCrossTrainerCacheOptions, cross_trainer_cache_options_attr});
+
+    if (op_version_ >= 4) {
+      AttrValue load_aware_task_selection;
+      b->BuildAttrValue(load_aware_task_selection_,
+                        &load_aware_task_selection);
+      attrs.push_back({kLoadAwareTaskSelection, load_aware_task_selection});
+    }
     return b->AddDataset(this, inputs, attrs, output);
   }
 
@@ -521,6 +532,7 @@ class DataServiceDatasetOp::Dataset : public DatasetBase {
   ResourceMgr* const resource_mgr_;  // Not owned
   const std::unique_ptr<CapturedFunction> captured_uncompress_func_;
   const std::optional<CrossTrainerCacheOptions> cross_trainer_cache_options_;
+  const bool load_aware_task_selection_;
   const DataTypeVector output_types_;
   const std::vector<PartialTensorShape> output_shapes_;
 };
@@ -579,6 +591,11 @@ DataServiceDatasetOp::DataServiceDatasetOp(OpKernelConstruction* ctx)
     OP_REQUIRES_OK(ctx, ctx->GetAttr(kCrossTrainerCacheOptions,
                                      &seriazlied_cross_trainer_cache_options_));
   }
+
+  if (ctx->HasAttr(kLoadAwareTaskSelection)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kLoadAwareTaskSelection,
+                                     &load_aware_task_selection_));
+  }
 }
 
 void DataServiceDatasetOp::MakeDataset(OpKernelContext* ctx,
@@ -749,7 +766,8 @@ void DataServiceDatasetOp::MakeDataset(OpKernelContext* ctx,
       max_outstanding_requests, task_refresh_interval_hint_, target_workers_,
       *metadata, iteration_counter, owns_resource, iteration_counter_handle,
       std::move(captured_uncompress_func), cross_trainer_cache_options,
-      data_service_output_types, data_service_output_shapes);
+      load_aware_task_selection_, data_service_output_types,
+      data_service_output_shapes);
   if (should_uncompress) {
     VLOG(2) << "Inserting a ParallelMap dataset to uncompress tf.data service "
             << "dataset " << dataset_id << ".";
@@ -79,6 +79,8 @@ class DataServiceDatasetOp : public DatasetOpKernel {
   static constexpr const char* const kUncompressFn = "uncompress_fn";
   static constexpr const char* const kCrossTrainerCacheOptions =
       "cross_trainer_cache_options";
+  static constexpr const char* const kLoadAwareTaskSelection =
+      "load_aware_task_selection";
 
   // Note: If a new constant is declared here, it *must* be defined in
   // data_service_dataset_op.cc, otherwise it will not compile in debug mode.
@@ -99,6 +101,7 @@ class DataServiceDatasetOp : public DatasetOpKernel {
   bool uncompress_;
   std::shared_ptr<FunctionMetadata> uncompress_fn_ = nullptr;
   std::string seriazlied_cross_trainer_cache_options_;
+  bool load_aware_task_selection_ = false;
 };
 
 }  // namespace data
@@ -546,7 +546,7 @@ class MapAndBatchDatasetOp::Dataset : public DatasetBase {
         component_shape.AppendShape(return_values->at(i).shape());
         AllocatorAttributes attr;
         attr.set_gpu_compatible(true);
-        result->output.emplace_back(ctx->allocator(attr),
+        result->output.emplace_back(ctx->batch_allocator(attr),
                                     return_values->at(i).dtype(),
                                     component_shape);
         if (!result->output.back().IsInitialized()) {
@@ -21,7 +21,10 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "xla/tsl/platform/statusor.h"
 #include "tensorflow/core/activity_watcher/activity.h"
@@ -80,6 +83,12 @@ bool SymbolicCheckpointEnabled(const Options& options) {
          options.symbolic_checkpoint();
 }
 
+bool AsyncCheckpointEnabled(const Options& options) {
+  return options.optional_async_checkpoint_case() ==
+             Options::kAsyncCheckpoint &&
+         options.async_checkpoint();
+}
+
 }  // namespace
 
 /* static */ constexpr const char* const
@@ -216,6 +225,55 @@ absl::Status IteratorResource::Save(OpKernelContext* ctx,
   return iterator->Save(&serialization_ctx, writer);
 }
 
+absl::StatusOr<std::vector<IteratorStateVariant>>
+IteratorResource::SaveToVariants(OpKernelContext* ctx,
+                                 ExternalStatePolicy external_state_policy) {
+  std::shared_ptr<State> captured_state;
+  {
+    tf_shared_lock l(mu_);
+    captured_state = iterator_state_;
+  }
+  VariantTensorDataWriter writer;
+  TF_RETURN_IF_ERROR(Save(ctx, external_state_policy, &writer));
+  std::vector<std::unique_ptr<VariantTensorData>> data;
+  writer.ReleaseData(&data);
+  std::vector<IteratorStateVariant> variants;
+  variants.reserve(data.size());
+  for (auto& it : data) {
+    IteratorStateVariant v;
+    TF_RETURN_IF_ERROR(v.InitializeFromVariantData(std::move(it)));
+    variants.push_back(v);
+  }
+  if (!AsyncCheckpointEnabled(captured_state->dataset()->options())) {
+    return variants;
+  }
+
+  // The state only holds references to the tensors of the iterators, so it is
+  // encoded in the background while iteration continues. The previous
+  // checkpoint is kept, so that state which did not change since, such as an
+  // untouched shuffle buffer, is not encoded again.
+  mutex_lock l(checkpoint_mu_);
+  absl::flat_hash_map<absl::string_view, const IteratorStateVariant*> previous;
+  for (const auto& variant : last_checkpoint_) {
+    previous[variant.GetData()->metadata_string()] = &variant;
+  }
+  int64_t num_reused = 0;
+  for (auto& variant : variants) {
+    auto it = previous.find(variant.GetData()->metadata_string());
+    if (it != previous.end() && variant.ReuseEncoding(*it->second)) {
+      ++num_reused;
+      continue;
+    }
+    variant.EncodeAsync([this](std::function<void()> fn) {
+      unbounded_thread_pool_.Schedule(std::move(fn));
+    });
+  }
+  VLOG(2) << "Reused the encoding of " << num_reused << " out of "
+          << variants.size() << " iterator states";
+  last_checkpoint_ = std::vector<IteratorStateVariant>(variants);
+  return variants;
+}
+
 absl::Status IteratorResource::Restore(OpKernelContext* ctx,
                                        IteratorStateReader* reader) {
   const DatasetBase* dataset;
@@ -376,23 +434,14 @@ class IteratorVariantSerializer {
  public:
   IteratorVariantSerializer() = default;
 
-  // Calls `Save` on the iterator_resource to build up the list of
+  // Calls `SaveToVariants` on the iterator_resource to build up the list of
   // IteratorStateVariant objects.
   absl::Status InitializeFromIterator(OpKernelContext* ctx,
                                       ExternalStatePolicy external_state_policy,
                                       IteratorResource* iterator_resource) {
-    VariantTensorDataWriter writer;
-    TF_RETURN_IF_ERROR(
-        iterator_resource->Save(ctx, external_state_policy, &writer));
-    std::vector<std::unique_ptr<VariantTensorData>> data;
-    writer.ReleaseData(&data);
-    variants_.clear();
-    variants_.reserve(data.size());
-    for (auto& it : data) {
-      IteratorStateVariant v;
-      TF_RETURN_IF_ERROR(v.InitializeFromVariantData(std::move(it)));
-      variants_.push_back(v);
-    }
+    TF_ASSIGN_OR_RETURN(
+        variants_,
+        iterator_resource->SaveToVariants(ctx, external_state_policy));
     num_tensors_ = variants_.size();
     can_serialize_ = true;
     return absl::OkStatus();
@@ -20,8 +20,10 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/status/statusor.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/metric_utils.h"
+#include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/data/tfdataz_metrics.h"
 #include "tensorflow/core/data/unbounded_thread_pool.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -63,6 +65,14 @@ class IteratorResource : public ResourceBase {
                     ExternalStatePolicy external_state_policy,
                     IteratorStateWriter* writer);
 
+  // Saves a checkpoint of the state of the iterator like `Save`, and returns it
+  // as one `IteratorStateVariant` per iterator. If the dataset enables
+  // asynchronous checkpointing, the variants are encoded in the background, and
+  // iterators whose state did not change since the previous checkpoint reuse
+  // its encoding.
+  absl::StatusOr<std::vector<IteratorStateVariant>> SaveToVariants(
+      OpKernelContext* ctx, ExternalStatePolicy external_state_policy);
+
   // Restores the state of the iterator from a checkpoint created by `Save`.
   absl::Status Restore(OpKernelContext* ctx, IteratorStateReader* reader);
 
@@ -160,6 +170,11 @@ class IteratorResource : public ResourceBase {
   const Env& env_;
   const std::unique_ptr<DeviceMgr> device_mgr_ TF_GUARDED_BY(mu_);
   std::shared_ptr<State> iterator_state_ TF_GUARDED_BY(mu_);
+  mutex checkpoint_mu_;
+  // The previous asynchronous checkpoint, whose encodings can be reused by the
+  // next one.
+  std::vector<IteratorStateVariant> last_checkpoint_
+      TF_GUARDED_BY(checkpoint_mu_);
   const DataTypeVector output_dtypes_;
   const std::vector<PartialTensorShape> output_shapes_;
 };
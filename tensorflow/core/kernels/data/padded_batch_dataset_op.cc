@@ -340,7 +340,7 @@ class PaddedBatchDatasetOp::Dataset : public DatasetBase {
 
         // 2. Copy each batch element to the appropriate location in
         // the output component tensor.
-        out_tensors->emplace_back(ctx->allocator({}),
+        out_tensors->emplace_back(ctx->batch_allocator({}),
                                   output_dtypes()[component_index],
                                   batch_component_shape);
         Tensor& batch_component = out_tensors->back();
@@ -441,7 +441,9 @@ class ParallelBatchDatasetOp::Dataset : public DatasetBase {
         absl::Status status;
         {
           mutex_lock l(result->mu);
-          status = CopyBatch(AnyContext(ctx.get()), std::move(batch_elements),
+          AnyContext batch_ctx(ctx.get());
+          batch_ctx.allocator = ctx->batch_allocator({});
+          status = CopyBatch(batch_ctx, std::move(batch_elements),
                              dataset()->parallel_copy_, &result->output);
           result->status.Update(status);
 
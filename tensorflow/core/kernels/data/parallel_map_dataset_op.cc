@@ -32,6 +32,7 @@ limitations under the License.
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/notification.h"
+#include "absl/types/span.h"
 #include "xla/tsl/platform/logging.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/input_colocation_exemption_registry.h"
@@ -39,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/stats_utils.h"
 #include "tensorflow/core/data/unbounded_thread_pool.h"
+#include "tensorflow/core/data/vectorization_utils.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
@@ -99,6 +101,18 @@ constexpr int kStatsReportingPeriodMillis = 1000;
 // large values for the parallelism, e.g. creating 300k threads.
 constexpr int kUnboundedThreadpoolAutotuningFactor = 10;
 
+// Maximum number of elements that a vectorized map function is applied to in
+// one invocation. Larger micro-batches amortize more per-call overhead, but
+// each element waits for the whole micro-batch to be computed.
+constexpr int64_t kMaxMicroBatchSize = 16;
+
+// Returns the number of elements to apply a vectorized map function to in one
+// invocation. Using at most half of the parallelism for a micro-batch keeps
+// the next micro-batch computing while the previous one is consumed.
+int64_t MicroBatchSize(int64_t num_parallel_calls) {
+  return std::clamp<int64_t>(num_parallel_calls / 2, 1, kMaxMicroBatchSize);
+}
+
 }  // namespace
 
 class ParallelMapDatasetOp::Dataset : public DatasetBase {
@@ -299,8 +313,10 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       mutex_lock l(*mu_);
       interleave_depth_ = ctx->interleave_depth();
       if (use_unbounded_threadpool_) {
+        ThreadOptions thread_options;
+        thread_options.numa_node = ctx->numa_node();
         unbounded_thread_pool_ = std::make_unique<UnboundedThreadPool>(
-            ctx->env(), "tf_data_map_unbounded_thread_pool");
+            ctx->env(), "tf_data_map_unbounded_thread_pool", thread_options);
       }
       if (num_parallel_calls_->value == model::kAutotune) {
         num_parallel_calls_->value = GetAutotuneDefaultParallelism(ctx);
@@ -317,6 +333,14 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       ctx->MergeCheckpoint(iter_ctx->checkpoint());
       TF_RETURN_IF_ERROR(dataset()->captured_func_->Instantiate(
           ctx, &instantiated_captured_func_));
+      // Functions that short-circuit do not go through the function runtime,
+      // so there is no per-call overhead for vectorization to amortize.
+      vectorize_ =
+          ctx->options() != nullptr &&
+          ctx->options()->optimization_options().map_micro_batching() &&
+          dataset()->captured_func_->short_circuit_info().indices.empty() &&
+          dataset()->captured_func_->CanRunBatched(
+              dataset()->input_->output_dtypes().size());
       if (ctx->warm_start() && !ctx->is_restoring()) {
         EnsureThreadsStarted(ctx);
       }
@@ -501,6 +525,8 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       result.push_back(std::make_pair(
           "interleave_depth",
           absl::StrFormat("%lld", static_cast<long long>(interleave_depth_))));
+      result.push_back(
+          std::make_pair("vectorized", vectorize_ ? "true" : "false"));
       return result;
     }
 
@@ -564,14 +590,89 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       });
       // Get the next input element.
       std::vector<Tensor> input_element;
-      result->status = input_impl_->GetNext(ctx.get(), &input_element,
+      if (!GetNextInput(ctx, result, &input_element)) {
+        return;
+      }
+      RunFunction(ctx, result, std::move(input_element));
+    }
+
+    // Applies the map function to a micro-batch of input elements with a
+    // single invocation. Falls back to per-element invocations if the
+    // elements cannot be stacked into a batch.
+    void CallBatchedFunction(
+        const std::shared_ptr<IteratorContext>& ctx,
+        absl::Span<const std::shared_ptr<InvocationResult>> results)
+        TF_LOCKS_EXCLUDED(*mu_) {
+      tsl::profiler::TraceMe traceme([&] {
+        return tsl::profiler::TraceMeEncode(
+            "ParallelMapProduceBatch", {{"element_id", results.front()->uid},
+                                        {"batch_size", results.size()}});
+      });
+      std::vector<std::shared_ptr<InvocationResult>> calls;
+      std::vector<std::vector<Tensor>> input_elements;
+      calls.reserve(results.size());
+      input_elements.reserve(results.size());
+      for (const auto& result : results) {
+        std::vector<Tensor> input_element;
+        if (GetNextInput(ctx, result, &input_element)) {
+          calls.push_back(result);
+          input_elements.push_back(std::move(input_element));
+        }
+      }
+      std::vector<Tensor> batch;
+      if (calls.size() < 2 || !StackElements(input_elements, &batch).ok()) {
+        for (size_t i = 0; i < calls.size(); ++i) {
+          RunFunction(ctx, calls[i], std::move(input_elements[i]));
+        }
+        return;
+      }
+      auto batched_rets = std::make_shared<std::vector<Tensor>>();
+      auto done = [this, ctx, calls = std::move(calls),
+                   input_elements = std::move(input_elements),
+                   batched_rets](absl::Status status) mutable {
+        std::vector<std::vector<Tensor>> return_values;
+        if (status.ok()) {
+          status = UnstackElements(*batched_rets, calls.size(), &return_values);
+        }
+        if (!status.ok()) {
+          // Rerun the function on each element, so that an error is reported
+          // for the element that raised it.
+          for (size_t i = 0; i < calls.size(); ++i) {
+            RunFunction(ctx, calls[i], std::move(input_elements[i]));
+          }
+          return;
+        }
+        // The iterator may be destroyed once the last call completes.
+        for (size_t i = 0; i < calls.size(); ++i) {
+          calls[i]->return_values = std::move(return_values[i]);
+          RecordBufferEnqueue(ctx.get(), calls[i]->return_values);
+          CallCompleted(ctx, calls[i]);
+        }
+      };
+      RunFunctionAsync(ctx, std::move(batch), batched_rets.get(),
+                       std::move(done));
+    }
+
+    // Gets the next input element for `result`. Returns false, after
+    // completing the call, if there is no input element to map.
+    bool GetNextInput(const std::shared_ptr<IteratorContext>& ctx,
+                      const std::shared_ptr<InvocationResult>& result,
+                      std::vector<Tensor>* input_element)
+        TF_LOCKS_EXCLUDED(*mu_) {
+      result->status = input_impl_->GetNext(ctx.get(), input_element,
                                             &result->end_of_input);
       result->checkpoint.Merge(ctx->checkpoint());
       if (result->end_of_input || !result->status.ok()) {
         CallCompleted(ctx, result);
-        return;
+        return false;
       }
+      return true;
+    }
 
+    void RunFunction(const std::shared_ptr<IteratorContext>& ctx,
+                     const std::shared_ptr<InvocationResult>& result,
+                     std::vector<Tensor> input_element)
+        TF_LOCKS_EXCLUDED(*mu_) {
       auto done = [this, ctx, result](absl::Status status) {
         if (!status.ok()) {
           result->status = AddErrorContext(status);
@@ -579,32 +680,38 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
         RecordBufferEnqueue(ctx.get(), result->return_values);
         CallCompleted(ctx, result);
       };
+      RunFunctionAsync(ctx, std::move(input_element), &result->return_values,
+                       std::move(done));
+    }
 
-      // Apply the map function on `input_element`, storing the result in
-      // `result->return_values`, and invoking `done` when finished.
+    // Applies the map function on `args`, storing the result in `rets`, and
+    // invokes `done` when finished. A runner thread is only blocked when the
+    // function runs inline on the single-threaded executor, since otherwise
+    // the executor schedules the function's ops on the same runner.
+    void RunFunctionAsync(const std::shared_ptr<IteratorContext>& ctx,
+                          std::vector<Tensor> args, std::vector<Tensor>* rets,
+                          std::function<void(absl::Status)> done)
+        TF_LOCKS_EXCLUDED(*mu_) {
       if (use_unbounded_threadpool_) {
         auto runner_fn = [this](std::function<void()> fn) {
           this->unbounded_thread_pool_->Schedule(fn);
         };
         instantiated_captured_func_->RunAsync(
             runner_fn, ctx->cancellation_manager(), ctx->collective_executor(),
-            std::move(input_element), &result->return_values, done,
-            model_node());
+            std::move(args), rets, std::move(done), model_node());
       } else if (dataset()->captured_func_->use_inter_op_parallelism()) {
         instantiated_captured_func_->RunAsync(
-            ctx.get(), std::move(input_element), &result->return_values,
-            std::move(done), model_node());
+            ctx.get(), std::move(args), rets, std::move(done), model_node());
       } else {
         // In this case, the function will be executed using single-threaded
         // executor. We schedule it using `ctx->runner()` to enable concurrent
         // application of the function over different input elements.
         auto fn = std::bind(
-            [this, ctx, result](std::vector<Tensor> input_element) {
+            [this, ctx, rets](std::vector<Tensor> args) {
               return instantiated_captured_func_->Run(
-                  ctx.get(), std::move(input_element), &result->return_values,
-                  model_node());
+                  ctx.get(), std::move(args), rets, model_node());
             },
-            std::move(input_element));
+            std::move(args));
         (*ctx->runner())(
             [this, ctx, fn = std::move(fn), done = std::move(done)]() {
               absl::Status s;
@@ -661,10 +768,18 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
         tf_shared_lock l(*mu_);  // mu_ == num_parallel_calls_->mu
         new_calls.reserve(num_parallel_calls_->value);
       }
-      auto busy = [this]() TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) -> bool {
+      // Calls are issued in groups of `micro_batch_size`, which is 1 unless
+      // the map function is vectorized.
+      int64_t micro_batch_size = 1;
+      auto busy = [this, &micro_batch_size]()
+                      TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) -> bool {
         int64_t num_parallel_calls = num_parallel_calls_->value;
-        return num_calls_ >= num_parallel_calls ||
-               invocation_results_.size() >= num_parallel_calls;
+        if (vectorize_) {
+          micro_batch_size = MicroBatchSize(num_parallel_calls);
+        }
+        return num_calls_ + micro_batch_size > num_parallel_calls ||
+               invocation_results_.size() + micro_batch_size >
+                   num_parallel_calls;
       };
       while (true) {
         {
@@ -678,15 +793,24 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
             return;
           }
           while (!busy()) {
-            invocation_results_.push_back(
-                std::make_shared<InvocationResult>(ctx.get()));
-            new_calls.push_back(invocation_results_.back());
-            num_calls_++;
+            for (int64_t i = 0; i < micro_batch_size; ++i) {
+              invocation_results_.push_back(
+                  std::make_shared<InvocationResult>(ctx.get()));
+              new_calls.push_back(invocation_results_.back());
+              num_calls_++;
+            }
           }
           cond_var_->notify_all();
         }
-        for (const auto& call : new_calls) {
-          CallFunction(ctx, call);
+        if (micro_batch_size == 1) {
+          for (const auto& call : new_calls) {
+            CallFunction(ctx, call);
+          }
+        } else {
+          absl::Span<const std::shared_ptr<InvocationResult>> calls(new_calls);
+          for (size_t i = 0; i < calls.size(); i += micro_batch_size) {
+            CallBatchedFunction(ctx, calls.subspan(i, micro_batch_size));
+          }
         }
         new_calls.clear();
       }
@@ -802,6 +926,11 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
     const bool preserve_cardinality_;
     const bool use_unbounded_threadpool_;
     const bool autotune_;
+    // Whether the map function is applied to micro-batches of input elements
+    // with one invocation each. Set in `Initialize()` if the
+    // `map_micro_batching` option is set and the function only applies
+    // elementwise ops to its input.
+    bool vectorize_ = false;
     // Counts the number of outstanding calls.
     int64_t num_calls_ TF_GUARDED_BY(*mu_) = 0;
     // Controls cancellation of `input_impl_`. Must be ordered before
@@ -11,11 +11,19 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/parallel_map_dataset_op.h"
 
+#include <cstdint>
+#include <memory>
+
 #include <gtest/gtest.h>
+#include "absl/status/status.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset_options.pb.h"
+#include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 
 namespace tensorflow {
 namespace data {
@@ -101,7 +109,24 @@ class ParallelMapDatasetParams : public DatasetParams {
   bool preserve_cardinality_;
 };
 
-class ParallelMapDatasetOpTest : public DatasetOpsTestBase {};
+class ParallelMapDatasetOpTest : public DatasetOpsTestBase {
+ protected:
+  // Initializes the dataset, and recreates `iterator_` with the
+  // `map_micro_batching` option set.
+  absl::Status InitializeWithMicroBatching(
+      const ParallelMapDatasetParams& dataset_params) {
+    TF_RETURN_IF_ERROR(Initialize(dataset_params));
+    options_.mutable_optimization_options()->set_map_micro_batching(true);
+    IteratorContext::Params params(iterator_ctx_.get());
+    params.options = &options_;
+    iterator_ctx_ = std::make_unique<IteratorContext>(params);
+    return dataset_->MakeIterator(iterator_ctx_.get(), /*parent=*/nullptr,
+                                  dataset_params.iterator_prefix(), &iterator_);
+  }
+
+ private:
+  Options options_;
+};
 
 FunctionDefHelper::AttrValueWrapper MapFunc(const std::string& func_name,
                                             const DataType& dtype) {
@@ -278,6 +303,47 @@ ParallelMapDatasetParams ParallelMapDatasetParams9() {
       /*node_name=*/kNodeName);
 }
 
+// With micro-batching, XTimesTwo is applied to micro-batches of 4 elements.
+ParallelMapDatasetParams VectorizedParallelMapDatasetParams() {
+  return ParallelMapDatasetParams(
+      RangeDatasetParams(0, 10, 1),
+      /*other_arguments=*/{},
+      /*num_parallel_calls=*/8,
+      /*func=*/MapFunc("XTimesTwo", DT_INT64),
+      /*func_lib*/ {test::function::XTimesTwo()},
+      /*type_arguments=*/{},
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({})},
+      /*use_inter_op_parallelism=*/true,
+      /*deterministic=*/DeterminismPolicy::kDeterministic,
+      /*preserve_cardinality=*/false,
+      /*node_name=*/kNodeName);
+}
+
+// With micro-batching, but the input elements have different shapes and cannot
+// be stacked, so the function is applied to each element.
+ParallelMapDatasetParams VectorizedParallelMapDatasetParamsWithRaggedInput() {
+  return ParallelMapDatasetParams(
+      BatchDatasetParams(RangeDatasetParams(0, 5, 1),
+                         /*batch_size=*/2,
+                         /*drop_remainder=*/false,
+                         /*parallel_copy*/ false,
+                         /*output_dtypes=*/{DT_INT64},
+                         /*output_shapes=*/{PartialTensorShape({-1})},
+                         /*node_name=*/"batch_dataset"),
+      /*other_arguments=*/{},
+      /*num_parallel_calls=*/8,
+      /*func=*/MapFunc("XTimesTwo", DT_INT64),
+      /*func_lib*/ {test::function::XTimesTwo()},
+      /*type_arguments=*/{},
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({-1})},
+      /*use_inter_op_parallelism=*/false,
+      /*deterministic=*/DeterminismPolicy::kDeterministic,
+      /*preserve_cardinality=*/false,
+      /*node_name=*/kNodeName);
+}
+
 ParallelMapDatasetParams ParallelMapDatasetParamsWithInvalidNumParallelCalls() {
   return ParallelMapDatasetParams(
       RangeDatasetParams(0, 10, 3),
@@ -452,6 +518,112 @@ ITERATOR_SAVE_AND_RESTORE_TEST_P(ParallelMapDatasetOpTest,
                                  ParallelMapDatasetParams,
                                  IteratorSaveAndRestoreTestCases())
 
+TEST_F(ParallelMapDatasetOpTest, VectorizedMap) {
+  TF_ASSERT_OK(
+      InitializeWithMicroBatching(VectorizedParallelMapDatasetParams()));
+  TF_ASSERT_OK(CheckIteratorGetNext(
+      CreateTensors<int64_t>(
+          TensorShape{},
+          {{0}, {2}, {4}, {6}, {8}, {10}, {12}, {14}, {16}, {18}}),
+      /*compare_order=*/true));
+}
+
+TEST_F(ParallelMapDatasetOpTest, VectorizedMapWithRaggedInput) {
+  TF_ASSERT_OK(InitializeWithMicroBatching(
+      VectorizedParallelMapDatasetParamsWithRaggedInput()));
+  TF_ASSERT_OK(
+      CheckIteratorGetNext({CreateTensor<int64_t>(TensorShape{2}, {0, 2}),
+                            CreateTensor<int64_t>(TensorShape{2}, {4, 6}),
+                            CreateTensor<int64_t>(TensorShape{1}, {8})},
+                           /*compare_order=*/true));
+}
+
+TEST_F(ParallelMapDatasetOpTest, VectorizedMapSaveAndRestore) {
+  auto dataset_params = VectorizedParallelMapDatasetParams();
+  TF_ASSERT_OK(InitializeWithMicroBatching(dataset_params));
+  TF_ASSERT_OK(CheckIteratorSaveAndRestore(
+      dataset_params.iterator_prefix(),
+      CreateTensors<int64_t>(
+          TensorShape{},
+          {{0}, {2}, {4}, {6}, {8}, {10}, {12}, {14}, {16}, {18}}),
+      /*breakpoints=*/{0, 3, 11}, /*compare_order=*/true));
+}
+
+TEST_F(ParallelMapDatasetOpTest, VectorizedMapWithOneRunnerThread) {
+  // With inter-op parallelism, the function runtime schedules the function's
+  // ops on the runner, so a micro-batch must not block the only thread.
+  thread_num_ = 1;
+  auto dataset_params = ParallelMapDatasetParams(
+      RangeDatasetParams(0, 10, 1),
+      /*other_arguments=*/{},
+      /*num_parallel_calls=*/8,
+      /*func=*/MapFunc("XTimesTwo", DT_INT64),
+      /*func_lib*/ {test::function::XTimesTwo()},
+      /*type_arguments=*/{},
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({})},
+      /*use_inter_op_parallelism=*/true,
+      /*deterministic=*/DeterminismPolicy::kDeterministic,
+      /*preserve_cardinality=*/false,
+      /*node_name=*/kNodeName);
+  TF_ASSERT_OK(InitializeWithMicroBatching(dataset_params));
+  TF_ASSERT_OK(CheckIteratorGetNext(
+      CreateTensors<int64_t>(
+          TensorShape{},
+          {{0}, {2}, {4}, {6}, {8}, {10}, {12}, {14}, {16}, {18}}),
+      /*compare_order=*/true));
+}
+
+// Returns 12 / x, which fails for x = 0.
+FunctionDef TwelveDivX() {
+  return FunctionDefHelper::Define(
+      "TwelveDivX", {"x: T"}, {"y: T"}, {"T: {int64}"},
+      {{{"twelve"},
+        "Const",
+        {},
+        {{"value", test::AsScalar<int64_t>(12)}, {"dtype", DT_INT64}}},
+       {{"y"}, "FloorDiv", {"twelve", "x"}, {{"T", "$T"}}}});
+}
+
+TEST_F(ParallelMapDatasetOpTest, VectorizedMapReportsElementErrors) {
+  auto dataset_params = ParallelMapDatasetParams(
+      RangeDatasetParams(-2, 3, 1),
+      /*other_arguments=*/{},
+      /*num_parallel_calls=*/8,
+      /*func=*/MapFunc("TwelveDivX", DT_INT64),
+      /*func_lib*/ {TwelveDivX()},
+      /*type_arguments=*/{},
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({})},
+      /*use_inter_op_parallelism=*/true,
+      /*deterministic=*/DeterminismPolicy::kDeterministic,
+      /*preserve_cardinality=*/false,
+      /*node_name=*/kNodeName);
+  TF_ASSERT_OK(InitializeWithMicroBatching(dataset_params));
+
+  // The micro-batch holding 0 fails as a whole, so its elements are mapped
+  // one by one and only 0 produces an error.
+  std::vector<Tensor> out_tensors;
+  bool end_of_sequence = false;
+  for (int64_t expected : {-6, -12}) {
+    TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                    &end_of_sequence));
+    ASSERT_FALSE(end_of_sequence);
+    test::ExpectEqual(out_tensors[0], test::AsScalar<int64_t>(expected));
+  }
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence)));
+  for (int64_t expected : {12, 6}) {
+    TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                    &end_of_sequence));
+    ASSERT_FALSE(end_of_sequence);
+    test::ExpectEqual(out_tensors[0], test::AsScalar<int64_t>(expected));
+  }
+  TF_ASSERT_OK(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence));
+  EXPECT_TRUE(end_of_sequence);
+}
+
 TEST_F(ParallelMapDatasetOpTest, InvalidNumParallelCalls) {
   auto dataset_params = ParallelMapDatasetParamsWithInvalidNumParallelCalls();
   EXPECT_EQ(Initialize(dataset_params).code(),
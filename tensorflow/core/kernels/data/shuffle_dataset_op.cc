@@ -28,9 +28,11 @@ limitations under the License.
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "xla/tsl/platform/statusor.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/data/tiered_shuffle_buffer.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -59,6 +61,8 @@ namespace data {
     ShuffleDatasetOpBase::kReshuffleEachIteration;
 
 /* static */ constexpr const char* const ShuffleDatasetOp::kDatasetType;
+/* static */ constexpr const char* const ShuffleDatasetOp::kBufferSizeBytes;
+/* static */ constexpr const char* const ShuffleDatasetOp::kSpillDirectory;
 
 /* static */ constexpr const char* const
     ShuffleAndRepeatDatasetOp::kDatasetType;
@@ -93,12 +97,14 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   ShuffleDatasetBase(OpKernelContext* ctx, const DatasetBase* input,
                      int64_t buffer_size,
                      std::shared_ptr<SeedGenerator> seed_generator,
-                     int64_t count)
+                     int64_t count,
+                     const TieredShuffleBufferOptions& buffer_options = {})
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
         buffer_size_(buffer_size),
         seed_generator_(std::move(seed_generator)),
         count_(count),
+        buffer_options_(buffer_options),
         traceme_metadata_(
             {{"buffer_size",
               absl::StrFormat("%lld", static_cast<long long>(buffer_size))}}) {
@@ -164,6 +170,12 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
 
   std::unique_ptr<IteratorBase> MakeIteratorInternal(
       const std::string& prefix) const override {
+    if (buffer_options_.memory_budget_bytes > 0) {
+      return std::make_unique<TieredIterator>(
+          TieredIterator::Params{this,
+                                 name_utils::IteratorPrefix(op_type(), prefix)},
+          seed_generator_.get());
+    }
     return std::make_unique<Iterator>(
         Iterator::Params{this, name_utils::IteratorPrefix(op_type(), prefix)},
         seed_generator_.get());
@@ -596,6 +608,156 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     bool data_produced_ TF_GUARDED_BY(mu_) = false;
   };
 
+  // Shuffles a single epoch with a `TieredShuffleBuffer`, which keeps elements
+  // compressed within a memory budget and spills the rest to local disk. This
+  // allows shuffle windows larger than the available memory.
+  class TieredIterator : public DatasetIterator<ShuffleDatasetBase> {
+   public:
+    explicit TieredIterator(const Params& params,
+                            SeedGenerator* seed_generator)
+        : DatasetIterator<ShuffleDatasetBase>(params),
+          seed_generator_(seed_generator),
+          parent_generator_(seed_generator->seed(), seed_generator->seed2()),
+          generator_(&parent_generator_) {}
+
+    bool SymbolicCheckpointCompatible() const override { return true; }
+
+    absl::Status Initialize(IteratorContext* ctx) override {
+      mutex_lock l(mu_);
+      seed_generator_->GenerateSeeds(&seed_, &seed2_);
+      ResetRngs();
+      TF_ASSIGN_OR_RETURN(buffer_, TieredShuffleBuffer::Create(
+                                       ctx->env(), dataset()->buffer_options_));
+      return dataset()->input_->MakeIterator(ctx, this, prefix(),
+                                             &input_impl_);
+    }
+
+    absl::Status GetNextInternal(IteratorContext* ctx,
+                                 std::vector<Tensor>* out_tensors,
+                                 bool* end_of_sequence) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(FillBuffer(ctx));
+      if (buffer_->size() == 0) {
+        *end_of_sequence = true;
+        return absl::OkStatus();
+      }
+      *end_of_sequence = false;
+      return buffer_->Remove(
+          [this]() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) { return Random(); },
+          out_tensors);
+    }
+
+   protected:
+    std::shared_ptr<model::Node> CreateNode(
+        IteratorContext* ctx, model::Node::Args args) const override {
+      return model::MakeKnownRatioNode(std::move(args),
+                                       /*ratio=*/1);
+    }
+
+    absl::Status SaveInternal(SerializationContext* ctx,
+                              IteratorStateWriter* writer) override {
+      mutex_lock l(mu_);
+      TF_RETURN_IF_ERROR(
+          writer->WriteScalar(prefix(), kEpochNumRandomSamples,
+                              seed_generator_->num_random_samples()));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kNumRandomSamples,
+                                             num_random_samples_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kSeed, seed_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kSeed2, seed2_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(
+          prefix(), kEndOfInputSequence, static_cast<int64_t>(!input_impl_)));
+      if (input_impl_) {
+        TF_RETURN_IF_ERROR(SaveInput(ctx, writer, input_impl_));
+      }
+      // Unlike `Iterator`, the whole buffer is written on every save, since
+      // spilled elements cannot be tracked individually.
+      return buffer_->Save(prefix(), writer);
+    }
+
+    absl::Status RestoreInternal(IteratorContext* ctx,
+                                 IteratorStateReader* reader) override {
+      mutex_lock l(mu_);
+      int64_t num_random_samples;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kEpochNumRandomSamples,
+                                            &num_random_samples));
+      seed_generator_->set_num_random_samples(num_random_samples);
+      seed_generator_->Reset();
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kNumRandomSamples,
+                                            &num_random_samples_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kSeed, &seed_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kSeed2, &seed2_));
+      ResetRngs();
+
+      int64_t input_empty;
+      TF_RETURN_IF_ERROR(
+          reader->ReadScalar(prefix(), kEndOfInputSequence, &input_empty));
+      if (static_cast<bool>(!input_empty)) {
+        TF_RETURN_IF_ERROR(
+            dataset()->input_->MakeIterator(ctx, this, prefix(), &input_impl_));
+        TF_RETURN_IF_ERROR(RestoreInput(ctx, reader, input_impl_));
+      } else {
+        input_impl_.reset();
+      }
+      if (!buffer_) {
+        TF_ASSIGN_OR_RETURN(buffer_,
+                            TieredShuffleBuffer::Create(
+                                ctx->env(), dataset()->buffer_options_));
+      }
+      return buffer_->Restore(prefix(), reader);
+    }
+
+    TraceMeMetadata GetTraceMeMetadata() const override {
+      return dataset()->traceme_metadata_;
+    }
+
+   private:
+    void ResetRngs() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      parent_generator_ = random::PhiloxRandom(seed_, seed2_);
+      generator_ =
+          random::SingleSampleAdapter<random::PhiloxRandom>(&parent_generator_);
+      generator_.Skip(num_random_samples_);
+    }
+
+    random::SingleSampleAdapter<random::PhiloxRandom>::ResultType Random()
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      num_random_samples_++;
+      return generator_();
+    }
+
+    // Adds input elements to the buffer until it holds `buffer_size_`
+    // elements or the input is exhausted.
+    absl::Status FillBuffer(IteratorContext* ctx)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      const bool shuffle_all = dataset()->buffer_size_ == kUnknownCardinality;
+      while (input_impl_ &&
+             (shuffle_all || buffer_->size() < dataset()->buffer_size_)) {
+        std::vector<Tensor> element;
+        bool end_of_input_sequence = false;
+        TF_RETURN_IF_ERROR(
+            input_impl_->GetNext(ctx, &element, &end_of_input_sequence));
+        if (end_of_input_sequence) {
+          input_impl_.reset();
+          break;
+        }
+        TF_RETURN_IF_ERROR(buffer_->Add(
+            element,
+            [this]() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) { return Random(); }));
+      }
+      return absl::OkStatus();
+    }
+
+    mutex mu_;
+    SeedGenerator* const seed_generator_ TF_GUARDED_BY(mu_);  // Not owned.
+    std::unique_ptr<TieredShuffleBuffer> buffer_ TF_GUARDED_BY(mu_);
+    std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
+    int64_t seed_ TF_GUARDED_BY(mu_) = 0;
+    int64_t seed2_ TF_GUARDED_BY(mu_) = 0;
+    random::PhiloxRandom parent_generator_ TF_GUARDED_BY(mu_);
+    random::SingleSampleAdapter<random::PhiloxRandom> generator_
+        TF_GUARDED_BY(mu_);
+    int64_t num_random_samples_ TF_GUARDED_BY(mu_) = 0;
+  };
+
   const DatasetBase* const input_;
   const int64_t buffer_size_;
   const std::shared_ptr<SeedGenerator> seed_generator_;
@@ -603,6 +765,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   // fuse shuffle and repeat together, and make the shuffle dataset op
   // responsible for repeating as well.
   const int64_t count_;
+  // If `memory_budget_bytes` is positive, elements are buffered in a
+  // `TieredShuffleBuffer`. Only supported for a single epoch.
+  const TieredShuffleBufferOptions buffer_options_;
   const TraceMeMetadata traceme_metadata_;
   mutable mutex mu_;
   mutable std::vector<std::int64_t> shuffled_indices_ TF_GUARDED_BY(mu_);
@@ -728,8 +893,10 @@ class ShuffleDatasetOp::DatasetV3 : public ShuffleDatasetBase {
  public:
   DatasetV3(OpKernelContext* ctx, const DatasetBase* input, int64_t buffer_size,
             int64_t count, RandomSeeds&& seeds, SeedGeneratorManager* manager,
-            ResourceHandle&& resource_handle, bool owns_resource)
-      : ShuffleDatasetBase(ctx, input, buffer_size, manager->get(), count),
+            ResourceHandle&& resource_handle, bool owns_resource,
+            const TieredShuffleBufferOptions& buffer_options)
+      : ShuffleDatasetBase(ctx, input, buffer_size, manager->get(), count,
+                           buffer_options),
         manager_(manager),
         owns_resource_(owns_resource),
         resource_handle_(std::move(resource_handle)),
@@ -768,13 +935,22 @@ class ShuffleDatasetOp::DatasetV3 : public ShuffleDatasetBase {
     AttrValue reshuffle_each_iteration;
     b->BuildAttrValue(seed_generator_->reshuffle_each_iteration(),
                       &reshuffle_each_iteration);
+    std::vector<std::pair<absl::string_view, AttrValue>> attrs = {
+        std::make_pair(kReshuffleEachIteration, reshuffle_each_iteration)};
+    // The memory budget attrs are only set when used, so that graphs without
+    // them remain loadable by older binaries.
+    if (buffer_options_.memory_budget_bytes > 0) {
+      attrs.emplace_back(
+          kBufferSizeBytes,
+          b->BuildAttrValue(buffer_options_.memory_budget_bytes));
+      attrs.emplace_back(kSpillDirectory,
+                         b->BuildAttrValue(buffer_options_.spill_directory));
+    }
     TF_RETURN_IF_ERROR(
         b->AddDataset(this,
                       {input_graph_node, buffer_size_node, seed_node,
                        seed2_node, resource_handle_node},  // Inputs
-                      {std::make_pair(kReshuffleEachIteration,
-                                      reshuffle_each_iteration)},  // Attrs
-                      output));
+                      attrs, output));
     return absl::OkStatus();
   }
 
@@ -800,6 +976,16 @@ ShuffleDatasetOp::ShuffleDatasetOp(OpKernelConstruction* ctx)
     OP_REQUIRES_OK(
         ctx, ctx->GetAttr(kReshuffleEachIteration, &reshuffle_each_iteration_));
   }
+  if (ctx->HasAttr(kBufferSizeBytes)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kBufferSizeBytes, &buffer_size_bytes_));
+    OP_REQUIRES(ctx, buffer_size_bytes_ >= 0,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "buffer_size_bytes must be non-negative, got ",
+                    buffer_size_bytes_, ".")));
+  }
+  if (ctx->HasAttr(kSpillDirectory)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kSpillDirectory, &spill_directory_));
+  }
 }
 
 void ShuffleDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
@@ -851,10 +1037,15 @@ void ShuffleDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
       OP_REQUIRES_OK(ctx, s);
     }
 
+    TieredShuffleBufferOptions buffer_options;
+    buffer_options.memory_budget_bytes = buffer_size_bytes_;
+    if (buffer_size_bytes_ > 0) {
+      buffer_options.spill_directory = spill_directory_;
+    }
     // Ownership of manager is transferred onto `DatasetV3`.
-    *output = new ShuffleDatasetOp::DatasetV3(ctx, input, buffer_size, count,
-                                              std::move(seeds), manager,
-                                              std::move(handle), owns_resource);
+    *output = new ShuffleDatasetOp::DatasetV3(
+        ctx, input, buffer_size, count, std::move(seeds), manager,
+        std::move(handle), owns_resource, buffer_options);
   } else if (op_version_ == 2) {
     ResourceHandle handle;
     OP_REQUIRES_OK(ctx, HandleFromInput(ctx, 2, &handle));
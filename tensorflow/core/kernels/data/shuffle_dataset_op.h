@@ -15,6 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_DATASET_OP_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_DATASET_OP_H_
 
+#include <cstdint>
+#include <string>
+
 #include "tensorflow/core/framework/dataset.h"
 
 namespace tensorflow {
@@ -40,6 +43,8 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
 class ShuffleDatasetOp : public ShuffleDatasetOpBase {
  public:
   static constexpr const char* const kDatasetType = "Shuffle";
+  static constexpr const char* const kBufferSizeBytes = "buffer_size_bytes";
+  static constexpr const char* const kSpillDirectory = "spill_directory";
 
   explicit ShuffleDatasetOp(OpKernelConstruction* ctx);
 
@@ -53,6 +58,10 @@ class ShuffleDatasetOp : public ShuffleDatasetOpBase {
   class DatasetV3;
   int op_version_ = 0;
   bool reshuffle_each_iteration_ = true;
+  // Memory budget of the shuffle buffer. If positive, elements are buffered
+  // compressed and spilled to `spill_directory_` beyond the budget.
+  int64_t buffer_size_bytes_ = 0;
+  std::string spill_directory_;
 };
 
 class ShuffleAndRepeatDatasetOp : public ShuffleDatasetOpBase {
@@ -14,10 +14,23 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
+#include <algorithm>
 #include <cstdint>
-
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/data/global_shuffle_utils.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/tfrecord_index.h"
 #include "tensorflow/core/data/utils.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
@@ -43,6 +56,7 @@ namespace data {
 /* static */ constexpr const char* const TFRecordDatasetOp::kCompressionType;
 /* static */ constexpr const char* const TFRecordDatasetOp::kBufferSize;
 /* static */ constexpr const char* const TFRecordDatasetOp::kByteOffsets;
+/* static */ constexpr const char* const TFRecordDatasetOp::kUseIndex;
 
 constexpr char kTFRecordDataset[] = "TFRecordDataset";
 constexpr char kCurrentFileIndex[] = "current_file_index";
@@ -53,6 +67,8 @@ constexpr int64_t kUnspecifiedBufferSize = -1;
 constexpr int64_t kDefaultBufferSize = 256LL << 10;  // 256KB
 constexpr int64_t kCloudTpuBlockSize = 127LL << 20;  // 127MB.
 constexpr int64_t kS3BlockSize = kCloudTpuBlockSize;
+// Threads issuing range reads for an iterator over indexed files.
+constexpr int kIndexedReadThreads = 4;
 
 bool is_cloud_tpu_gcs_fs() {
 #if defined(LIBTPU_ON_GCE)
@@ -64,21 +80,67 @@ bool is_cloud_tpu_gcs_fs() {
 #endif
 }
 
+// Returns the record offsets of each of `filenames` from their sidecar
+// indexes, or an empty vector unless every file has an index that matches its
+// current size. Probing stops at the first file without an index.
+std::vector<std::vector<int64_t>> ReadTFRecordIndexes(
+    Env* env, const std::vector<std::string>& filenames) {
+  std::vector<std::vector<int64_t>> record_offsets;
+  record_offsets.reserve(filenames.size());
+  for (const std::string& filename : filenames) {
+    const std::string translated_filename = TranslateFileName(filename);
+    const std::string index_filename =
+        TFRecordIndexFilename(translated_filename);
+    if (!env->FileExists(index_filename).ok()) return {};
+    absl::StatusOr<std::vector<int64_t>> offsets =
+        ReadTFRecordIndex(env, index_filename);
+    uint64_t file_size = 0;
+    absl::Status s = offsets.status();
+    if (s.ok()) s = env->GetFileSize(translated_filename, &file_size);
+    if (s.ok() && static_cast<uint64_t>(offsets->back()) != file_size) {
+      s = absl::FailedPreconditionError(absl::StrCat(
+          "the index covers ", offsets->back(), " bytes but the file has ",
+          file_size, " bytes"));
+    }
+    if (!s.ok()) {
+      LOG(WARNING) << "Ignoring the TFRecord index of " << filename << ": "
+                   << s;
+      return {};
+    }
+    record_offsets.push_back(*std::move(offsets));
+  }
+  return record_offsets;
+}
+
 class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<std::string> filenames,
                    const std::string& compression_type, int64_t buffer_size,
-                   std::vector<int64_t> byte_offsets, int op_version)
+                   std::vector<int64_t> byte_offsets,
+                   std::vector<std::vector<int64_t>> record_offsets,
+                   bool use_index, int op_version)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         options_(io::RecordReaderOptions::CreateRecordReaderOptions(
             compression_type)),
         byte_offsets_(std::move(byte_offsets)),
+        record_offsets_(std::move(record_offsets)),
+        use_index_(use_index),
         op_version_(op_version) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
+    if (is_indexed()) {
+      cumulative_records_.reserve(record_offsets_.size() + 1);
+      cumulative_records_.push_back(0);
+      for (const std::vector<int64_t>& offsets : record_offsets_) {
+        cumulative_records_.push_back(cumulative_records_.back() +
+                                      static_cast<int64_t>(offsets.size()) -
+                                      1);
+      }
+      random_access_files_.resize(filenames_.size());
+    }
   }
 
   std::unique_ptr<IteratorBase> MakeIteratorInternal(
@@ -113,6 +175,57 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
   absl::Status CheckExternalState() const override { return absl::OkStatus(); }
 
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    return is_indexed() ? cumulative_records_.back() : kUnknownCardinality;
+  }
+
+  absl::Status Get(OpKernelContext* ctx, int64_t index,
+                   std::vector<Tensor>* out_tensors) const override {
+    return Get(AnyContext(ctx), index, out_tensors);
+  }
+
+  absl::Status Get(AnyContext ctx, int64_t index,
+                   std::vector<Tensor>* out_tensors) const override {
+    TF_RETURN_IF_ERROR(CheckRandomAccessCompatible(index));
+    // Files without records share their cumulative count with the next file,
+    // so take the last file starting at or before `index`.
+    const size_t file_index =
+        std::upper_bound(cumulative_records_.begin(),
+                         cumulative_records_.end(), index) -
+        cumulative_records_.begin() - 1;
+    const std::vector<int64_t>& offsets = record_offsets_[file_index];
+    const int64_t record_index = index - cumulative_records_[file_index];
+    RandomAccessFile* file = nullptr;
+    TF_RETURN_IF_ERROR(GetRandomAccessFile(file_index, &file));
+
+    const int64_t offset = offsets[record_index];
+    std::string scratch(offsets[record_index + 1] - offset, '\0');
+    absl::string_view data;
+    absl::Status s = file->Read(offset, data, absl::MakeSpan(scratch));
+    if (absl::IsOutOfRange(s) && data.size() == scratch.size()) {
+      s = absl::OkStatus();
+    }
+    if (absl::IsOutOfRange(s)) {
+      return absl::DataLossError(absl::StrCat("truncated record at ", offset,
+                                              " in ", filenames_[file_index],
+                                              ": ", s.message()));
+    }
+    TF_RETURN_IF_ERROR(s);
+    out_tensors->clear();
+    out_tensors->emplace_back(ctx.allocator, DT_STRING, TensorShape({}));
+    return DecodeTFRecord(data, offset,
+                          &out_tensors->back().scalar<tstring>()());
+  }
+
+  absl::Status RandomIndexingCompatible() const override {
+    if (is_indexed()) return absl::OkStatus();
+    return absl::FailedPreconditionError(absl::StrCat(
+        type_string(),
+        " supports random access only when `use_index` is set, every file is "
+        "uncompressed and has a TFRecord index (",
+        kTFRecordIndexSuffix, " sidecar file) and `byte_offsets` is empty."));
+  }
+
  protected:
   absl::Status AsGraphDefInternal(SerializationContext* ctx,
                                   DatasetGraphDefBuilder* b,
@@ -123,8 +236,11 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     TF_RETURN_IF_ERROR(b->AddScalar(compression_type_, &compression_type));
     Node* buffer_size = nullptr;
     TF_RETURN_IF_ERROR(b->AddScalar(options_.buffer_size, &buffer_size));
-    TF_RETURN_IF_ERROR(b->AddDataset(
-        this, {filenames, compression_type, buffer_size}, output));
+    AttrValue use_index;
+    b->BuildAttrValue(use_index_, &use_index);
+    TF_RETURN_IF_ERROR(
+        b->AddDataset(this, {filenames, compression_type, buffer_size},
+                      {{kUseIndex, use_index}}, output));
     Node* byte_offsets = nullptr;
     TF_RETURN_IF_ERROR(b->AddVector(byte_offsets_, &byte_offsets));
     return absl::OkStatus();
@@ -134,13 +250,18 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
   class Iterator : public DatasetIterator<Dataset> {
    public:
     explicit Iterator(const Params& params)
-        : DatasetIterator<Dataset>(params) {}
+        : DatasetIterator<Dataset>(params),
+          global_shuffle_iterator_(dataset()) {}
 
     absl::Status Initialize(IteratorContext* ctx) override {
       LogFilenamesOptions log_filenames_options = {
           .files = dataset()->filenames_,
           .data_service_address = ctx->data_service_address()};
       LogFilenames(log_filenames_options);
+      if (dataset()->is_indexed()) {
+        io_pool_ = ctx->CreateThreadPool("tf_record_indexed_reader",
+                                         kIndexedReadThreads);
+      }
       return absl::OkStatus();
     }
 
@@ -149,15 +270,19 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     absl::Status GetNextInternal(IteratorContext* ctx,
                                  std::vector<Tensor>* out_tensors,
                                  bool* end_of_sequence) override {
+      if (ctx->index_mapper() != nullptr) {
+        return global_shuffle_iterator_.GetNext(ctx, out_tensors,
+                                                end_of_sequence);
+      }
       out_tensors->reserve(1);
       mutex_lock l(mu_);
       do {
         // We are currently processing a file, so try to read the next record.
-        if (reader_) {
+        if (HasReaderLocked()) {
           out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
                                     TensorShape({}));
           absl::Status s =
-              reader_->ReadRecord(&out_tensors->back().scalar<tstring>()());
+              ReadRecordLocked(&out_tensors->back().scalar<tstring>()());
           if (s.ok()) {
             static monitoring::CounterCell* bytes_counter =
                 metrics::GetTFDataBytesReadCounter(kDatasetType);
@@ -200,10 +325,10 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       do {
         // We are currently processing a file, so try to skip reading
         // the next (num_to_skip - *num_skipped) record.
-        if (reader_) {
+        if (HasReaderLocked()) {
           int last_num_skipped;
-          absl::Status s = reader_->SkipRecords(num_to_skip - *num_skipped,
-                                                &last_num_skipped);
+          absl::Status s = SkipRecordsLocked(num_to_skip - *num_skipped,
+                                             &last_num_skipped);
           *num_skipped += last_num_skipped;
           if (s.ok()) {
             *end_of_sequence = false;
@@ -246,15 +371,22 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCurrentFileIndex,
                                              current_file_index_));
 
-      if (reader_) {
+      if (HasReaderLocked()) {
+        TF_RETURN_IF_ERROR(
+            writer->WriteScalar(prefix(), kOffset, TellOffsetLocked()));
+      }
+      if (dataset()->is_indexed()) {
         TF_RETURN_IF_ERROR(
-            writer->WriteScalar(prefix(), kOffset, reader_->TellOffset()));
+            global_shuffle_iterator_.Save(prefix(), ctx, writer));
       }
       return absl::OkStatus();
     }
 
     absl::Status RestoreInternal(IteratorContext* ctx,
                                  IteratorStateReader* reader) override {
+      if (ctx->restored_element_count().has_value()) {
+        return global_shuffle_iterator_.Restore(prefix(), ctx, reader);
+      }
       mutex_lock l(mu_);
       ResetStreamsLocked();
       int64_t current_file_index;
@@ -265,7 +397,7 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
         int64_t offset;
         TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kOffset, &offset));
         TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
-        TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+        TF_RETURN_IF_ERROR(SeekOffsetLocked(offset));
       }
       return absl::OkStatus();
     }
@@ -291,6 +423,12 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
           TranslateFileName(dataset()->filenames_[current_file_index_]),
           &file_));
+      if (dataset()->is_indexed()) {
+        indexed_reader_ = std::make_unique<IndexedRecordReader>(
+            file_.get(), dataset()->record_offsets_[current_file_index_],
+            io_pool_.get(), IndexedRecordReader::Options());
+        return absl::OkStatus();
+      }
       reader_ = std::make_unique<io::SequentialRecordReader>(
           file_.get(), dataset()->options_);
       if (!dataset()->byte_offsets_.empty()) {
@@ -303,28 +441,111 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     // Resets all reader streams.
     void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       reader_.reset();
+      indexed_reader_.reset();
       file_.reset();
     }
 
+    bool HasReaderLocked() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return reader_ != nullptr || indexed_reader_ != nullptr;
+    }
+
+    absl::Status ReadRecordLocked(tstring* record)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (indexed_reader_) return indexed_reader_->ReadRecord(record);
+      return reader_->ReadRecord(record);
+    }
+
+    absl::Status SkipRecordsLocked(int num_to_skip, int* num_skipped)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (indexed_reader_) {
+        return indexed_reader_->SkipRecords(num_to_skip, num_skipped);
+      }
+      return reader_->SkipRecords(num_to_skip, num_skipped);
+    }
+
+    // Checkpoints store byte offsets in both modes, so they can be restored
+    // whether or not the files were indexed when they were written.
+    int64_t TellOffsetLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (indexed_reader_) {
+        return dataset()
+            ->record_offsets_[current_file_index_][indexed_reader_->index()];
+      }
+      return reader_->TellOffset();
+    }
+
+    absl::Status SeekOffsetLocked(int64_t offset)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (!indexed_reader_) return reader_->SeekOffset(offset);
+      const std::vector<int64_t>& offsets =
+          dataset()->record_offsets_[current_file_index_];
+      auto it = std::lower_bound(offsets.begin(), offsets.end(), offset);
+      if (it == offsets.end() || *it != offset) {
+        return absl::DataLossError(absl::StrCat(
+            "Offset ", offset, " is not a record boundary in ",
+            dataset()->filenames_[current_file_index_]));
+      }
+      indexed_reader_->Seek(it - offsets.begin());
+      return absl::OkStatus();
+    }
+
     mutex mu_;
     size_t current_file_index_ TF_GUARDED_BY(mu_) = 0;
 
-    // `reader_` will borrow the object that `file_` points to, so
-    // we must destroy `reader_` before `file_`.
+    // Issues the range reads of `indexed_reader_`. Only created when the
+    // files are indexed.
+    std::unique_ptr<thread::ThreadPool> io_pool_;
+
+    // `reader_` and `indexed_reader_` will borrow the object that `file_`
+    // points to, so we must destroy them before `file_`.
     std::unique_ptr<RandomAccessFile> file_ TF_GUARDED_BY(mu_);
     std::unique_ptr<io::SequentialRecordReader> reader_ TF_GUARDED_BY(mu_);
+    std::unique_ptr<IndexedRecordReader> indexed_reader_ TF_GUARDED_BY(mu_);
+
+    GlobalShuffleIterator global_shuffle_iterator_;
   };
 
+  bool is_indexed() const { return !record_offsets_.empty(); }
+
+  // Opens file `file_index` for random access on first use.
+  absl::Status GetRandomAccessFile(size_t file_index,
+                                   RandomAccessFile** file) const {
+    mutex_lock l(files_mu_);
+    std::unique_ptr<RandomAccessFile>& cached =
+        random_access_files_[file_index];
+    if (cached == nullptr) {
+      TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(
+          TranslateFileName(filenames_[file_index]), &cached));
+    }
+    *file = cached.get();
+    return absl::OkStatus();
+  }
+
   const std::vector<std::string> filenames_;
   const tstring compression_type_;
   io::RecordReaderOptions options_;
   const std::vector<int64_t> byte_offsets_;
+  // Record offsets of each file, read from their TFRecord indexes. Empty
+  // unless every file is uncompressed and indexed.
+  const std::vector<std::vector<int64_t>> record_offsets_;
+  // `cumulative_records_[i]` is the number of records in files before `i`.
+  std::vector<int64_t> cumulative_records_;
+  const bool use_index_;
   const int op_version_;
+
+  // Files opened by `Get`. RandomAccessFile reads are thread-safe, so
+  // `files_mu_` only guards opening them.
+  mutable mutex files_mu_;
+  mutable std::vector<std::unique_ptr<RandomAccessFile>> random_access_files_
+      TF_GUARDED_BY(files_mu_);
 };
 
 TFRecordDatasetOp::TFRecordDatasetOp(OpKernelConstruction* ctx)
     : DatasetOpKernel(ctx),
-      op_version_(ctx->def().op() == kTFRecordDataset ? 1 : 2) {}
+      op_version_(ctx->def().op() == kTFRecordDataset ? 1 : 2) {
+  if (ctx->HasAttr(kUseIndex)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kUseIndex, &use_index_));
+  }
+}
 
 void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
                                     DatasetBase** output) {
@@ -401,8 +622,20 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
         << buffer_size;
   }
 
+  // Indexes only describe uncompressed files read from their first record.
+  // Probing for them costs a request per file on remote file systems, so it is
+  // only done on request.
+  std::vector<std::vector<int64_t>> record_offsets;
+  if (use_index_ &&
+      io::RecordReaderOptions::CreateRecordReaderOptions(compression_type)
+              .compression_type == io::RecordReaderOptions::NONE &&
+      byte_offsets.empty() && !filenames.empty()) {
+    record_offsets = ReadTFRecordIndexes(ctx->env(), filenames);
+  }
+
   *output = new Dataset(ctx, std::move(filenames), compression_type,
-                        buffer_size, std::move(byte_offsets), op_version_);
+                        buffer_size, std::move(byte_offsets),
+                        std::move(record_offsets), use_index_, op_version_);
 }
 
 namespace {
@@ -28,6 +28,7 @@ limitations under the License.
 #include "xla/tsl/platform/status.h"
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/tfrecord_index.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
@@ -69,13 +70,14 @@ class TFRecordDatasetParams : public DatasetParams {
   TFRecordDatasetParams(std::vector<tstring> filenames,
                         CompressionType compression_type, int64_t buffer_size,
                         std::vector<int64_t> byte_offsets,
-                        std::string node_name)
+                        std::string node_name, bool use_index = false)
       : DatasetParams({DT_STRING}, {PartialTensorShape({})},
                       std::move(node_name)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         buffer_size_(buffer_size),
-        byte_offsets_(std::move(byte_offsets)) {
+        byte_offsets_(std::move(byte_offsets)),
+        use_index_(use_index) {
     op_version_ = 2;
   }
 
@@ -104,6 +106,7 @@ class TFRecordDatasetParams : public DatasetParams {
   absl::Status GetAttributes(AttributeVector* attr_vector) const override {
     attr_vector->clear();
     attr_vector->emplace_back("metadata", "");
+    attr_vector->emplace_back(TFRecordDatasetOp::kUseIndex, use_index_);
     return absl::OkStatus();
   }
 
@@ -116,6 +119,7 @@ class TFRecordDatasetParams : public DatasetParams {
   CompressionType compression_type_;
   int64_t buffer_size_;
   std::vector<int64_t> byte_offsets_;
+  bool use_index_;
 };
 
 class TFRecordDatasetOpTest : public DatasetOpsTestBase {};
@@ -233,6 +237,28 @@ TFRecordDatasetParams InvalidByteOffsets() {
                                /*node_name=*/kNodeName);
 }
 
+// Test case 6: multiple uncompressed files with TFRecord indexes.
+TFRecordDatasetParams IndexedTFRecordDatasetParams(bool use_index = true) {
+  std::vector<tstring> filenames = {
+      absl::StrCat(testing::TmpDir(), "/tf_record_INDEXED_1"),
+      absl::StrCat(testing::TmpDir(), "/tf_record_INDEXED_2"),
+      absl::StrCat(testing::TmpDir(), "/tf_record_INDEXED_3")};
+  std::vector<std::vector<std::string>> contents = {
+      {"1", "22", "333"}, {}, {"a", "bb", "ccc"}};
+  CompressionType compression_type = CompressionType::UNCOMPRESSED;
+  absl::Status status = CreateTestFiles(filenames, contents, compression_type);
+  TF_CHECK_OK(status) << "Failed to create the test files: "
+                      << absl::StrJoin(filenames, ", ") << ": " << status;
+  for (const tstring& filename : filenames) {
+    TF_CHECK_OK(WriteTFRecordIndexForFile(Env::Default(), filename));
+  }
+  return TFRecordDatasetParams(filenames,
+                               /*compression_type=*/compression_type,
+                               /*buffer_size=*/10,
+                               /*byte_offsets=*/{},
+                               /*node_name=*/kNodeName, use_index);
+}
+
 std::vector<GetNextTestCase<TFRecordDatasetParams>> GetNextTestCases() {
   return {
       {/*dataset_params=*/TFRecordDatasetParams1(),
@@ -248,7 +274,10 @@ std::vector<GetNextTestCase<TFRecordDatasetParams>> GetNextTestCases() {
       {/*dataset_params=*/TFRecordDatasetParams4(),
        CreateTensors<tstring>(
            TensorShape({}),
-           {{"1"}, {"22"}, {"333"}, {"bb"}, {"ccc"}, {"zzz"}})}};
+           {{"1"}, {"22"}, {"333"}, {"bb"}, {"ccc"}, {"zzz"}})},
+      {/*dataset_params=*/IndexedTFRecordDatasetParams(),
+       CreateTensors<tstring>(
+           TensorShape({}), {{"1"}, {"22"}, {"333"}, {"a"}, {"bb"}, {"ccc"}})}};
 }
 
 ITERATOR_GET_NEXT_TEST_P(TFRecordDatasetOpTest, TFRecordDatasetParams,
@@ -286,6 +315,17 @@ std::vector<SkipTestCase<TFRecordDatasetParams>> SkipTestCases() {
            /*expected_outputs=*/
            CreateTensors<tstring>(TensorShape({}), {{"bb"}})},
           {/*dataset_params=*/TFRecordDatasetParams3(),
+           /*num_to_skip*/ 7, /*expected_num_skipped*/ 6},
+
+          {/*dataset_params=*/IndexedTFRecordDatasetParams(),
+           /*num_to_skip*/ 2, /*expected_num_skipped*/ 2, /*get_next*/ true,
+           /*expected_outputs=*/
+           CreateTensors<tstring>(TensorShape({}), {{"333"}})},
+          {/*dataset_params=*/IndexedTFRecordDatasetParams(),
+           /*num_to_skip*/ 4, /*expected_num_skipped*/ 4, /*get_next*/ true,
+           /*expected_outputs=*/
+           CreateTensors<tstring>(TensorShape({}), {{"bb"}})},
+          {/*dataset_params=*/IndexedTFRecordDatasetParams(),
            /*num_to_skip*/ 7, /*expected_num_skipped*/ 6}};
 }
 
@@ -325,6 +365,45 @@ TEST_F(TFRecordDatasetOpTest, Cardinality) {
   TF_ASSERT_OK(CheckDatasetCardinality(kUnknownCardinality));
 }
 
+TEST_F(TFRecordDatasetOpTest, IndexedCardinality) {
+  auto dataset_params = IndexedTFRecordDatasetParams();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckDatasetCardinality(6));
+}
+
+TEST_F(TFRecordDatasetOpTest, IndexedRandomAccess) {
+  auto dataset_params = IndexedTFRecordDatasetParams();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(dataset_->RandomIndexingCompatible());
+  const std::vector<std::string> expected = {"1", "22", "333",
+                                             "a", "bb", "ccc"};
+  for (int i : {5, 0, 3, 2, 4, 1}) {
+    std::vector<Tensor> out_tensors;
+    TF_ASSERT_OK(
+        dataset_->Get(AnyContext(iterator_ctx_.get()), i, &out_tensors));
+    ASSERT_EQ(out_tensors.size(), 1);
+    EXPECT_EQ(out_tensors[0].scalar<tstring>()(), expected[i]);
+  }
+  std::vector<Tensor> out_tensors;
+  EXPECT_FALSE(
+      dataset_->Get(AnyContext(iterator_ctx_.get()), 6, &out_tensors).ok());
+}
+
+TEST_F(TFRecordDatasetOpTest, RandomAccessRequiresIndex) {
+  auto dataset_params = TFRecordDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  EXPECT_TRUE(
+      absl::IsFailedPrecondition(dataset_->RandomIndexingCompatible()));
+}
+
+TEST_F(TFRecordDatasetOpTest, IndexesUnusedUnlessRequested) {
+  auto dataset_params = IndexedTFRecordDatasetParams(/*use_index=*/false);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckDatasetCardinality(kUnknownCardinality));
+  EXPECT_TRUE(
+      absl::IsFailedPrecondition(dataset_->RandomIndexingCompatible()));
+}
+
 TEST_F(TFRecordDatasetOpTest, IteratorOutputDtypes) {
   auto dataset_params = TFRecordDatasetParams1();
   TF_ASSERT_OK(Initialize(dataset_params));
@@ -372,6 +451,10 @@ IteratorSaveAndRestoreTestCases() {
            TensorShape({}), {{"1"}, {"22"}, {"333"}, {"a"}, {"bb"}, {"ccc"}})},
       {/*dataset_params=*/TFRecordDatasetParams3(),
        /*breakpoints=*/{0, 2, 7},
+       CreateTensors<tstring>(
+           TensorShape({}), {{"1"}, {"22"}, {"333"}, {"a"}, {"bb"}, {"ccc"}})},
+      {/*dataset_params=*/IndexedTFRecordDatasetParams(),
+       /*breakpoints=*/{0, 2, 4, 7},
        CreateTensors<tstring>(
            TensorShape({}), {{"1"}, {"22"}, {"333"}, {"a"}, {"bb"}, {"ccc"}})}};
 }
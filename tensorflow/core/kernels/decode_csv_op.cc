@@ -14,13 +14,24 @@ limitations under the License.
 ==============================================================================*/
 
 // See docs in ../ops/parsing_ops.cc.
+#include <cstring>
+#include <deque>
+#include <string>
+#include <utility>
 #include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/csv_scanner.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -77,128 +88,43 @@ class DecodeCSVOp : public OpKernel {
     OpOutputList output;
     OP_REQUIRES_OK(ctx, ctx->output_list("output", &output));
 
+    std::vector<Tensor*> outputs(out_type_.size());
     for (int i = 0; i < static_cast<int>(out_type_.size()); ++i) {
-      Tensor* out = nullptr;
-      OP_REQUIRES_OK(ctx, output.allocate(i, records->shape(), &out));
+      OP_REQUIRES_OK(ctx, output.allocate(i, records->shape(), &outputs[i]));
     }
+    if (records_size == 0) return;
 
-    for (int64_t i = 0; i < records_size; ++i) {
-      const absl::string_view record(records_t(i));
-      std::vector<std::string> fields;
-      ExtractFields(ctx, record, &fields);
-      OP_REQUIRES(ctx, fields.size() == out_type_.size(),
-                  absl::InvalidArgumentError(absl::StrCat(
-                      "Expect ", out_type_.size(), " fields but have ",
-                      fields.size(), " in record ", i)));
-
-      // Check each field in the record
-      for (int f = 0; f < static_cast<int>(out_type_.size()); ++f) {
-        const DataType& dtype = out_type_[f];
-        switch (dtype) {
-          case DT_INT32: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!")));
-
-              output[f]->flat<int32_t>()(i) =
-                  record_defaults[f].flat<int32_t>()(0);
-            } else {
-              int32_t value;
-              OP_REQUIRES(ctx, absl::SimpleAtoi(fields[f], &value),
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f, " in record ", i,
-                              " is not a valid int32: ", fields[f])));
-              output[f]->flat<int32_t>()(i) = value;
-            }
-            break;
-          }
-          case DT_INT64: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!")));
-
-              output[f]->flat<int64_t>()(i) =
-                  record_defaults[f].flat<int64_t>()(0);
-            } else {
-              int64_t value;
-              OP_REQUIRES(ctx, absl::SimpleAtoi(fields[f], &value),
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f, " in record ", i,
-                              " is not a valid int64: ", fields[f])));
-              output[f]->flat<int64_t>()(i) = value;
-            }
-            break;
+    // Records are independent, so they are parsed in parallel and each field
+    // is converted straight into its slot of the output tensors. If several
+    // records are malformed, the error for the first one is reported.
+    mutex mu;
+    int64_t error_record = records_size;
+    absl::Status error;
+    auto parse_records = [&](int64_t start, int64_t limit) {
+      std::vector<absl::string_view> fields;
+      std::deque<std::string> unescaped;
+      for (int64_t i = start; i < limit; ++i) {
+        absl::Status s =
+            ParseRecord(i, records_t(i), record_defaults, outputs, &fields,
+                        &unescaped);
+        if (!s.ok()) {
+          mutex_lock l(mu);
+          if (i < error_record) {
+            error_record = i;
+            error = std::move(s);
           }
-          case DT_FLOAT: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!")));
-              output[f]->flat<float>()(i) = record_defaults[f].flat<float>()(0);
-            } else {
-              float value;
-              OP_REQUIRES(ctx, absl::SimpleAtof(fields[f], &value),
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f, " in record ", i,
-                              " is not a valid float: ", fields[f])));
-              output[f]->flat<float>()(i) = value;
-            }
-            break;
-          }
-          case DT_DOUBLE: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!")));
-              output[f]->flat<double>()(i) =
-                  record_defaults[f].flat<double>()(0);
-            } else {
-              double value;
-              OP_REQUIRES(ctx, absl::SimpleAtod(fields[f], &value),
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f, " in record ", i,
-                              " is not a valid double: ", fields[f])));
-              output[f]->flat<double>()(i) = value;
-            }
-            break;
-          }
-          case DT_STRING: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          absl::InvalidArgumentError(absl::StrCat(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!")));
-              output[f]->flat<tstring>()(i) =
-                  record_defaults[f].flat<tstring>()(0);
-            } else {
-              output[f]->flat<tstring>()(i) = std::move(fields[f]);
-            }
-            break;
-          }
-          default:
-            OP_REQUIRES(
-                ctx, false,
-                absl::InvalidArgumentError(absl::StrCat(
-                    "csv: data type ", dtype, " not supported in field ", f)));
+          return;
         }
       }
-    }
+    };
+    // Scanning costs a few cycles per byte and every field pays for a
+    // conversion; the first record stands in for the rest.
+    const int64_t cost_per_record =
+        8 * records_t(0).size() + 100 * out_type_.size();
+    auto worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, records_size,
+          cost_per_record, parse_records);
+    OP_REQUIRES_OK(ctx, error);
   }
 
  private:
@@ -209,91 +135,195 @@ class DecodeCSVOp : public OpKernel {
   bool select_all_cols_;
   std::string na_value_;
 
-  void ExtractFields(OpKernelContext* ctx, absl::string_view input,
-                     std::vector<std::string>* result) {
-    int64_t current_idx = 0;
-    int64_t num_fields_parsed = 0;
-    int64_t selector_idx = 0;  // Keep track of index into select_cols
+  // Splits record `i` into fields and writes each one to row `i` of
+  // `outputs`, substituting `record_defaults` for empty and NA fields.
+  absl::Status ParseRecord(int64_t i, absl::string_view record,
+                           const OpInputList& record_defaults,
+                           const std::vector<Tensor*>& outputs,
+                           std::vector<absl::string_view>* fields,
+                           std::deque<std::string>* unescaped) const {
+    TF_RETURN_IF_ERROR(ExtractFields(record, fields, unescaped));
+    if (fields->size() != out_type_.size()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Expect ", out_type_.size(), " fields but have ",
+                       fields->size(), " in record ", i));
+    }
 
-    if (!input.empty()) {
-      while (static_cast<size_t>(current_idx) < input.size()) {
-        if (input[current_idx] == '\n' || input[current_idx] == '\r') {
-          current_idx++;
-          continue;
+    // Check each field in the record
+    for (int f = 0; f < static_cast<int>(out_type_.size()); ++f) {
+      const absl::string_view field = (*fields)[f];
+      // If this field is empty or NA value, check if default is given:
+      // If yes, use default value; Otherwise report error.
+      const bool missing = field.empty() || field == na_value_;
+      if (missing && record_defaults[f].NumElements() != 1) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Field ", f, " is required but missing in record ", i, "!"));
+      }
+      const Tensor& record_default = record_defaults[f];
+      Tensor* out = outputs[f];
+      const DataType& dtype = out_type_[f];
+      switch (dtype) {
+        case DT_INT32: {
+          if (missing) {
+            out->flat<int32_t>()(i) = record_default.flat<int32_t>()(0);
+          } else if (!absl::SimpleAtoi(field, &out->flat<int32_t>()(i))) {
+            return absl::InvalidArgumentError(
+                absl::StrCat("Field ", f, " in record ", i,
+                             " is not a valid int32: ", field));
+          }
+          break;
         }
-
-        bool quoted = false;
-        bool include =
-            (select_all_cols_ || select_cols_[selector_idx] ==
-                                     static_cast<size_t>(num_fields_parsed));
-
-        if (use_quote_delim_ && input[current_idx] == '"') {
-          quoted = true;
-          current_idx++;
+        case DT_INT64: {
+          if (missing) {
+            out->flat<int64_t>()(i) = record_default.flat<int64_t>()(0);
+          } else if (!absl::SimpleAtoi(field, &out->flat<int64_t>()(i))) {
+            return absl::InvalidArgumentError(
+                absl::StrCat("Field ", f, " in record ", i,
+                             " is not a valid int64: ", field));
+          }
+          break;
         }
-
-        // This is the body of the field;
-        std::string field;
-        if (!quoted) {
-          while (static_cast<size_t>(current_idx) < input.size() &&
-                 input[current_idx] != delim_) {
-            OP_REQUIRES(ctx,
-                        (!use_quote_delim_ || input[current_idx] != '"') &&
-                            input[current_idx] != '\n' &&
-                            input[current_idx] != '\r',
-                        absl::InvalidArgumentError(
-                            "Unquoted fields cannot have quotes/CRLFs inside"));
-            if (include) field += input[current_idx];
-            current_idx++;
+        case DT_FLOAT: {
+          if (missing) {
+            out->flat<float>()(i) = record_default.flat<float>()(0);
+          } else if (!absl::SimpleAtof(field, &out->flat<float>()(i))) {
+            return absl::InvalidArgumentError(
+                absl::StrCat("Field ", f, " in record ", i,
+                             " is not a valid float: ", field));
           }
-
-          // Go to next field or the end
-          current_idx++;
-        } else if (use_quote_delim_) {
-          // Quoted field needs to be ended with '"' and delim or end
-          while (
-              (static_cast<size_t>(current_idx) < input.size() - 1) &&
-              (input[current_idx] != '"' || input[current_idx + 1] != delim_)) {
-            if (input[current_idx] != '"') {
-              if (include) field += input[current_idx];
-              current_idx++;
-            } else {
-              OP_REQUIRES(
-                  ctx, input[current_idx + 1] == '"',
-                  absl::InvalidArgumentError("Quote inside a string has to be "
-                                             "escaped by another quote"));
-              if (include) field += '"';
-              current_idx += 2;
-            }
+          break;
+        }
+        case DT_DOUBLE: {
+          if (missing) {
+            out->flat<double>()(i) = record_default.flat<double>()(0);
+          } else if (!absl::SimpleAtod(field, &out->flat<double>()(i))) {
+            return absl::InvalidArgumentError(
+                absl::StrCat("Field ", f, " in record ", i,
+                             " is not a valid double: ", field));
+          }
+          break;
+        }
+        case DT_STRING: {
+          if (missing) {
+            out->flat<tstring>()(i) = record_default.flat<tstring>()(0);
+          } else {
+            out->flat<tstring>()(i).assign(field.data(), field.size());
           }
+          break;
+        }
+        default:
+          return absl::InvalidArgumentError(absl::StrCat(
+              "csv: data type ", dtype, " not supported in field ", f));
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  // Splits `input` into the selected fields. Fields point into `input`,
+  // except quoted fields with escaped quotes, which are unescaped into
+  // `unescaped`.
+  absl::Status ExtractFields(absl::string_view input,
+                             std::vector<absl::string_view>* result,
+                             std::deque<std::string>* unescaped) const {
+    result->clear();
+    unescaped->clear();
+    if (input.empty()) return absl::OkStatus();
 
-          OP_REQUIRES(
-              ctx,
-              (static_cast<size_t>(current_idx) < input.size() &&
-               input[current_idx] == '"' &&
-               (static_cast<size_t>(current_idx) == input.size() - 1 ||
-                input[current_idx + 1] == delim_)),
-              absl::InvalidArgumentError("Quoted field has to end with quote "
-                                         "followed by delim or end"));
+    const char* data = input.data();
+    const size_t size = input.size();
+    size_t current_idx = 0;
+    int64_t num_fields_parsed = 0;
+    size_t selector_idx = 0;  // Keep track of index into select_cols
 
-          current_idx += 2;
+    while (current_idx < size) {
+      if (data[current_idx] == '\n' || data[current_idx] == '\r') {
+        current_idx++;
+        continue;
+      }
+
+      const bool include =
+          select_all_cols_ || select_cols_[selector_idx] == num_fields_parsed;
+
+      // This is the body of the field;
+      absl::string_view field;
+      if (!use_quote_delim_ || data[current_idx] != '"') {
+        const size_t length = FindCsvSpecialChar(
+            data + current_idx, size - current_idx, delim_, use_quote_delim_);
+        const size_t end = current_idx + length;
+        if (end < size && data[end] != delim_) {
+          return absl::InvalidArgumentError(
+              "Unquoted fields cannot have quotes/CRLFs inside");
         }
+        field = absl::string_view(data + current_idx, length);
+
+        // Go to next field or the end
+        current_idx = end + 1;
+      } else {
+        current_idx++;
+        TF_RETURN_IF_ERROR(ExtractQuotedField(input, include, &current_idx,
+                                              &field, unescaped));
+      }
 
-        num_fields_parsed++;
+      num_fields_parsed++;
+      if (include) {
+        result->push_back(field);
+        selector_idx++;
+        if (selector_idx == select_cols_.size()) return absl::OkStatus();
+      }
+    }
+
+    const bool include =
+        select_all_cols_ || select_cols_[selector_idx] == num_fields_parsed;
+    // Check if the last field is missing
+    if (include && input.back() == delim_) {
+      result->push_back(absl::string_view());
+    }
+    return absl::OkStatus();
+  }
+
+  // Parses the quoted field whose body starts at `*current_idx` and leaves
+  // `*current_idx` past the closing quote and delimiter. Only quotes need a
+  // closer look, so the scan jumps from one to the next.
+  absl::Status ExtractQuotedField(absl::string_view input, bool include,
+                                  size_t* current_idx, absl::string_view* field,
+                                  std::deque<std::string>* unescaped) const {
+    const char* data = input.data();
+    const size_t size = input.size();
+    const size_t start = *current_idx;
+    size_t segment_start = start;
+    std::string* buffer = nullptr;
+    for (size_t pos = start; pos < size;) {
+      const char* quote =
+          static_cast<const char*>(std::memchr(data + pos, '"', size - pos));
+      if (quote == nullptr) break;
+      const size_t quote_idx = quote - data;
+      // Quoted field needs to be ended with '"' and delim or end
+      if (quote_idx == size - 1 || data[quote_idx + 1] == delim_) {
         if (include) {
-          result->push_back(field);
-          selector_idx++;
-          if (selector_idx == select_cols_.size()) return;
+          if (buffer == nullptr) {
+            *field = input.substr(start, quote_idx - start);
+          } else {
+            buffer->append(data + segment_start, quote_idx - segment_start);
+            *field = *buffer;
+          }
         }
+        *current_idx = quote_idx + 2;
+        return absl::OkStatus();
       }
-
-      bool include =
-          (select_all_cols_ || select_cols_[selector_idx] ==
-                                   static_cast<size_t>(num_fields_parsed));
-      // Check if the last field is missing
-      if (include && input[input.size() - 1] == delim_)
-        result->push_back(std::string());
+      if (data[quote_idx + 1] != '"') {
+        return absl::InvalidArgumentError(
+            "Quote inside a string has to be escaped by another quote");
+      }
+      if (include) {
+        if (buffer == nullptr) buffer = &unescaped->emplace_back();
+        // Keep one of the two quotes.
+        buffer->append(data + segment_start, quote_idx + 1 - segment_start);
+      }
+      pos = quote_idx + 2;
+      segment_start = pos;
     }
+    return absl::InvalidArgumentError(
+        "Quoted field has to end with quote followed by delim or end");
   }
 };
 
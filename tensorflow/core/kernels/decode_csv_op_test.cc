@@ -0,0 +1,155 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+class DecodeCSVOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(const DataTypeVector& out_types,
+              const std::vector<int64_t>& select_cols = {}) {
+    TF_ASSERT_OK(NodeDefBuilder("decode_csv", "DecodeCSV")
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(out_types))
+                     .Attr("select_cols", select_cols)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(DecodeCSVOpTest, ParsesQuotedAndUnquotedFields) {
+  MakeOp({DT_INT32, DT_FLOAT, DT_STRING});
+  AddInputFromArray<tstring>(
+      TensorShape({3}), {"1,2.5,abc", "-7,,\"a \"\"b\"\", c\"", "3,1e3,\"\""});
+  AddInputFromArray<int32_t>(TensorShape({1}), {0});
+  AddInputFromArray<float>(TensorShape({1}), {-1.0f});
+  AddInputFromArray<tstring>(TensorShape({1}), {"default"});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<int32_t>(*GetOutput(0),
+                                   test::AsTensor<int32_t>({1, -7, 3}));
+  test::ExpectTensorEqual<float>(*GetOutput(1),
+                                 test::AsTensor<float>({2.5f, -1.0f, 1000.0f}));
+  test::ExpectTensorEqual<tstring>(
+      *GetOutput(2), test::AsTensor<tstring>({"abc", "a \"b\", c", "default"}));
+}
+
+TEST_F(DecodeCSVOpTest, SelectsColumns) {
+  MakeOp({DT_INT64, DT_STRING}, {1, 3});
+  AddInputFromArray<tstring>(TensorShape({2}),
+                             {"x,1,\"y\",\"z,w\",v", "x,2,y,,"});
+  AddInputFromArray<int64_t>(TensorShape({}), {0});
+  AddInputFromArray<tstring>(TensorShape({1}), {"missing"});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<int64_t>(*GetOutput(0),
+                                   test::AsTensor<int64_t>({1, 2}));
+  test::ExpectTensorEqual<tstring>(*GetOutput(1),
+                                   test::AsTensor<tstring>({"z,w", "missing"}));
+}
+
+TEST_F(DecodeCSVOpTest, ReportsFirstMalformedRecord) {
+  MakeOp({DT_INT32, DT_INT32});
+  std::vector<tstring> records(10000, "1,2");
+  records[5000] = "1,\"2";
+  records[9000] = "1";
+  AddInputFromArray<tstring>(TensorShape({10000}), records);
+  AddInputFromArray<int32_t>(TensorShape({}), {0});
+  AddInputFromArray<int32_t>(TensorShape({}), {0});
+  const absl::Status s = RunOpKernel();
+  EXPECT_TRUE(absl::StrContains(
+      s.message(), "Quoted field has to end with quote followed by delim"))
+      << s;
+}
+
+// Args: number of records, number of float columns, and whether every other
+// column is a quoted string instead.
+void BM_DecodeCSV(::testing::benchmark::State& state) {
+  const int num_records = state.range(0);
+  const int num_columns = state.range(1);
+  const bool with_strings = state.range(2);
+
+  std::mt19937 rng(0);
+  Tensor records(DT_STRING, TensorShape({num_records}));
+  int64_t num_bytes = 0;
+  for (int i = 0; i < num_records; ++i) {
+    std::string record;
+    for (int c = 0; c < num_columns; ++c) {
+      if (c > 0) record.push_back(',');
+      if (with_strings && c % 2 == 1) {
+        absl::StrAppend(&record, "\"name ", rng() % 100000, "\"");
+      } else {
+        absl::StrAppend(&record, (rng() % 2000000) / 1000.0f - 1000.0f);
+      }
+    }
+    num_bytes += record.size();
+    records.flat<tstring>()(i) = record;
+  }
+
+  Graph* g = new Graph(OpRegistry::Global());
+  std::vector<NodeBuilder::NodeOut> defaults;
+  DataTypeVector out_types;
+  for (int c = 0; c < num_columns; ++c) {
+    if (with_strings && c % 2 == 1) {
+      defaults.emplace_back(
+          test::graph::Constant(g, test::AsScalar<tstring>("")));
+      out_types.push_back(DT_STRING);
+    } else {
+      defaults.emplace_back(test::graph::Constant(g, test::AsScalar<float>(0)));
+      out_types.push_back(DT_FLOAT);
+    }
+  }
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "DecodeCSV")
+                  .Input(test::graph::Constant(g, records))
+                  .Input(defaults)
+                  .Attr("OUT_TYPE", out_types)
+                  .Finalize(g, &node));
+  test::Benchmark("cpu", g, /*old_benchmark_api*/ false).Run(state);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_bytes);
+}
+
+BENCHMARK(BM_DecodeCSV)
+    ->UseRealTime()
+    ->Args({1024, 8, 0})
+    ->Args({1024, 8, 1})
+    ->Args({16384, 8, 0})
+    ->Args({16384, 8, 1})
+    ->Args({16384, 64, 0})
+    ->Args({16384, 64, 1});
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,255 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// CPU kernel for _FusedSparseEmbeddingLookup. It streams rows of `params`
+// straight into per-segment accumulators, so the gathered
+// [num_ids, embedding_dim] intermediate of the unfused
+// Unique + GatherV2 + SparseSegment{Sum,Mean,SqrtN} chain is never built.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <type_traits>
+
+#include "absl/base/prefetch.h"
+#include "absl/strings/str_cat.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Rows this many ids ahead of the current one are prefetched.
+constexpr int kPrefetchDistance = 4;
+
+enum class Combiner { kSum, kMean, kSqrtN };
+
+absl::Status ParseCombiner(const std::string& combiner, Combiner* out) {
+  if (combiner == "sum") {
+    *out = Combiner::kSum;
+  } else if (combiner == "mean") {
+    *out = Combiner::kMean;
+  } else if (combiner == "sqrtn") {
+    *out = Combiner::kSqrtN;
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported combiner: ", combiner));
+  }
+  return absl::OkStatus();
+}
+
+// Reduced-precision inputs are accumulated in float.
+template <typename T>
+using AccumulatorType =
+    typename std::conditional<std::is_same<T, double>::value, double,
+                              float>::type;
+
+// Returns the factor that a segment whose weights sum to `weight_sum` and
+// whose squared weights sum to `squared_weight_sum` is scaled by.
+template <typename Acc>
+Acc SegmentScale(Combiner combiner, Acc weight_sum, Acc squared_weight_sum) {
+  switch (combiner) {
+    case Combiner::kSum:
+      return Acc(1);
+    case Combiner::kMean:
+      return weight_sum == Acc(0) ? Acc(0) : Acc(1) / weight_sum;
+    case Combiner::kSqrtN:
+      return squared_weight_sum == Acc(0)
+                 ? Acc(0)
+                 : Acc(1) / std::sqrt(squared_weight_sum);
+  }
+  return Acc(1);
+}
+
+}  // namespace
+
+template <typename T, typename Tidx, typename Tsegmentids>
+class FusedSparseEmbeddingLookupOp : public OpKernel {
+ public:
+  using Acc = AccumulatorType<T>;
+
+  explicit FusedSparseEmbeddingLookupOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    std::string combiner;
+    OP_REQUIRES_OK(context, context->GetAttr("combiner", &combiner));
+    OP_REQUIRES_OK(context, ParseCombiner(combiner, &combiner_));
+    OP_REQUIRES_OK(context, context->GetAttr("num_weights", &num_weights_));
+    OP_REQUIRES(context, num_weights_ <= 1,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "Expected at most one weights input, got ",
+                    num_weights_)));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& params = context->input(0);
+    const Tensor& ids = context->input(1);
+    const Tensor& segment_ids = context->input(2);
+    const Tensor* weights = num_weights_ > 0 ? &context->input(3) : nullptr;
+    const Tensor& num_segments_t = context->input(3 + num_weights_);
+
+    OP_REQUIRES(context, TensorShapeUtils::IsVectorOrHigher(params.shape()),
+                absl::InvalidArgumentError("params must be at least 1-D"));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(ids.shape()),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "ids should be a vector, got ",
+                    ids.shape().DebugString())));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(segment_ids.shape()),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "segment_ids should be a vector, got ",
+                    segment_ids.shape().DebugString())));
+    const int64_t num_ids = ids.NumElements();
+    OP_REQUIRES(context, segment_ids.NumElements() == num_ids,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "segment_ids and ids should have the same size, got ",
+                    segment_ids.NumElements(), " vs ", num_ids)));
+    OP_REQUIRES(context,
+                weights == nullptr || weights->NumElements() == num_ids,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "weights and ids should have the same size, got ",
+                    weights == nullptr ? 0 : weights->NumElements(), " vs ",
+                    num_ids)));
+    OP_REQUIRES(context, TensorShapeUtils::IsScalar(num_segments_t.shape()),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "num_segments should be a scalar, got ",
+                    num_segments_t.shape().DebugString())));
+
+    const auto ids_flat = ids.flat<Tidx>();
+    const auto segments_flat = segment_ids.flat<Tsegmentids>();
+    const int64_t num_rows = params.dim_size(0);
+    for (int64_t i = 0; i < num_ids; ++i) {
+      OP_REQUIRES(context, FastBoundsCheck(ids_flat(i), num_rows),
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "ids[", i, "] = ", ids_flat(i), " is out of range [0, ",
+                      num_rows, ")")));
+      OP_REQUIRES(context,
+                  segments_flat(i) >= 0 &&
+                      (i == 0 || segments_flat(i - 1) <= segments_flat(i)),
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "segment_ids must be non-negative and sorted, got ",
+                      "segment_ids[", i, "] = ", segments_flat(i))));
+    }
+
+    int64_t num_segments = num_segments_t.dtype() == DT_INT32
+                               ? num_segments_t.scalar<int32_t>()()
+                               : num_segments_t.scalar<int64_t>()();
+    if (num_segments < 0) {
+      num_segments = num_ids > 0 ? segments_flat(num_ids - 1) + 1 : 0;
+    }
+    OP_REQUIRES(context,
+                num_ids == 0 || segments_flat(num_ids - 1) < num_segments,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "segment ids must be < num_segments, got ",
+                    segments_flat(num_ids - 1), " >= ", num_segments)));
+
+    TensorShape output_shape = params.shape();
+    OP_REQUIRES_OK(context, output_shape.SetDimWithStatus(0, num_segments));
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, output_shape, &output));
+    if (num_segments == 0) return;
+
+    const int64_t row_size = output->NumElements() / num_segments;
+    const T* params_data = params.flat<T>().data();
+    const T* weights_data =
+        weights == nullptr ? nullptr : weights->flat<T>().data();
+    T* output_data = output->flat<T>().data();
+    const Combiner combiner = combiner_;
+
+    // Segment ids are sorted, so the ids of each output row are contiguous
+    // and shards of output rows can be reduced independently.
+    auto reduce_segments = [&](int64_t begin, int64_t end) {
+      using AccRow = Eigen::Array<Acc, Eigen::Dynamic, 1>;
+      using ConstRow = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>;
+      using OutRow = Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>;
+      AccRow accumulator(row_size);
+      int64_t i = std::lower_bound(segments_flat.data(),
+                                   segments_flat.data() + num_ids,
+                                   static_cast<Tsegmentids>(begin)) -
+                  segments_flat.data();
+      for (int64_t segment = begin; segment < end; ++segment) {
+        OutRow out(output_data + segment * row_size, row_size);
+        if (i == num_ids || segments_flat(i) != segment) {
+          out.setZero();
+          continue;
+        }
+        accumulator.setZero();
+        Acc weight_sum = 0;
+        Acc squared_weight_sum = 0;
+        for (; i < num_ids && segments_flat(i) == segment; ++i) {
+          if (i + kPrefetchDistance < num_ids) {
+            absl::PrefetchToLocalCache(
+                params_data + ids_flat(i + kPrefetchDistance) * row_size);
+          }
+          ConstRow row(params_data + ids_flat(i) * row_size, row_size);
+          if (weights_data == nullptr) {
+            accumulator += row.template cast<Acc>();
+            weight_sum += Acc(1);
+          } else {
+            const Acc weight = static_cast<Acc>(weights_data[i]);
+            accumulator += weight * row.template cast<Acc>();
+            weight_sum += weight;
+            squared_weight_sum += weight * weight;
+          }
+        }
+        if (weights_data == nullptr) squared_weight_sum = weight_sum;
+        const Acc scale =
+            SegmentScale(combiner, weight_sum, squared_weight_sum);
+        out = (accumulator * scale).template cast<T>();
+      }
+    };
+    const int64_t cost_per_segment =
+        (num_ids / num_segments + 1) * row_size * sizeof(T);
+    auto* worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_segments,
+          cost_per_segment, reduce_segments);
+  }
+
+ private:
+  Combiner combiner_;
+  int num_weights_;
+};
+
+#define REGISTER_CPU_KERNELS_WITH_INDICES(type, index_type, segment_type) \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_FusedSparseEmbeddingLookup")                                 \
+          .Device(DEVICE_CPU)                                             \
+          .TypeConstraint<type>("T")                                      \
+          .TypeConstraint<index_type>("Tidx")                             \
+          .TypeConstraint<segment_type>("Tsegmentids"),                   \
+      FusedSparseEmbeddingLookupOp<type, index_type, segment_type>);
+
+#define REGISTER_CPU_KERNELS(type)                                  \
+  REGISTER_CPU_KERNELS_WITH_INDICES(type, int32_t, int32_t)         \
+  REGISTER_CPU_KERNELS_WITH_INDICES(type, int32_t, int64_t)         \
+  REGISTER_CPU_KERNELS_WITH_INDICES(type, int64_t, int32_t)         \
+  REGISTER_CPU_KERNELS_WITH_INDICES(type, int64_t, int64_t)
+
+TF_CALL_bfloat16(REGISTER_CPU_KERNELS);
+TF_CALL_half(REGISTER_CPU_KERNELS);
+TF_CALL_float(REGISTER_CPU_KERNELS);
+TF_CALL_double(REGISTER_CPU_KERNELS);
+
+#undef REGISTER_CPU_KERNELS
+#undef REGISTER_CPU_KERNELS_WITH_INDICES
+
+}  // namespace tensorflow
@@ -0,0 +1,235 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+class FusedSparseEmbeddingLookupOpTest : public OpsTestBase {
+ protected:
+  absl::Status Init(const std::string& combiner, int num_weights) {
+    TF_CHECK_OK(NodeDefBuilder("op", "_FusedSparseEmbeddingLookup")
+                    .Input(FakeInput(DT_FLOAT))
+                    .Input(FakeInput(DT_INT64))
+                    .Input(FakeInput(DT_INT32))
+                    .Input(FakeInput(num_weights, DT_FLOAT))
+                    .Input(FakeInput(DT_INT32))
+                    .Attr("combiner", combiner)
+                    .Finalize(node_def()));
+    return InitOp();
+  }
+
+  // Params is a [4, 2] matrix whose row r is {r, 10 * r}.
+  void AddParams() {
+    AddInputFromArray<float>(TensorShape({4, 2}),
+                             {0, 0, 1, 10, 2, 20, 3, 30});
+  }
+};
+
+TEST_F(FusedSparseEmbeddingLookupOpTest, SumInfersNumSegments) {
+  TF_ASSERT_OK(Init("sum", /*num_weights=*/0));
+  AddParams();
+  AddInputFromArray<int64_t>(TensorShape({5}), {1, 3, 3, 2, 1});
+  AddInputFromArray<int32_t>(TensorShape({5}), {0, 0, 1, 1, 1});
+  AddInputFromArray<int32_t>(TensorShape({}), {-1});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({2, 2}));
+  test::FillValues<float>(&expected, {4, 40, 6, 60});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(FusedSparseEmbeddingLookupOpTest, WeightedMeanWithEmptySegment) {
+  TF_ASSERT_OK(Init("mean", /*num_weights=*/1));
+  AddParams();
+  AddInputFromArray<int64_t>(TensorShape({3}), {1, 3, 2});
+  AddInputFromArray<int32_t>(TensorShape({3}), {0, 0, 2});
+  AddInputFromArray<float>(TensorShape({3}), {1, 3, 2});
+  AddInputFromArray<int32_t>(TensorShape({}), {4});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Segment 0 is (1 * row1 + 3 * row3) / 4, segment 2 is row2.
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({4, 2}));
+  test::FillValues<float>(&expected, {2.5, 25, 0, 0, 2, 20, 0, 0});
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-5);
+}
+
+TEST_F(FusedSparseEmbeddingLookupOpTest, SqrtN) {
+  TF_ASSERT_OK(Init("sqrtn", /*num_weights=*/0));
+  AddParams();
+  AddInputFromArray<int64_t>(TensorShape({4}), {1, 1, 1, 1});
+  AddInputFromArray<int32_t>(TensorShape({4}), {0, 0, 0, 0});
+  AddInputFromArray<int32_t>(TensorShape({}), {-1});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({1, 2}));
+  test::FillValues<float>(&expected, {2, 20});
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-5);
+}
+
+TEST_F(FusedSparseEmbeddingLookupOpTest, IdOutOfRange) {
+  TF_ASSERT_OK(Init("sum", /*num_weights=*/0));
+  AddParams();
+  AddInputFromArray<int64_t>(TensorShape({2}), {1, 4});
+  AddInputFromArray<int32_t>(TensorShape({2}), {0, 0});
+  AddInputFromArray<int32_t>(TensorShape({}), {-1});
+  absl::Status s = RunOpKernel();
+  EXPECT_TRUE(absl::StrContains(s.message(), "out of range")) << s;
+}
+
+TEST_F(FusedSparseEmbeddingLookupOpTest, UnsortedSegmentIds) {
+  TF_ASSERT_OK(Init("sum", /*num_weights=*/0));
+  AddParams();
+  AddInputFromArray<int64_t>(TensorShape({2}), {1, 2});
+  AddInputFromArray<int32_t>(TensorShape({2}), {1, 0});
+  AddInputFromArray<int32_t>(TensorShape({}), {-1});
+  absl::Status s = RunOpKernel();
+  EXPECT_TRUE(absl::StrContains(s.message(), "sorted")) << s;
+}
+
+// Returns `n` ids in [0, num_rows). Zipfian ids with exponent 1.1 model the
+// skewed popularity of real embedding vocabularies.
+Tensor RandomIds(int64_t n, int64_t num_rows, bool zipfian) {
+  std::mt19937 gen(301);
+  Tensor ids(DT_INT64, TensorShape({n}));
+  auto ids_flat = ids.flat<int64_t>();
+  if (!zipfian) {
+    std::uniform_int_distribution<int64_t> dist(0, num_rows - 1);
+    for (int64_t i = 0; i < n; ++i) ids_flat(i) = dist(gen);
+    return ids;
+  }
+  std::vector<double> cdf(num_rows);
+  double total = 0;
+  for (int64_t r = 0; r < num_rows; ++r) {
+    total += 1.0 / std::pow(r + 1, 1.1);
+    cdf[r] = total;
+  }
+  std::uniform_real_distribution<double> dist(0, total);
+  for (int64_t i = 0; i < n; ++i) {
+    ids_flat(i) = std::min<int64_t>(
+        std::lower_bound(cdf.begin(), cdf.end(), dist(gen)) - cdf.begin(),
+        num_rows - 1);
+  }
+  return ids;
+}
+
+// Builds a graph that looks up `batch_size` bags of `bag_size` ids each in a
+// [num_rows, dim] embedding table and sums each bag, either with the fused op
+// or with the Unique + GatherV2 + SparseSegmentSum chain it replaces.
+Graph* EmbeddingLookupGraph(bool fused, bool zipfian, int64_t num_rows,
+                            int64_t dim, int64_t batch_size,
+                            int64_t bag_size) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor params(DT_FLOAT, TensorShape({num_rows, dim}));
+  params.flat<float>().setRandom();
+  const int64_t num_ids = batch_size * bag_size;
+  Tensor ids = RandomIds(num_ids, num_rows, zipfian);
+  Tensor segment_ids(DT_INT32, TensorShape({num_ids}));
+  test::FillFn<int32_t>(&segment_ids, [bag_size](int i) {
+    return static_cast<int32_t>(i / bag_size);
+  });
+
+  Node* params_node = test::graph::Constant(g, params);
+  Node* ids_node = test::graph::Constant(g, ids);
+  Node* segment_ids_node = test::graph::Constant(g, segment_ids);
+  Node* node;
+  if (fused) {
+    TF_CHECK_OK(NodeBuilder(g->NewName("n"), "_FusedSparseEmbeddingLookup")
+                    .Input(params_node)
+                    .Input(ids_node)
+                    .Input(segment_ids_node)
+                    .Input(std::vector<NodeBuilder::NodeOut>())
+                    .Input(test::graph::Constant(g, test::AsScalar<int32_t>(
+                                                        batch_size)))
+                    .Attr("combiner", "sum")
+                    .Finalize(g, &node));
+  } else {
+    Node* unique;
+    TF_CHECK_OK(NodeBuilder(g->NewName("n"), "Unique")
+                    .Input(ids_node)
+                    .Attr("out_idx", DT_INT32)
+                    .Finalize(g, &unique));
+    Node* gather;
+    TF_CHECK_OK(NodeBuilder(g->NewName("n"), "GatherV2")
+                    .Input(params_node)
+                    .Input(unique, 0)
+                    .Input(test::graph::Constant(g, test::AsScalar<int32_t>(0)))
+                    .Finalize(g, &gather));
+    TF_CHECK_OK(NodeBuilder(g->NewName("n"), "SparseSegmentSum")
+                    .Input(gather)
+                    .Input(unique, 1)
+                    .Input(segment_ids_node)
+                    .Finalize(g, &node));
+  }
+  FixupSourceAndSinkEdges(g);
+  return g;
+}
+
+void BM_EmbeddingLookup(::testing::benchmark::State& state, bool fused,
+                        bool zipfian) {
+  const int64_t num_rows = state.range(0);
+  const int64_t dim = state.range(1);
+  const int64_t batch_size = state.range(2);
+  const int64_t bag_size = state.range(3);
+  test::Benchmark("cpu",
+                  EmbeddingLookupGraph(fused, zipfian, num_rows, dim,
+                                       batch_size, bag_size),
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(state.iterations() * batch_size * bag_size);
+  state.SetBytesProcessed(state.iterations() * batch_size * bag_size * dim *
+                          sizeof(float));
+}
+
+#define BM_EMBEDDING_LOOKUP(fused, zipfian)                               \
+  void BM_EmbeddingLookup_##fused##_##zipfian(                            \
+      ::testing::benchmark::State& state) {                               \
+    BM_EmbeddingLookup(state, fused, zipfian);                            \
+  }                                                                       \
+  BENCHMARK(BM_EmbeddingLookup_##fused##_##zipfian)                       \
+      ->UseRealTime()                                                     \
+      ->Args({1 << 16, 32, 256, 16})                                      \
+      ->Args({1 << 20, 64, 1024, 32})                                     \
+      ->Args({1 << 20, 128, 4096, 8});
+
+BM_EMBEDDING_LOOKUP(true, true);
+BM_EMBEDDING_LOOKUP(false, true);
+BM_EMBEDDING_LOOKUP(true, false);
+BM_EMBEDDING_LOOKUP(false, false);
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,259 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#define EIGEN_USE_THREADS
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/image/sampling_kernels.h"
+#include "tensorflow/core/kernels/image/scale_and_translate_op.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+int64_t CeilOfRatio(int64_t numerator, int64_t denominator) {
+  return (numerator + denominator - 1) / denominator;
+}
+
+// Returns the largest libjpeg IDCT downscaling ratio that still leaves at
+// least one decoded pixel per output pixel across the crop window, so the
+// resampling filter never has to upsample what the decoder threw away.
+int ChooseDecodeRatio(int64_t crop_height, int64_t crop_width,
+                      int64_t output_height, int64_t output_width) {
+  for (const int ratio : {8, 4, 2}) {
+    if (crop_height >= output_height * ratio &&
+        crop_width >= output_width * ratio) {
+      return ratio;
+    }
+  }
+  return 1;
+}
+
+// Decodes a JPEG at the coarsest scaled-IDCT resolution that covers the
+// requested size, decoding only the rows and columns under the crop window,
+// and resamples the result to `size` with ScaleAndTranslate's separable
+// filters. The full-resolution image is never materialized.
+class DecodeAndResizeJpegOp : public OpKernel {
+ public:
+  explicit DecodeAndResizeJpegOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, channels_ == 0 || channels_ == 1 || channels_ == 3,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "`channels` must be 0, 1 or 3 but got ", channels_)));
+    std::string kernel_type_str;
+    OP_REQUIRES_OK(context, context->GetAttr("kernel_type", &kernel_type_str));
+    kernel_type_ = functor::SamplingKernelTypeFromString(kernel_type_str);
+    OP_REQUIRES(context, kernel_type_ != functor::SamplingKernelTypeEnd,
+                absl::InvalidArgumentError("Unrecognized kernel type: " +
+                                           kernel_type_str));
+    OP_REQUIRES_OK(context, context->GetAttr("antialias", &antialias_));
+    OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
+                                             &flags_.fancy_upscaling));
+    std::string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        absl::InvalidArgumentError("dct_method must be one of {'', "
+                                   "'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    flags_.dct_method =
+        dct_method == "INTEGER_ACCURATE" ? JDCT_ISLOW : JDCT_IFAST;
+    flags_.components = channels_;
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsScalar(contents.shape()),
+                absl::InvalidArgumentError(
+                    absl::StrCat("`contents` must be scalar but got shape",
+                                 contents.shape().DebugString())));
+    const absl::string_view input = contents.scalar<tstring>()();
+
+    const Tensor& crop_window = context->input(1);
+    OP_REQUIRES(context,
+                crop_window.dims() == 1 && (crop_window.dim_size(0) == 0 ||
+                                            crop_window.dim_size(0) == 4),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "crop_window must be empty or have four elements, got "
+                    "shape ",
+                    crop_window.shape().DebugString())));
+    const Tensor& size = context->input(2);
+    OP_REQUIRES(context, size.dims() == 1 && size.dim_size(0) == 2,
+                absl::InvalidArgumentError(
+                    absl::StrCat("size must have two elements, got shape ",
+                                 size.shape().DebugString())));
+    const int64_t output_height = size.vec<int32_t>()(0);
+    const int64_t output_width = size.vec<int32_t>()(1);
+    OP_REQUIRES(
+        context, output_height > 0 && output_width > 0,
+        absl::InvalidArgumentError("output dimensions must be positive"));
+
+    int image_height = 0;
+    int image_width = 0;
+    OP_REQUIRES(context,
+                jpeg::GetImageInfo(input.data(), input.size(), &image_width,
+                                   &image_height, nullptr),
+                absl::InvalidArgumentError("Invalid JPEG data"));
+
+    int64_t crop_y = 0;
+    int64_t crop_x = 0;
+    int64_t crop_height = image_height;
+    int64_t crop_width = image_width;
+    if (crop_window.NumElements() == 4) {
+      auto crop_window_vec = crop_window.vec<int32_t>();
+      crop_y = crop_window_vec(0);
+      crop_x = crop_window_vec(1);
+      crop_height = crop_window_vec(2);
+      crop_width = crop_window_vec(3);
+      OP_REQUIRES(context,
+                  crop_y >= 0 && crop_x >= 0 && crop_height > 0 &&
+                      crop_width > 0 && crop_y + crop_height <= image_height &&
+                      crop_x + crop_width <= image_width,
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "Invalid crop window [", crop_y, ", ", crop_x, ", ",
+                      crop_height, ", ", crop_width, "] for a ", image_height,
+                      "x", image_width, " image")));
+    }
+
+    // libjpeg rounds scaled dimensions up, so scaled pixel i covers
+    // full-resolution pixels [i * ratio, (i + 1) * ratio).
+    const int ratio =
+        ChooseDecodeRatio(crop_height, crop_width, output_height, output_width);
+    const int64_t scaled_height = CeilOfRatio(image_height, ratio);
+    const int64_t scaled_width = CeilOfRatio(image_width, ratio);
+    const int64_t decode_y = crop_y / ratio;
+    const int64_t decode_x = crop_x / ratio;
+    const int64_t decode_height =
+        std::min(CeilOfRatio(crop_y + crop_height, ratio), scaled_height) -
+        decode_y;
+    const int64_t decode_width =
+        std::min(CeilOfRatio(crop_x + crop_width, ratio), scaled_width) -
+        decode_x;
+
+    jpeg::UncompressFlags flags = flags_;
+    flags.ratio = ratio;
+    if (decode_height < scaled_height || decode_width < scaled_width) {
+      flags.crop = true;
+      flags.crop_y = decode_y;
+      flags.crop_x = decode_x;
+      flags.crop_height = decode_height;
+      flags.crop_width = decode_width;
+    }
+
+    Tensor decoded;
+    uint8_t* buffer = jpeg::Uncompress(
+        input.data(), input.size(), flags, nullptr /* nwarn */,
+        [&](int width, int height, int channels) -> uint8_t* {
+          absl::Status status = context->allocate_temp(
+              DT_UINT8, TensorShape({1, height, width, channels}), &decoded);
+          if (!status.ok()) {
+            context->SetStatus(status);
+            return nullptr;
+          }
+          return decoded.flat<uint8_t>().data();
+        });
+    OP_REQUIRES(
+        context, buffer,
+        absl::InvalidArgumentError(
+            "jpeg::Uncompress failed. Invalid JPEG data or crop window."));
+
+    const int64_t decoded_height = decoded.dim_size(1);
+    const int64_t decoded_width = decoded.dim_size(2);
+    const int64_t channels = decoded.dim_size(3);
+
+    // Full-resolution coordinate u lies at u / ratio - decode_{x,y} in the
+    // decoded buffer; express that as ScaleAndTranslate's scale and
+    // translation from output to decoded pixels.
+    const float row_scale = static_cast<float>(output_height) * ratio /
+                            static_cast<float>(crop_height);
+    const float row_translation =
+        (decode_y - static_cast<float>(crop_y) / ratio) * row_scale;
+    const float col_scale = static_cast<float>(output_width) * ratio /
+                            static_cast<float>(crop_width);
+    const float col_translation =
+        (decode_x - static_cast<float>(crop_x) / ratio) * col_scale;
+
+    functor::Spans col_spans;
+    OP_REQUIRES_OK(context,
+                   functor::ComputeSpans(context, kernel_type_, output_width,
+                                         decoded_width, col_scale,
+                                         col_translation, antialias_,
+                                         &col_spans));
+    functor::Spans row_spans;
+    OP_REQUIRES_OK(context,
+                   functor::ComputeSpans(context, kernel_type_, output_height,
+                                         decoded_height, row_scale,
+                                         row_translation, antialias_,
+                                         &row_spans));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({output_height, output_width, channels}),
+                       &output));
+    Tensor intermediate;
+    OP_REQUIRES_OK(context, context->allocate_temp(
+                                DT_FLOAT,
+                                TensorShape({1, output_height, decoded_width,
+                                             channels}),
+                                &intermediate));
+
+    const Tensor& const_decoded = decoded;
+    const functor::Spans& const_row_spans = row_spans;
+    const functor::Spans& const_col_spans = col_spans;
+    functor::GatherSpans<CPUDevice, uint8_t>()(
+        context, context->eigen_device<CPUDevice>(), row_spans.span_size,
+        const_row_spans.starts.tensor<int32_t, 1>(),
+        const_row_spans.weights.tensor<float, 1>(), col_spans.span_size,
+        const_col_spans.starts.tensor<int32_t, 1>(),
+        const_col_spans.weights.tensor<float, 1>(),
+        const_decoded.tensor<uint8_t, 4>(), intermediate.tensor<float, 4>(),
+        output->shaped<float, 4>(
+            {1, output_height, output_width, channels}));
+  }
+
+ private:
+  int channels_;
+  functor::SamplingKernelType kernel_type_;
+  bool antialias_;
+  jpeg::UncompressFlags flags_;
+};
+
+}  // namespace
+
+REGISTER_KERNEL_BUILDER(Name("DecodeAndResizeJpeg").Device(DEVICE_CPU),
+                        DecodeAndResizeJpegOp);
+
+}  // namespace tensorflow
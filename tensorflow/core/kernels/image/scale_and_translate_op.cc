@@ -192,6 +192,8 @@ absl::Status ComputeGradSpansCore(OpKernelContext* context, const Spans& spans,
   return absl::OkStatus();
 }
 
+}  // namespace
+
 // Computes the spans for the passed kernel, for a input dimension of length
 // input_size transformed by scale and translate to an output dimension of
 // length output_size. Note that there's no requirement that;
@@ -241,6 +243,8 @@ absl::Status ComputeSpans(OpKernelContext* context,
   return absl::OkStatus();
 }
 
+namespace {
+
 // Computes the grad spans for the passed kernel.
 // forward_input_size and forward_output_size are the input and output size from
 // the forward operation.
@@ -591,49 +595,45 @@ void GatherRows(OpKernelContext* context, int span_size, const int32_t* starts,
 
 }  // namespace
 
-// Partial specialization of GatherSpans functor for a CPUDevice.
 template <typename T>
-struct GatherSpans<CPUDevice, T> {
-  void operator()(OpKernelContext* context, const CPUDevice& d,
-                  int row_span_size,
-                  typename TTypes<int32_t, 1>::ConstTensor row_starts,
-                  typename TTypes<float, 1>::ConstTensor row_weights,
-                  int col_span_size,
-                  typename TTypes<int32_t, 1>::ConstTensor col_starts,
-                  typename TTypes<float, 1>::ConstTensor col_weights,
-                  typename TTypes<T, 4>::ConstTensor images,
-                  typename TTypes<float, 4>::Tensor intermediate_buffer,
-                  typename TTypes<float, 4>::Tensor resized_images) {
-    const int batch_size = images.dimension(0);
-    const int64_t input_height = images.dimension(1);
-    const int64_t input_width = images.dimension(2);
-    const int channels = images.dimension(3);
-
-    const int64_t output_height = resized_images.dimension(1);
-    const int64_t output_width = resized_images.dimension(2);
-
-    const int64_t input_pix_per_batch = input_width * input_height * channels;
-    const int64_t intermediate_pix_per_batch =
-        input_width * output_height * channels;
-    const int64_t output_pix_per_batch =
-        output_width * output_height * channels;
-    float* intermediate_ptr = intermediate_buffer.data();
-
-    const T* image_ptr = images.data();
-    float* out_ptr = resized_images.data();
-    for (int b = 0; b < batch_size; ++b, image_ptr += input_pix_per_batch,
-             intermediate_ptr += intermediate_pix_per_batch,
-             out_ptr += output_pix_per_batch) {
-      GatherRows(context, row_span_size, row_starts.data(), row_weights.data(),
-                 image_ptr, input_height, input_width, output_height,
-                 input_width, channels, intermediate_ptr);
-      GatherColumns(context, col_span_size, col_starts.data(),
-                    col_weights.data(), intermediate_ptr, output_height,
-                    input_width, output_height, output_width, channels,
-                    out_ptr);
-    }
+void GatherSpans<CPUDevice, T>::operator()(
+    OpKernelContext* context, const CPUDevice& d, int row_span_size,
+    typename TTypes<int32_t, 1>::ConstTensor row_starts,
+    typename TTypes<float, 1>::ConstTensor row_weights, int col_span_size,
+    typename TTypes<int32_t, 1>::ConstTensor col_starts,
+    typename TTypes<float, 1>::ConstTensor col_weights,
+    typename TTypes<T, 4>::ConstTensor images,
+    typename TTypes<float, 4>::Tensor intermediate_buffer,
+    typename TTypes<float, 4>::Tensor resized_images) {
+  const int batch_size = images.dimension(0);
+  const int64_t input_height = images.dimension(1);
+  const int64_t input_width = images.dimension(2);
+  const int channels = images.dimension(3);
+
+  const int64_t output_height = resized_images.dimension(1);
+  const int64_t output_width = resized_images.dimension(2);
+
+  const int64_t input_pix_per_batch = input_width * input_height * channels;
+  const int64_t intermediate_pix_per_batch =
+      input_width * output_height * channels;
+  const int64_t output_pix_per_batch = output_width * output_height * channels;
+  float* intermediate_ptr = intermediate_buffer.data();
+
+  const T* image_ptr = images.data();
+  float* out_ptr = resized_images.data();
+  for (int b = 0; b < batch_size; ++b, image_ptr += input_pix_per_batch,
+           intermediate_ptr += intermediate_pix_per_batch,
+           out_ptr += output_pix_per_batch) {
+    GatherRows(context, row_span_size, row_starts.data(), row_weights.data(),
+               image_ptr, input_height, input_width, output_height, input_width,
+               channels, intermediate_ptr);
+    GatherColumns(context, col_span_size, col_starts.data(), col_weights.data(),
+                  intermediate_ptr, output_height, input_width, output_height,
+                  output_width, channels, out_ptr);
   }
-};
+}
+
+template struct GatherSpans<CPUDevice, uint8_t>;
 
 #define REGISTER_KERNEL(T)                                \
   REGISTER_KERNEL_BUILDER(Name("ScaleAndTranslate")       \
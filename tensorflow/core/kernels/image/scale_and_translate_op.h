@@ -16,8 +16,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_IMAGE_SCALE_AND_TRANSLATE_OP_H_
 #define TENSORFLOW_CORE_KERNELS_IMAGE_SCALE_AND_TRANSLATE_OP_H_
 
+#include <cstdint>
+
+#include "absl/status/status.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/numeric_types.h"
+#include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/kernels/image/sampling_kernels.h"
@@ -51,6 +55,14 @@ struct Spans {
   Tensor weights;
 };
 
+// Computes the spans of `kernel_type` for an input dimension of length
+// input_size transformed by scale and translate to an output dimension of
+// length output_size. The span tensors are allocated in host memory.
+absl::Status ComputeSpans(OpKernelContext* context,
+                          SamplingKernelType kernel_type, int64_t output_size,
+                          int64_t input_size, float scale, float translate,
+                          bool antialias, Spans* spans);
+
 // Gather spans in both dimensions.
 // row_span_size, row_starts and row_weights correspond to the variables in
 // the row Spans data structure, similarly for col_span_size etc.
@@ -70,6 +82,23 @@ struct GatherSpans {
                   typename TTypes<float, 4>::Tensor output_images);
 };
 
+template <typename T>
+struct GatherSpans<Eigen::ThreadPoolDevice, T> {
+  void operator()(OpKernelContext* context, const Eigen::ThreadPoolDevice& d,
+                  int row_span_size,
+                  typename TTypes<int32_t, 1>::ConstTensor row_starts,
+                  typename TTypes<float, 1>::ConstTensor row_weights,
+                  int col_span_size,
+                  typename TTypes<int32_t, 1>::ConstTensor col_starts,
+                  typename TTypes<float, 1>::ConstTensor col_weights,
+                  typename TTypes<T, 4>::ConstTensor images,
+                  typename TTypes<float, 4>::Tensor intermediate_buffer,
+                  typename TTypes<float, 4>::Tensor output_images);
+};
+
+// Used by DecodeAndResizeJpeg to resample decoded images.
+extern template struct GatherSpans<Eigen::ThreadPoolDevice, uint8_t>;
+
 }  // namespace functor
 }  // namespace tensorflow
 
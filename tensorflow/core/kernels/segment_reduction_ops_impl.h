@@ -54,6 +54,7 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/util/determinism.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
@@ -86,6 +87,49 @@ absl::Status ValidateSparseSegmentReduction(OpKernelContext* context,
                                             const Tensor& indices,
                                             const Tensor& segment_ids,
                                             bool has_num_segments);
+
+// Splits segments into at most one run per thread, each covering roughly the
+// same number of input rows so that skewed segment sizes still balance.
+// `starts` holds the first input row of every segment followed by the total
+// number of rows; `row_size` is the number of elements per row. Returns the
+// first segment of every run followed by the number of segments.
+std::vector<int64_t> BalanceSegments(const std::vector<int64_t>& starts,
+                                     int64_t row_size, int num_threads);
+
+// Checks that the sorted `segment_ids` are increasing and lie in
+// [0, output_rows), in the same order the sequential kernels checked them,
+// and records the first input row and the id of every segment. `starts` ends
+// with the number of ids.
+template <typename SegmentId>
+absl::Status GetSortedSegments(
+    typename TTypes<SegmentId>::ConstVec segment_ids, int64_t output_rows,
+    std::vector<int64_t>* starts, std::vector<SegmentId>* ids) {
+  const int64_t num_indices = segment_ids.dimension(0);
+  SegmentId out_index = SubtleMustCopy(segment_ids(0));
+  starts->push_back(0);
+  ids->push_back(out_index);
+  for (int64_t i = 1; i <= num_indices; ++i) {
+    SegmentId next_index = 0;
+    if (i < num_indices) {
+      next_index = SubtleMustCopy(segment_ids(i));
+      if (out_index == next_index) continue;
+      if (out_index > next_index) {
+        return absl::InvalidArgumentError("segment ids are not increasing");
+      }
+    }
+    if (!FastBoundsCheck(out_index, output_rows)) {
+      return errors::InvalidArgument(
+          "Segment id ", out_index, " out of range [0, ", output_rows,
+          "), possibly because 'segment_ids' input is not sorted.");
+    }
+    if (i == num_indices) break;
+    starts->push_back(i);
+    ids->push_back(next_index);
+    out_index = next_index;
+  }
+  starts->push_back(num_indices);
+  return absl::OkStatus();
+}
 }  // namespace internal
 
 // This operator handles reducing segments along the first dimension.
@@ -133,84 +177,81 @@ class SegmentReductionOp : public OpKernel {
     if (num_indices == 0) return;
     OP_REQUIRES(context, output_rows > 0,
                 absl::InvalidArgumentError("segment ids must be >= 0"));
+    std::vector<int64_t> starts;
+    std::vector<Index> ids;
+    OP_REQUIRES_OK(context, internal::GetSortedSegments<Index>(
+                                segment_vec, output_rows, &starts, &ids));
     auto output_flat = output->flat_outer_dims<T>();
 
-    Eigen::IndexList<Eigen::type2index<0> > dims_to_reduce;
-    Index start = 0, end = 1;
-
-    Index uninitialized_index = 0;  // Index from which the output is not set.
-    Index out_index = internal::SubtleMustCopy(segment_vec(start));
-
-    // TODO(agarwal): if this loop becomes a bottleneck, consider sharding it
-    // across threads.
-    Eigen::DSizes<Eigen::DenseIndex, 1> out_slice_shape(num_col);
-    while (end <= num_indices) {
-      // We initialize next_index to 0 to avoid "warning: 'next_index' may be
-      // used uninitialized in this function" in the Mac build (since the
-      // compiler isn't smart enough to realize the code is safe).
-      Index next_index = 0;
-      if (end < num_indices) {
-        next_index = internal::SubtleMustCopy(segment_vec(end));
-        if (out_index == next_index) {
-          ++end;
-          continue;
+    // Reduces segments [first, last). Each run also fills the gap of missing
+    // ids in front of each of its segments with the default value.
+    auto reduce_segments = [&](int64_t first, int64_t last) {
+      Eigen::IndexList<Eigen::type2index<0> > dims_to_reduce;
+      Eigen::DSizes<Eigen::DenseIndex, 1> out_slice_shape(num_col);
+      // Index from which the output is not set.
+      Index uninitialized_index = first == 0 ? 0 : ids[first - 1] + 1;
+      for (int64_t s = first; s < last; ++s) {
+        const Index out_index = ids[s];
+        const int64_t start = starts[s];
+        const int64_t end = starts[s + 1];
+
+        // Process segment [start, end)
+        const T* in_slice_ptr = &input_flat(start, 0);
+        typedef Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor>,
+                                 Eigen::Unaligned>
+            OutT;
+
+        // If there is a gap between two indices, we need to set that gap to
+        // the default value.
+        if (out_index > uninitialized_index) {
+          Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
+              out_index - uninitialized_index, num_col);
+          Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                           Eigen::Unaligned>
+              gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
+          gap_slice.setConstant(T(default_value));
         }
-        // We have a new segment here.  Verify that the segment ids are growing.
-        OP_REQUIRES(
-            context, out_index < next_index,
-            absl::InvalidArgumentError("segment ids are not increasing"));
-      }
-
-      // Process segment [start, end)
-      const T* in_slice_ptr = &input_flat(start, 0);
-      typedef Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor>,
-                               Eigen::Unaligned>
-          OutT;
 
-      OP_REQUIRES(
-          context, FastBoundsCheck(out_index, output_rows),
-          errors::InvalidArgument(
-              "Segment id ", out_index, " out of range [0, ", output_rows,
-              "), possibly because 'segment_ids' input is not sorted."));
-
-      // If there is a gap between two indices, we need to set that gap to the
-      // default value.
-      if (out_index > uninitialized_index) {
-        Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
-            out_index - uninitialized_index, num_col);
-        Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>, Eigen::Unaligned>
-            gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
-        gap_slice.setConstant(T(default_value));
+        T* out_slice_ptr = &output_flat(out_index, 0);
+        OutT out_slice(out_slice_ptr, out_slice_shape);
+        // We don't use out_slice.device(context->eigen_device<Device>)
+        // because these pieces of work are likely to be very small and
+        // the context switching overhead dwarfs any benefit we get from
+        // using another thread to do this work.
+        if (start == end - 1) {
+          typedef Eigen::TensorMap<Eigen::Tensor<const T, 1, Eigen::RowMajor>,
+                                   Eigen::Unaligned>
+              InT;
+          InT in_slice(in_slice_ptr, out_slice_shape);
+          out_slice = in_slice;
+        } else {
+          Eigen::DSizes<Eigen::DenseIndex, 2> in_slice_shape(end - start,
+                                                             num_col);
+          typedef Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor>,
+                                   Eigen::Unaligned>
+              InT;
+          InT in_slice(in_slice_ptr, in_slice_shape);
+
+          out_slice = in_slice.reduce(dims_to_reduce, Reducer());
+        }
+        uninitialized_index = out_index + 1;
       }
+    };
 
-      T* out_slice_ptr = &output_flat(out_index, 0);
-      OutT out_slice(out_slice_ptr, out_slice_shape);
-      // We don't use out_slice.device(context->eigen_device<Device>)
-      // because these pieces of work are likely to be very small and
-      // the context switching overhead dwarfs any benefit we get from
-      // using another thread to do this work.
-      if (start == end - 1) {
-        typedef Eigen::TensorMap<Eigen::Tensor<const T, 1, Eigen::RowMajor>,
-                                 Eigen::Unaligned>
-            InT;
-        InT in_slice(in_slice_ptr, out_slice_shape);
-        out_slice = in_slice;
-      } else {
-        Eigen::DSizes<Eigen::DenseIndex, 2> in_slice_shape(end - start,
-                                                           num_col);
-        typedef Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor>,
-                                 Eigen::Unaligned>
-            InT;
-        InT in_slice(in_slice_ptr, in_slice_shape);
-
-        out_slice = in_slice.reduce(dims_to_reduce, Reducer());
-      }
-      if (end >= num_indices) break;
-      start = end;
-      ++end;
-      uninitialized_index = out_index + 1;
-      out_index = next_index;
-    }
+    // Runs of whole segments with balanced row counts are reduced in
+    // parallel; segments never straddle runs, so each output row is written
+    // by exactly one thread.
+    auto* worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    const std::vector<int64_t> runs = internal::BalanceSegments(
+        starts, num_col, worker_threads->num_threads);
+    const int64_t num_runs = runs.size() - 1;
+    Shard(worker_threads->num_threads, worker_threads->workers, num_runs,
+          num_indices / num_runs * num_col,
+          [&](int64_t begin, int64_t end) {
+            for (int64_t r = begin; r < end; ++r) {
+              reduce_segments(runs[r], runs[r + 1]);
+            }
+          });
   }
 };
 
@@ -382,11 +423,16 @@ struct UnsortedSegmentFunctor<CPUDevice, T, Index, InitialValueF, ReductionF> {
     // output row, the row only fills with InitialValueF() will keep 0.
     // Length of non-zero elements is `num_reductions`.
     std::vector<Index> row_counter(num_segments, 0);
+    // Whether the ids are non-decreasing and non-negative, in which case the
+    // rows of every segment are already contiguous in the input.
+    bool is_sorted = true;
+    Index previous = 0;
 
     for (int64_t i = 0; i < N; ++i) {
       Index j = internal::SubtleMustCopy(segment_ids(i));
       if (j < 0) {
         --num_real_segment;
+        is_sorted = false;
         continue;
       }
       OP_REQUIRES(ctx, FastBoundsCheck(j, num_segments),
@@ -395,53 +441,74 @@ struct UnsortedSegmentFunctor<CPUDevice, T, Index, InitialValueF, ReductionF> {
                       " = ", j, " is out of range [0, ", num_segments, ")"));
       if (row_counter[j] == 0) num_reductions++;
       row_counter[j]++;
+      is_sorted = is_sorted && j >= previous;
+      previous = j;
     }
 
     // Nothing to reduce. All output values equal to `InitialValueF()`.
     if (num_reductions == 0) return;
 
-    // Parallelize by `num_segments`. It's simple, efficient and safe
-    // (no data dependency):
+    // Group the input rows by segment with a counting sort, keeping each
+    // segment's rows in input order so that the reduction order (and thus
+    // the result) is the same as a sequential scan:
     //
-    //   input   segment_ids                 num_segments  operation
-    //   | a0 |  | 0 |            worker 1:  |0|           f(a0, a1)
-    //   | b0 |  | 1 |            worker 2:  |1|           f(b0, b1)
-    // N | c0 |  | 2 |       -->  worker 3:  |2|           f(c0)
-    //   | b1 |  | 1 |
-    //   | a1 |  | 0 |
+    //   input   segment_ids          offsets  rows
+    //   | a0 |  | 0 |                | 0 |    | 0 |  segment 0: f(a0, a1)
+    //   | b0 |  | 1 |                | 2 |    | 4 |
+    // N | c0 |  | 2 |       -->      | 4 |    | 1 |  segment 1: f(b0, b1)
+    //   | b1 |  | 1 |                | 5 |    | 3 |
+    //   | a1 |  | 0 |                         | 2 |  segment 2: f(c0)
     //
-    // TODO(intel-tf): Balance workload in `row_counter` to make parallelism
-    //                 more efficient.
-    auto reductionWorker = [&](int64_t begin, int64_t end) -> void {
-      for (int64_t i = 0; i < N; i++) {
+    // Sorted ids need no permutation: segment j covers input rows
+    // [offsets[j], offsets[j + 1]).
+    std::vector<int64_t> offsets(num_segments + 1);
+    offsets[0] = 0;
+    for (int64_t j = 0; j < num_segments; ++j) {
+      offsets[j + 1] = offsets[j] + row_counter[j];
+    }
+    std::vector<int64_t> rows;
+    if (!is_sorted) {
+      rows.resize(num_real_segment);
+      std::vector<int64_t> next(offsets.begin(), offsets.end() - 1);
+      for (int64_t i = 0; i < N; ++i) {
         Index j = internal::SubtleMustCopy(segment_ids(i));
-        // If `j` is in work scope of this worker, do the reduction.
-        if (j >= begin && j < end) {
-          reduction(data.template chip<0>(i), output.template chip<0>(j));
+        if (!FastBoundsCheck(j, num_segments) || next[j] == offsets[j + 1]) {
+          continue;
         }
+        rows[next[j]++] = i;
       }
-    };
-    auto reductionWorker1D = [&](int64_t begin, int64_t end) -> void {
-      for (int64_t i = 0; i < N; i++) {
-        Index j = internal::SubtleMustCopy(segment_ids(i));
-        // If `j` is in work scope of this worker, do the reduction.
-        if (j >= begin && j < end) {
-          reduction(data_ptr[i], out_ptr[j]);
+    }
+
+    // Parallelize by runs of segments holding roughly the same number of
+    // input rows, so skewed ids still spread evenly. Every output row is
+    // written by exactly one worker, and a worker only visits its own rows.
+    auto reductionWorker = [&](int64_t first, int64_t last) -> void {
+      for (int64_t j = first; j < last; ++j) {
+        for (int64_t k = offsets[j]; k < offsets[j + 1]; ++k) {
+          const int64_t i = is_sorted ? k : rows[k];
+          if (is_inner_dim_1d) {
+            reduction(data_ptr[i], out_ptr[j]);
+          } else {
+            reduction(data.template chip<0>(i), output.template chip<0>(j));
+          }
         }
       }
     };
+    const std::vector<int64_t> runs = internal::BalanceSegments(
+        offsets, inner_dim, cpu_device.numThreads());
+    const int64_t num_runs = runs.size() - 1;
     // Reduction functors includes Sum, Max, Min, etc. Simply consider it
     // will cost 5 cycles per operation.
-    const int64_t kAverTaskSize = num_real_segment / num_segments;
+    const int64_t kAverTaskSize = num_real_segment / num_runs;
     const int64_t compute_cycles = 5 * inner_dim * kAverTaskSize;
     const int64_t input_bytes = sizeof(T) * inner_dim * kAverTaskSize;
     const int64_t output_bytes = sizeof(T) * inner_dim * kAverTaskSize;
     const Eigen::TensorOpCost cost(input_bytes, output_bytes, compute_cycles);
-    if (is_inner_dim_1d) {
-      cpu_device.parallelFor(num_segments, cost, reductionWorker1D);
-    } else {
-      cpu_device.parallelFor(num_segments, cost, reductionWorker);
-    }
+    cpu_device.parallelFor(num_runs, cost, [&](int64_t begin, int64_t end) {
+      for (int64_t r = begin; r < end; ++r) {
+        reductionWorker(runs[r], runs[r + 1]);
+      }
+    });
   }
 };
 
@@ -634,71 +701,77 @@ class SparseSegmentReductionOpBase : public OpKernel {
                 absl::InvalidArgumentError("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
+    std::vector<int64_t> starts;
+    std::vector<SegmentId> ids;
+    OP_REQUIRES_OK(context, internal::GetSortedSegments<SegmentId>(
+                                segment_vec, output_rows, &starts, &ids));
+
+    // Runs of whole segments with balanced index counts are reduced in
+    // parallel; segments never straddle runs, so each output row is written
+    // by exactly one thread.
+    auto* worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    const std::vector<int64_t> runs = internal::BalanceSegments(
+        starts, num_col, worker_threads->num_threads);
+    const int64_t num_runs = runs.size() - 1;
+
     // If we use DT_BFLOAT16 or DT_HALF, we need to use DT_FLOAT for
     // accumulation. We create a temp tensor to perform this accumulation for
-    // every segment.
+    // every segment, with one row per run.
     Tensor temp;
     if (input.dtype() == DT_BFLOAT16 || input.dtype() == DT_HALF) {
       TensorShape temp_shape = output_shape;
-      OP_REQUIRES_OK(context, temp_shape.SetDimWithStatus(/*d=*/0, /*size=*/1));
+      OP_REQUIRES_OK(context,
+                     temp_shape.SetDimWithStatus(/*d=*/0, /*size=*/num_runs));
       temp = tensorflow::Tensor(DT_FLOAT, temp_shape);
     }
     auto temp_flat = temp.flat_outer_dims<float>();
-
-    int64_t start = 0, end = 1;
-    // Index from which the output is not initialized.
-    SegmentId uninitialized_index = 0;
-    SegmentId out_index = internal::SubtleMustCopy(segment_vec(start));
-
-    while (true) {
-      // We initialize next_index to 0 to avoid "warning: 'next_index' may be
-      // used uninitialized in this function" in the Mac build (since the
-      // compiler isn't smart enough to realize the code is safe).
-      SegmentId next_index = 0;
-      if (end < num_indices) {
-        next_index = internal::SubtleMustCopy(segment_vec(end));
-        if (out_index == next_index) {
-          ++end;
-          continue;
+    const bool has_temp = temp.NumElements() > 0;
+
+    // The first out-of-range position in `indices` found by each run, or -1.
+    std::vector<int64_t> bad_positions(num_runs, -1);
+    auto reduce_run = [&](int64_t run) {
+      // Index from which the output is not initialized.
+      SegmentId uninitialized_index =
+          runs[run] == 0 ? 0 : ids[runs[run] - 1] + 1;
+      for (int64_t s = runs[run]; s < runs[run + 1]; ++s) {
+        const SegmentId out_index = ids[s];
+        const int64_t start = starts[s];
+        const int64_t end = starts[s + 1];
+
+        // If there is a gap between two indices, we need to set that gap to
+        // the default value.
+        if (out_index > uninitialized_index) {
+          Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
+              out_index - uninitialized_index, num_col);
+          Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                           Eigen::Unaligned>
+              gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
+          gap_slice.setConstant(default_value_);
         }
-        // We have a new segment here.  Verify that the segment ids are growing.
-        OP_REQUIRES(
-            context, out_index < next_index,
-            absl::InvalidArgumentError("segment ids are not increasing"));
-      }
 
-      OP_REQUIRES(
-          context, FastBoundsCheck(out_index, output_rows),
-          errors::InvalidArgument(
-              "Segment id ", out_index, " out of range [0, ", output_rows,
-              "), possibly because 'segment_ids' input is not sorted."));
-
-      // If there is a gap between two indices, we need to set that gap to the
-      // default value.
-      if (out_index > uninitialized_index) {
-        Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
-            out_index - uninitialized_index, num_col);
-        Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>, Eigen::Unaligned>
-            gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
-        gap_slice.setConstant(default_value_);
+        auto out = output_flat.template chip<0>(out_index);
+        auto temp = temp_flat.template chip<0>(has_temp ? run : 0);
+        const int bad_offset = Reduce<T, Index>(input_flat, indices_vec, start,
+                                                end - start, out, temp);
+        if (bad_offset >= 0) {
+          bad_positions[run] = start + bad_offset;
+          return;
+        }
+        uninitialized_index = out_index + 1;
       }
-
-      auto out = output_flat.template chip<0>(out_index);
-      auto temp = temp_flat.template chip<0>(0);
-      const int bad_offset = Reduce<T, Index>(input_flat, indices_vec, start,
-                                              end - start, out, temp);
-      OP_REQUIRES(context, bad_offset < 0,
+    };
+    Shard(worker_threads->num_threads, worker_threads->workers, num_runs,
+          num_indices / num_runs * num_col, [&](int64_t begin, int64_t end) {
+            for (int64_t run = begin; run < end; ++run) reduce_run(run);
+          });
+    for (const int64_t bad_position : bad_positions) {
+      OP_REQUIRES(context, bad_position < 0,
                   errors::InvalidArgument(
-                      "Bad: indices[", start + bad_offset,
-                      "] == ", indices_vec(start + bad_offset),
-                      " out of range [0, ", input_flat.dimension(0), ")"));
-
-      start = end;
-      ++end;
-      uninitialized_index = out_index + 1;
-      out_index = next_index;
-      if (end > num_indices) break;
+                      "Bad: indices[", bad_position,
+                      "] == ", indices_vec(bad_position), " out of range [0, ",
+                      input_flat.dimension(0), ")"));
     }
+    const SegmentId uninitialized_index = ids.back() + 1;
 
     // Fill the gap at the end with the default value.
     if (uninitialized_index < output_rows) {
@@ -60,6 +60,29 @@ absl::Status ValidateUnsortedSegmentReduction(OpKernel* op_kernel,
   return absl::OkStatus();
 }
 
+std::vector<int64_t> BalanceSegments(const std::vector<int64_t>& starts,
+                                     int64_t row_size, int num_threads) {
+  // Runs smaller than this many elements are not worth a thread.
+  constexpr int64_t kMinElementsPerRun = 1 << 15;
+  const int64_t num_segments = starts.size() - 1;
+  const int64_t num_rows = starts.back();
+  const int64_t max_runs = std::min<int64_t>(
+      {num_threads, num_segments,
+       num_rows * row_size / kMinElementsPerRun});
+  std::vector<int64_t> runs = {0};
+  for (int64_t r = 1; r < max_runs; ++r) {
+    const int64_t target = num_rows / max_runs * r;
+    const int64_t segment =
+        std::lower_bound(starts.begin(), starts.end() - 1, target) -
+        starts.begin();
+    if (segment > runs.back() && segment < num_segments) {
+      runs.push_back(segment);
+    }
+  }
+  runs.push_back(num_segments);
+  return runs;
+}
+
 absl::Status ValidateSparseSegmentReduction(OpKernelContext* context,
                                             const Tensor& input,
                                             const Tensor& indices,
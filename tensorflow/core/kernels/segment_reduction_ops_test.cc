@@ -13,7 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
+#include <random>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/device.h"
@@ -182,6 +184,76 @@ BM_Reduce_Arg(64, 32, 2);
 BM_Reduce_Arg(4096, 32, 2);
 BM_Reduce_Arg(4096, 128, 2);
 
+// Segment sizes follow a power law: a few segments hold most of the rows.
+static Tensor SkewedSegmentIds(int num_rows, int num_segments, bool sorted) {
+  Tensor ids(DT_INT32, TensorShape({num_rows}));
+  auto ids_flat = ids.flat<int32>();
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  for (int i = 0; i < num_rows; ++i) {
+    const double u = uniform(rng);
+    ids_flat(i) = static_cast<int32>(num_segments * u * u * u);
+  }
+  if (sorted) std::sort(ids_flat.data(), ids_flat.data() + num_rows);
+  return ids;
+}
+
+// Args: rows, columns, segments, and intra-op threads.
+static void BM_SkewedSegmentReduction(::testing::benchmark::State& state,
+                                      const std::string& reduction) {
+  const int num_rows = state.range(0);
+  const int num_cols = state.range(1);
+  const int num_segments = state.range(2);
+  const int num_threads = state.range(3);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor data(DT_FLOAT, TensorShape({num_rows, num_cols}));
+  data.flat<float>().setRandom();
+  const bool sorted = reduction != "UnsortedSegmentSum";
+  Tensor ids = SkewedSegmentIds(num_rows, num_segments, sorted);
+
+  NodeBuilder builder(g->NewName("n"), reduction);
+  builder.Input(test::graph::Constant(g, data));
+  if (reduction == "SparseSegmentSum") {
+    Tensor indices(DT_INT32, TensorShape({num_rows}));
+    test::FillFn<int32>(&indices, [](int i) -> int32 { return i; });
+    builder.Input(test::graph::Constant(g, indices));
+  }
+  builder.Input(test::graph::Constant(g, ids));
+  if (reduction == "UnsortedSegmentSum") {
+    builder.Input(
+        test::graph::Constant(g, test::AsScalar<int32>(num_segments)));
+  }
+  Node* node;
+  TF_CHECK_OK(builder.Finalize(g, &node));
+
+  SessionOptions opts;
+  opts.config.set_intra_op_parallelism_threads(num_threads);
+  opts.config.set_inter_op_parallelism_threads(1);
+  test::Benchmark("cpu", g, &opts, nullptr, nullptr, "",
+                  /*old_benchmark_api*/ false)
+      .Run(state);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_rows * num_cols * sizeof(float));
+}
+
+#define BM_SkewedReduce(O)                                                \
+  static void BM_Skewed_##O(::testing::benchmark::State& state) {         \
+    BM_SkewedSegmentReduction(state, #O);                                 \
+  }                                                                       \
+  BENCHMARK(BM_Skewed_##O)                                                \
+      ->UseRealTime()                                                     \
+      ->Args({1 << 16, 1, 1 << 10, 1})                                    \
+      ->Args({1 << 16, 1, 1 << 10, 16})                                   \
+      ->Args({1 << 16, 64, 1 << 10, 1})                                   \
+      ->Args({1 << 16, 64, 1 << 10, 16})                                  \
+      ->Args({1 << 20, 16, 1 << 16, 1})                                   \
+      ->Args({1 << 20, 16, 1 << 16, 16});
+
+BM_SkewedReduce(UnsortedSegmentSum);
+BM_SkewedReduce(SegmentSum);
+BM_SkewedReduce(SparseSegmentSum);
+
 template <DataType T>
 static void SparseSegmentMeanGradHelper(::testing::benchmark::State& state,
                                         float uniqueness, int size) {
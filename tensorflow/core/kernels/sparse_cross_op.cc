@@ -293,6 +293,21 @@ class OutputUpdater {
     value_vec(output_index) = cross;
   }
 
+  // Sets the indices of all `cross_count` crosses of `batch_index` and returns
+  // where their values should be written.
+  OutType* UpdateRow(const int64_t batch_index,
+                     const int64_t cross_count) const {
+    const int64_t output_index = output_start_indices_[batch_index];
+
+    auto indices_matrix = indices_out_->matrix<int64_t>();
+    for (int64_t i = 0; i < cross_count; ++i) {
+      indices_matrix(output_index + i, 0) = batch_index;
+      indices_matrix(output_index + i, 1) = i;
+    }
+
+    return values_out_->vec<OutType>().data() + output_index;
+  }
+
  private:
   const std::vector<int64_t>& output_start_indices_;
   Tensor* indices_out_;
@@ -327,6 +342,54 @@ class StringCrosser {
   const tstring k_feature_separator_;
 };
 
+// Expands the partial hashes in `hashes` with the features of columns
+// [first_column, columns.size()) of `batch_index`, one column at a time. On
+// return `hashes` holds one hash per cross, in the order generated by
+// ProductIterator.
+//
+// Each feature is fetched once per row rather than once per cross it takes
+// part in, and every step combines independent lanes with FingerprintCat64,
+// which keeps the multiplies pipelined (and vectorizable where 64-bit
+// multiplies are available).
+void ExpandCrossHashes(
+    const std::vector<std::unique_ptr<ColumnInterface<int64_t>>>& columns,
+    size_t first_column, int64_t batch_index, bool strong_hash,
+    std::vector<uint64_t>* hashes, std::vector<uint64_t>* features,
+    std::vector<uint64_t>* scratch) {
+  for (size_t i = first_column; i < columns.size(); ++i) {
+    const int64_t feature_count = columns[i]->FeatureCount(batch_index);
+    features->resize(feature_count);
+    for (int64_t n = 0; n < feature_count; ++n) {
+      (*features)[n] = columns[i]->Feature(batch_index, n, strong_hash);
+    }
+    const uint64_t* f = features->data();
+    const size_t num_partial = hashes->size();
+    scratch->resize(num_partial * feature_count);
+    uint64_t* next = scratch->data();
+    for (size_t p = 0; p < num_partial; ++p) {
+      const uint64_t partial = (*hashes)[p];
+      for (int64_t n = 0; n < feature_count; ++n) {
+        next[n] = FingerprintCat64(partial, f[n]);
+      }
+      next += feature_count;
+    }
+    hashes->swap(*scratch);
+  }
+}
+
+// Reduces the cross hashes to bucket ids.
+void HashesToBuckets(const std::vector<uint64_t>& hashes, int64_t num_buckets,
+                     int64_t* out) {
+  // To prevent negative output we take modulo to max int64 when no bucket
+  // count is given.
+  const uint64_t modulus = num_buckets > 0
+                               ? static_cast<uint64_t>(num_buckets)
+                               : std::numeric_limits<int64_t>::max();
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    out[i] = hashes[i] % modulus;
+  }
+}
+
 // Generates the sparse crosses as nested hash to avoid string manipulations.
 class HashCrosser {
  public:
@@ -336,23 +399,17 @@ class HashCrosser {
       const tstring k_feature_separator_unused)
       : columns_(columns), num_buckets_(num_buckets), hash_key_(hash_key) {}
 
-  int64_t Generate(const int64_t batch_index,
-                   const std::vector<int>& permutation,
-                   bool unused_strong_hash) const {
+  // Writes all crosses of `batch_index` to `out`, in the order generated by
+  // ProductIterator. `hashes`, `features` and `scratch` are reusable buffers.
+  void GenerateRow(const int64_t batch_index, bool unused_strong_hash,
+                   std::vector<uint64_t>* hashes,
+                   std::vector<uint64_t>* features,
+                   std::vector<uint64_t>* scratch, int64_t* out) const {
     // Do the fingerprint concatenation on uint64.
-    uint64_t hashed_output = hash_key_;
-    for (size_t i = 0; i < permutation.size(); ++i) {
-      uint64_t hash_i =
-          columns_[i]->Feature(batch_index, permutation[i], false);
-      hashed_output = FingerprintCat64(hashed_output, hash_i);
-    }
-    // The return value is int64 based on the number of buckets.
-    if (num_buckets_ > 0) {
-      return hashed_output % num_buckets_;
-    } else {
-      // To prevent negative output we take modulo to max int64.
-      return hashed_output % std::numeric_limits<int64_t>::max();
-    }
+    hashes->assign(1, hash_key_);
+    ExpandCrossHashes(columns_, 0, batch_index, false, hashes, features,
+                      scratch);
+    HashesToBuckets(*hashes, num_buckets_, out);
   }
 
  private:
@@ -370,24 +427,22 @@ class HashCrosserV2 {
       const tstring k_feature_separator_unused)
       : columns_(columns), num_buckets_(num_buckets) {}
 
-  int64_t Generate(const int64_t batch_index,
-                   const std::vector<int>& permutation,
-                   bool strong_hash) const {
-    // Do the fingerprint concatenation on uint64.
-    uint64_t hashed_output =
-        columns_[0]->Feature(batch_index, permutation[0], strong_hash);
-    for (size_t i = 1; i < permutation.size(); ++i) {
-      uint64_t hash_i =
-          columns_[i]->Feature(batch_index, permutation[i], strong_hash);
-      hashed_output = FingerprintCat64(hashed_output, hash_i);
-    }
-    // The return value is int64 based on the number of buckets.
-    if (num_buckets_ > 0) {
-      return hashed_output % num_buckets_;
-    } else {
-      // To prevent negative output we take modulo to max int64.
-      return hashed_output % std::numeric_limits<int64_t>::max();
+  // Writes all crosses of `batch_index` to `out`, in the order generated by
+  // ProductIterator. `hashes`, `features` and `scratch` are reusable buffers.
+  void GenerateRow(const int64_t batch_index, bool strong_hash,
+                   std::vector<uint64_t>* hashes,
+                   std::vector<uint64_t>* features,
+                   std::vector<uint64_t>* scratch, int64_t* out) const {
+    // Do the fingerprint concatenation on uint64, starting from the features
+    // of the first column.
+    const int64_t feature_count = columns_[0]->FeatureCount(batch_index);
+    hashes->resize(feature_count);
+    for (int64_t n = 0; n < feature_count; ++n) {
+      (*hashes)[n] = columns_[0]->Feature(batch_index, n, strong_hash);
     }
+    ExpandCrossHashes(columns_, 1, batch_index, strong_hash, hashes, features,
+                      scratch);
+    HashesToBuckets(*hashes, num_buckets_, out);
   }
 
  private:
@@ -788,14 +843,24 @@ class SparseCrossOp : public OpKernel {
     typename CrossTraits<HASHED_OUTPUT, InternalType>::Updater updater(
         output_start_indices, indices_out, values_out);
     auto do_work = [&columns, crosser, updater](int64_t begin, int64_t end) {
-      for (int b = begin; b < end; b++) {
-        ProductIterator<InternalType> product_iterator(columns, b);
-        int64_t cross_count = 0;
-        while (product_iterator.HasNext()) {
-          const auto permutation = product_iterator.Next();
-          updater.Update(b, cross_count,
-                         crosser.Generate(b, permutation, false));
-          cross_count++;
+      if constexpr (HASHED_OUTPUT) {
+        std::vector<uint64_t> hashes, features, scratch;
+        for (int64_t b = begin; b < end; b++) {
+          const int64_t cross_count = CrossCountByBatchIndex(columns, b);
+          if (cross_count == 0) continue;
+          crosser.GenerateRow(b, false, &hashes, &features, &scratch,
+                              updater.UpdateRow(b, cross_count));
+        }
+      } else {
+        for (int b = begin; b < end; b++) {
+          ProductIterator<InternalType> product_iterator(columns, b);
+          int64_t cross_count = 0;
+          while (product_iterator.HasNext()) {
+            const auto permutation = product_iterator.Next();
+            updater.Update(b, cross_count,
+                           crosser.Generate(b, permutation, false));
+            cross_count++;
+          }
         }
       }
     };
@@ -940,15 +1005,12 @@ class SparseCrossHashedOp : public OpKernel {
                                    values_out);
     auto do_work = [&columns, crosser, updater, strong_hash](int64_t begin,
                                                              int64_t end) {
-      for (int b = begin; b < end; b++) {
-        ProductIterator<int64_t> product_iterator(columns, b);
-        int64_t cross_count = 0;
-        while (product_iterator.HasNext()) {
-          const auto permutation = product_iterator.Next();
-          updater.Update(b, cross_count,
-                         crosser.Generate(b, permutation, strong_hash));
-          cross_count++;
-        }
+      std::vector<uint64_t> hashes, features, scratch;
+      for (int64_t b = begin; b < end; b++) {
+        const int64_t cross_count = CrossCountByBatchIndex(columns, b);
+        if (cross_count == 0) continue;
+        crosser.GenerateRow(b, strong_hash, &hashes, &features, &scratch,
+                            updater.UpdateRow(b, cross_count));
       }
     };
 
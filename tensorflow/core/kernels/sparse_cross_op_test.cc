@@ -0,0 +1,140 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+class SparseCrossHashedOpTest : public OpsTestBase {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("sparse_cross_hashed", "SparseCrossHashed")
+                     .Input(FakeInput(1, DT_INT64))
+                     .Input(FakeInput({DT_STRING}))
+                     .Input(FakeInput(1, DT_INT64))
+                     .Input(FakeInput({DT_STRING}))
+                     .Input(FakeInput(DT_INT64))
+                     .Input(FakeInput(DT_BOOL))
+                     .Input(FakeInput(DT_INT64))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+uint64_t Cross(const std::string& a, const std::string& b) {
+  return FingerprintCat64(Fingerprint64(a), Fingerprint64(b)) %
+         std::numeric_limits<int64_t>::max();
+}
+
+TEST_F(SparseCrossHashedOpTest, CrossesInProductOrder) {
+  MakeOp();
+  // Sparse column: row 0 has {a, b}, row 1 has {c}.
+  AddInputFromArray<int64_t>(TensorShape({3, 2}), {0, 0, 0, 1, 1, 0});
+  AddInputFromArray<tstring>(TensorShape({3}), {"a", "b", "c"});
+  AddInputFromArray<int64_t>(TensorShape({2}), {2, 2});
+  // Dense column.
+  AddInputFromArray<tstring>(TensorShape({2, 2}), {"x", "y", "z", "w"});
+  AddInputFromArray<int64_t>(TensorShape({}), {0});
+  AddInputFromArray<bool>(TensorShape({}), {false});
+  AddInputFromArray<int64_t>(TensorShape({2}), {1, 2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>({0, 0, 0, 1, 0, 2, 0, 3, 1, 0, 1, 1},
+                              TensorShape({6, 2})));
+  const std::vector<uint64_t> expected = {
+      Cross("a", "x"), Cross("a", "y"), Cross("b", "x"),
+      Cross("b", "y"), Cross("c", "z"), Cross("c", "w")};
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(1),
+      test::AsTensor<int64_t>(
+          std::vector<int64_t>(expected.begin(), expected.end())));
+  test::ExpectTensorEqual<int64_t>(*GetOutput(2),
+                                   test::AsTensor<int64_t>({2, 4}));
+}
+
+// Args: batch size, number of dense string columns, and features per column
+// in every row; each row produces features^columns crosses.
+void BM_SparseCrossHashed(::testing::benchmark::State& state) {
+  const int batch_size = state.range(0);
+  const int num_columns = state.range(1);
+  const int num_features = state.range(2);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  std::mt19937_64 rng(0);
+  std::vector<NodeBuilder::NodeOut> dense_inputs;
+  for (int i = 0; i < num_columns; ++i) {
+    Tensor column(DT_STRING, TensorShape({batch_size, num_features}));
+    auto column_flat = column.flat<tstring>();
+    for (int j = 0; j < column_flat.size(); ++j) {
+      column_flat(j) = absl::StrCat("feature_", rng() % 100000);
+    }
+    dense_inputs.emplace_back(test::graph::Constant(g, column));
+  }
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "SparseCrossHashed")
+                  .Input(std::vector<NodeBuilder::NodeOut>{})
+                  .Input(std::vector<NodeBuilder::NodeOut>{})
+                  .Input(std::vector<NodeBuilder::NodeOut>{})
+                  .Input(dense_inputs)
+                  .Input(test::graph::Constant(g, test::AsScalar<int64_t>(0)))
+                  .Input(test::graph::Constant(g, test::AsScalar<bool>(false)))
+                  .Input(test::graph::Constant(
+                      g, test::AsTensor<int64_t>({1, 2})))
+                  .Attr("N", 0)
+                  .Attr("sparse_types", DataTypeVector{})
+                  .Finalize(g, &node));
+
+  test::Benchmark("cpu", g, /*old_benchmark_api*/ false).Run(state);
+  int64_t crosses_per_row = 1;
+  for (int i = 0; i < num_columns; ++i) crosses_per_row *= num_features;
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          batch_size * crosses_per_row);
+}
+
+BENCHMARK(BM_SparseCrossHashed)
+    ->UseRealTime()
+    ->Args({1024, 2, 4})
+    ->Args({1024, 4, 4})
+    ->Args({8192, 2, 4})
+    ->Args({8192, 3, 8})
+    ->Args({8192, 8, 2})
+    ->Args({65536, 2, 1})
+    ->Args({65536, 4, 2});
+
+}  // namespace
+}  // namespace tensorflow
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -44,18 +45,32 @@ class StringToHashBucketOp : public OpKernel {
                                             &output_tensor));
     auto output_flat = output_tensor->flat<int64_t>();
 
-    typedef decltype(input_flat.size()) Index;
-    for (Index i = 0; i < input_flat.size(); ++i) {
-      const uint64_t input_hash = hash(input_flat(i));
-      const uint64_t bucket_id = input_hash % num_buckets_;
-      // The number of buckets is always in the positive range of int64 so is
-      // the resulting bucket_id. Casting the bucket_id from uint64 to int64 is
-      // safe.
-      output_flat(i) = static_cast<int64_t>(bucket_id);
-    }
+    const tstring* input = input_flat.data();
+    int64_t* output = output_flat.data();
+    const uint64_t num_buckets = num_buckets_;
+    auto hash_range = [input, output, num_buckets](int64_t start,
+                                                   int64_t limit) {
+      for (int64_t i = start; i < limit; ++i) {
+        const uint64_t input_hash = hash(input[i]);
+        const uint64_t bucket_id = input_hash % num_buckets;
+        // The number of buckets is always in the positive range of int64 so
+        // is the resulting bucket_id. Casting the bucket_id from uint64 to
+        // int64 is safe.
+        output[i] = static_cast<int64_t>(bucket_id);
+      }
+    };
+
+    // Hashing is independent per element, so large inputs are split across
+    // the intra-op pool.
+    auto* worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers,
+          input_flat.size(), kCostPerElement, hash_range);
   }
 
  private:
+  // Roughly the cost of fingerprinting a short string.
+  static constexpr int64_t kCostPerElement = 100;
+
   int64_t num_buckets_;
 
   StringToHashBucketOp(const StringToHashBucketOp&) = delete;
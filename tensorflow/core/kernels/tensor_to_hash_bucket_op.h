@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <string>
 
+#include "absl/strings/str_cat.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -38,9 +39,13 @@ struct LaunchTensorToHashBucket {
                   const int num_elems, int64_t* output) {
     switch (DataTypeToEnum<T>::value) {
       case DT_INT8:
+      case DT_UINT8:
       case DT_INT16:
+      case DT_UINT16:
       case DT_INT32:
+      case DT_UINT32:
       case DT_INT64:
+      case DT_UINT64:
         break;
       default:
         bool type_not_supported = true;
@@ -51,8 +56,10 @@ struct LaunchTensorToHashBucket {
     }
 
     for (int i = 0; i < num_elems; ++i) {
-      std::string input_str = absl::StrFormat("%d", input[i]);
-      const uint64_t input_hash = Fingerprint64(input_str);
+      // AlphaNum formats into an inline buffer, producing the same digits as
+      // "%d" without allocating a string per element.
+      const absl::AlphaNum input_str(input[i]);
+      const uint64_t input_hash = Fingerprint64(input_str.Piece());
       const uint64_t bucket_id = input_hash % num_buckets;
       // The number of buckets is always in the positive range of int64 so is
       // the resulting bucket_id. Casting the bucket_id from uint64 to int64 is
@@ -0,0 +1,95 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int64_t kNumBuckets = 1 << 20;
+
+class TensorToHashBucketOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(DataType dtype) {
+    TF_ASSERT_OK(NodeDefBuilder("hash", "_TensorToHashBucketFast")
+                     .Input(FakeInput(dtype))
+                     .Attr("num_buckets", kNumBuckets)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+// The bucket ids computed by the kernel before it stopped going through a
+// string per element.
+template <typename T>
+std::vector<int64_t> ExpectedBuckets(const std::vector<T>& values) {
+  std::vector<int64_t> buckets;
+  for (const T value : values) {
+    buckets.push_back(Fingerprint64(absl::StrFormat("%d", value)) %
+                      kNumBuckets);
+  }
+  return buckets;
+}
+
+TEST_F(TensorToHashBucketOpTest, Int64) {
+  const std::vector<int64_t> values = {
+      0, 1, -1, std::numeric_limits<int64_t>::min(),
+      std::numeric_limits<int64_t>::max()};
+  MakeOp(DT_INT64);
+  AddInputFromArray<int64_t>(TensorShape({5}), values);
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>(ExpectedBuckets(values), TensorShape({5})));
+}
+
+TEST_F(TensorToHashBucketOpTest, Uint64AboveInt64Max) {
+  const std::vector<uint64_t> values = {
+      0, uint64_t{1} << 63, std::numeric_limits<uint64_t>::max()};
+  MakeOp(DT_UINT64);
+  AddInputFromArray<uint64_t>(TensorShape({3}), values);
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>(ExpectedBuckets(values), TensorShape({3})));
+}
+
+TEST_F(TensorToHashBucketOpTest, Int8) {
+  const std::vector<int8_t> values = {0, -128, 127};
+  MakeOp(DT_INT8);
+  AddInputFromArray<int8_t>(TensorShape({3}), values);
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>(ExpectedBuckets(values), TensorShape({3})));
+}
+
+}  // namespace
+}  // namespace tensorflow
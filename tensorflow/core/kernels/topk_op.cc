@@ -130,6 +130,115 @@ class TopK : public OpKernel {
   bool sorted_;
 };
 
+namespace {
+
+// Rows with at least this many columns may be split across threads when
+// there are fewer rows than threads.
+constexpr int64_t kMinColsPerSegment = 1 << 15;
+
+// Orders column indices of `data` by decreasing value, breaking ties by
+// increasing index.
+template <typename T>
+struct StableGreater {
+  const T* data;
+  template <typename Tidx>
+  bool operator()(const Tidx a, const Tidx b) const {
+    if (data[b] < data[a]) {
+      return true;
+    } else if (data[b] > data[a]) {
+      return false;
+    } else {
+      return a < b;
+    }
+  }
+};
+
+// Appends the indices of the top `k` values of data[begin, end) to `out`, in
+// no particular order.
+//
+// Columns are visited in increasing order, so once `k` candidates are held
+// only values strictly greater than the current k-th value can enter. Blocks
+// of values that cannot are rejected with a branch-free comparison that the
+// compiler vectorizes; for random inputs almost every block is rejected.
+template <typename T, typename Tidx>
+void SegmentTopK(const T* data, int64_t begin, int64_t end, int k,
+                 std::vector<Tidx>* out) {
+  constexpr int kBlock = 16;
+  const StableGreater<T> comp{data};
+  gtl::TopN<Tidx, StableGreater<T>> filter(k, comp);
+  int64_t c = begin;
+  for (; c < end && filter.size() < static_cast<size_t>(k); ++c) {
+    filter.push(static_cast<Tidx>(c));
+  }
+  if (c == end) {
+    out->insert(out->end(), filter.unsorted_begin(), filter.unsorted_end());
+    return;
+  }
+  T threshold = data[filter.peek_bottom()];
+  const auto push = [&](int64_t col) {
+    if (data[col] > threshold) {
+      filter.push(static_cast<Tidx>(col));
+      threshold = data[filter.peek_bottom()];
+    }
+  };
+  for (; c + kBlock <= end; c += kBlock) {
+    bool any = false;
+    for (int j = 0; j < kBlock; ++j) {
+      any |= data[c + j] > threshold;
+    }
+    if (!any) continue;
+    for (int j = 0; j < kBlock; ++j) push(c + j);
+  }
+  for (; c < end; ++c) push(c);
+  out->insert(out->end(), filter.unsorted_begin(), filter.unsorted_end());
+}
+
+// Computes the top `k` of every row by splitting each row into
+// `num_segments` column ranges that are reduced independently on the thread
+// pool, then merging the per-segment candidates. The merge sorts by the same
+// value-then-index order as the single-threaded path, so the results are
+// identical to the sorted output, which is also valid when `sorted` is false.
+template <typename T, typename Tidx>
+void SplitRowTopK(OpKernelContext* context, int k,
+                  const typename TTypes<T, 2>::ConstTensor& input,
+                  const int64_t num_rows, const int64_t num_cols,
+                  const int64_t num_segments,
+                  typename TTypes<T, 2>::Tensor values,
+                  typename TTypes<Tidx, 2>::Tensor indices) {
+  const int64_t segment_size = (num_cols + num_segments - 1) / num_segments;
+  std::vector<std::vector<Tidx>> candidates(num_rows * num_segments);
+  auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+  Shard(worker_threads.num_threads, worker_threads.workers,
+        num_rows * num_segments, /*cost_per_unit=*/4 * segment_size,
+        [&](int64_t start, int64_t limit) {
+          for (int64_t i = start; i < limit; ++i) {
+            const int64_t row = i / num_segments;
+            const int64_t begin = (i % num_segments) * segment_size;
+            const int64_t end = std::min(num_cols, begin + segment_size);
+            candidates[i].reserve(k);
+            SegmentTopK<T, Tidx>(&input(row, 0), begin, end, k,
+                                 &candidates[i]);
+          }
+        });
+
+  for (int64_t row = 0; row < num_rows; ++row) {
+    std::vector<Tidx>& merged = candidates[row * num_segments];
+    for (int64_t i = 1; i < num_segments; ++i) {
+      std::vector<Tidx>& segment = candidates[row * num_segments + i];
+      merged.insert(merged.end(), segment.begin(), segment.end());
+      std::vector<Tidx>().swap(segment);
+    }
+    std::partial_sort(merged.begin(), merged.begin() + k, merged.end(),
+                      StableGreater<T>{&input(row, 0)});
+    for (int i = 0; i < k; ++i) {
+      indices(row, i) = merged[i];
+      values(row, i) = input(row, merged[i]);
+    }
+  }
+}
+
+}  // namespace
+
 namespace functor {
 
 template <typename T, typename Tidx>
@@ -164,6 +273,22 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
       return absl::OkStatus();
     }
 
+    // Long rows that cannot keep the pool busy on their own are split into
+    // column segments, each much longer than k.
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    if (k < num_cols && num_rows < worker_threads.num_threads) {
+      const int64_t max_segments =
+          num_cols / std::max<int64_t>(kMinColsPerSegment, 8 * int64_t{k});
+      const int64_t num_segments = std::min(
+          max_segments,
+          (worker_threads.num_threads + num_rows - 1) / num_rows);
+      if (num_segments > 1) {
+        SplitRowTopK<T, Tidx>(context, k, input, num_rows, num_cols,
+                              num_segments, values, indices);
+        return absl::OkStatus();
+      }
+    }
+
     auto SortIndices = [&](int64_t start_batch, int64_t limit_batch) {
       for (int32_t b = start_batch; b < limit_batch; ++b) {
         const T* input_data = &input(b, 0);
@@ -251,7 +376,6 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
         (total_cost >= static_cast<double>(std::numeric_limits<int64_t>::max()))
             ? std::numeric_limits<int64_t>::max()
             : static_cast<int64_t>(total_cost);
-    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
@@ -17,6 +17,9 @@ limitations under the License.
 #include "tensorflow/core/kernels/training_ops.h"
 
 #include <algorithm>  // NOLINT
+#include <cmath>
+#include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
@@ -42,6 +45,97 @@ inline T sgn(const T x) {
   T one(1);
   return (x == zero ? zero : (x < zero ? -one : one));
 }
+
+// Approximate cost of one comparison, including moving the elements, when
+// sorting the gradient slices by row.
+constexpr double kCyclesPerSortComparison = 8;
+
+// Calls `update(i, indices(i))` for every gradient slice `i` on the threads
+// of `d`. All indices must already be validated. `cost` is the cost of a
+// single update.
+//
+// Slices are grouped by row so that each row is owned by a single thread and
+// its updates run in their original order: the result matches a sequential
+// loop while distinct rows are updated in parallel. Unique indices shard over
+// the slices directly. Grouping sorts the slices on the calling thread, so
+// slices that are too cheap to update to amortize the sort, e.g. narrow rows,
+// are applied sequentially instead.
+template <typename Tindex, typename UpdateFn>
+void ParallelSparseApply(const CPUDevice& d,
+                         typename TTypes<Tindex>::ConstVec indices,
+                         const Eigen::TensorOpCost& cost, UpdateFn update) {
+  const Tindex N = static_cast<Tindex>(indices.dimension(0));
+  if (N == 0) return;
+  const auto apply_slices = [&](Index start, Index end) {
+    for (Index i = start; i < end; ++i) {
+      update(static_cast<Tindex>(i), internal::SubtleMustCopy(indices(i)));
+    }
+  };
+  const int num_threads =
+      Eigen::TensorCostModel<CPUDevice>::numThreads(N, cost, d.numThreads());
+  if (num_threads == 1) {
+    apply_slices(0, N);
+    return;
+  }
+
+  bool unique = true;
+  for (Tindex i = 1; i < N && unique; ++i) {
+    unique = indices(i - 1) < indices(i);
+  }
+  if (unique) {
+    d.parallelFor(N, cost, apply_slices);
+    return;
+  }
+  // Per slice, parallel updates save `(1 - 1 / num_threads)` of an update and
+  // sorting costs about log2(N) comparisons.
+  const double saved_cycles =
+      Eigen::TensorCostModel<CPUDevice>::totalCost(/*output_size=*/1, cost) *
+      (1.0 - 1.0 / num_threads);
+  const double sort_cycles =
+      kCyclesPerSortComparison * std::log2(static_cast<double>(N));
+  if (saved_cycles <= sort_cycles) {
+    apply_slices(0, N);
+    return;
+  }
+
+  // Sorting (row, slice) pairs keeps the slices of a row in their original
+  // order.
+  std::vector<std::pair<Tindex, Tindex>> slices(N);
+  for (Tindex i = 0; i < N; ++i) {
+    slices[i] = {internal::SubtleMustCopy(indices(i)), i};
+  }
+  std::sort(slices.begin(), slices.end());
+  std::vector<Tindex> row_starts;
+  for (Tindex i = 0; i < N; ++i) {
+    if (i == 0 || slices[i].first != slices[i - 1].first) {
+      row_starts.push_back(i);
+    }
+  }
+  const Index num_rows = row_starts.size();
+  row_starts.push_back(N);
+  const auto apply_rows = [&](Index start, Index end) {
+    for (Index row = start; row < end; ++row) {
+      for (Tindex j = row_starts[row]; j < row_starts[row + 1]; ++j) {
+        update(slices[j].second, slices[j].first);
+      }
+    }
+  };
+  d.parallelFor(num_rows, cost * (static_cast<double>(N) / num_rows),
+                apply_rows);
+}
+
+// Cost of updating one row of `inner_dim` elements that reads `num_inputs`
+// and writes `num_outputs` tensors with roughly `ops_per_element` arithmetic
+// operations per element.
+template <typename T>
+Eigen::TensorOpCost SparseRowCost(int64_t inner_dim, int num_inputs,
+                                  int num_outputs, int ops_per_element) {
+  return Eigen::TensorOpCost(
+      inner_dim * sizeof(T) * num_inputs, inner_dim * sizeof(T) * num_outputs,
+      inner_dim * ops_per_element *
+          (Eigen::TensorOpCost::AddCost<T>() +
+           Eigen::TensorOpCost::MulCost<T>()) / 2);
+}
 }  // namespace
 
 namespace functor {
@@ -183,61 +277,44 @@ struct SparseApplyAdagrad<CPUDevice, T, Tindex, has_epsilon> {
                                     Eigen::TensorOpCost::MulCost<T>() * 2);
     const Eigen::TensorOpCost cost(in_bytes, out_bytes, cycles);
 
-    if (inner_dim > 1) {
-      for (Tindex i = 0; i < N; ++i) {
-        const Tindex index = internal::SubtleMustCopy(indices(i));
-        if (!FastBoundsCheck(index, first_dim_size)) {
-          return errors::InvalidArgument(
-              strings::StrCat("Index ", index, " at offset ", i,
-                              " in indices is out of range"));
-        }
+    for (Tindex i = 0; i < N; ++i) {
+      const Tindex index = internal::SubtleMustCopy(indices(i));
+      if (!FastBoundsCheck(index, first_dim_size)) {
+        return errors::InvalidArgument(
+            strings::StrCat("Index ", index, " at offset ", i,
+                            " in indices is out of range"));
       }
+    }
 
-      const auto shard = [&](Tindex start_idx, Tindex end_idx) -> void {
-        for (Tindex i = start_idx; i < end_idx; ++i) {
-          const Tindex index = internal::SubtleMustCopy(indices(i));
-          auto a = accum.template chip<0>(index);
-          auto g = grad.template chip<0>(i);
-          auto v = var.template chip<0>(index);
-          if (update_slots) {
-            a += g.square();
-          }
-          if (has_epsilon) {
-            v -= g.constant(lr_scalar) * g / (a.sqrt() + a.constant(epsilon()));
-          } else {
-            v -= g.constant(lr_scalar) * g * a.rsqrt();
-          }
+    if (inner_dim > 1) {
+      const auto update = [&](Tindex i, Tindex index) {
+        auto a = accum.template chip<0>(index);
+        auto g = grad.template chip<0>(i);
+        auto v = var.template chip<0>(index);
+        if (update_slots) {
+          a += g.square();
+        }
+        if (has_epsilon) {
+          v -= g.constant(lr_scalar) * g / (a.sqrt() + a.constant(epsilon()));
+        } else {
+          v -= g.constant(lr_scalar) * g * a.rsqrt();
         }
       };
-
-      d.parallelFor(N, cost, shard);
+      ParallelSparseApply<Tindex>(d, indices, cost, update);
     } else {
-      for (Tindex i = 0; i < N; ++i) {
-        const Tindex index = internal::SubtleMustCopy(indices(i));
-        if (!FastBoundsCheck(index, first_dim_size)) {
-          return errors::InvalidArgument(
-              strings::StrCat("Index ", index, " at offset ", i,
-                              " in indices is out of range"));
+      const auto update = [&](Tindex i, Tindex index) {
+        T& a = accum(index);
+        const T& g = grad(i);
+        if (update_slots) {
+          a += g * g;
         }
-      }
-
-      const auto shard = [&](Tindex start_idx, Tindex end_idx) -> void {
-        for (Tindex i = start_idx; i < end_idx; ++i) {
-          const Tindex index = internal::SubtleMustCopy(indices(i));
-          T& a = accum(index);
-          const T& g = grad(i);
-          if (update_slots) {
-            a += g * g;
-          }
-          if (has_epsilon) {
-            var(index) -= lr_scalar * g / (Eigen::numext::sqrt(a) + epsilon());
-          } else {
-            var(index) -= lr_scalar * g / Eigen::numext::sqrt(a);
-          }
+        if (has_epsilon) {
+          var(index) -= lr_scalar * g / (Eigen::numext::sqrt(a) + epsilon());
+        } else {
+          var(index) -= lr_scalar * g / Eigen::numext::sqrt(a);
         }
       };
-
-      d.parallelFor(N, cost, shard);
+      ParallelSparseApply<Tindex>(d, indices, cost, update);
     }
 
     return absl::OkStatus();
@@ -288,14 +365,20 @@ struct SparseApplyProximalAdagrad<CPUDevice, T, Tindex> {
     const T lr_scalar = lr();
     const T l1_scalar = l1();
     const T l2_scalar = l2();
+    for (Tindex i = 0; i < N; i++) {
+      const Tindex index = internal::SubtleMustCopy(indices(i));
+      if (!FastBoundsCheck(index, first_dim_size)) {
+        return errors::InvalidArgument(
+            strings::StrCat("Index ", index, " at offset ", i,
+                            " in indices is out of range"));
+      }
+    }
+    const Eigen::TensorOpCost cost =
+        SparseRowCost<T>(inner_dim, /*num_inputs=*/3, /*num_outputs=*/2,
+                         /*ops_per_element=*/12);
+
     if (inner_dim > 1) {
-      for (Tindex i = 0; i < N; i++) {
-        const Tindex index = internal::SubtleMustCopy(indices(i));
-        if (!FastBoundsCheck(index, first_dim_size)) {
-          return errors::InvalidArgument(
-              strings::StrCat("Index ", index, " at offset ", i,
-                              " in indices is out of range"));
-        }
+      const auto update = [&](Tindex i, Tindex index) {
         auto a = accum.template chip<0>(index);
         auto g = grad.template chip<0>(i);
         auto v = var.template chip<0>(index);
@@ -315,15 +398,10 @@ struct SparseApplyProximalAdagrad<CPUDevice, T, Tindex> {
           v = prox_v /
               (v.constant(1.0) + v.constant(l2_scalar) * learning_rate);
         }
-      }
+      };
+      ParallelSparseApply<Tindex>(d, indices, cost, update);
     } else {
-      for (Tindex i = 0; i < N; i++) {
-        const Tindex index = internal::SubtleMustCopy(indices(i));
-        if (!FastBoundsCheck(index, first_dim_size)) {
-          return errors::InvalidArgument(
-              strings::StrCat("Index ", index, " at offset ", i,
-                              " in indices is out of range"));
-        }
+      const auto update = [&](Tindex i, Tindex index) {
         T& a = accum(index);
         const T& g = grad(i);
         a += g * g;
@@ -338,7 +416,8 @@ struct SparseApplyProximalAdagrad<CPUDevice, T, Tindex> {
         } else {
           var(index) = prox_v / (1.0 + l2_scalar * learning_rate);
         }
-      }
+      };
+      ParallelSparseApply<Tindex>(d, indices, cost, update);
     }
     return absl::OkStatus();
   }
@@ -611,17 +690,23 @@ struct SparseApplyFtrl<CPUDevice, T, Tindex, has_l2_shrinkage> {
         l2_shrinkage_scalar = l2_shrinkage();
       }
       T lr_power_scalar = lr_power();
-      if (inner_dim > 1) {
-        const Tindex first_dim_size =
-            static_cast<Tindex>(var_flat.dimension(0));
+      const Tindex first_dim_size =
+          inner_dim > 1 ? static_cast<Tindex>(var_flat.dimension(0))
+                        : static_cast<Tindex>(accum_flat.size());
+      for (Tindex i = 0; i < N; i++) {
+        const Tindex index = internal::SubtleMustCopy(indices_vec(i));
+        if (!FastBoundsCheck(index, first_dim_size)) {
+          return errors::InvalidArgument(
+              strings::StrCat("Index ", index, " at offset ", i,
+                              " in indices is out of range"));
+        }
+      }
+      const Eigen::TensorOpCost cost =
+          SparseRowCost<T>(inner_dim, /*num_inputs=*/4, /*num_outputs=*/3,
+                           /*ops_per_element=*/20);
 
-        for (Tindex i = 0; i < N; i++) {
-          const Tindex index = internal::SubtleMustCopy(indices_vec(i));
-          if (!FastBoundsCheck(index, first_dim_size)) {
-            return errors::InvalidArgument(
-                strings::StrCat("Index ", index, " at offset ", i,
-                                " in indices is out of range"));
-          }
+      if (inner_dim > 1) {
+        const auto update = [&](Tindex i, Tindex index) {
           auto accum = accum_flat.template chip<0>(index);
           auto linear = linear_flat.template chip<0>(index);
           auto grad = grad_flat.template chip<0>(i);
@@ -645,17 +730,10 @@ struct SparseApplyFtrl<CPUDevice, T, Tindex, has_l2_shrinkage> {
                         /*lr_power_scalar=*/lr_power_scalar,
                         /*lr_scalar=*/lr_scalar);
           }
-        }
+        };
+        ParallelSparseApply<Tindex>(d, indices_vec, cost, update);
       } else {
-        const Tindex first_dim_size = accum_flat.size();
-
-        for (Tindex i = 0; i < N; i++) {
-          const Tindex index = internal::SubtleMustCopy(indices_vec(i));
-          if (!FastBoundsCheck(index, first_dim_size)) {
-            return errors::InvalidArgument(
-                strings::StrCat("Index ", index, " at offset ", i,
-                                " in indices is out of range"));
-          }
+        const auto update = [&](Tindex i, Tindex index) {
           T& a = accum_flat(index);
           T& l = linear_flat(index);
           T& v = var_flat(index);
@@ -679,7 +757,8 @@ struct SparseApplyFtrl<CPUDevice, T, Tindex, has_l2_shrinkage> {
                           lr_power_scalar, multiply_linear_by_lr);
           a = updated_a;
           l = updated_l;
-        }
+        };
+        ParallelSparseApply<Tindex>(d, indices_vec, cost, update);
       }
     }
     return absl::OkStatus();
@@ -732,6 +811,11 @@ struct SparseApplyKerasMomentum<CPUDevice, T, Tindex> {
     for (Tindex i = 0; i < N; i++) {
       const Tindex index = internal::SubtleMustCopy(indices(i));
       if (!FastBoundsCheck(index, first_dim_size)) return i;
+    }
+    const Eigen::TensorOpCost cost =
+        SparseRowCost<T>(var.dimension(1), /*num_inputs=*/3,
+                         /*num_outputs=*/2, /*ops_per_element=*/6);
+    ParallelSparseApply<Tindex>(d, indices, cost, [&](Tindex i, Tindex index) {
       auto a = accum.template chip<0>(index);
       auto g = grad.template chip<0>(i);
       auto v = var.template chip<0>(index);
@@ -741,7 +825,7 @@ struct SparseApplyKerasMomentum<CPUDevice, T, Tindex> {
       } else {
         v += a;
       }
-    }
+    });
     return -1;
   }
 };
@@ -756,9 +840,10 @@ struct SparseApplyAdadelta<CPUDevice, T, Tindex> {
                   typename TTypes<T>::ConstScalar epsilon,
                   typename TTypes<T>::ConstMatrix grad,
                   typename TTypes<Tindex>::ConstFlat indices) {
-    const Tindex N = static_cast<Tindex>(indices.size());
-    for (Tindex i = 0; i < N; i++) {
-      const Tindex index = indices(i);
+    const Eigen::TensorOpCost cost =
+        SparseRowCost<T>(var.dimension(1), /*num_inputs=*/4,
+                         /*num_outputs=*/3, /*ops_per_element=*/16);
+    ParallelSparseApply<Tindex>(d, indices, cost, [&](Tindex i, Tindex index) {
       auto a = accum.template chip<0>(index);
       auto a_update = accum_update.template chip<0>(index);
       auto g = grad.template chip<0>(i);
@@ -770,7 +855,7 @@ struct SparseApplyAdadelta<CPUDevice, T, Tindex> {
       v -= update * update.constant(lr());
       a_update = a_update * a_update.constant(rho()) +
                  update.square() * update.constant(static_cast<T>(1) - rho());
-    }
+    });
   }
 };
 
@@ -3293,6 +3378,12 @@ class SparseApplyMomentumOp : public OpKernel {
                     errors::InvalidArgument(
                         strings::StrCat("Index ", index, " at offset ", i,
                                         " in indices is out of range")));
+      }
+
+      const Eigen::TensorOpCost cost =
+          SparseRowCost<T>(var_flat.dimension(1), /*num_inputs=*/3,
+                           /*num_outputs=*/2, /*ops_per_element=*/6);
+      const auto update = [&](Tindex i, Tindex index) {
         auto a = accum_flat.template chip<0>(index);
         auto g = grad_flat.template chip<0>(i);
         auto v = var_flat.template chip<0>(index);
@@ -3303,7 +3394,9 @@ class SparseApplyMomentumOp : public OpKernel {
         } else {
           v -= a.constant(lr_scalar) * a;
         }
-      }
+      };
+      ParallelSparseApply<Tindex>(ctx->eigen_device<CPUDevice>(), indices_vec,
+                                  cost, update);
     }
 
     MaybeForwardRefInputToRefOutput(ctx, 0, 0);
@@ -4356,9 +4449,10 @@ class SparseApplyRMSPropOp : public OpKernel {
       const T epsilon_scalar = epsilon.scalar<T>()();
       const T momentum_scalar = momentum.scalar<T>()();
 
-      for (Tindex i = 0; i < N; i++) {
-        const Tindex index = indices_vec(i);
-
+      const Eigen::TensorOpCost cost =
+          SparseRowCost<T>(var_flat.dimension(1), /*num_inputs=*/4,
+                           /*num_outputs=*/3, /*ops_per_element=*/12);
+      const auto update = [&](Tindex i, Tindex index) {
         auto ms_ = ms_flat.template chip<0>(index);
         auto mom_ = mom_flat.template chip<0>(index);
         auto grad_ = grad_flat.template chip<0>(i);
@@ -4371,7 +4465,9 @@ class SparseApplyRMSPropOp : public OpKernel {
 
         auto v = var_flat.template chip<0>(index);
         v -= mom_;
-      }
+      };
+      ParallelSparseApply<Tindex>(ctx->eigen_device<CPUDevice>(), indices_vec,
+                                  cost, update);
     }
 
     MaybeForwardRefInputToRefOutput(ctx, 0, 0);
@@ -4502,9 +4598,10 @@ class SparseApplyCenteredRMSPropOp : public OpKernel {
       const T epsilon_scalar = epsilon.scalar<T>()();
       const T momentum_scalar = momentum.scalar<T>()();
 
-      for (Tindex i = 0; i < N; i++) {
-        const Tindex index = indices_vec(i);
-
+      const Eigen::TensorOpCost cost =
+          SparseRowCost<T>(var_flat.dimension(1), /*num_inputs=*/5,
+                           /*num_outputs=*/4, /*ops_per_element=*/16);
+      const auto update = [&](Tindex i, Tindex index) {
         auto ms_ = ms_flat.template chip<0>(index);
         auto mom_ = mom_flat.template chip<0>(index);
         auto grad_ = grad_flat.template chip<0>(i);
@@ -4520,7 +4617,9 @@ class SparseApplyCenteredRMSPropOp : public OpKernel {
                denom_.rsqrt() * ms_.constant(lr_scalar) * grad_;
         auto v = var_flat.template chip<0>(index);
         v -= mom_;
-      }
+      };
+      ParallelSparseApply<Tindex>(ctx->eigen_device<CPUDevice>(), indices_vec,
+                                  cost, update);
     }
 
     MaybeForwardRefInputToRefOutput(ctx, 0, 0);
@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <random>
+
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/ops_util.h"
@@ -420,4 +422,128 @@ static void BM_PowerSign(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_PowerSign)->Arg(128 << 10)->Arg(256 << 10);
 
+static Node* Fill(Graph* g, int m, int n, float val) {
+  Tensor data(DT_FLOAT, TensorShape({m, n}));
+  data.flat<float>().setConstant(val);
+  return test::graph::Constant(g, data);
+}
+
+// Returns `k` indices into `m` rows. With `duplicates`, indices are drawn
+// uniformly at random so rows repeat; otherwise they are 0, 1, ..., k - 1.
+static Node* SparseIndices(Graph* g, int k, int m, bool duplicates) {
+  Tensor data(DT_INT32, TensorShape({k}));
+  auto indices = data.flat<int32_t>();
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int32_t> dist(0, m - 1);
+  for (int i = 0; i < k; ++i) indices(i) = duplicates ? dist(rng) : i;
+  return test::graph::Constant(g, data);
+}
+
+static void SparseFtrl(int32_t m, int32_t n, int32_t k, bool duplicates,
+                       Graph** init_g, Graph** train_g) {
+  {
+    Graph* g = new Graph(OpRegistry::Global());
+    auto var = Var(g, m, n);
+    auto accum = Var(g, m, n);
+    auto linear = Var(g, m, n);
+    test::graph::Assign(g, var, Zeros(g, m, n));
+    test::graph::Assign(g, accum, Fill(g, m, n, 0.1));
+    test::graph::Assign(g, linear, Zeros(g, m, n));
+    *init_g = g;
+  }
+  {
+    Graph* g = new Graph(OpRegistry::Global());
+    auto var = Var(g, m, n);
+    auto accum = Var(g, m, n);
+    auto linear = Var(g, m, n);
+    auto grad = Random(g, k, n);
+    auto indices = SparseIndices(g, k, m, duplicates);
+    auto lr = Scalar(g, 0.01);
+    auto l1 = Scalar(g, 0.001);
+    auto l2 = Scalar(g, 0.001);
+    auto lr_power = Scalar(g, -0.5);
+    test::graph::Multi(g, "SparseApplyFtrl",
+                       {var, accum, linear, grad, indices, lr, l1, l2,
+                        lr_power});
+    *train_g = g;
+  }
+}
+
+// Args: rows in the variable, row width, gradient slices, and whether the
+// slices hit random (repeating) rows.
+static void BM_SparseFtrl(::testing::benchmark::State& state) {
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+  const bool duplicates = state.range(3);
+
+  Graph* init;
+  Graph* train;
+  SparseFtrl(m, n, k, duplicates, &init, &train);
+  test::Benchmark("cpu", train, GetMultiThreadedOptions(), init, nullptr, "",
+                  /*old_benchmark_api*/ false)
+      .Run(state);
+  const int64_t tot = static_cast<int64_t>(state.iterations()) * k * n;
+  state.SetItemsProcessed(tot);
+  state.SetBytesProcessed(tot * sizeof(float));
+}
+BENCHMARK(BM_SparseFtrl)
+    ->UseRealTime()
+    ->Args({1 << 20, 16, 64 << 10, 0})
+    ->Args({1 << 20, 16, 64 << 10, 1})
+    ->Args({64 << 10, 128, 16 << 10, 0})
+    ->Args({64 << 10, 128, 16 << 10, 1})
+    ->Args({1 << 10, 128, 16 << 10, 1});
+
+static void SparseMomentum(int32_t m, int32_t n, int32_t k, bool duplicates,
+                           Graph** init_g, Graph** train_g) {
+  {
+    Graph* g = new Graph(OpRegistry::Global());
+    auto var = Var(g, m, n);
+    auto accum = Var(g, m, n);
+    auto zero = Zeros(g, m, n);
+    test::graph::Assign(g, var, zero);
+    test::graph::Assign(g, accum, zero);
+    *init_g = g;
+  }
+  {
+    Graph* g = new Graph(OpRegistry::Global());
+    auto var = Var(g, m, n);
+    auto accum = Var(g, m, n);
+    auto lr = Scalar(g, 0.01);
+    auto grad = Random(g, k, n);
+    auto indices = SparseIndices(g, k, m, duplicates);
+    auto mom = Scalar(g, 0.9);
+    test::graph::Multi(g, "SparseApplyMomentum",
+                       {var, accum, lr, grad, indices, mom});
+    *train_g = g;
+  }
+}
+
+// Args: rows in the variable, row width, gradient slices, and whether the
+// slices hit random (repeating) rows.
+static void BM_SparseMomentum(::testing::benchmark::State& state) {
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+  const bool duplicates = state.range(3);
+
+  Graph* init;
+  Graph* train;
+  SparseMomentum(m, n, k, duplicates, &init, &train);
+  test::Benchmark("cpu", train, GetMultiThreadedOptions(), init, nullptr, "",
+                  /*old_benchmark_api*/ false)
+      .Run(state);
+  const int64_t tot = static_cast<int64_t>(state.iterations()) * k * n;
+  state.SetItemsProcessed(tot);
+  state.SetBytesProcessed(tot * sizeof(float));
+}
+BENCHMARK(BM_SparseMomentum)
+    ->UseRealTime()
+    ->Args({1 << 20, 16, 64 << 10, 0})
+    ->Args({1 << 20, 16, 64 << 10, 1})
+    ->Args({64 << 10, 128, 16 << 10, 0})
+    ->Args({64 << 10, 128, 16 << 10, 1})
+    ->Args({1 << 10, 128, 16 << 10, 1});
+
 }  // end namespace tensorflow
@@ -15,7 +15,10 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <complex>
+#include <cstdint>
+#include <type_traits>
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/attr_value.pb.h"
@@ -68,12 +71,275 @@ void TransposeSimple(const CPUDevice& device, const Tensor& in,
   device.parallelFor(in.NumElements(), cost, std::move(transpose_fn));
 }
 
+// Shape of the blocks that TransposeBlocked hands out as units of parallel
+// work: one cache line from each of kBlockRows source rows. Keeping the source
+// segments short keeps the destination rows long, so stores stream through
+// whole lines instead of touching a new page every few elements.
+constexpr int64_t kBlockRows = 256;
+
+template <typename T>
+constexpr int64_t BlockCols() {
+  return sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+}
+
+// Elements per unit of work when copying rows that stay contiguous.
+constexpr int64_t kCopyChunkSize = 16384;
+
+// Floating point type whose Eigen packets move T bit for bit, or void if T
+// has no in-register transpose.
+template <typename T>
+struct TransposePacketScalar {
+  using type = void;
+};
+template <>
+struct TransposePacketScalar<uint32_t> {
+  using type = float;
+};
+template <>
+struct TransposePacketScalar<uint64_t> {
+  using type = double;
+};
+
+template <typename T, bool conjugate>
+inline T MaybeConjugate(const T& x) {
+  if constexpr (conjugate) {
+    return Eigen::numext::conj(x);
+  } else {
+    return x;
+  }
+}
+
+// Transposes a square tile of one packet per row entirely in registers.
+template <typename Scalar>
+void TransposeMicroTile(const Scalar* src, int64_t src_stride, Scalar* dst,
+                        int64_t dst_stride) {
+  using Packet = typename Eigen::internal::packet_traits<Scalar>::type;
+  constexpr int kSize = Eigen::internal::unpacket_traits<Packet>::size;
+  Eigen::internal::PacketBlock<Packet, kSize> tile;
+  for (int i = 0; i < kSize; ++i) {
+    tile.packet[i] = Eigen::internal::ploadu<Packet>(src + i * src_stride);
+  }
+  Eigen::internal::ptranspose(tile);
+  for (int i = 0; i < kSize; ++i) {
+    Eigen::internal::pstoreu(dst + i * dst_stride, tile.packet[i]);
+  }
+}
+
+// Writes the transpose of the rows x cols matrix at `src` (row stride
+// `src_stride`) to the cols x rows matrix at `dst` (row stride `dst_stride`).
+template <typename T, bool conjugate>
+void TransposeBlock(const T* src, int64_t src_stride, T* dst,
+                    int64_t dst_stride, int64_t rows, int64_t cols) {
+  using Scalar = typename TransposePacketScalar<T>::type;
+  int64_t i = 0;
+  if constexpr (!conjugate && !std::is_void_v<Scalar>) {
+    using Packet = typename Eigen::internal::packet_traits<Scalar>::type;
+    constexpr int64_t kSize = Eigen::internal::unpacket_traits<Packet>::size;
+    if constexpr (kSize > 1) {
+      const Scalar* s = reinterpret_cast<const Scalar*>(src);
+      Scalar* d = reinterpret_cast<Scalar*>(dst);
+      for (; i + kSize <= rows; i += kSize) {
+        int64_t j = 0;
+        for (; j + kSize <= cols; j += kSize) {
+          TransposeMicroTile(s + i * src_stride + j, src_stride,
+                             d + j * dst_stride + i, dst_stride);
+        }
+        for (; j < cols; ++j) {
+          for (int64_t k = i; k < i + kSize; ++k) {
+            dst[j * dst_stride + k] = src[k * src_stride + j];
+          }
+        }
+      }
+    }
+  }
+  // Remaining rows, or the whole block for types without packets. Walking
+  // the destination contiguously keeps the stores streaming.
+  for (int64_t j = 0; j < cols; ++j) {
+    for (int64_t k = i; k < rows; ++k) {
+      dst[j * dst_stride + k] =
+          MaybeConjugate<T, conjugate>(src[k * src_stride + j]);
+    }
+  }
+}
+
+// Drops the dimensions of size one and merges dimensions that stay adjacent
+// under `perm`, so e.g. NHWC -> NCHW becomes a batch of [HW, C] -> [C, HW]
+// matrix transposes. `new_dims` are the input dimensions of the result.
+void PlanTranspose(const TensorShape& shape, absl::Span<const int32_t> perm,
+                   internal::TransposePermsVec* new_perm,
+                   internal::TransposeDimsVec* new_dims) {
+  internal::TransposePermsVec squeezed_index(shape.dims(), -1);
+  TensorShape squeezed;
+  for (int i = 0; i < shape.dims(); ++i) {
+    if (shape.dim_size(i) == 1) continue;
+    squeezed_index[i] = squeezed.dims();
+    squeezed.AddDim(shape.dim_size(i));
+  }
+  if (squeezed.dims() == 0) {
+    *new_perm = {0};
+    *new_dims = {1};
+    return;
+  }
+  internal::TransposePermsVec squeezed_perm;
+  for (const int32_t d : perm) {
+    if (squeezed_index[d] >= 0) squeezed_perm.push_back(squeezed_index[d]);
+  }
+  internal::TransposePermsVec output_position;
+  new_dims->resize(squeezed.dims());
+  internal::ReduceTransposeDimensions(squeezed, squeezed_perm,
+                                      &output_position, new_dims);
+  // ReduceTransposeDimensions reports where each merged input dimension
+  // lands in the output, which is the inverse of the permutation wanted here.
+  new_perm->resize(output_position.size());
+  for (int i = 0; i < output_position.size(); ++i) {
+    (*new_perm)[output_position[i]] = i;
+  }
+}
+
+// Transposes trivially copyable elements. The permutation is first reduced
+// with PlanTranspose. If the innermost dimension stays innermost, the
+// transpose is a gather of contiguous rows. Otherwise it is a batch of 2-D
+// transposes between the input's innermost dimension and the dimension that
+// becomes the output's innermost, which is done block by block with
+// in-register micro tiles and spread over the thread pool block-wise.
+template <typename T, bool conjugate>
+void TransposeBlocked(const CPUDevice& device, const Tensor& in,
+                      const absl::Span<const int32_t> perm, Tensor* out) {
+  const int64_t num_elements = in.NumElements();
+  if (num_elements == 0) return;
+  internal::TransposePermsVec new_perm;
+  internal::TransposeDimsVec dims;
+  PlanTranspose(in.shape(), perm, &new_perm, &dims);
+  const int ndims = dims.size();
+
+  internal::TransposeDimsVec in_strides(ndims);
+  internal::TransposeDimsVec out_dims(ndims);
+  internal::TransposeDimsVec out_strides(ndims);
+  // Input stride of each output dimension.
+  internal::TransposeDimsVec src_strides(ndims);
+  in_strides[ndims - 1] = 1;
+  for (int i = ndims - 2; i >= 0; --i) {
+    in_strides[i] = in_strides[i + 1] * dims[i + 1];
+  }
+  for (int i = 0; i < ndims; ++i) {
+    out_dims[i] = dims[new_perm[i]];
+    src_strides[i] = in_strides[new_perm[i]];
+  }
+  out_strides[ndims - 1] = 1;
+  for (int i = ndims - 2; i >= 0; --i) {
+    out_strides[i] = out_strides[i + 1] * out_dims[i + 1];
+  }
+
+  const T* src = reinterpret_cast<const T*>(in.tensor_data().data());
+  T* dst = reinterpret_cast<T*>(const_cast<char*>(out->tensor_data().data()));
+
+  if (new_perm[ndims - 1] == ndims - 1) {
+    const int64_t row_size = dims[ndims - 1];
+    const int64_t chunk_size = std::min(row_size, kCopyChunkSize);
+    const int64_t chunks_per_row = Eigen::divup(row_size, chunk_size);
+    auto copy_fn = [=, &out_dims, &src_strides](int64_t begin, int64_t end) {
+      // Output index of the current row, stepped like an odometer so that
+      // short rows do not pay for a division per dimension.
+      internal::TransposeDimsVec index(ndims, 0);
+      int64_t row = begin / chunks_per_row;
+      int64_t src_offset = 0;
+      int64_t t = row;
+      for (int i = ndims - 2; i >= 0; --i) {
+        index[i] = t % out_dims[i];
+        t /= out_dims[i];
+        src_offset += index[i] * src_strides[i];
+      }
+      for (int64_t u = begin; u < end; ++u) {
+        if (u / chunks_per_row != row) {
+          ++row;
+          for (int i = ndims - 2; i >= 0; --i) {
+            src_offset += src_strides[i];
+            if (++index[i] < out_dims[i]) break;
+            src_offset -= index[i] * src_strides[i];
+            index[i] = 0;
+          }
+        }
+        const int64_t start = (u - row * chunks_per_row) * chunk_size;
+        const int64_t size = std::min(chunk_size, row_size - start);
+        const T* s = src + src_offset + start;
+        T* d = dst + row * row_size + start;
+        if constexpr (conjugate) {
+          for (int64_t k = 0; k < size; ++k) d[k] = Eigen::numext::conj(s[k]);
+        } else {
+          std::copy(s, s + size, d);
+        }
+      }
+    };
+    Eigen::TensorOpCost cost(/*bytes_loaded=*/chunk_size * sizeof(T),
+                             /*bytes_stored=*/chunk_size * sizeof(T),
+                             /*compute_cycles=*/conjugate ? chunk_size : 0);
+    device.parallelFor(num_elements / row_size * chunks_per_row, cost,
+                       std::move(copy_fn));
+    return;
+  }
+
+  // The matrix transposed in every batch: rows run along input dimension
+  // new_perm[ndims - 1], columns along the input's innermost dimension, which
+  // lands at output position `col_dim`.
+  const int row_dim = new_perm[ndims - 1];
+  const int col_dim =
+      std::find(new_perm.begin(), new_perm.end(), ndims - 1) - new_perm.begin();
+  const int64_t rows = dims[row_dim];
+  const int64_t cols = dims[ndims - 1];
+  const int64_t src_row_stride = in_strides[row_dim];
+  const int64_t dst_row_stride = out_strides[col_dim];
+  constexpr int64_t kBlockCols = BlockCols<T>();
+  const int64_t row_blocks = Eigen::divup(rows, kBlockRows);
+  const int64_t col_blocks = Eigen::divup(cols, kBlockCols);
+  auto transpose_fn = [=, &out_dims, &src_strides, &out_strides](int64_t begin,
+                                                                 int64_t end) {
+    for (int64_t u = begin; u < end; ++u) {
+      const int64_t row_block = u % row_blocks;
+      const int64_t col_block = u / row_blocks % col_blocks;
+      int64_t t = u / row_blocks / col_blocks;
+      int64_t src_offset = 0;
+      int64_t dst_offset = 0;
+      for (int i = ndims - 2; i >= 0; --i) {
+        if (i == col_dim) continue;
+        const int64_t index = t % out_dims[i];
+        t /= out_dims[i];
+        src_offset += index * src_strides[i];
+        dst_offset += index * out_strides[i];
+      }
+      const int64_t r = row_block * kBlockRows;
+      const int64_t c = col_block * kBlockCols;
+      TransposeBlock<T, conjugate>(
+          src + src_offset + r * src_row_stride + c, src_row_stride,
+          dst + dst_offset + c * dst_row_stride + r, dst_row_stride,
+          std::min(kBlockRows, rows - r), std::min(kBlockCols, cols - c));
+    }
+  };
+  Eigen::TensorOpCost cost(
+      /*bytes_loaded=*/kBlockRows * kBlockCols * sizeof(T),
+      /*bytes_stored=*/kBlockRows * kBlockCols * sizeof(T),
+      /*compute_cycles=*/kBlockRows * kBlockCols);
+  device.parallelFor(num_elements / (rows * cols) * row_blocks * col_blocks,
+                     cost, std::move(transpose_fn));
+}
+
 }  // namespace
 
 template <typename T, bool conjugate>
 struct Transpose<CPUDevice, T, conjugate> {
   static void run(const CPUDevice& d, const Tensor& in,
                   const absl::Span<const int32_t> perm, Tensor* out) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      TransposeBlocked<T, conjugate>(d, in, perm, out);
+    } else {
+      TransposeUsingEigenOrSimple(d, in, perm, out);
+    }
+  }
+
+ private:
+  // Strings are not trivially copyable and keep going through Eigen.
+  static void TransposeUsingEigenOrSimple(const CPUDevice& d, const Tensor& in,
+                                          const absl::Span<const int32_t> perm,
+                                          Tensor* out) {
     switch (in.dims()) {
       case 2:
         internal::TransposeUsingEigen<CPUDevice, T, 2>(d, in, perm, conjugate,
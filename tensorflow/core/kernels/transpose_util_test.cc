@@ -13,12 +13,21 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#define EIGEN_USE_THREADS
+
+#include <complex>
 #include <cstdint>
+#include <type_traits>
+#include <vector>
 
 #include "absl/types/span.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/kernels/transpose_functor.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -38,6 +47,51 @@ class TransposeUtilTest : public ::testing::Test {
     EXPECT_EQ(computed_perm, expected_perm);
     EXPECT_EQ(computed_dims, expected_dims);
   }
+
+  // Checks DoTranspose (or DoConjugateTranspose) on the CPU against a
+  // straightforward index computation.
+  template <typename T>
+  void TestCpuTranspose(const TensorShape& shape,
+                        const std::vector<int32_t>& perm,
+                        bool conjugate = false) {
+    Tensor in(DataTypeToEnum<T>::value, shape);
+    auto in_flat = in.flat<T>();
+    for (int64_t i = 0; i < in_flat.size(); ++i) {
+      in_flat(i) = static_cast<T>(i % 101);
+      if constexpr (std::is_same_v<T, complex64>) in_flat(i) += T(0, i % 7);
+    }
+    TensorShape out_shape;
+    for (const int32_t d : perm) out_shape.AddDim(shape.dim_size(d));
+    Tensor out(DataTypeToEnum<T>::value, out_shape);
+
+    thread::ThreadPool threadpool(Env::Default(), "test", 4);
+    Eigen::ThreadPoolDevice device(threadpool.AsEigenThreadPool(), 4);
+    if (conjugate) {
+      TF_ASSERT_OK(DoConjugateTranspose(device, in, perm, &out));
+    } else {
+      TF_ASSERT_OK(DoTranspose(device, in, perm, &out));
+    }
+
+    Tensor expected(DataTypeToEnum<T>::value, out_shape);
+    auto expected_flat = expected.flat<T>();
+    const int ndims = shape.dims();
+    std::vector<int64_t> in_strides(ndims);
+    for (int d = ndims - 1, stride = 1; d >= 0; --d) {
+      in_strides[d] = stride;
+      stride *= shape.dim_size(d);
+    }
+    for (int64_t o = 0; o < expected_flat.size(); ++o) {
+      int64_t t = o;
+      int64_t i = 0;
+      for (int d = ndims - 1; d >= 0; --d) {
+        i += (t % out_shape.dim_size(d)) * in_strides[perm[d]];
+        t /= out_shape.dim_size(d);
+      }
+      expected_flat(o) = in_flat(i);
+      if (conjugate) expected_flat(o) = Eigen::numext::conj(in_flat(i));
+    }
+    test::ExpectTensorEqual<T>(expected, out);
+  }
 };
 
 TEST_F(TransposeUtilTest, NormalDimensionReduction) {
@@ -101,6 +155,29 @@ TEST_F(TransposeUtilTest, LargeDimensionReduction) {
                          {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, {0}, {72576000});
 }
 
+TEST_F(TransposeUtilTest, CpuTransposeCommonPermutations) {
+  // NHWC <-> NCHW.
+  TestCpuTranspose<float>({2, 33, 17, 40}, {0, 3, 1, 2});
+  TestCpuTranspose<float>({2, 40, 33, 17}, {0, 2, 3, 1});
+  // Attention head reshuffle, which keeps the innermost dimension.
+  TestCpuTranspose<float>({3, 37, 4, 24}, {0, 2, 1, 3});
+  // Matrix transposes with ragged block edges.
+  TestCpuTranspose<double>({259, 301}, {1, 0});
+  TestCpuTranspose<int8_t>({5, 301, 67}, {0, 2, 1});
+  TestCpuTranspose<Eigen::half>({129, 3, 65}, {2, 1, 0});
+  // Cyclic permutations, which ReduceTransposeDimensions reports inverted.
+  TestCpuTranspose<int32_t>({6, 5, 4, 3, 2}, {0, 3, 1, 4, 2});
+  TestCpuTranspose<int64_t>({3, 7, 1, 5, 9, 1, 4}, {6, 2, 0, 5, 4, 1, 3});
+  // Ranks above eight used to fall back to per-element index arithmetic.
+  TestCpuTranspose<float>({2, 3, 2, 3, 2, 3, 2, 3, 2, 3},
+                          {9, 7, 5, 3, 1, 0, 2, 4, 6, 8});
+}
+
+TEST_F(TransposeUtilTest, CpuConjugateTranspose) {
+  TestCpuTranspose<complex64>({17, 3, 40}, {2, 0, 1}, /*conjugate=*/true);
+  TestCpuTranspose<complex64>({17, 3, 40}, {1, 0, 2}, /*conjugate=*/true);
+}
+
 TEST_F(TransposeUtilTest, NonSingletonDimensionAlignment) {
   // Non-singleton dims 0, 2
   EXPECT_TRUE(internal::NonSingletonDimensionsAlign({2, 1, 2}, {1, 0, 2}));
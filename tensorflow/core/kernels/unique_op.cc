@@ -13,8 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -29,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace {
@@ -71,6 +75,191 @@ struct UniqueOpHashMap<bfloat16, TIndex> {
   using map_type = std::unordered_map<bfloat16, TIndex>;
 };
 
+// Vectors with at least this many elements are uniquified in parallel when
+// the intra-op thread pool has more than one thread.
+constexpr int64_t kParallelUniqueMinElements = 1 << 16;
+
+// Integer keys can be radix-partitioned by hash. Floating-point keys are left
+// to the sequential path, which handles NaN.
+template <typename T>
+constexpr bool kParallelUniqueSupported =
+    std::is_integral<T>::value && !std::is_same<T, bool>::value;
+
+// Maps `key` to one of `1 << log2_partitions` partitions with multiplicative
+// hashing, which spreads dense and strided ids alike.
+template <typename T>
+inline int UniquePartition(T key, int log2_partitions) {
+  return static_cast<int>(
+      (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >>
+      (64 - log2_partitions));
+}
+
+// Computes `y`, `idx` and, if `with_counts`, `count` for a vector of integer
+// keys on the intra-op thread pool, with the same first-occurrence order as
+// the sequential implementation:
+//
+//  1. Positions are radix-partitioned by the hash of their key into
+//     per-partition lists that keep input order.
+//  2. Each partition is deduplicated independently, numbering its keys by
+//     first occurrence.
+//  3. A prefix sum over the first-occurrence positions assigns global ids,
+//     which are then scattered back to `y`, `idx` and `count`.
+//
+// `idx` doubles as scratch space for the global id of each first occurrence.
+template <typename T, typename TIndex>
+void ParallelUnique(OpKernelContext* context,
+                    typename TTypes<T>::ConstFlat input,
+                    TensorShape output_shape, int64_t axis,
+                    typename TTypes<TIndex>::Vec idx, bool with_counts) {
+  thread::ThreadPool* workers =
+      context->device()->tensorflow_cpu_worker_threads()->workers;
+  const int64_t N = input.size();
+  int log2_partitions = 1;
+  while ((1 << log2_partitions) < 4 * workers->NumThreads() &&
+         log2_partitions < 8) {
+    ++log2_partitions;
+  }
+  const int num_partitions = 1 << log2_partitions;
+  const int64_t block_size =
+      std::max<int64_t>(1024, N / (4 * workers->NumThreads()));
+  const int64_t num_blocks = (N + block_size - 1) / block_size;
+  const auto block_limit = [&](int64_t block) {
+    return std::min(N, (block + 1) * block_size);
+  };
+
+  // Histogram the partitions of every block, then turn the histograms into
+  // partition-major write offsets so each partition's positions are
+  // contiguous and ordered by block.
+  std::vector<int64_t> offsets(num_partitions * num_blocks);
+  workers->ParallelFor(
+      num_blocks, block_size * 4, [&](int64_t start, int64_t limit) {
+        std::vector<int64_t> counts(num_partitions);
+        for (int64_t b = start; b < limit; ++b) {
+          std::fill(counts.begin(), counts.end(), 0);
+          for (int64_t i = b * block_size; i < block_limit(b); ++i) {
+            ++counts[UniquePartition(input(i), log2_partitions)];
+          }
+          for (int p = 0; p < num_partitions; ++p) {
+            offsets[p * num_blocks + b] = counts[p];
+          }
+        }
+      });
+  std::vector<int64_t> partition_starts(num_partitions + 1);
+  int64_t total = 0;
+  for (int p = 0; p < num_partitions; ++p) {
+    partition_starts[p] = total;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      const int64_t count = offsets[p * num_blocks + b];
+      offsets[p * num_blocks + b] = total;
+      total += count;
+    }
+  }
+  partition_starts[num_partitions] = total;
+
+  // Input sizes are capped at int32 max by the caller.
+  std::vector<int32_t> positions(N);
+  workers->ParallelFor(
+      num_blocks, block_size * 6, [&](int64_t start, int64_t limit) {
+        std::vector<int64_t> cursors(num_partitions);
+        for (int64_t b = start; b < limit; ++b) {
+          for (int p = 0; p < num_partitions; ++p) {
+            cursors[p] = offsets[p * num_blocks + b];
+          }
+          for (int64_t i = b * block_size; i < block_limit(b); ++i) {
+            positions[cursors[UniquePartition(input(i), log2_partitions)]++] =
+                static_cast<int32_t>(i);
+          }
+        }
+      });
+
+  // Deduplicate every partition. `local_ids` is parallel to `positions`.
+  struct Partition {
+    std::vector<int32_t> first_positions;
+    std::vector<TIndex> counts;
+  };
+  std::vector<Partition> partitions(num_partitions);
+  std::vector<int32_t> local_ids(N);
+  std::vector<uint8_t> is_first(N, 0);
+  const int64_t partition_cost = 100 * (N / num_partitions + 1);
+  workers->ParallelFor(
+      num_partitions, partition_cost, [&](int64_t start, int64_t limit) {
+        for (int64_t p = start; p < limit; ++p) {
+          Partition& partition = partitions[p];
+          absl::flat_hash_map<T, int32_t> uniq;
+          uniq.reserve(partition_starts[p + 1] - partition_starts[p]);
+          for (int64_t k = partition_starts[p]; k < partition_starts[p + 1];
+               ++k) {
+            const int32_t i = positions[k];
+            auto it = uniq.emplace(input(i), partition.first_positions.size());
+            if (it.second) {
+              partition.first_positions.push_back(i);
+              partition.counts.push_back(0);
+              is_first[i] = 1;
+            }
+            local_ids[k] = it.first->second;
+            ++partition.counts[it.first->second];
+          }
+        }
+      });
+
+  // Global ids follow the order of first occurrences in the input.
+  std::vector<int64_t> block_starts(num_blocks + 1);
+  workers->ParallelFor(
+      num_blocks, block_size, [&](int64_t start, int64_t limit) {
+        for (int64_t b = start; b < limit; ++b) {
+          int64_t count = 0;
+          for (int64_t i = b * block_size; i < block_limit(b); ++i) {
+            count += is_first[i];
+          }
+          block_starts[b + 1] = count;
+        }
+      });
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    block_starts[b + 1] += block_starts[b];
+  }
+  const int64_t uniq_size = block_starts[num_blocks];
+  workers->ParallelFor(
+      num_blocks, block_size, [&](int64_t start, int64_t limit) {
+        for (int64_t b = start; b < limit; ++b) {
+          TIndex id = static_cast<TIndex>(block_starts[b]);
+          for (int64_t i = b * block_size; i < block_limit(b); ++i) {
+            if (is_first[i]) idx(i) = id++;
+          }
+        }
+      });
+
+  output_shape.set_dim(axis, uniq_size);
+  Tensor* output = nullptr;
+  OP_REQUIRES_OK(context, context->allocate_output(0, output_shape, &output));
+  auto y = output->flat<T>();
+  TIndex* count = nullptr;
+  if (with_counts) {
+    Tensor* count_output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                2, TensorShape({uniq_size}), &count_output));
+    count = count_output->vec<TIndex>().data();
+  }
+
+  workers->ParallelFor(
+      num_partitions, partition_cost, [&](int64_t start, int64_t limit) {
+        std::vector<TIndex> global_ids;
+        for (int64_t p = start; p < limit; ++p) {
+          const Partition& partition = partitions[p];
+          global_ids.resize(partition.first_positions.size());
+          for (size_t l = 0; l < global_ids.size(); ++l) {
+            const int32_t i = partition.first_positions[l];
+            global_ids[l] = idx(i);
+            y(global_ids[l]) = input(i);
+            if (count != nullptr) count[global_ids[l]] = partition.counts[l];
+          }
+          for (int64_t k = partition_starts[p]; k < partition_starts[p + 1];
+               ++k) {
+            idx(positions[k]) = global_ids[local_ids[k]];
+          }
+        }
+      });
+}
+
 // `UniqueOp` computes the unique elements in the input tensor.
 //
 // * `T` is the element type.
@@ -153,6 +342,17 @@ class UniqueOp : public OpKernel {
       auto Tin = input.flat<T>();
       const int64_t N = static_cast<int64_t>(Tin.size());
 
+      if constexpr (kParallelUniqueSupported<T>) {
+        const int num_threads = context->device()
+                                    ->tensorflow_cpu_worker_threads()
+                                    ->workers->NumThreads();
+        if (N >= kParallelUniqueMinElements && num_threads > 1) {
+          ParallelUnique<T, TIndex>(context, Tin, input.shape(), axis, idx_vec,
+                                    /*with_counts=*/num_outputs() > 2);
+          return;
+        }
+      }
+
       typename UniqueOpHashMap<T, TIndex>::map_type uniq;
       uniq.reserve(2 * N);
       for (Eigen::Index i = 0, j = 0; i < N; ++i) {
@@ -15,10 +15,15 @@ limitations under the License.
 
 #include <cstdint>
 #include <cstdlib>
+#include <random>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -32,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/session_options.h"
 
 namespace tensorflow {
 
@@ -113,6 +119,81 @@ void BM_Unique_INT32_Repeat(::testing::benchmark::State& state) {
                           sizeof(int32_t));
 }
 
+class UniqueOpTest : public OpsTestBase {};
+
+// Large integer inputs take the parallel path when the test device has more
+// than one thread; the outputs must match first-occurrence order exactly.
+TEST_F(UniqueOpTest, LargeInt64WithCountsKeepsFirstOccurrenceOrder) {
+  TF_ASSERT_OK(NodeDefBuilder("unique", "UniqueWithCounts")
+                   .Input(FakeInput(DT_INT64))
+                   .Attr("out_idx", DT_INT32)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+
+  const int n = 1 << 18;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int64_t> dist(-5000, 20000);
+  std::vector<int64_t> values(n);
+  for (int64_t& value : values) value = dist(rng);
+  AddInputFromArray<int64_t>(TensorShape({n}), values);
+  TF_ASSERT_OK(RunOpKernel());
+
+  std::unordered_map<int64_t, int32_t> ids;
+  std::vector<int64_t> expected_y;
+  std::vector<int32_t> expected_idx(n);
+  std::vector<int32_t> expected_count;
+  for (int i = 0; i < n; ++i) {
+    auto it = ids.emplace(values[i], expected_y.size());
+    if (it.second) {
+      expected_y.push_back(values[i]);
+      expected_count.push_back(0);
+    }
+    expected_idx[i] = it.first->second;
+    ++expected_count[it.first->second];
+  }
+  const int num_unique = expected_y.size();
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>(expected_y, TensorShape({num_unique})));
+  test::ExpectTensorEqual<int32_t>(
+      *GetOutput(1), test::AsTensor<int32_t>(expected_idx, TensorShape({n})));
+  test::ExpectTensorEqual<int32_t>(
+      *GetOutput(2),
+      test::AsTensor<int32_t>(expected_count, TensorShape({num_unique})));
+}
+
+// Args: input size, range of the random ids (which sets the duplication
+// rate), and intra-op threads.
+void BM_Unique_INT64_Threads(::testing::benchmark::State& state) {
+  const int dim = state.range(0);
+  const int max_int = state.range(1);
+  const int num_threads = state.range(2);
+
+  Graph* g = new Graph(OpRegistry::Global());
+
+  Tensor input(DT_INT64, TensorShape({dim}));
+  auto input_flat = input.flat<int64_t>();
+  std::mt19937_64 rng(0);
+  for (int i = 0; i < dim; ++i) input_flat(i) = rng() % max_int;
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "Unique")
+                  .Input(test::graph::Constant(g, input))
+                  .Attr("T", DT_INT64)
+                  .Finalize(g, &node));
+  FixupSourceAndSinkEdges(g);
+
+  SessionOptions opts;
+  opts.config.set_intra_op_parallelism_threads(num_threads);
+  opts.config.set_inter_op_parallelism_threads(1);
+  test::Benchmark("cpu", g, &opts, nullptr, nullptr, "",
+                  /*old_benchmark_api*/ false)
+      .Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * dim);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * dim *
+                          sizeof(int64_t));
+}
+
 TensorProto GetRandomStringsTensorProto(int dim, int max_str_len) {
   TensorProto tensor_proto;
   tensor_proto.set_dtype(DT_STRING);
@@ -195,6 +276,19 @@ BENCHMARK(BM_Unique_INT32_Repeat)
     ->ArgPair(64 * 1024, 64 * 1024 * 1024)
     ->ArgPair(1024 * 1024, 64 * 1024 * 1024);
 
+BENCHMARK(BM_Unique_INT64_Threads)
+    ->UseRealTime()
+    ->Args({1 << 20, 1 << 10, 1})
+    ->Args({1 << 20, 1 << 10, 16})
+    ->Args({1 << 20, 1 << 20, 1})
+    ->Args({1 << 20, 1 << 20, 16})
+    ->Args({16 << 20, 1 << 10, 1})
+    ->Args({16 << 20, 1 << 10, 16})
+    ->Args({16 << 20, 1 << 20, 1})
+    ->Args({16 << 20, 1 << 20, 16})
+    ->Args({16 << 20, 1 << 30, 1})
+    ->Args({16 << 20, 1 << 30, 16});
+
 BENCHMARK(BM_Unique_STRING)
     ->UseRealTime()
     ->Arg(32)
@@ -650,6 +650,8 @@ REGISTER_OP("ShuffleDatasetV3")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
     .Attr("metadata: string = ''")
+    .Attr("buffer_size_bytes: int = 0")
+    .Attr("spill_directory: string = ''")
     .SetTypeConstructor(full_type::VariadicTensorContainer(TFT_DATASET,
                                                            "output_types"))
     .SetShapeFn([](shape_inference::InferenceContext* c) {
@@ -841,6 +843,7 @@ REGISTER_OP("TFRecordDataset")
     .Input("compression_type: string")
     .Input("buffer_size: int64")
     .Attr("metadata: string = ''")
+    .Attr("use_index: bool = false")
     .Output("handle: variant")
     .SetDoNotOptimize()  // TODO(b/123753214): See comment in dataset_ops.cc.
     .SetTypeConstructor(full_type::UnaryTensorContainer(TFT_DATASET,
@@ -862,6 +865,7 @@ REGISTER_OP("TFRecordDatasetV2")
     .Input("buffer_size: int64")
     .Input("byte_offsets: int64")
     .Attr("metadata: string = ''")
+    .Attr("use_index: bool = false")
     .Output("handle: variant")
     .SetDoNotOptimize()  // TODO(b/123753214): See comment in dataset_ops.cc.
     .SetTypeConstructor(full_type::UnaryTensorContainer(TFT_DATASET,
@@ -1593,6 +1593,7 @@ REGISTER_OP("DataServiceDatasetV4")
     .Attr("uncompress: bool = false")
     .Attr("uncompress_fn: func")
     .Attr("cross_trainer_cache_options: string = ''")
+    .Attr("load_aware_task_selection: bool = false")
     .SetIsStateful()
     .SetTypeConstructor(full_type::VariadicTensorContainer(TFT_DATASET,
                                                            "output_types"))
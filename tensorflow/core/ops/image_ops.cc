@@ -524,6 +524,39 @@ REGISTER_OP("DecodeAndCropJpeg")
       return absl::OkStatus();
     });
 
+// --------------------------------------------------------------------------
+REGISTER_OP("DecodeAndResizeJpeg")
+    .Input("contents: string")
+    .Input("crop_window: int32")
+    .Input("size: int32")
+    .Attr("channels: int = 0")
+    .Attr("kernel_type: string = 'triangle'")
+    .Attr("antialias: bool = true")
+    .Attr("fancy_upscaling: bool = true")
+    .Attr("dct_method: string = ''")
+    .Output("image: float")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &unused));
+      TF_ASSIGN_OR_RETURN(DimensionHandle channels_dim, GetChannelsDim(c));
+
+      ShapeHandle size;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &size));
+      DimensionHandle unused_dim;
+      TF_RETURN_IF_ERROR(c->WithValue(c->Dim(size, 0), 2, &unused_dim));
+      DimensionHandle h = c->UnknownDim();
+      DimensionHandle w = c->UnknownDim();
+      const Tensor* size_tensor = c->input_tensor(2);
+      if (size_tensor != nullptr) {
+        auto size_vec = size_tensor->vec<int32_t>();
+        h = c->MakeDim(size_vec(0));
+        w = c->MakeDim(size_vec(1));
+      }
+      c->set_output(0, c->MakeShape({h, w, channels_dim}));
+      return absl::OkStatus();
+    });
+
 // --------------------------------------------------------------------------
 REGISTER_OP("EncodeJpeg")
     .Input("image: uint8")
@@ -939,6 +939,75 @@ _FusedConv2D output.
 expected to create these operators.
 )doc");
 
+REGISTER_OP("_DenseToBlockSparse")
+    .Input("dense: T")
+    .Output("values: T")
+    .Output("col_indices: int32")
+    .Output("row_ptr: int32")
+    .Attr("T: {float}")
+    .Attr("block_rows: int >= 1")
+    .Attr("block_cols: int >= 1")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle dense;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 2, &dense));
+      int block_rows;
+      int block_cols;
+      TF_RETURN_IF_ERROR(c->GetAttr("block_rows", &block_rows));
+      TF_RETURN_IF_ERROR(c->GetAttr("block_cols", &block_cols));
+      c->set_output(0, c->MakeShape({InferenceContext::kUnknownDim, block_rows,
+                                     block_cols}));
+      c->set_output(1, c->Vector(InferenceContext::kUnknownDim));
+      DimensionHandle num_block_rows;
+      TF_RETURN_IF_ERROR(
+          c->Divide(c->Dim(dense, 0), block_rows,
+                    /*evenly_divisible=*/true, &num_block_rows));
+      DimensionHandle row_ptr_size;
+      TF_RETURN_IF_ERROR(c->Add(num_block_rows, 1, &row_ptr_size));
+      c->set_output(2, c->Vector(row_ptr_size));
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+Internal operation converting a matrix to the block compressed sparse row
+layout read by _BlockSparseMatMul: reserved for internal use.
+
+`values` holds the `block_rows` x `block_cols` blocks of `dense` that contain a
+non-zero element, in row-major block order. `col_indices` gives the block
+column of each stored block, and block row `r` owns the stored blocks
+`[row_ptr[r], row_ptr[r + 1])`. Both dimensions of `dense` must be multiples of
+the block shape.
+)doc");
+
+REGISTER_OP("_BlockSparseMatMul")
+    .Input("a: T")
+    .Input("b_values: T")
+    .Input("b_col_indices: int32")
+    .Input("b_row_ptr: int32")
+    .Output("product: T")
+    .Attr("T: {float}")
+    .Attr("block_rows: int >= 1")
+    .Attr("block_cols: int >= 1")
+    .Attr("num_cols: int >= 0")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle a;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 2, &a));
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 3, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(3), 1, &unused));
+      int num_cols;
+      TF_RETURN_IF_ERROR(c->GetAttr("num_cols", &num_cols));
+      c->set_output(0, c->Matrix(c->Dim(a, 0), num_cols));
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+Internal operation computing `a` * `b` where `b` is a [K, num_cols] matrix in
+the block compressed sparse row layout produced by _DenseToBlockSparse:
+reserved for internal use.
+
+*NOTE*: Do not invoke this operator directly in Python. Grappler is
+expected to create these operators for MatMuls with pruned constant weights.
+)doc");
+
 // --------------------------------------------------------------------------
 
 // For operations where the output is a reduction function along some
@@ -1475,6 +1544,70 @@ REGISTER_OP("SparseSegmentSqrtNGradV2")
     .Attr("Tsegmentids: {int32, int64} = DT_INT32")
     .SetShapeFn(SparseSegmentReductionGradV2ShapeFn);
 
+REGISTER_OP("_FusedSparseEmbeddingLookup")
+    .Input("params: T")
+    .Input("ids: Tidx")
+    .Input("segment_ids: Tsegmentids")
+    .Input("weights: num_weights * T")
+    .Input("num_segments: Tnumsegments")
+    .Output("output: T")
+    .Attr("T: {bfloat16, half, float, double}")
+    .Attr("Tidx: {int32, int64} = DT_INT32")
+    .Attr("Tsegmentids: {int32, int64} = DT_INT32")
+    .Attr("Tnumsegments: {int32, int64} = DT_INT32")
+    .Attr("num_weights: int >= 0 = 0")
+    .Attr("combiner: {'sum', 'mean', 'sqrtn'} = 'sum'")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle params_shape;
+      TF_RETURN_IF_ERROR(c->WithRankAtLeast(c->input(0), 1, &params_shape));
+      ShapeHandle ids_shape;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &ids_shape));
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &unused));
+      TF_RETURN_IF_ERROR(c->Merge(ids_shape, unused, &ids_shape));
+      int num_weights;
+      TF_RETURN_IF_ERROR(c->GetAttr("num_weights", &num_weights));
+      if (num_weights > 1) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Expected at most one weights input, got ",
+                         num_weights));
+      }
+      for (int i = 0; i < num_weights; ++i) {
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(3 + i), 1, &unused));
+        TF_RETURN_IF_ERROR(c->Merge(ids_shape, unused, &ids_shape));
+      }
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(3 + num_weights), 0, &unused));
+
+      ShapeHandle subshape;
+      TF_RETURN_IF_ERROR(c->Subshape(params_shape, 1, &subshape));
+      DimensionHandle dim0 = c->UnknownDim();
+      const Tensor* num_segments = c->input_tensor(3 + num_weights);
+      if (num_segments != nullptr) {
+        const int64_t value = num_segments->dtype() == DT_INT32
+                                  ? num_segments->scalar<int32_t>()()
+                                  : num_segments->scalar<int64_t>()();
+        if (value >= 0) dim0 = c->MakeDim(value);
+      }
+      ShapeHandle out;
+      TF_RETURN_IF_ERROR(c->Concatenate(c->Vector(dim0), subshape, &out));
+      c->set_output(0, out);
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+Internal operation which is a composition of gathering rows of `params` at
+`ids`, optionally scaling them by `weights`, and reducing them per segment
+(Unique + GatherV2 + SparseSegment{Sum,Mean,SqrtN}): reserved for internal use.
+
+`segment_ids` must be sorted. If `num_segments` is negative, the output has
+`segment_ids[-1] + 1` rows. With `combiner` "mean" or "sqrtn", each segment is
+divided by the sum of its weights or the square root of the sum of its squared
+weights, where missing weights count as one. Segments whose divisor is zero are
+zero in the output.
+
+Do not invoke this operator directly in Python. A fusion optimization is
+expected to create these operators.
+)doc");
+
 REGISTER_OP("All")
     .Input("input: bool")
     .Input("reduction_indices: Tidx")
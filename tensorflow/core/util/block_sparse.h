@@ -0,0 +1,93 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_UTIL_BLOCK_SPARSE_H_
+#define TENSORFLOW_CORE_UTIL_BLOCK_SPARSE_H_
+
+#include <cstdint>
+
+namespace tensorflow {
+
+// Helpers for the block compressed sparse row (BSR) layout used by
+// _BlockSparseMatMul.
+//
+// A row-major [rows, cols] matrix is tiled into block_rows x block_cols
+// blocks, and only blocks with at least one non-zero element are stored.
+// Block row r owns the stored blocks [row_ptr[r], row_ptr[r + 1]). Stored
+// block b covers columns [col_indices[b] * block_cols, (col_indices[b] + 1) *
+// block_cols) and keeps its values row-major at
+// values[b * block_rows * block_cols].
+
+// Returns true if `block_rows` x `block_cols` is a block shape the
+// _BlockSparseMatMul kernel has a micro-kernel for.
+inline bool IsSupportedBlockShape(int block_rows, int block_cols) {
+  return (block_rows == 1 && block_cols == 4) ||
+         (block_rows == 4 && block_cols == 4) ||
+         (block_rows == 8 && block_cols == 1);
+}
+
+// Returns the number of blocks of `dense` with at least one non-zero
+// element. `rows` and `cols` must be multiples of the block shape.
+template <typename T>
+int64_t CountNonZeroBlocks(const T* dense, int64_t rows, int64_t cols,
+                           int block_rows, int block_cols) {
+  int64_t count = 0;
+  for (int64_t r = 0; r < rows; r += block_rows) {
+    for (int64_t c = 0; c < cols; c += block_cols) {
+      bool non_zero = false;
+      for (int i = 0; i < block_rows && !non_zero; ++i) {
+        const T* row = dense + (r + i) * cols + c;
+        for (int j = 0; j < block_cols; ++j) {
+          non_zero |= row[j] != T(0);
+        }
+      }
+      count += non_zero;
+    }
+  }
+  return count;
+}
+
+// Writes the BSR form of `dense` to `values` (CountNonZeroBlocks() *
+// block_rows * block_cols elements), `col_indices` (one per stored block) and
+// `row_ptr` (rows / block_rows + 1 elements).
+template <typename T, typename Index>
+void DenseToBlockSparse(const T* dense, int64_t rows, int64_t cols,
+                        int block_rows, int block_cols, T* values,
+                        Index* col_indices, Index* row_ptr) {
+  Index num_blocks = 0;
+  row_ptr[0] = 0;
+  for (int64_t r = 0; r < rows; r += block_rows) {
+    for (int64_t c = 0; c < cols; c += block_cols) {
+      bool non_zero = false;
+      for (int i = 0; i < block_rows && !non_zero; ++i) {
+        const T* row = dense + (r + i) * cols + c;
+        for (int j = 0; j < block_cols; ++j) {
+          non_zero |= row[j] != T(0);
+        }
+      }
+      if (!non_zero) continue;
+      for (int i = 0; i < block_rows; ++i) {
+        const T* row = dense + (r + i) * cols + c;
+        for (int j = 0; j < block_cols; ++j) *values++ = row[j];
+      }
+      col_indices[num_blocks++] = static_cast<Index>(c / block_cols);
+    }
+    row_ptr[r / block_rows + 1] = num_blocks;
+  }
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_UTIL_BLOCK_SPARSE_H_
@@ -0,0 +1,86 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_UTIL_CSV_SCANNER_H_
+#define TENSORFLOW_CORE_UTIL_CSV_SCANNER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/numeric/bits.h"
+#include "tensorflow/core/platform/byte_order.h"
+
+namespace tensorflow {
+
+namespace csv_internal {
+
+// Returns a word with the high bit set in every byte of `word` that equals
+// the corresponding byte of `pattern`. Bits above the lowest match may be
+// spurious (the subtraction borrows across bytes), so only the lowest set bit
+// is meaningful.
+inline uint64_t MatchBytes(uint64_t word, uint64_t pattern) {
+  constexpr uint64_t kOnes = 0x0101010101010101ULL;
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  const uint64_t x = word ^ pattern;
+  return (x - kOnes) & ~x & kHighBits;
+}
+
+inline bool IsCsvSpecialChar(char c, char delim, bool use_quote_delim) {
+  return c == delim || c == '\n' || c == '\r' || (use_quote_delim && c == '"');
+}
+
+}  // namespace csv_internal
+
+// Returns the offset of the first byte in [data, data + size) that ends or
+// invalidates an unquoted CSV field: `delim`, '\n', '\r', or '"' when
+// `use_quote_delim` is set. Returns `size` if there is no such byte.
+//
+// Eight bytes are tested per step with 64-bit SWAR arithmetic, which keeps
+// the scan free of per-byte branches on the long runs of field content that
+// dominate CSV input.
+inline size_t FindCsvSpecialChar(const char* data, size_t size, char delim,
+                                 bool use_quote_delim) {
+  constexpr uint64_t kOnes = 0x0101010101010101ULL;
+  const uint64_t delim_pattern = kOnes * static_cast<uint8_t>(delim);
+  // Without quote handling the fourth pattern repeats '\n' and never adds
+  // matches of its own.
+  const uint64_t quote_pattern =
+      kOnes * static_cast<uint8_t>(use_quote_delim ? '"' : '\n');
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    const uint64_t found = csv_internal::MatchBytes(word, delim_pattern) |
+                           csv_internal::MatchBytes(word, kOnes * '\n') |
+                           csv_internal::MatchBytes(word, kOnes * '\r') |
+                           csv_internal::MatchBytes(word, quote_pattern);
+    if (found == 0) continue;
+    if (port::kLittleEndian) return i + absl::countr_zero(found) / 8;
+    // On big-endian hosts the lowest set bit is the last byte in memory, so
+    // resolve the match byte by byte.
+    break;
+  }
+  for (; i < size; ++i) {
+    if (csv_internal::IsCsvSpecialChar(data[i], delim, use_quote_delim)) {
+      return i;
+    }
+  }
+  return size;
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_UTIL_CSV_SCANNER_H_
@@ -0,0 +1,108 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/csv_scanner.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+// The byte-at-a-time loop FindCsvSpecialChar replaces.
+size_t FindCsvSpecialCharSlow(const char* data, size_t size, char delim,
+                              bool use_quote_delim) {
+  for (size_t i = 0; i < size; ++i) {
+    if (data[i] == delim || data[i] == '\n' || data[i] == '\r' ||
+        (use_quote_delim && data[i] == '"')) {
+      return i;
+    }
+  }
+  return size;
+}
+
+TEST(CsvScannerTest, FindsFirstSpecialChar) {
+  EXPECT_EQ(FindCsvSpecialChar("", 0, ',', true), 0);
+  EXPECT_EQ(FindCsvSpecialChar("abc", 3, ',', true), 3);
+  EXPECT_EQ(FindCsvSpecialChar("abc,def", 7, ',', true), 3);
+  EXPECT_EQ(FindCsvSpecialChar("abcdefghij\"k", 12, ',', true), 10);
+  EXPECT_EQ(FindCsvSpecialChar("abcdefghij\"k", 12, ',', false), 12);
+  EXPECT_EQ(FindCsvSpecialChar("abcdefgh\r\n", 10, ',', true), 8);
+  EXPECT_EQ(FindCsvSpecialChar("abcdefgh|ijk", 12, '|', true), 8);
+}
+
+TEST(CsvScannerTest, HighBytesDoNotMatch) {
+  // Bytes with the high bit set and bytes one above a special char must not
+  // be mistaken for matches.
+  const std::string s = "\x80\xff-\x0b\x0e#\xac\xa2\xff\xff\xff\xff\xff\xff,";
+  EXPECT_EQ(FindCsvSpecialChar(s.data(), s.size(), ',', true), s.size() - 1);
+}
+
+TEST(CsvScannerTest, MatchesByteLoop) {
+  std::mt19937 rng(0);
+  const std::string alphabet = "ab,\"\n\r\x80\xff|";
+  for (int iter = 0; iter < 2000; ++iter) {
+    std::string s(rng() % 40, 'x');
+    for (char& c : s) {
+      // Keep special chars rare so matches land at every word offset.
+      if (rng() % 8 == 0) c = alphabet[rng() % alphabet.size()];
+    }
+    for (const char delim : {',', '|'}) {
+      for (const bool use_quote_delim : {false, true}) {
+        EXPECT_EQ(
+            FindCsvSpecialChar(s.data(), s.size(), delim, use_quote_delim),
+            FindCsvSpecialCharSlow(s.data(), s.size(), delim, use_quote_delim))
+            << s;
+      }
+    }
+  }
+}
+
+// Args: field length in bytes, and whether to use the SWAR scanner.
+void BM_FindCsvSpecialChar(::testing::benchmark::State& state) {
+  const int field_length = state.range(0);
+  const bool use_swar = state.range(1);
+  std::string line;
+  while (line.size() < (1 << 20)) {
+    line.append(field_length, 'a');
+    line.push_back(',');
+  }
+  auto find = use_swar ? FindCsvSpecialChar : FindCsvSpecialCharSlow;
+  for (auto s : state) {
+    size_t num_fields = 0;
+    for (size_t pos = 0; pos < line.size(); ++num_fields) {
+      pos += find(line.data() + pos, line.size() - pos, ',', true) + 1;
+    }
+    ::testing::DoNotOptimize(num_fields);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          line.size());
+}
+
+BENCHMARK(BM_FindCsvSpecialChar)
+    ->ArgPair(4, 0)
+    ->ArgPair(4, 1)
+    ->ArgPair(16, 0)
+    ->ArgPair(16, 1)
+    ->ArgPair(64, 0)
+    ->ArgPair(64, 1);
+
+}  // namespace
+}  // namespace tensorflow
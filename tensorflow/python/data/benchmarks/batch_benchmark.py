@@ -104,6 +104,59 @@ class BatchBenchmark(benchmark_base.DatasetBenchmarkBase):
           },
           name="batch_size_%d_%s" % (batch_size, op_str))
 
+  def benchmark_numa_aware(self):
+    """Compares NUMA-aware and NUMA-oblivious pipelines.
+
+    The NUMA-aware mode only takes effect when the benchmark is bound to the
+    CPUs of a single NUMA node, e.g. with `numactl --cpunodebind=0`.
+    """
+    batch_size = 128
+    num_range = 100000
+
+    def f(_):
+      return random_ops.random_uniform([224, 224, 3])
+
+    for numa_aware in [False, True]:
+      dataset = dataset_ops.Dataset.range(num_range).map(
+          f, num_parallel_calls=dataset_ops.AUTOTUNE).batch(
+              batch_size, num_parallel_calls=dataset_ops.AUTOTUNE)
+      options = options_lib.Options()
+      options.threading.numa_aware = numa_aware
+      dataset = dataset.with_options(options)
+      tag = "_numa_aware" if numa_aware else ""
+      self.run_and_report_benchmark(
+          dataset,
+          num_elements=num_range // batch_size,
+          iters=1,
+          extras={
+              "model_name": "batch.benchmark.5",
+              "parameters": "%d.%s" % (batch_size, numa_aware),
+          },
+          name="batch_size_%d_parallel_map%s" % (batch_size, tag))
+
+  def benchmark_batch_buffer_pool(self):
+    """Compares batching into pooled and freshly allocated buffers."""
+    batch_size = 128
+    num_range = 100000
+
+    for batch_buffer_pool in [False, True]:
+      dataset = dataset_ops.Dataset.from_tensors(
+          random_ops.random_uniform([224, 224, 3])).repeat(num_range).batch(
+              batch_size)
+      options = options_lib.Options()
+      options.experimental_batch_buffer_pool = batch_buffer_pool
+      dataset = dataset.with_options(options)
+      tag = "_buffer_pool" if batch_buffer_pool else ""
+      self.run_and_report_benchmark(
+          dataset,
+          num_elements=num_range // batch_size,
+          iters=1,
+          extras={
+              "model_name": "batch.benchmark.6",
+              "parameters": "%d.%s" % (batch_size, batch_buffer_pool),
+          },
+          name="batch_size_%d%s" % (batch_size, tag))
+
 
 if __name__ == "__main__":
   benchmark_base.test.main()
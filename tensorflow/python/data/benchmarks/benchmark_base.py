@@ -245,6 +245,8 @@ class DatasetBenchmarkBase(test.Benchmark):
       name = "{}.graph".format(name)
       extras["implementation"] = "graph"
     extras["num_elements"] = num_elements
+    if wall_time > 0:
+      extras["elements_per_second"] = 1.0 / wall_time
     self.report_benchmark(
         wall_time=wall_time, iters=iters, name=name, extras=extras)
     return wall_time
@@ -0,0 +1,93 @@
+# Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Benchmarks for checkpointing `tf.data` iterators."""
+import os
+import time
+
+import numpy as np
+
+from tensorflow.python.checkpoint import checkpoint as checkpoint_lib
+from tensorflow.python.data.ops import dataset_ops
+from tensorflow.python.data.ops import options as options_lib
+from tensorflow.python.eager import context
+from tensorflow.python.ops import random_ops
+from tensorflow.python.platform import test
+
+
+class CheckpointBenchmark(test.Benchmark):
+  """Benchmarks for checkpointing `tf.data` iterators."""
+
+  def _benchmark_checkpoint_stall(self, buffer_size, async_checkpoint, advance,
+                                  model_name):
+    """Measures how long checkpointing a shuffle iterator blocks training.
+
+    Args:
+      buffer_size: The number of elements in the shuffle buffer.
+      async_checkpoint: Whether to enable asynchronous checkpointing.
+      advance: Whether to produce an element between checkpoints. If not, the
+        shuffle buffer does not change between checkpoints.
+      model_name: The name to report the benchmark under.
+    """
+    num_checkpoints = 10
+    with context.eager_mode():
+      dataset = dataset_ops.Dataset.from_tensors(
+          random_ops.random_uniform([256])).repeat().shuffle(buffer_size)
+      options = options_lib.Options()
+      options.experimental_async_checkpoint = async_checkpoint
+      dataset = dataset.with_options(options)
+      iterator = iter(dataset)
+      # Fills the shuffle buffer.
+      next(iterator)
+      checkpoint = checkpoint_lib.Checkpoint(iterator=iterator)
+      prefix = os.path.join(test.get_temp_dir(), model_name)
+
+      deltas = []
+      for _ in range(num_checkpoints):
+        if advance:
+          next(iterator)
+        start = time.time()
+        checkpoint.write(prefix)
+        deltas.append(time.time() - start)
+
+    # The first checkpoint has nothing to reuse.
+    median = np.median(deltas[1:])
+    self.report_benchmark(
+        wall_time=median,
+        iters=num_checkpoints,
+        extras={
+            "model_name": model_name,
+            "parameters": "%d.%s.%s" % (buffer_size, async_checkpoint,
+                                        advance),
+            "buffer_size": buffer_size,
+            "checkpoint_stall": median,
+        },
+        name="checkpoint_stall_buffer_%d_async_%s_advance_%s" %
+        (buffer_size, async_checkpoint, advance))
+
+  def benchmark_checkpoint_stall(self):
+    model_id = 1
+    for buffer_size in [1000, 10000, 100000]:
+      for async_checkpoint in [False, True]:
+        for advance in [False, True]:
+          self._benchmark_checkpoint_stall(
+              buffer_size=buffer_size,
+              async_checkpoint=async_checkpoint,
+              advance=advance,
+              model_name="checkpoint.benchmark.%d" % model_id)
+          model_id += 1
+
+
+if __name__ == "__main__":
+  test.main()
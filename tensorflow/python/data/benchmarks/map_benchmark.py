@@ -18,6 +18,7 @@ import numpy as np
 from tensorflow.python.data.benchmarks import benchmark_base
 from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.data.ops import map_op
+from tensorflow.python.data.ops import options as options_lib
 from tensorflow.python.framework import constant_op
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import map_fn
@@ -105,6 +106,41 @@ class MapBenchmark(benchmark_base.DatasetBenchmarkBase):
           label="_short_circuit",
           benchmark_id=6)
 
+  def benchmark_parallel_map_small_function(self):
+
+    def benchmark_helper(fn, num_parallel_calls, micro_batching, label,
+                         benchmark_id):
+      num_elements = 100000
+      dataset = dataset_ops.Dataset.range(num_elements).map(
+          fn, num_parallel_calls=num_parallel_calls)
+      options = options_lib.Options()
+      options.experimental_optimization.map_micro_batching = micro_batching
+      dataset = dataset.with_options(options)
+      self.run_and_report_benchmark(
+          dataset,
+          num_elements=num_elements,
+          extras={
+              "model_name": "map.benchmark.%d" % benchmark_id,
+              "parameters": "%d" % num_parallel_calls,
+          },
+          name="small_function_num_parallel_calls_%d%s" %
+          (num_parallel_calls, label))
+
+    for num_parallel_calls in [2, 8, 32]:
+      # Elementwise functions are applied to micro-batches of elements.
+      benchmark_helper(
+          fn=lambda x: x * 2 + 1,
+          num_parallel_calls=num_parallel_calls,
+          micro_batching=True,
+          label="",
+          benchmark_id=11)
+      benchmark_helper(
+          fn=lambda x: x * 2 + 1,
+          num_parallel_calls=num_parallel_calls,
+          micro_batching=False,
+          label="_not_vectorized",
+          benchmark_id=12)
+
   def benchmark_sequential_control_flow(self):
     dataset = dataset_ops.Dataset.from_tensors(100000)
 
@@ -13,10 +13,12 @@
 # limitations under the License.
 # ==============================================================================
 """Benchmarks for static optimizations."""
+import tempfile
 
 from tensorflow.python.data.benchmarks import benchmark_base
 from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.data.ops import options as options_lib
+from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import math_ops
 
 
@@ -160,6 +162,57 @@ class OptimizationBenchmark(benchmark_base.DatasetBenchmarkBase):
         name="filter_parallelization_{}_chain_length_{}".format(opt_mark,
                                                                 chain_length))
 
+  # This benchmark compares the performance of canonical pipelines with the
+  # default optimizations and with the cost-based optimization, which rewrites
+  # the pipelines using the statistics recorded by a previous run.
+
+  def benchmark_cost_based_optimization(self):
+    for pipeline in ["selective_filter", "expanding_map_cache", "cheap_maps",
+                     "expensive_map"]:
+      self._benchmark_cost_based_optimization(
+          pipeline=pipeline, optimize_dataset=False)
+      self._benchmark_cost_based_optimization(
+          pipeline=pipeline, optimize_dataset=True)
+
+  def _make_cost_based_pipeline(self, pipeline):
+    dataset = dataset_ops.Dataset.range(1000 * 1000)
+    if pipeline == "selective_filter":
+      dataset = dataset.map(lambda x: (x, math_ops.square(x))).filter(
+          lambda x, _: math_ops.equal(x % 10, 0))
+    elif pipeline == "expanding_map_cache":
+      dataset = dataset.take(1000).map(
+          lambda x: array_ops.fill([100], x)).cache().repeat()
+    elif pipeline == "cheap_maps":
+      for _ in range(5):
+        dataset = dataset.map(lambda x: x + 1)
+    elif pipeline == "expensive_map":
+      dataset = dataset.map(
+          lambda x: math_ops.reduce_sum(array_ops.fill([1000], x))).map(
+              lambda x: x + 1)
+    return dataset
+
+  def _benchmark_cost_based_optimization(self, pipeline, optimize_dataset):
+    dataset = self._make_cost_based_pipeline(pipeline)
+    if optimize_dataset:
+      options = options_lib.Options()
+      options.experimental_optimization.pipeline_stats_dir = tempfile.mkdtemp()
+      dataset = dataset.with_options(options)
+      # Records the statistics used to optimize the benchmarked runs.
+      for _ in dataset.take(1000):
+        pass
+
+    opt_mark = "opt" if optimize_dataset else "noopt"
+    self.run_and_report_benchmark(
+        dataset=dataset,
+        num_elements=1000,
+        iters=10,
+        warmup=True,
+        extras={
+            "model_name": "optimize.benchmark.5",
+            "parameters": "%s.%s" % (pipeline, optimize_dataset),
+        },
+        name="cost_based_optimization_{}_{}".format(opt_mark, pipeline))
+
 
 if __name__ == "__main__":
   benchmark_base.test.main()
@@ -75,6 +75,16 @@ class DataServiceOpsTest(
     ds = self.make_distributed_range_dataset(num_elements, cluster)
     self.assertDatasetProduces(ds, list(range(num_elements)))
 
+  @combinations.generate(test_base.default_test_combinations())
+  def testDistributeLoadAwareTaskSelection(self):
+    num_workers = 3
+    cluster = self.make_test_cluster(num_workers=num_workers)
+    num_elements = 10
+    ds = self.make_distributed_range_dataset(
+        num_elements, cluster, load_aware_task_selection=True)
+    self.assertDatasetProduces(
+        ds, num_workers * list(range(num_elements)), assert_items_equal=True)
+
   @combinations.generate(test_base.default_test_combinations())
   def testDistributeInvalidCompression(self):
     cluster = self.make_test_cluster(num_workers=1)
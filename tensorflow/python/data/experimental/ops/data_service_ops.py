@@ -281,7 +281,8 @@ class _DataServiceDatasetV2(dataset_ops.DatasetSource):
                max_outstanding_requests=None,
                task_refresh_interval_hint_ms=None,
                cross_trainer_cache=None,
-               target_workers="AUTO"):
+               target_workers="AUTO",
+               load_aware_task_selection=False):
     """Constructs a _DataServiceDatasetV2.
 
     Args:
@@ -333,6 +334,10 @@ class _DataServiceDatasetV2(dataset_ops.DatasetSource):
         avoid RPCs and data copy if every TF worker colocates with a tf.data
         service worker. Consumers of a shared job must use the same
         `target_workers`. Defaults to `"AUTO"`.
+      load_aware_task_selection: (Optional.) Whether reads without
+        `consumer_index` favor workers on the same host and with less load,
+        reading from stragglers less often. If `False`, tasks are read
+        round-robin. Defaults to `False`.
     """
     if consumer_index is None != num_consumers is None:
       raise ValueError(
@@ -385,6 +390,8 @@ class _DataServiceDatasetV2(dataset_ops.DatasetSource):
     compat_kwargs = {}
     if data_transfer_protocol is not None:
       compat_kwargs["data_transfer_protocol"] = data_transfer_protocol
+    if load_aware_task_selection:
+      compat_kwargs["load_aware_task_selection"] = load_aware_task_selection
 
     # If `uncompress` is `True`, the dataset will query the servers to find
     # out the actual compression used. It is always set to `True` the first
@@ -424,7 +431,7 @@ class _DataServiceDatasetV1(dataset_ops.DatasetV1Adapter):
                protocol, data_transfer_protocol, job_name, consumer_index,
                num_consumers, max_outstanding_requests,
                task_refresh_interval_hint_ms, cross_trainer_cache,
-               target_workers):
+               target_workers, load_aware_task_selection):
 
     self._wrapped = _DataServiceDatasetV2(
         dataset_id=dataset_id,
@@ -439,7 +446,8 @@ class _DataServiceDatasetV1(dataset_ops.DatasetV1Adapter):
         max_outstanding_requests=max_outstanding_requests,
         task_refresh_interval_hint_ms=task_refresh_interval_hint_ms,
         cross_trainer_cache=cross_trainer_cache,
-        target_workers=target_workers)
+        target_workers=target_workers,
+        load_aware_task_selection=load_aware_task_selection)
     super(_DataServiceDatasetV1, self).__init__(self._wrapped)
 
 
@@ -489,6 +497,7 @@ def _distribute(
     compression="AUTO",
     cross_trainer_cache=None,
     target_workers="AUTO",
+    load_aware_task_selection=False,
 ) -> Callable[dataset_ops.Dataset, dataset_ops.Dataset]:
   """A transformation that moves dataset processing to the tf.data service.
 
@@ -548,6 +557,10 @@ def _distribute(
       data copy if every TF worker colocates with a tf.data service worker.
       Consumers of a shared job must use the same `target_workers`. Defaults to
       `"AUTO"`.
+    load_aware_task_selection: (Optional.) Whether reads without
+      `consumer_index` favor workers on the same host and with less load,
+      reading from stragglers less often. If `False`, tasks are read
+      round-robin. Defaults to `False`.
 
   Returns:
     Dataset: A `Dataset` of the elements produced by the data service.
@@ -569,7 +582,8 @@ def _distribute(
         task_refresh_interval_hint_ms=task_refresh_interval_hint_ms,
         data_transfer_protocol=data_transfer_protocol,
         cross_trainer_cache=cross_trainer_cache,
-        target_workers=target_workers)
+        target_workers=target_workers,
+        load_aware_task_selection=load_aware_task_selection)
 
   return _apply_fn
 
@@ -958,7 +972,8 @@ def _from_dataset_id(processing_mode,
                      task_refresh_interval_hint_ms=None,
                      data_transfer_protocol=None,
                      cross_trainer_cache=None,
-                     target_workers="AUTO") -> dataset_ops.Dataset:
+                     target_workers="AUTO",
+                     load_aware_task_selection=False) -> dataset_ops.Dataset:
   """Creates a dataset which reads data from the tf.data service.
 
   This transformation is similar to `from_dataset_id`, but supports additional
@@ -1024,6 +1039,10 @@ def _from_dataset_id(processing_mode,
       data copy if every TF worker colocates with a tf.data service worker.
       Consumers of a shared job must use the same `target_workers`. Defaults to
       `"AUTO"`.
+    load_aware_task_selection: (Optional.) Whether reads without
+      `consumer_index` favor workers on the same host and with less load,
+      reading from stragglers less often. If `False`, tasks are read
+      round-robin. Defaults to `False`.
 
   Returns:
     A `tf.data.Dataset` which reads from the tf.data service.
@@ -1092,7 +1111,8 @@ def _from_dataset_id(processing_mode,
       max_outstanding_requests=max_outstanding_requests,
       task_refresh_interval_hint_ms=task_refresh_interval_hint_ms,
       cross_trainer_cache=cross_trainer_cache,
-      target_workers=target_workers)
+      target_workers=target_workers,
+      load_aware_task_selection=load_aware_task_selection)
 
   # Disable autosharding for shared jobs.
   if job_name is not None:
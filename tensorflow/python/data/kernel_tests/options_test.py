@@ -146,6 +146,8 @@ class OptionsTest(test_base.DatasetTestBase, parameterized.TestCase):
     options.autotune.cpu_budget = 10
     options.autotune.ram_budget = 20
     options.deterministic = True
+    options.experimental_async_checkpoint = True
+    options.experimental_batch_buffer_pool = True
     options.experimental_external_state_policy = (
         options_lib.ExternalStatePolicy.FAIL)
     options.experimental_distribute.auto_shard_policy = (
@@ -158,9 +160,11 @@ class OptionsTest(test_base.DatasetTestBase, parameterized.TestCase):
     options.experimental_optimization.map_and_batch_fusion = True
     options.experimental_optimization.map_and_filter_fusion = True
     options.experimental_optimization.map_fusion = True
+    options.experimental_optimization.map_micro_batching = True
     options.experimental_optimization.map_parallelization = True
     options.experimental_optimization.noop_elimination = True
     options.experimental_optimization.parallel_batch = True
+    options.experimental_optimization.pipeline_stats_dir = "/tmp/stats"
     options.experimental_optimization.shuffle_and_repeat_fusion = True
     options.experimental_optimization.seq_interleave_prefetch = True
     options.experimental_warm_start = True
@@ -169,6 +173,7 @@ class OptionsTest(test_base.DatasetTestBase, parameterized.TestCase):
     options.framework_type = ["TFDS", "TfGrain"]
     options.threading.max_intra_op_parallelism = 30
     options.threading.private_threadpool_size = 40
+    options.threading.numa_aware = True
     pb = options._to_proto()
     result = options_lib.Options()
     result._from_proto(pb)
@@ -28,6 +28,7 @@ from tensorflow.python.data.kernel_tests import checkpoint_test_base
 from tensorflow.python.data.kernel_tests import test_base
 from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.data.ops import options as options_lib
+from tensorflow.python.data.ops import shuffle_op
 from tensorflow.python.eager import def_function
 from tensorflow.python.framework import combinations
 from tensorflow.python.framework import constant_op
@@ -530,6 +531,23 @@ class ShuffleTest(test_base.DatasetTestBase, parameterized.TestCase):
     dataset = dataset_ops.Dataset.from_tensors(42).shuffle(1, name="shuffle")
     self.assertDatasetProduces(dataset, [42])
 
+  @combinations.generate(
+      combinations.times(
+          test_base.default_test_combinations(),
+          combinations.combine(spill=[True, False])))
+  def testMemoryBudget(self, spill):
+    dataset = dataset_ops.Dataset.range(100).map(
+        lambda x: array_ops.fill([64], x))
+    dataset = shuffle_op._shuffle(  # pylint: disable=protected-access
+        dataset,
+        buffer_size=50,
+        seed=42,
+        buffer_size_bytes=1024,
+        spill_directory=self.get_temp_dir() if spill else None)
+    output = self.getDatasetOutput(dataset)
+    self.assertCountEqual([x[0] for x in output], range(100))
+    self.assertNotEqual([x[0] for x in output], list(range(100)))
+
 
 class ShuffleCheckpointTest(checkpoint_test_base.CheckpointTestBase,
                             parameterized.TestCase):
@@ -596,6 +614,26 @@ class ShuffleCheckpointTest(checkpoint_test_base.CheckpointTestBase,
         num_outputs,
     )
 
+  @combinations.generate(
+      combinations.times(
+          test_base.default_test_combinations(),
+          checkpoint_test_base.default_test_combinations(),
+          combinations.combine(buffer_size=[1, 5, dataset_ops.UNKNOWN]),
+      )
+  )
+  def testMemoryBudget(self, verify_fn, buffer_size):
+
+    def build_dataset():
+      # A budget of 64 bytes spills every few elements.
+      return shuffle_op._shuffle(  # pylint: disable=protected-access
+          dataset_ops.Dataset.range(20),
+          buffer_size=buffer_size,
+          seed=55,
+          buffer_size_bytes=64,
+          spill_directory=self.get_temp_dir())
+
+    verify_fn(self, build_dataset, num_outputs=20)
+
   @combinations.generate(
       combinations.combine(
           tf_api_version=1,
@@ -408,6 +408,19 @@ class OptimizationOptions(options_lib.OptionsBase):
       ),
   )
 
+  map_micro_batching = options_lib.create_option(
+      name="map_micro_batching",
+      ty=bool,
+      docstring=(
+          "Whether to apply parallel map functions which only use elementwise"
+          " ops to micro-batches of elements, with one function call per"
+          " micro-batch. This reduces the per-call overhead of cheap functions."
+          " Floating-point results may differ in the last bits, since some ops"
+          " compute batches with different instructions than single elements."
+          " If None, defaults to False."
+      ),
+  )
+
   map_parallelization = options_lib.create_option(
       name="map_parallelization",
       ty=bool,
@@ -427,6 +440,17 @@ class OptimizationOptions(options_lib.OptionsBase):
       docstring="Whether to parallelize copying of batch elements. If None, "
       "defaults to True.")
 
+  pipeline_stats_dir = options_lib.create_option(
+      name="pipeline_stats_dir",
+      ty=str,
+      docstring=(
+          "Directory in which the statistics of input pipeline runs are"
+          " recorded. If set, the statistics recorded by a previous run of the"
+          " same pipeline are used to reorder, fuse and prefetch its"
+          " transformations. If None, no statistics are recorded or used."
+      ),
+  )
+
   shuffle_and_repeat_fusion = options_lib.create_option(
       name="shuffle_and_repeat_fusion",
       ty=bool,
@@ -451,12 +475,16 @@ class OptimizationOptions(options_lib.OptionsBase):
       pb.map_and_filter_fusion = self.map_and_filter_fusion
     if self.map_fusion is not None:
       pb.map_fusion = self.map_fusion
+    if self.map_micro_batching is not None:
+      pb.map_micro_batching = self.map_micro_batching
     if self.map_parallelization is not None:
       pb.map_parallelization = self.map_parallelization
     if self.noop_elimination is not None:
       pb.noop_elimination = self.noop_elimination
     if self.parallel_batch is not None:
       pb.parallel_batch = self.parallel_batch
+    if self.pipeline_stats_dir is not None:
+      pb.pipeline_stats_dir = self.pipeline_stats_dir
     if self.shuffle_and_repeat_fusion is not None:
       pb.shuffle_and_repeat_fusion = self.shuffle_and_repeat_fusion
     return pb
@@ -478,12 +506,16 @@ class OptimizationOptions(options_lib.OptionsBase):
       self.map_and_filter_fusion = pb.map_and_filter_fusion
     if pb.WhichOneof("optional_map_fusion") is not None:
       self.map_fusion = pb.map_fusion
+    if pb.WhichOneof("optional_map_micro_batching") is not None:
+      self.map_micro_batching = pb.map_micro_batching
     if pb.WhichOneof("optional_map_parallelization") is not None:
       self.map_parallelization = pb.map_parallelization
     if pb.WhichOneof("optional_noop_elimination") is not None:
       self.noop_elimination = pb.noop_elimination
     if pb.WhichOneof("optional_parallel_batch") is not None:
       self.parallel_batch = pb.parallel_batch
+    if pb.WhichOneof("optional_pipeline_stats_dir") is not None:
+      self.pipeline_stats_dir = pb.pipeline_stats_dir
     if pb.WhichOneof("optional_shuffle_and_repeat_fusion") is not None:
       self.shuffle_and_repeat_fusion = pb.shuffle_and_repeat_fusion
 
@@ -561,12 +593,26 @@ class ThreadingOptions(options_lib.OptionsBase):
       "The value 0 can be used to indicate that the threadpool size should be "
       "determined at runtime based on the number of available CPU cores.")
 
+  numa_aware = options_lib.create_option(
+      name="numa_aware",
+      ty=bool,
+      docstring=(
+          "Whether to run the input pipeline on the NUMA node of the thread"
+          " creating its iterator, pinning its threads to that node and"
+          " allocating its elements from node-local memory. Has no effect if"
+          " that thread may run on the CPUs of several NUMA nodes. If None,"
+          " defaults to False."
+      ),
+  )
+
   def _to_proto(self):
     pb = dataset_options_pb2.ThreadingOptions()
     if self.max_intra_op_parallelism is not None:
       pb.max_intra_op_parallelism = self.max_intra_op_parallelism
     if self.private_threadpool_size is not None:
       pb.private_threadpool_size = self.private_threadpool_size
+    if self.numa_aware is not None:
+      pb.numa_aware = self.numa_aware
     return pb
 
   def _from_proto(self, pb):
@@ -574,6 +620,8 @@ class ThreadingOptions(options_lib.OptionsBase):
       self.max_intra_op_parallelism = pb.max_intra_op_parallelism
     if pb.WhichOneof("optional_private_threadpool_size") is not None:
       self.private_threadpool_size = pb.private_threadpool_size
+    if pb.WhichOneof("optional_numa_aware") is not None:
+      self.numa_aware = pb.numa_aware
 
 
 @tf_export("data.Options")
@@ -619,6 +667,25 @@ class Options(options_lib.OptionsBase):
       "Whether the outputs need to be produced in deterministic order. If None,"
       " defaults to True.")
 
+  experimental_async_checkpoint = options_lib.create_option(
+      name="experimental_async_checkpoint",
+      ty=bool,
+      docstring="Whether to encode iterator checkpoints in the background, so "
+      "that iteration can continue while a checkpoint is written. The "
+      "encoding of the previous checkpoint is reused for iterators whose "
+      "state did not change, e.g. a shuffle buffer that was not consumed "
+      "from, at the expense of holding on to the previous checkpoint. If "
+      "None, defaults to False.")
+
+  experimental_batch_buffer_pool = options_lib.create_option(
+      name="experimental_batch_buffer_pool",
+      ty=bool,
+      docstring="Whether batching transformations should allocate their "
+      "output from a pool of buffers which are recycled once the consumer "
+      "releases a batch, instead of allocating each batch. The buffers come "
+      "from GPU-compatible host memory, so they can be copied to the device "
+      "without staging. If None, defaults to False.")
+
   experimental_deterministic = options_lib.create_option(
       name="experimental_deterministic",
       ty=bool,
@@ -765,6 +832,10 @@ class Options(options_lib.OptionsBase):
       pb.symbolic_checkpoint = self.experimental_symbolic_checkpoint
     if self.experimental_warm_start is not None:
       pb.warm_start = self.experimental_warm_start
+    if self.experimental_async_checkpoint is not None:
+      pb.async_checkpoint = self.experimental_async_checkpoint
+    if self.experimental_batch_buffer_pool is not None:
+      pb.batch_buffer_pool = self.experimental_batch_buffer_pool
     if self.dataset_name is not None:
       pb.dataset_name = self.dataset_name
     if self.framework_type:
@@ -790,6 +861,10 @@ class Options(options_lib.OptionsBase):
       self.experimental_symbolic_checkpoint = pb.symbolic_checkpoint
     if pb.WhichOneof("optional_warm_start") is not None:
       self.experimental_warm_start = pb.warm_start
+    if pb.WhichOneof("optional_async_checkpoint") is not None:
+      self.experimental_async_checkpoint = pb.async_checkpoint
+    if pb.WhichOneof("optional_batch_buffer_pool") is not None:
+      self.experimental_batch_buffer_pool = pb.batch_buffer_pool
     if pb.WhichOneof("optional_dataset_name") is not None:
       self.dataset_name = pb.dataset_name
     if pb.framework_type:
@@ -289,6 +289,7 @@ class _TFRecordDataset(dataset_ops.DatasetSource):
                filenames,
                compression_type=None,
                buffer_size=None,
+               use_index=False,
                name=None):
     """Creates a `TFRecordDataset`.
 
@@ -298,6 +299,8 @@ class _TFRecordDataset(dataset_ops.DatasetSource):
         `""` (no compression), `"ZLIB"`, or `"GZIP"`.
       buffer_size: (Optional.) A `tf.int64` scalar representing the number of
         bytes in the read buffer. 0 means no buffering.
+      use_index: (Optional.) Whether to read the records of uncompressed files
+        using their TFRecord index sidecar files.
       name: (Optional.) A name for the tf.data operation.
     """
     self._filenames = filenames
@@ -314,7 +317,8 @@ class _TFRecordDataset(dataset_ops.DatasetSource):
 
     variant_tensor = gen_dataset_ops.tf_record_dataset(
         self._filenames, self._compression_type, self._buffer_size,
-        metadata=self._metadata.SerializeToString())
+        metadata=self._metadata.SerializeToString(),
+        use_index=use_index)
     super(_TFRecordDataset, self).__init__(variant_tensor)
 
   @property
@@ -437,6 +441,7 @@ class TFRecordDatasetV2(dataset_ops.DatasetV2):
                compression_type=None,
                buffer_size=None,
                num_parallel_reads=None,
+               use_index=False,
                name=None):
     """Creates a `TFRecordDataset` to read one or more TFRecord files.
 
@@ -457,6 +462,12 @@ class TFRecordDatasetV2(dataset_ops.DatasetV2):
         input pipeline is I/O bottlenecked, consider setting this parameter to a
         value greater than one to parallelize the I/O. If `None`, files will be
         read sequentially.
+      use_index: (Optional.) If `True`, uncompressed files that all have a
+        TFRecord index sidecar file (`<filename>.tfrecord-index`) are read
+        using their indexes, which gives the dataset a known cardinality and
+        supports random access, e.g. by `tf.data.Dataset.global_shuffle`.
+        Looking for the indexes costs a file system request per file, so it is
+        off by default.
       name: (Optional.) A name for the tf.data operation.
 
     Raises:
@@ -472,7 +483,8 @@ class TFRecordDatasetV2(dataset_ops.DatasetV2):
 
     def creator_fn(filename):
       return _TFRecordDataset(
-          filename, compression_type, buffer_size, name=name)
+          filename, compression_type, buffer_size, use_index=use_index,
+          name=name)
 
     self._impl = _create_dataset_reader(
         creator_fn, filenames, num_parallel_reads, name=name)
@@ -496,9 +508,15 @@ class TFRecordDatasetV1(dataset_ops.DatasetV1Adapter):
                compression_type=None,
                buffer_size=None,
                num_parallel_reads=None,
+               use_index=False,
                name=None):
     wrapped = TFRecordDatasetV2(
-        filenames, compression_type, buffer_size, num_parallel_reads, name=name)
+        filenames,
+        compression_type,
+        buffer_size,
+        num_parallel_reads,
+        use_index=use_index,
+        name=name)
     super(TFRecordDatasetV1, self).__init__(wrapped)
 
   __init__.__doc__ = TFRecordDatasetV2.__init__.__doc__
@@ -28,9 +28,17 @@ def _shuffle(  # pylint: disable=unused-private-name
     seed=None,
     reshuffle_each_iteration=True,
     name=None,
+    buffer_size_bytes=None,
+    spill_directory=None,
 ):
   return _ShuffleDataset(
-      input_dataset, buffer_size, seed, reshuffle_each_iteration, name=name)
+      input_dataset,
+      buffer_size,
+      seed,
+      reshuffle_each_iteration,
+      name=name,
+      buffer_size_bytes=buffer_size_bytes,
+      spill_directory=spill_directory)
 
 
 class _ShuffleDataset(dataset_ops.UnaryUnchangedStructureDataset):
@@ -43,17 +51,40 @@ class _ShuffleDataset(dataset_ops.UnaryUnchangedStructureDataset):
       seed=None,
       reshuffle_each_iteration=True,
       name=None,
+      buffer_size_bytes=None,
+      spill_directory=None,
   ):
-    """See `Dataset.shuffle()` for details."""
+    """See `Dataset.shuffle()` for details.
+
+    Args:
+      input_dataset: The input dataset.
+      buffer_size: See `Dataset.shuffle()`.
+      seed: See `Dataset.shuffle()`.
+      reshuffle_each_iteration: See `Dataset.shuffle()`.
+      name: See `Dataset.shuffle()`.
+      buffer_size_bytes: (Optional.) If positive, the shuffle buffer keeps its
+        elements compressed in at most this many bytes of memory and spills
+        the rest to `spill_directory`. Reading spilled elements additionally
+        takes up to 16 open files, with read buffers of about this many bytes
+        in total.
+      spill_directory: (Optional.) A local directory for the elements which do
+        not fit in `buffer_size_bytes`. If unset, all elements are kept in
+        memory, compressed.
+    """
     self._input_dataset = input_dataset
     self._buffer_size = ops.convert_to_tensor(
         buffer_size, dtype=dtypes.int64, name="buffer_size")
     self._seed, self._seed2 = random_seed.get_seed(seed)
     self._reshuffle_each_iteration = reshuffle_each_iteration
     self._name = name
+    budget_args = {}
+    if buffer_size_bytes:
+      budget_args["buffer_size_bytes"] = buffer_size_bytes
+      budget_args["spill_directory"] = spill_directory or ""
 
-    if (tf2.enabled() and
-        (context.executing_eagerly() or ops.inside_function())):
+    # Only `ShuffleDatasetV3` supports a memory budget.
+    if budget_args or (tf2.enabled() and
+                       (context.executing_eagerly() or ops.inside_function())):
       variant_tensor = gen_dataset_ops.shuffle_dataset_v3(
           input_dataset._variant_tensor,  # pylint: disable=protected-access
           buffer_size=self._buffer_size,
@@ -61,6 +92,7 @@ class _ShuffleDataset(dataset_ops.UnaryUnchangedStructureDataset):
           seed2=self._seed2,
           seed_generator=gen_dataset_ops.dummy_seed_generator(),
           reshuffle_each_iteration=self._reshuffle_each_iteration,
+          **budget_args,
           **self._common_args)
     else:
       variant_tensor = gen_dataset_ops.shuffle_dataset(
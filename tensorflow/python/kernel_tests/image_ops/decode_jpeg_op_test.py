@@ -18,11 +18,14 @@ import os
 import time
 
 from tensorflow.python.client import session
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import ops
 from tensorflow.python.ops import array_ops
 from tensorflow.python.ops import control_flow_ops
+from tensorflow.python.ops import gen_image_ops
 from tensorflow.python.ops import image_ops
 from tensorflow.python.ops import io_ops
+from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import variable_scope
 from tensorflow.python.ops import variables
 from tensorflow.python.platform import resource_loader
@@ -38,7 +41,9 @@ class DecodeJpegBenchmark(test.Benchmark):
                       num_iters,
                       crop_during_decode=None,
                       crop_window=None,
-                      tile=None):
+                      tile=None,
+                      resize=None,
+                      resize_during_decode=False):
     """Evaluate DecodeJpegOp for the given image.
 
     TODO(tanmingxing): add decoding+cropping as well.
@@ -52,6 +57,9 @@ class DecodeJpegBenchmark(test.Benchmark):
       crop_window: if not None, crop the decoded image. Depending on
           crop_during_decode, cropping could happen during or after decoding.
       tile: if not None, tile the image to composite a larger fake image.
+      resize: if not None, the [height, width] to resize the decoded image to.
+      resize_during_decode: If true, use fused DecodeAndResizeJpeg instead of
+          separate decode and resize ops. It is ignored if resize is None.
 
     Returns:
       The duration of the run in seconds.
@@ -85,7 +93,18 @@ class DecodeJpegBenchmark(test.Benchmark):
       self.evaluate(variables.global_variables_initializer())
       images = []
       for _ in range(parallelism):
-        if crop_window is None:
+        if resize is not None:
+          if resize_during_decode:
+            # Combined decode and resize.
+            image = gen_image_ops.decode_and_resize_jpeg(
+                image_content, [], resize, channels=3)
+          else:
+            # Separate decode and resize.
+            image = image_ops.decode_jpeg(image_content, channels=3)
+            image = image_ops.resize_images_v2(
+                math_ops.cast(image, dtypes.float32), resize,
+                method=image_ops.ResizeMethod.BILINEAR, antialias=True)
+        elif crop_window is None:
           # No crop.
           image = image_ops.decode_jpeg(image_content, channels=3)
         elif crop_during_decode:
@@ -189,6 +208,31 @@ class DecodeJpegBenchmark(test.Benchmark):
           iters=num_iters,
           wall_time=duration_decode_after_crop)
 
+  def benchmarkDecodeAndResizeJpegLarge(self):
+    """Evaluate fused DecodeAndResizeJpeg against decode then resize."""
+    num_iters = 10
+    resize = [224, 224]
+    tile = [4, 4, 1]
+    for parallelism in [1, 100]:
+      # Tile the medium size image to composite a larger fake image.
+      duration_decode_resize = self._evalDecodeJpeg(
+          'medium.jpg', parallelism, num_iters, tile=tile, resize=resize)
+      duration_fused = self._evalDecodeJpeg(
+          'medium.jpg',
+          parallelism,
+          num_iters,
+          tile=tile,
+          resize=resize,
+          resize_during_decode=True)
+      self.report_benchmark(
+          name='decode_resize_jpeg_large_p%d' % (parallelism),
+          iters=num_iters,
+          wall_time=duration_decode_resize)
+      self.report_benchmark(
+          name='decode_and_resize_jpeg_large_p%d' % (parallelism),
+          iters=num_iters,
+          wall_time=duration_fused)
+
 
 if __name__ == '__main__':
   test.main()
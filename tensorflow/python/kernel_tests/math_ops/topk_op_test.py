@@ -195,6 +195,19 @@ class TopKTest(test.TestCase):
       values = -np.sort(-inputs, axis=1)[:, :k]
       self._validateTopK(inputs, k, values, indices)
 
+  def testLongRowTopK(self):
+    # Long rows may be split into column segments that are reduced on
+    # different threads; ties must still resolve to the lowest index.
+    b = 2
+    n = 200000
+    for dtype in [np.float32, np.int32, dtypes.bfloat16.as_numpy_dtype]:
+      for k in [2, 100, 1000]:
+        inputs = np.random.randint(0, 50, size=(b, n)).astype(dtype)
+        indices = np.argsort(-inputs, axis=1, kind="mergesort")[:, :k]
+        values = -np.sort(-inputs, axis=1)[:, :k]
+        self._validateTopK(inputs, k, values, indices)
+        self._validateTopK(inputs, k, values, indices, sorted=False)
+
   def testTopAll(self):
     inputs = [[0.1, 0.3, 0.2, 0.4], [0.1, 0.3, 0.3, 0.2]]
     self._validateTopK(inputs, 4, [[0.4, 0.3, 0.2, 0.1], [0.3, 0.3, 0.2, 0.1]],
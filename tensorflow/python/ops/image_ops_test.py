@@ -4565,6 +4565,51 @@ class JpegTest(test_util.TensorFlowTestCase):
           result = image_ops.decode_and_crop_jpeg(jpeg0, crop_window)
           self.evaluate(result)
 
+  def testDecodeAndResizeJpeg(self):
+    with self.cached_session():
+      base = "tensorflow/core/lib/jpeg/testdata"
+      jpeg0 = io_ops.read_file(os.path.join(base, "jpeg_merge_test1.jpg"))
+
+      h, w = 256, 128
+      # The first two decode at ratios 2 and 4, the last at full resolution.
+      cases = [([], [h // 2, w // 2]), ([6, 5, 128, 64], [32, 16]),
+               ([6, 5, 15, 10], [15, 10])]
+      for crop_window, size in cases:
+        if crop_window:
+          image1 = image_ops.decode_and_crop_jpeg(
+              jpeg0, crop_window, channels=3)
+        else:
+          image1 = image_ops.decode_jpeg(jpeg0, channels=3)
+        image1 = image_ops.resize_images_v2(
+            math_ops.cast(image1, dtypes.float32), size,
+            method=image_ops.ResizeMethod.BILINEAR, antialias=True)
+        image2 = gen_image_ops.decode_and_resize_jpeg(
+            jpeg0, crop_window, size, channels=3)
+        self.assertAllEqual(image2.get_shape().as_list(), size + [3])
+
+        image1, image2 = self.evaluate([image1, image2])
+        if size == crop_window[2:]:
+          # Without scaling the filter passes pixels through unchanged.
+          self.assertAllEqual(image1, image2)
+        else:
+          # The scaled IDCT is close to, but not exactly, a box filter.
+          self.assertLess(self.averageError(image1, image2), 3)
+
+  def testDecodeAndResizeJpegWithInvalidCropWindow(self):
+    with self.cached_session():
+      base = "tensorflow/core/lib/jpeg/testdata"
+      jpeg0 = io_ops.read_file(os.path.join(base, "jpeg_merge_test1.jpg"))
+
+      h, w = 256, 128
+      crop_windows = [[-1, 11, 11, 11], [11, 11, 0, 11], [0, 0, h + 1, w],
+                      [0, 0, h]]
+      for crop_window in crop_windows:
+        with self.assertRaisesRegex((ValueError, errors.InvalidArgumentError),
+                                    "crop window|crop_window"):
+          result = gen_image_ops.decode_and_resize_jpeg(
+              jpeg0, crop_window, [8, 8])
+          self.evaluate(result)
+
   def testSynthetic(self):
     with self.cached_session():
       # Encode it, then decode it, then encode it
@@ -149,6 +149,27 @@ class TransposeBenchmark(test.Benchmark):
       for ishape, perm in zip(small_dim_small_shapes, small_dim_perms):
         self._run_graph("gpu", ishape, perm, num_iters, datatype)
 
+  def benchmark_transpose_cpu(self):
+    print("transpose cpu benchmark:")
+
+    # NHWC <-> NCHW on large activations, attention head reshuffles and a
+    # high-rank permutation.
+    shapes_and_perms = [
+        ([32, 56, 56, 256], [0, 3, 1, 2]),
+        ([32, 256, 56, 56], [0, 2, 3, 1]),
+        ([8, 28, 28, 28, 64], [0, 4, 1, 2, 3]),
+        ([8, 64, 28, 28, 28], [0, 2, 3, 4, 1]),
+        ([64, 128, 12, 64], [0, 2, 1, 3]),
+        ([64, 12, 128, 64], [0, 2, 3, 1]),
+        ([4096, 4096], [1, 0]),
+        ([8, 16, 16, 8, 8, 32], [0, 5, 2, 4, 1, 3]),
+    ]
+
+    num_iters = 10
+    for datatype in [np.float32, np.float16, np.int8, np.complex64]:
+      for ishape, perm in shapes_and_perms:
+        self._run_graph("cpu", ishape, perm, num_iters, datatype)
+
 
 if __name__ == "__main__":
   test.main()